@@ -0,0 +1,162 @@
+//
+//  benchmarkImageProcess.cpp
+//  MNN
+//
+//  Created by MNN on 2020/05/11.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <cfloat>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
+#if defined(_MSC_VER)
+#include <Windows.h>
+#undef min
+#undef max
+#else
+#include <sys/time.h>
+#endif
+#include <MNN/ImageProcess.hpp>
+
+using namespace MNN;
+using namespace MNN::CV;
+
+static inline uint64_t getTimeInUs() {
+    uint64_t time;
+#if defined(_MSC_VER)
+    LARGE_INTEGER now, freq;
+    QueryPerformanceCounter(&now);
+    QueryPerformanceFrequency(&freq);
+    uint64_t sec  = now.QuadPart / freq.QuadPart;
+    uint64_t usec = (now.QuadPart % freq.QuadPart) * 1000000 / freq.QuadPart;
+    time          = sec * 1000000 + usec;
+#else
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+    time = static_cast<uint64_t>(tv.tv_sec) * 1000000 + tv.tv_usec;
+#endif
+    return time;
+}
+
+// Besides the time, show the throughput as million pixels of destination per second
+static void displayStats(const char* name, const std::vector<float>& costs, int pixels) {
+    float max = 0, min = FLT_MAX, sum = 0, avg;
+    for (auto v : costs) {
+        max = max < v ? v : max;
+        min = min > v ? v : min;
+        sum += v;
+    }
+    avg = costs.size() > 0 ? sum / costs.size() : 0;
+    printf("[ - ] %-36s    max = %8.3fms  min = %8.3fms  avg = %8.3fms  %8.1f Mpix/s\n", name, max, avg == 0 ? 0 : min,
+           avg, avg == 0 ? 0 : pixels / avg / 1000.0f);
+}
+
+static int _getBpp(ImageFormat format) {
+    switch (format) {
+        case RGB:
+        case BGR:
+            return 3;
+        case RGBA:
+        case BGRA:
+            return 4;
+        case GRAY:
+            return 1;
+        default:
+            break;
+    }
+    return 0;
+}
+
+struct BenchCase {
+    const char* name;
+    ImageFormat sourceFormat;
+    ImageFormat destFormat;
+    Filter filter;
+    int ow;
+    int oh;
+    bool isFloat;
+};
+
+// The source is a 1080p frame, the destination is either of same size or resized like the input of models
+static std::vector<float> runImageProcess(const BenchCase& c, int iw, int ih, int numThread, int loop) {
+    ImageProcess::Config config;
+    config.sourceFormat = c.sourceFormat;
+    config.destFormat   = c.destFormat;
+    config.filterType   = c.filter;
+    for (int i = 0; i < 4; ++i) {
+        config.mean[i]   = 127.5f;
+        config.normal[i] = 1.0f / 127.5f;
+    }
+    std::shared_ptr<ImageProcess> process(ImageProcess::create(config));
+    process->setThreadNumber(numThread);
+    Matrix transform;
+    transform.setScale((float)iw / (float)c.ow, (float)ih / (float)c.oh);
+    process->setMatrix(transform);
+
+    // NV21 has the plane of Y and the interleaved plane of VU in half size
+    auto sourceBpp  = _getBpp(c.sourceFormat);
+    auto sourceSize = sourceBpp > 0 ? iw * ih * sourceBpp : iw * ih + ((iw + 1) / 2) * ((ih + 1) / 2) * 2;
+    std::vector<uint8_t> source(sourceSize);
+    srand(iw + ih);
+    for (auto& v : source) {
+        v = rand() % 256;
+    }
+    auto destBpp   = _getBpp(c.destFormat);
+    auto destBytes = c.isFloat ? sizeof(float) : sizeof(uint8_t);
+    auto type      = c.isFloat ? halide_type_of<float>() : halide_type_of<uint8_t>();
+    std::vector<uint8_t> dest(c.ow * c.oh * destBpp * destBytes);
+    auto stride = sourceBpp > 0 ? iw * sourceBpp : iw;
+
+    // Warming up...
+    for (int i = 0; i < 3; ++i) {
+        process->convert(source.data(), iw, ih, stride, dest.data(), c.ow, c.oh, destBpp, 0, type);
+    }
+    std::vector<float> costs;
+    for (int i = 0; i < loop; ++i) {
+        auto timeBegin = getTimeInUs();
+        process->convert(source.data(), iw, ih, stride, dest.data(), c.ow, c.oh, destBpp, 0, type);
+        auto timeEnd = getTimeInUs();
+        costs.push_back((timeEnd - timeBegin) / 1000.0);
+    }
+    return costs;
+}
+
+int main(int argc, const char* argv[]) {
+    printf("MNN ImageProcess benchmark\n");
+    printf("Usage: benchmarkImageProcess.out [loop_count] [numberThread]\n");
+    int loop      = 10;
+    int numThread = 4;
+    if (argc > 1) {
+        loop = atoi(argv[1]);
+    }
+    if (argc > 2) {
+        numThread = atoi(argv[2]);
+    }
+    printf("Forward type: CPU thread=%d loop=%d\n", numThread, loop);
+
+    const int iw = 1920, ih = 1080;
+    const BenchCase cases[] = {
+        {"RGBA->RGBA copy", RGBA, RGBA, NEAREST, iw, ih, false},
+        {"RGBA->RGB copy", RGBA, RGB, NEAREST, iw, ih, false},
+        {"RGB->BGR copy", RGB, BGR, NEAREST, iw, ih, false},
+        {"NV21->RGB copy", YUV_NV21, RGB, NEAREST, iw, ih, false},
+        {"NV21->RGBA copy", YUV_NV21, RGBA, NEAREST, iw, ih, false},
+        {"RGB->RGB float", RGB, RGB, NEAREST, iw, ih, true},
+        {"RGBA->RGBA float", RGBA, RGBA, NEAREST, iw, ih, true},
+        {"GRAY->GRAY float", GRAY, GRAY, NEAREST, iw, ih, true},
+        {"RGBA->RGBA nearest 640x360", RGBA, RGBA, NEAREST, 640, 360, false},
+        {"GRAY->GRAY nearest 640x360", GRAY, GRAY, NEAREST, 640, 360, false},
+        {"RGBA->RGBA bilinear 640x360", RGBA, RGBA, BILINEAR, 640, 360, false},
+        {"GRAY->GRAY bilinear 640x360", GRAY, GRAY, BILINEAR, 640, 360, false},
+        {"RGBA->RGB bilinear 224 float", RGBA, RGB, BILINEAR, 224, 224, true},
+        {"RGBA->RGBA bilinear 224 float", RGBA, RGBA, BILINEAR, 224, 224, true},
+        {"NV21->RGB nearest 224 float", YUV_NV21, RGB, NEAREST, 224, 224, true},
+    };
+    for (auto& c : cases) {
+        displayStats(c.name, runImageProcess(c, iw, ih, numThread, loop), c.ow * c.oh);
+    }
+    return 0;
+}
@@ -0,0 +1,119 @@
+//
+//  benchmarkNMS.cpp
+//  MNN
+//
+//  Created by MNN on 2020/05/08.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <cfloat>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
+#if defined(_MSC_VER)
+#include <Windows.h>
+#undef min
+#undef max
+#else
+#include <sys/time.h>
+#endif
+#include <MNN/expr/Executor.hpp>
+#include <MNN/expr/ExprCreator.hpp>
+#include "MNN_generated.h"
+
+using namespace MNN;
+using namespace MNN::Express;
+
+static inline uint64_t getTimeInUs() {
+    uint64_t time;
+#if defined(_MSC_VER)
+    LARGE_INTEGER now, freq;
+    QueryPerformanceCounter(&now);
+    QueryPerformanceFrequency(&freq);
+    uint64_t sec  = now.QuadPart / freq.QuadPart;
+    uint64_t usec = (now.QuadPart % freq.QuadPart) * 1000000 / freq.QuadPart;
+    time          = sec * 1000000 + usec;
+#else
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+    time = static_cast<uint64_t>(tv.tv_sec) * 1000000 + tv.tv_usec;
+#endif
+    return time;
+}
+
+static void displayStats(const char* name, const std::vector<float>& costs) {
+    float max = 0, min = FLT_MAX, sum = 0, avg;
+    for (auto v : costs) {
+        max = max < v ? v : max;
+        min = min > v ? v : min;
+        sum += v;
+    }
+    avg = costs.size() > 0 ? sum / costs.size() : 0;
+    printf("[ - ] %-24s    max = %8.3fms  min = %8.3fms  avg = %8.3fms\n", name, max, avg == 0 ? 0 : min, avg);
+}
+
+// Boxes are jittered around the cells of a grid like the anchors of a detection model, so many of them overlap
+static std::vector<float> runNMS(int numBoxes, int maxDetections, float iouThreshold, int loop) {
+    std::unique_ptr<OpT> op(new OpT);
+    op->type   = OpType_NonMaxSuppressionV2;
+    auto boxes = _Input({numBoxes, 4}, NHWC);
+    auto score = _Input({numBoxes}, NHWC);
+    auto expr  = Expr::create(op.get(), {boxes, score, _Scalar<int32_t>(maxDetections), _Scalar<float>(iouThreshold)});
+    auto output = Variable::create(expr);
+
+    srand(numBoxes);
+    auto boxesPtr = boxes->writeMap<float>();
+    auto scorePtr = score->writeMap<float>();
+    const int grid = 32;
+    for (int i = 0; i < numBoxes; ++i) {
+        float cy = (float)((i / grid) % grid) / grid + (float)rand() / RAND_MAX * 0.02f;
+        float cx = (float)(i % grid) / grid + (float)rand() / RAND_MAX * 0.02f;
+        float h  = 0.02f + (float)rand() / RAND_MAX * 0.1f;
+        float w  = 0.02f + (float)rand() / RAND_MAX * 0.1f;
+        boxesPtr[4 * i + 0] = cy - h;
+        boxesPtr[4 * i + 1] = cx - w;
+        boxesPtr[4 * i + 2] = cy + h;
+        boxesPtr[4 * i + 3] = cx + w;
+        scorePtr[i]         = (float)rand() / RAND_MAX;
+    }
+    // Warming up...
+    for (int i = 0; i < 3; ++i) {
+        score->writeMap<float>();
+        output->readMap<int32_t>();
+    }
+    std::vector<float> costs;
+    for (int i = 0; i < loop; ++i) {
+        auto timeBegin = getTimeInUs();
+        score->writeMap<float>();
+        output->readMap<int32_t>();
+        auto timeEnd = getTimeInUs();
+        costs.push_back((timeEnd - timeBegin) / 1000.0);
+    }
+    return costs;
+}
+
+int main(int argc, const char* argv[]) {
+    printf("MNN NonMaxSuppression benchmark\n");
+    printf("Usage: benchmarkNMS.out [loop_count] [numberThread]\n");
+    int loop      = 10;
+    int numThread = 4;
+    if (argc > 1) {
+        loop = atoi(argv[1]);
+    }
+    if (argc > 2) {
+        numThread = atoi(argv[2]);
+    }
+    BackendConfig config;
+    Executor::getGlobalExecutor()->setGlobalExecutorConfig(MNN_FORWARD_CPU, config, numThread);
+    printf("Forward type: CPU thread=%d loop=%d\n", numThread, loop);
+
+    const int sizes[][2] = {{1000, 100}, {5000, 1000}, {10000, 100}, {10000, 5000}, {50000, 100}, {50000, 1000}};
+    for (auto& s : sizes) {
+        char name[64];
+        snprintf(name, sizeof(name), "boxes=%d max=%d", s[0], s[1]);
+        displayStats(name, runNMS(s[0], s[1], 0.5f, loop));
+    }
+    return 0;
+}
@@ -65,7 +65,7 @@ void Executor::Profiler::add(int opType, float timeInMs) {
 }
 
 void Executor::setGlobalExecutorConfig(MNNForwardType type, const BackendConfig& config, int numberThread) {
-    std::lock_guard<std::mutex> _l(mMutex);
+    std::lock_guard<std::mutex> _l(*mMutex);
     auto creator = MNNGetExtraBackendCreator(type);
     if (nullptr == creator) {
         MNN_ERROR("Error to find creator of %d\n", type);
@@ -84,7 +84,7 @@ void Executor::_resetCache() {
 }
 
 void Executor::gc(GCFlag flag) {
-    std::lock_guard<std::mutex> _l(mMutex);
+    std::lock_guard<std::mutex> _l(*mMutex);
     _resetCache();
     if (FULL == flag) {
         mBackend->onClearBuffer();
@@ -92,6 +92,7 @@ void Executor::gc(GCFlag flag) {
     }
 }
 Executor::Executor(std::shared_ptr<Backend> backend) {
+    mMutex.reset(new std::mutex);
     mBackend = backend;
     if (mBackend->type() == MNN_FORWARD_CPU) {
         mBackupBackend = mBackend;
@@ -163,35 +164,82 @@ std::shared_ptr<Executor> Executor::getGlobalExecutor() {
     return gExecutor;
 }
 
+std::shared_ptr<Executor> Executor::newExecutor(MNNForwardType type, const BackendConfig& config, int numberThread) {
+    // Init the size computers and the global executor
+    getGlobalExecutor();
+    auto creator = MNNGetExtraBackendCreator(type);
+    if (nullptr == creator) {
+        MNN_ERROR("Error to find creator of %d\n", type);
+        return nullptr;
+    }
+    Backend::Info info;
+    info.type = type;
+    info.numThread = numberThread;
+    BackendConfig cfg = config;
+    info.user = &cfg;
+    std::shared_ptr<Backend> bn(creator->onCreate(info));
+    return std::shared_ptr<Executor>(new Executor(bn));
+}
+
+// Executors of scopes in current thread, the last one is the innermost
+static std::vector<std::shared_ptr<Executor>>& _scopeExecutors() {
+    static thread_local std::vector<std::shared_ptr<Executor>> gExecutors;
+    return gExecutors;
+}
+ExecutorScope::ExecutorScope(std::shared_ptr<Executor> executor) {
+    MNN_ASSERT(nullptr != executor);
+    _scopeExecutors().emplace_back(std::move(executor));
+}
+ExecutorScope::~ExecutorScope() {
+    _scopeExecutors().pop_back();
+}
+std::shared_ptr<Executor> ExecutorScope::Current() {
+    auto& executors = _scopeExecutors();
+    if (executors.empty()) {
+        return Executor::getGlobalExecutor();
+    }
+    return executors.back();
+}
+
+// The tensors to compute shape, one group for each thread so computeInfo don't need lock
+struct InfoStack {
+    std::vector<std::shared_ptr<Tensor>> stack;
+    std::vector<Tensor*> inputs;
+    std::vector<Tensor*> outputs;
+};
+
 ErrorCode Executor::computeInfo(Expr* expr) {
     MNN_ASSERT(nullptr != expr);
     MNN_ASSERT(nullptr != expr->get());
     if (expr->get()->type() == OpType_Extra) {
         return NOT_SUPPORT;
     }
-    std::lock_guard<std::mutex> _l(mMutex);
-    mStackInputs.resize(expr->inputs().size());
-    mStackOutputs.resize(expr->outputSize());
-    if (mStack.size() < mStackInputs.size() + mStackOutputs.size()) {
-        int origin = (int)mStack.size();
-        int destSize = (int)(mStackInputs.size() + mStackOutputs.size());
+    static thread_local InfoStack gInfoStack;
+    auto& stack = gInfoStack.stack;
+    auto& stackInputs = gInfoStack.inputs;
+    auto& stackOutputs = gInfoStack.outputs;
+    stackInputs.resize(expr->inputs().size());
+    stackOutputs.resize(expr->outputSize());
+    if (stack.size() < stackInputs.size() + stackOutputs.size()) {
+        int origin = (int)stack.size();
+        int destSize = (int)(stackInputs.size() + stackOutputs.size());
         for (int i=origin; i<destSize; ++i) {
-            mStack.emplace_back(std::shared_ptr<Tensor>(new Tensor));
+            stack.emplace_back(std::shared_ptr<Tensor>(new Tensor));
         }
     }
-    for (int i=0; i<mStackInputs.size(); ++i) {
-        mStackInputs[i] = mStack[i].get();
+    for (int i=0; i<stackInputs.size(); ++i) {
+        stackInputs[i] = stack[i].get();
     }
-    for (int i=0; i<mStackOutputs.size(); ++i) {
-        mStackOutputs[i] = mStack[i+(int)mStackInputs.size()].get();
+    for (int i=0; i<stackOutputs.size(); ++i) {
+        stackOutputs[i] = stack[i+(int)stackInputs.size()].get();
     }
     auto op = expr->get();
     for (int i = 0; i < expr->inputs().size(); ++i) {
         auto inputExpr = expr->inputs()[i]->expr();
-        Utils::copyInfoToTensor(mStackInputs[i], inputExpr.first->outputInfo(inputExpr.second));
+        Utils::copyInfoToTensor(stackInputs[i], inputExpr.first->outputInfo(inputExpr.second));
     }
 
-    bool res = SizeComputer::computeOutputSize(op, mStackInputs, mStackOutputs);
+    bool res = SizeComputer::computeOutputSize(op, stackInputs, stackOutputs);
     if (!res) {
         // Compute Error
 #ifdef MNN_EXPRESS_ERROR_REPORT
@@ -203,8 +251,8 @@ ErrorCode Executor::computeInfo(Expr* expr) {
 #endif
         return COMPUTE_SIZE_ERROR;
     }
-    for (int i = 0; i < mStackOutputs.size(); ++i) {
-        auto tensor = mStackOutputs[i];
+    for (int i = 0; i < stackOutputs.size(); ++i) {
+        auto tensor = stackOutputs[i];
 #ifdef MNN_EXPRESS_ERROR_REPORT
         bool hasNoneOutput = false;
         // MNN_PRINT("Output(%d): [", i);
@@ -249,14 +297,14 @@ void Executor::ComputeCache::setShapeDirty(int offset, Variable::Info* info) {
 }
 
 void Executor::ComputeCache::_setShapeDirty() {
-    mShapeDirty = true;
+    mShapeDirty.store(true, std::memory_order_release);
 }
 void Executor::ComputeCache::setContentReady() {
-    mContentDirty = false;
+    mContentDirty.store(false, std::memory_order_release);
 }
 
 void Executor::ComputeCache::setContentDirty() {
-    mContentDirty = true;
+    mContentDirty.store(true, std::memory_order_release);
 }
 
 void Executor::ComputeCache::TensorContent::reset() {
@@ -277,7 +325,7 @@ public:
     InputCache() {}
     ~InputCache() {}
     virtual ErrorCode compute() override {
-        if (mContentDirty) {
+        if (mContentDirty.load(std::memory_order_acquire)) {
             return INPUT_DATA_ERROR;
         }
         return NO_ERROR;
@@ -301,6 +349,8 @@ public:
         if (tensor->host<void>() != nullptr || !host) {
             return tensor;
         }
+        // The host copies are shared by the threads reading the outputs
+        std::lock_guard<std::mutex> _l(*mMutex);
         auto iter = mCopyOutputs.find(tensor);
         if (iter == mCopyOutputs.end()) {
             // First get tensor, create and copy
@@ -333,6 +383,10 @@ private:
     std::map<Tensor*, Tensor*> mCopyOutputs;
     std::shared_ptr<Backend> mBackend;
     std::shared_ptr<Backend> mBackupBackend;
+    // The mutex of executor who owns the backends
+    std::shared_ptr<std::mutex> mMutex;
+    // The costs are charged to the owner, whichever thread computes the cache
+    std::shared_ptr<Executor::Profiler> mProfiler;
     friend class Executor;
 };
 
@@ -358,6 +412,17 @@ PipelineCache::~PipelineCache() {
     }
 }
 ErrorCode PipelineCache::compute() {
+    if (!mShapeDirty.load(std::memory_order_acquire) && !mContentDirty.load(std::memory_order_acquire)) {
+        return NO_ERROR;
+    }
+    // The inputs may belong to other executors, compute them before taking the lock of this one
+    for (auto c : mInputs) {
+        auto code = c->compute();
+        if (NO_ERROR != code) {
+            return code;
+        }
+    }
+    std::lock_guard<std::mutex> _l(*mMutex);
     if (mShapeDirty) {
         auto code = resize();
         if (NO_ERROR != code) {
@@ -367,12 +432,6 @@ ErrorCode PipelineCache::compute() {
     if (!mContentDirty) {
         return NO_ERROR;
     }
-    for (auto c : mInputs) {
-        auto code = c->compute();
-        if (NO_ERROR != code) {
-            return code;
-        }
-    }
     mBackend->onExecuteBegin();
     //mBackupBackend->onExecuteBegin();
     for (int i=0; i<mUnits.size(); ++i) {
@@ -406,7 +465,7 @@ ErrorCode PipelineCache::compute() {
 
 #ifdef MNN_EXPR_ENABLE_PROFILER
         float costTime = (float)autoTime.durationInUs() / (float)1000;
-        Executor::getGlobalExecutor()->addOpCostTime((int)mUnits[i]->op->type(), costTime);
+        mProfiler->add((int)mUnits[i]->op->type(), costTime);
 #endif
     }
     mBackend->onExecuteEnd();
@@ -414,7 +473,7 @@ ErrorCode PipelineCache::compute() {
     for (auto iter : mCopyOutputs) {
         iter.first->copyToHostTensor(iter.second);
     }
-    mContentDirty = false;
+    mContentDirty.store(false, std::memory_order_release);
     return NO_ERROR;
 }
 
@@ -431,12 +490,7 @@ ErrorCode PipelineCache::resize() {
     if (!mShapeDirty) {
         return NO_ERROR;
     }
-    for (auto c : mInputs) {
-        auto code = c->resize();
-        if (NO_ERROR != code) {
-            return code;
-        }
-    }
+    // The inputs have been resized by their compute under their own locks
     for (auto& t : mTensors) {
         t.reset();
     }
@@ -493,7 +547,7 @@ ErrorCode PipelineCache::resize() {
 
 #ifdef MNN_EXPR_ENABLE_PROFILER
             float costTime = (float)autoTime.durationInUs() / (float)1000;
-            Executor::getGlobalExecutor()->addOpCostTime((int)iter.op->type(), costTime);
+            mProfiler->add((int)iter.op->type(), costTime);
 #endif
         }
 #ifdef MNN_EXPR_ENABLE_PROFILER
@@ -521,7 +575,7 @@ ErrorCode PipelineCache::resize() {
         }
 #ifdef MNN_EXPR_ENABLE_PROFILER
         float costTime = (float)autoTime.durationInUs() / (float)1000;
-        Executor::getGlobalExecutor()->addOpCostTime((int)iter.op->type(), costTime);
+        mProfiler->add((int)iter.op->type(), costTime);
 #endif
 
 #ifdef MNN_EXPRESS_OPEN_MEMORY_REUSE
@@ -639,6 +693,8 @@ void Executor::_create(const std::vector<EXPRP>& outputs, std::set<std::shared_p
     }
     packedCache->mTensors = std::move(tensors);
     packedCache->mBackupBackend = mBackupBackend;
+    packedCache->mMutex = mMutex;
+    packedCache->mProfiler = mProfiler;
     
     // Backup Tensor Refcount
     for (auto& t : packedCache->mTensors) {
@@ -724,7 +780,7 @@ void Executor::_visit(EXPRP expr, std::set<std::shared_ptr<Executor::ComputeCach
 }
 
 void Executor::makeCache(const std::vector<EXPRP>& expr, bool forceCPU) {
-    std::lock_guard<std::mutex> _l(mMutex);
+    std::lock_guard<std::mutex> _l(*mMutex);
     //FUNC_PRINT(mCaches.size());
     std::set<std::shared_ptr<Executor::ComputeCache>> inputCaches;
     std::vector<ComputeCache::TensorContent> tensors;
@@ -740,7 +796,7 @@ void Executor::addOpCostTime(int op, float costTime) {
 }
 
 ErrorCode Executor::runCache(std::shared_ptr<ComputeCache> cache) {
-    std::lock_guard<std::mutex> _l(mMutex);
+    // The cache takes the lock of its executor
     return cache->compute();
 }
 void Executor::resetProfile() {
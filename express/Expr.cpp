@@ -117,6 +117,16 @@ void Expr::_addLinkForInputs(EXPRP expr) {
         }
     }
 }
+// Dims of known shape, a zero dim makes an empty variable
+static bool _validDims(const INTS& dims) {
+    for (auto d : dims) {
+        if (d < 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
 EXPRP Expr::create(Variable::Info&& info) {
     EXPRP expr(new Expr(1));
     expr->mOp = nullptr;
@@ -130,7 +140,7 @@ EXPRP Expr::create(Variable::Info&& info) {
         expr->mInside->mInfoDirty = false;
     } else {
         expr->mInside->mOutputInfos[0].ptr = nullptr;
-        expr->mInside->mInfoDirty = true;
+        expr->mInside->mInfoDirty = !_validDims(dstInfo.dim);
     }
     if (nullptr == originPtr) {
         expr->mType = VARP::INPUT;
@@ -148,7 +158,7 @@ EXPRP Expr::create(std::pair<std::shared_ptr<char>, int> extra, std::vector<VARP
     expr->mOpBufferSize = extra.second;
     expr->mInputs   = std::move(inputs);
     expr->mInside->mInputInfos.resize(expr->mInputs.size());
-    expr->mInside->mReq = Executor::getGlobalExecutor()->getRequirement(expr.get());
+    expr->mInside->mReq = ExecutorScope::Current()->getRequirement(expr.get());
     _addLinkForInputs(expr);
     return expr;
 }
@@ -213,7 +223,7 @@ bool Expr::requireInfo() {
         return false;
     }
     if (nullptr == mOp) {
-        return mInside->mOutputInfos[0].size > 0;
+        return mInside->mOutputInfos[0].size > 0 || _validDims(mInside->mOutputInfos[0].dim);
     }
     bool ready     = true;
     for (int i = 0; i < mInputs.size(); ++i) {
@@ -241,7 +251,7 @@ bool Expr::requireInfo() {
         return false;
     }
     //MNN_PRINT("Info %s, %p Start\n", mName.c_str(), this);
-    auto res   = Executor::getGlobalExecutor()->computeInfo(this);
+    auto res   = ExecutorScope::Current()->computeInfo(this);
     //MNN_PRINT("Info Compute %s\n", mName.c_str());
 
     if (NO_ERROR == res) {
@@ -362,7 +372,7 @@ bool Variable::input(VARP src) {
     }
 
     if (!mFrom->mInside->mCache) {
-        Executor::getGlobalExecutor()->makeCache({mFrom}, false);
+        ExecutorScope::Current()->makeCache({mFrom}, false);
     }
     if (needChange) {
         bool needAlloc = info->size * info->type.bytes() > mFrom->mInside->mOutputInfos[0].size * mFrom->mInside->mOutputInfos[0].type.bytes();
@@ -490,13 +500,13 @@ void* Variable::readInternal(bool forShape) {
     }
     auto cache = mFrom->inside()->mCache;
     if (nullptr == cache) {
-        Executor::getGlobalExecutor()->makeCache({mFrom}, forShape);
+        ExecutorScope::Current()->makeCache({mFrom}, forShape);
         cache = mFrom->inside()->mCache;
     }
     if (nullptr == cache) {
         return nullptr;
     }
-    if (NO_ERROR != Executor::getGlobalExecutor()->runCache(cache)) {
+    if (NO_ERROR != ExecutorScope::Current()->runCache(cache)) {
         return nullptr;
     }
     cache->syncOutput(mFrom->mInside->mCacheOffset + mFromIndex, mFrom->outputInfo(mFromIndex));
@@ -535,7 +545,7 @@ void Variable::prepareCompute(const std::vector<VARP>& vars, bool forceCpu) {
             exprs.emplace_back(v->expr().first);
         }
     }
-    Executor::getGlobalExecutor()->makeCache(std::move(exprs), forceCpu);
+    ExecutorScope::Current()->makeCache(std::move(exprs), forceCpu);
 }
 
 void* Variable::writeInternal(bool inform) {
@@ -547,7 +557,7 @@ void* Variable::writeInternal(bool inform) {
     }
     auto cache = mFrom->mInside->mCache;
     if (nullptr == cache) {
-        Executor::getGlobalExecutor()->makeCache({mFrom});
+        ExecutorScope::Current()->makeCache({mFrom});
         cache = mFrom->mInside->mCache;
     }
     if (nullptr == cache) {
@@ -727,10 +737,19 @@ void Variable::save(const std::vector<VARP>& vars, NetT* dest) {
                 auto blob        = new BlobT;
                 blob->dataFormat = (MNN_DATA_FORMAT)Utils::convertFormat(info.order);
                 blob->dims       = info.dim;
-                if (info.type.code == halide_type_float) {
+                if (info.type.code == halide_type_float && info.type.bits == 16) {
+                    // Compact tables, such as half embedding
+                    blob->dataType = DataType_DT_HALF;
+                    blob->uint8s.resize(info.size * info.type.bytes());
+                    ::memcpy(blob->uint8s.data(), info.ptr, info.size * info.type.bytes());
+                } else if (info.type.code == halide_type_float) {
                     blob->dataType = DataType_DT_FLOAT;
                     blob->float32s.resize(info.size);
                     ::memcpy(blob->float32s.data(), info.ptr, info.size * sizeof(float));
+                } else if (info.type.code == halide_type_int && info.type.bits == 8) {
+                    blob->dataType = DataType_DT_INT8;
+                    blob->int8s.resize(info.size);
+                    ::memcpy(blob->int8s.data(), info.ptr, info.size * sizeof(int8_t));
                 } else if (info.type.code == halide_type_int) {
                     blob->dataType = DataType_DT_INT32;
                     blob->int32s.resize(info.size);
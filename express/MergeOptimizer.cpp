@@ -7,12 +7,127 @@
 //
 
 #include "MergeOptimizer.hpp"
+#include <math.h>
 #include <map>
+#include <set>
+#include <MNN/expr/ExprCreator.hpp>
+#include "MNN_generated.h"
 #include "Utils.hpp"
+#include "core/SizeComputer.hpp"
+
+// Constants larger than this are only folded if they are not larger than the inputs, avoid expanding broadcast
+#define MAX_EXPAND_FOLD_SIZE (1 << 20)
 
 namespace MNN {
 namespace Express {
 
+// Expr::replace takes the name of new expr, the name of graph should keep unchanged
+static void _replaceKeepName(EXPRP oldExpr, EXPRP newExpr) {
+    auto name = oldExpr->name();
+    std::vector<std::string> outputNames(oldExpr->outputSize());
+    for (int i = 0; i < outputNames.size(); ++i) {
+        outputNames[i] = oldExpr->outputName(i);
+    }
+    Expr::replace(oldExpr, newExpr);
+    oldExpr->setName(name);
+    for (int i = 0; i < outputNames.size(); ++i) {
+        Variable::create(oldExpr, i)->setName(outputNames[i]);
+    }
+}
+
+static bool _canOptimize(const Op* op) {
+    // The result of extra op may not be decided by inputs and parameter
+    return OpType_Extra != op->type();
+}
+
+// Same as the postconvert passes of converter: MergeBNToConvolution, MergeScaleToConvolution, MergeReluToConvolution
+static bool _mergeToConvolution(const Op* inplaceOp, OpT* convolutionOp) {
+    auto conv2D = convolutionOp->main.AsConvolution2D();
+    if (nullptr == conv2D || nullptr == conv2D->common.get() || nullptr != conv2D->quanParameter.get()) {
+        return false;
+    }
+    auto common = conv2D->common.get();
+    if (common->relu || common->relu6) {
+        return false;
+    }
+    switch (inplaceOp->type()) {
+        case OpType_ReLU: {
+            auto relu = inplaceOp->main_as_Relu();
+            if (nullptr != relu && 0.0f != relu->slope()) {
+                return false;
+            }
+            common->relu = true;
+            return true;
+        }
+        case OpType_ReLU6: {
+            auto relu6 = inplaceOp->main_as_Relu6();
+            if (nullptr != relu6 && (0.0f != relu6->minValue() || 6.0f != relu6->maxValue())) {
+                return false;
+            }
+            common->relu6 = true;
+            return true;
+        }
+        default:
+            break;
+    }
+
+    const int outputCount = common->outputCount;
+    if (outputCount <= 0 || conv2D->weight.empty() || conv2D->weight.size() % outputCount != 0) {
+        return false;
+    }
+    std::vector<float> alpha(outputCount);
+    std::vector<float> bias(outputCount, 0.0f);
+    if (OpType_BatchNorm == inplaceOp->type()) {
+        auto l = inplaceOp->main_as_BatchNorm();
+        if (nullptr == l || nullptr == l->slopeData() || nullptr == l->meanData() || nullptr == l->varData() ||
+            nullptr == l->biasData()) {
+            return false;
+        }
+        if (l->slopeData()->size() != outputCount || l->meanData()->size() != outputCount ||
+            l->varData()->size() != outputCount || l->biasData()->size() != outputCount) {
+            return false;
+        }
+        const float eps = l->epsilon();
+        for (int i = 0; i < outputCount; ++i) {
+            float sqrt_var = sqrtf(l->varData()->data()[i] + eps);
+            bias[i]        = l->biasData()->data()[i] - l->slopeData()->data()[i] * l->meanData()->data()[i] / sqrt_var;
+            alpha[i]       = l->slopeData()->data()[i] / sqrt_var;
+        }
+    } else if (OpType_Scale == inplaceOp->type()) {
+        auto l = inplaceOp->main_as_Scale();
+        if (nullptr == l || nullptr == l->scaleData() || l->scaleData()->size() != outputCount) {
+            return false;
+        }
+        if (nullptr != l->biasData() && l->biasData()->size() > 0 && l->biasData()->size() != outputCount) {
+            return false;
+        }
+        for (int i = 0; i < outputCount; ++i) {
+            alpha[i] = l->scaleData()->data()[i];
+        }
+        if (nullptr != l->biasData() && l->biasData()->size() > 0) {
+            for (int i = 0; i < outputCount; ++i) {
+                bias[i] = l->biasData()->data()[i];
+            }
+        }
+    } else {
+        return false;
+    }
+    if (conv2D->bias.empty()) {
+        conv2D->bias.resize(outputCount, 0.0f);
+    }
+    for (int i = 0; i < outputCount; ++i) {
+        conv2D->bias[i] = conv2D->bias[i] * alpha[i] + bias[i];
+    }
+    int weightPartSize = (int)conv2D->weight.size() / outputCount;
+    for (int i = 0; i < outputCount; ++i) {
+        float a = alpha[i];
+        for (int j = 0; j < weightPartSize; ++j) {
+            conv2D->weight[i * weightPartSize + j] *= a;
+        }
+    }
+    return true;
+}
+
 MergeOptimizer::MergeOptimizer(MNNForwardType type, int numberThread, BackendConfig* config) {
     if (nullptr != config) {
         mConfig = *config;
@@ -21,14 +136,228 @@ MergeOptimizer::MergeOptimizer(MNNForwardType type, int numberThread, BackendCon
     mNumberThread = numberThread;
 }
 
+std::shared_ptr<Optimizer::Parameters> MergeOptimizer::onGetParameters(const std::vector<VARP>& outputs) {
+    std::shared_ptr<Parameters> parameters(new Parameters(PASS_NUMBER));
+    for (int i = 0; i < PASS_NUMBER; ++i) {
+        parameters->get()[i] = 1.0f;
+    }
+    return parameters;
+}
+
 Optimizer::Cost MergeOptimizer::onMeasure(const std::vector<VARP>& outputs, std::shared_ptr<Parameters> parameters) {
     Cost cost;
     cost.compute = 0.0f;
     cost.memory  = 0.0f;
+    auto order   = Variable::getExecuteOrder(outputs);
+    // Exprs merged by optimizer share the content, count them once
+    std::set<const void*> measured;
+    std::vector<std::shared_ptr<Tensor>> inputTensors;
+    std::vector<std::shared_ptr<Tensor>> outputTensors;
+    for (auto expr : order) {
+        if (measured.find(expr->inside().get()) != measured.end()) {
+            continue;
+        }
+        measured.insert(expr->inside().get());
+        std::vector<Tensor*> inputs(expr->inputs().size());
+        std::vector<Tensor*> outputs(expr->outputSize());
+        if (!expr->requireInfo()) {
+            continue;
+        }
+        for (int i = 0; i < outputs.size(); ++i) {
+            auto info = expr->outputInfo(i);
+            cost.memory += (float)info->size * info->type.bytes() / 1024.0f / 1024.0f;
+        }
+        auto op = expr->get();
+        if (nullptr == op) {
+            continue;
+        }
+        cost.memory += (float)expr->extra().second / 1024.0f / 1024.0f;
+        while (inputTensors.size() < inputs.size()) {
+            inputTensors.emplace_back(new Tensor);
+        }
+        while (outputTensors.size() < outputs.size()) {
+            outputTensors.emplace_back(new Tensor);
+        }
+        for (int i = 0; i < inputs.size(); ++i) {
+            auto inputExpr = expr->inputs()[i]->expr();
+            inputs[i]      = inputTensors[i].get();
+            Utils::copyInfoToTensor(inputs[i], inputExpr.first->outputInfo(inputExpr.second));
+        }
+        bool hasScalar = false;
+        for (int i = 0; i < outputs.size(); ++i) {
+            outputs[i] = outputTensors[i].get();
+            Utils::copyInfoToTensor(outputs[i], expr->outputInfo(i));
+            hasScalar  = hasScalar || outputs[i]->dimensions() == 0;
+        }
+        if (outputs.empty()) {
+            continue;
+        }
+        if (hasScalar) {
+            // The default estimator divides by batch, scalar has no batch
+            for (auto output : outputs) {
+                cost.compute += (float)output->elementSize() / 1024.0f / 1024.0f;
+            }
+            continue;
+        }
+        cost.compute += SizeComputer::computeFlops(op, inputs, outputs);
+    }
     return cost;
 }
+
+bool MergeOptimizer::_foldConstant(const std::vector<VARP>& outputs) {
+    bool changed = false;
+    auto order   = Variable::getExecuteOrder(outputs);
+    for (auto expr : order) {
+        auto op = expr->get();
+        if (nullptr == op || !_canOptimize(op) || expr->inputs().empty() || expr->outputSize() != 1) {
+            continue;
+        }
+        // Expr of order is computed before its outputs, so the chain of constant is folded at once
+        bool allConstant = true;
+        int inputSize    = 0;
+        for (auto input : expr->inputs()) {
+            auto inputExpr = input->expr().first;
+            if (nullptr != inputExpr->get() || VARP::CONSTANT != inputExpr->inputType()) {
+                allConstant = false;
+                break;
+            }
+            auto info = input->getInfo();
+            if (nullptr == info) {
+                allConstant = false;
+                break;
+            }
+            inputSize += info->size;
+        }
+        if (!allConstant) {
+            continue;
+        }
+        auto output = Variable::create(expr);
+        auto info   = output->getInfo();
+        if (nullptr == info || NC4HW4 == info->order) {
+            continue;
+        }
+        if (info->size > inputSize && info->size > MAX_EXPAND_FOLD_SIZE) {
+            continue;
+        }
+        auto ptr = output->readMap<void>();
+        if (nullptr == ptr) {
+            continue;
+        }
+        info          = output->getInfo();
+        auto constVar = _Const(ptr, info->dim, info->order, info->type);
+        _replaceKeepName(expr, constVar->expr().first);
+        changed = true;
+    }
+    return changed;
+}
+
+bool MergeOptimizer::_foldConvolution(const std::vector<VARP>& outputs) {
+    std::set<const Expr*> outputExprs;
+    for (auto output : outputs) {
+        outputExprs.insert(output->expr().first.get());
+    }
+    bool changed = false;
+    auto order   = Variable::getExecuteOrder(outputs);
+    for (auto expr : order) {
+        auto op = expr->get();
+        if (nullptr == op || expr->inputs().size() != 1) {
+            continue;
+        }
+        auto type = op->type();
+        if (OpType_BatchNorm != type && OpType_Scale != type && OpType_ReLU != type && OpType_ReLU6 != type) {
+            continue;
+        }
+        auto convExpr = expr->inputs()[0]->expr().first;
+        auto convOp   = convExpr->get();
+        if (nullptr == convOp ||
+            (OpType_Convolution != convOp->type() && OpType_ConvolutionDepthwise != convOp->type())) {
+            continue;
+        }
+        // Weight should be in the op, and the output of convolution is only used by expr
+        if (convExpr->inputs().size() != 1 || convExpr->outputSize() != 1 ||
+            outputExprs.find(convExpr.get()) != outputExprs.end()) {
+            continue;
+        }
+        int consumers = 0;
+        for (auto& weak : convExpr->outputs()) {
+            if (nullptr != weak.lock()) {
+                consumers++;
+            }
+        }
+        if (1 != consumers) {
+            continue;
+        }
+        std::unique_ptr<OpT> newOp(convOp->UnPack());
+        if (!_mergeToConvolution(op, newOp.get())) {
+            continue;
+        }
+        auto newConv = Expr::create(newOp.get(), convExpr->inputs());
+        _replaceKeepName(expr, newConv);
+        changed = true;
+    }
+    return changed;
+}
+
+bool MergeOptimizer::_eliminateCommon(const std::vector<VARP>& outputs) {
+    bool changed = false;
+    auto order   = Variable::getExecuteOrder(outputs);
+    // The replaced expr -> the expr whose content it shares, so that the outputs of them can be merged as well
+    std::map<const Expr*, const Expr*> represents;
+    std::map<std::string, EXPRP> exists;
+    for (auto expr : order) {
+        auto op = expr->get();
+        if (nullptr == op || !_canOptimize(op)) {
+            continue;
+        }
+        // The key is the op without name, and the inputs
+        std::unique_ptr<OpT> opT(op->UnPack());
+        opT->name.clear();
+        flatbuffers::FlatBufferBuilder builder;
+        builder.Finish(Op::Pack(builder, opT.get()));
+        std::string key((const char*)builder.GetBufferPointer(), builder.GetSize());
+        for (auto input : expr->inputs()) {
+            auto inputExpr    = input->expr();
+            const Expr* source = inputExpr.first.get();
+            auto iter          = represents.find(source);
+            if (iter != represents.end()) {
+                source = iter->second;
+            }
+            key.append((const char*)&source, sizeof(const Expr*));
+            key.append((const char*)&inputExpr.second, sizeof(int));
+        }
+        int outputSize = expr->outputSize();
+        key.append((const char*)&outputSize, sizeof(int));
+        auto iter = exists.find(key);
+        if (iter == exists.end()) {
+            exists.insert(std::make_pair(key, expr));
+            continue;
+        }
+        represents.insert(std::make_pair(expr.get(), iter->second.get()));
+        _replaceKeepName(expr, iter->second);
+        changed = true;
+    }
+    return changed;
+}
+
 bool MergeOptimizer::onExecute(const std::vector<VARP>& outputs, std::shared_ptr<Parameters> parameters) {
-    // Deceperate
+    bool enable[PASS_NUMBER];
+    for (int i = 0; i < PASS_NUMBER; ++i) {
+        enable[i] = true;
+    }
+    if (nullptr != parameters) {
+        for (int i = 0; i < PASS_NUMBER && i < parameters->size(); ++i) {
+            enable[i] = 0.0f != parameters->get()[i];
+        }
+    }
+    if (enable[CONSTANT_FOLD]) {
+        _foldConstant(outputs);
+    }
+    if (enable[CONVOLUTION_FOLD]) {
+        _foldConvolution(outputs);
+    }
+    if (enable[ELIMINATE_COMMON]) {
+        _eliminateCommon(outputs);
+    }
     return true;
 }
 } // namespace Express
@@ -14,14 +14,31 @@ namespace MNN {
 namespace Express {
 class MergeOptimizer : public Optimizer {
 public:
+    // Each parameter enables a pass when it is not zero, the passes run in this order
+    enum Pass {
+        CONSTANT_FOLD = 0,
+        CONVOLUTION_FOLD,
+        ELIMINATE_COMMON,
+        PASS_NUMBER
+    };
     virtual ~MergeOptimizer() = default;
     MergeOptimizer(MNNForwardType type, int numberThread, BackendConfig* config);
+    virtual std::shared_ptr<Parameters> onGetParameters(const std::vector<VARP>& outputs) override;
+
+    // Compute of ops from their size computers and memory of outputs and weights
     virtual Cost onMeasure(const std::vector<VARP>& outputs, std::shared_ptr<Parameters> parameters = nullptr)  override;
-    
+
     //Modify the output directly, the parameters must be the same as onGetParameters
     virtual bool onExecute(const std::vector<VARP>& outputs, std::shared_ptr<Parameters> parameters = nullptr) override;
 
 private:
+    // Replace ops whose inputs are all constant by the computed constant
+    static bool _foldConstant(const std::vector<VARP>& outputs);
+    // Merge BatchNorm / Scale / ReLU / ReLU6 after convolution into the convolution
+    static bool _foldConvolution(const std::vector<VARP>& outputs);
+    // Share the content of ops with the same parameter and inputs
+    static bool _eliminateCommon(const std::vector<VARP>& outputs);
+
     BackendConfig mConfig;
     MNNForwardType mType;
     int mNumberThread;
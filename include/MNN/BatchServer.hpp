@@ -0,0 +1,84 @@
+//
+//  BatchServer.hpp
+//  MNN
+//
+//  Created by MNN on 2020/04/30.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#ifndef BatchServer_hpp
+#define BatchServer_hpp
+
+#include <future>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <MNN/Interpreter.hpp>
+
+namespace MNN {
+
+/**
+ dynamic batching on top of interpreter. requests of single sample submitted from any threads are coalesced into a
+ batch until the batch is full or the first request has waited for max wait time, then the batch runs in one
+ runSession and outputs are scattered back to each request. the first dimension of all inputs and outputs is batch.
+ sessions are prepared once for every batch size and kept, sessions of one worker share weights.
+ */
+class MNN_PUBLIC BatchServer {
+public:
+    struct Config {
+        /** max number of samples in one batch */
+        int maxBatch = 8;
+        /** max time in microseconds that a request waits for other requests */
+        int maxWaitUs = 1000;
+        /** number of batches running at the same time, each worker owns its sessions */
+        int numWorker = 1;
+        /** config of sessions */
+        ScheduleConfig schedule;
+    };
+
+    /** float data of tensors in one sample keyed by tensor name, in NCHW or NHWC layout of the model */
+    typedef std::map<std::string, std::vector<float>> Tensors;
+    struct Result {
+        ErrorCode code = NO_ERROR;
+        Tensors outputs;
+    };
+
+    /**
+     * @brief create server and start workers.
+     * @param net       interpreter of model, should not be used by others while server is running.
+     * @param config    batching config.
+     * @return created server, NULL if config is invalid.
+     */
+    static BatchServer* create(std::shared_ptr<Interpreter> net, const Config& config);
+    /**
+     * @brief stop workers after running requests already submitted.
+     */
+    ~BatchServer();
+
+    /**
+     * @brief submit request of one sample, thread-safe.
+     * @param inputs    data of all inputs.
+     * @return future of outputs of all outputs.
+     */
+    std::future<Result> submit(Tensors&& inputs);
+
+    /**
+     * @brief get statistics of server.
+     * @return first: number of batches run, second: number of requests run.
+     */
+    std::pair<int64_t, int64_t> getStats() const;
+
+private:
+    BatchServer(std::shared_ptr<Interpreter> net, const Config& config);
+    struct Worker;
+    struct Request;
+    struct Queue;
+    std::shared_ptr<Interpreter> mNet;
+    Config mConfig;
+    std::shared_ptr<Queue> mQueue;
+    std::vector<std::shared_ptr<Worker>> mWorkers;
+};
+} // namespace MNN
+
+#endif /* BatchServer_hpp */
@@ -91,6 +91,12 @@ public:
     }
     void setMatrix(const Matrix& matrix);
 
+    /**
+     * @brief set number of threads converting images, the rows of destination are split among them. 1 by default.
+     * @param numThread number of threads.
+     */
+    void setThreadNumber(int numThread);
+
     /**
      * @brief convert source data to given tensor.
      * @param source    source data.
@@ -102,6 +108,19 @@ public:
      */
     ErrorCode convert(const uint8_t* source, int iw, int ih, int stride, Tensor* dest);
 
+    /**
+     * @brief convert batch of source images to given tensor, the images are converted in parallel.
+     * @param sources   source data of images, no more than batch of dest.
+     * @param iw        source width.
+     * @param ih        source height.
+     * @param stride    number of elements per row. eg: 100 width RGB contains at least 300 elements.
+     * @param matrixs   transform of each image, such as crops. if empty, use the matrix of process for all.
+     * @param dest      given tensor, NC4HW4 tensor of session input is written directly.
+     * @return result code.
+     */
+    ErrorCode convert(const std::vector<const uint8_t*>& sources, int iw, int ih, int stride,
+                      const std::vector<Matrix>& matrixs, Tensor* dest);
+
     /**
      * @brief convert source data to given tensor.
      * @param source    source data.
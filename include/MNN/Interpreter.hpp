@@ -63,6 +63,19 @@ struct ScheduleConfig {
     BackendConfig* backendConfig = nullptr;
 };
 
+/** round a dimension of input up to bucket sizes, so that a few prepared shapes serve inputs of any size */
+struct ShapeBucket {
+    /** input name, empty for the first input */
+    std::string input;
+    /** dimension of input to pad */
+    int axis = 0;
+    /** bucket sizes in ascending order. input is padded with zero to the first size not less than it, sizes larger
+     than the last bucket are not padded */
+    std::vector<int> sizes;
+    /** output names and their dimension to crop, cropped size = output size * real input size / padded input size */
+    std::vector<std::pair<std::string, int>> outputs;
+};
+
 class Session;
 struct Content;
 class Tensor;
@@ -99,6 +112,15 @@ public:
      * @return created net if success, NULL otherwise.
      */
     static Interpreter* createFromFile(const char* file);
+    /**
+     * @brief create net from file by mapping it read-only instead of reading it into memory.
+     *        processes loading the same file share its pages through the page cache.
+     *        falls back to createFromFile if the file can't be mapped.
+     * @param file  given file.
+     * @return created net if success, NULL otherwise.
+     * @warning updateSessionToModel is not supported on mapped net.
+     */
+    static Interpreter* createFromMappedFile(const char* file);
     /**
      * @brief create net from buffer.
      * @param buffer    given data buffer.
@@ -123,6 +145,17 @@ public:
      */
     Session* createMultiPathSession(const std::vector<ScheduleConfig>& configs);
 
+    /**
+     * @brief create execution context of given session. the context shares constant resources (such as transformed
+     *        weights) of the session's executions, and owns only its input / output tensors and activation memory.
+     *        different contexts of one session can run in different threads at the same time.
+     *        created context is a session managed in net, use getSessionInput / runSession / releaseSession on it.
+     * @param session   given session, should be resized.
+     * @return created context if success, NULL otherwise.
+     * @warning create, resize or release sessions of one net must not be called concurrently.
+     */
+    Session* createSessionContext(const Session* session);
+
     /**
      * @brief release session.
      * @param session   given session.
@@ -137,9 +170,89 @@ public:
      */
     void resizeSession(Session* session);
 
+    /**
+     * @brief plan activation memory of session offline. when enabled, resize gathers lifetime of every dynamic
+     *        buffer and assigns buffers offsets in one arena instead of reusing free list in op order.
+     *        resize costs about twice the time in this mode.
+     * @param session   given session.
+     * @param enable    plan memory or not. take effect on next resizeSession.
+     */
+    void setSessionMemoryPlan(Session* session, bool enable);
+
+    /**
+     * @brief run independent ops of session concurrently on CPU thread pool. ops are grouped into stages by the
+     *        dependency of their tensors, ops of one stage run at the same time and use separated memory.
+     *        useful for models with wide independent branches and small ops.
+     * @param session   given session.
+     * @param enable    run in parallel or not. take effect on next resizeSession.
+     */
+    void setSessionInterOpParallel(Session* session, bool enable);
+
+    /**
+     * @brief get dynamic memory size of session's last resize in bytes.
+     * @param session   given session.
+     * @return first: size allocated by free list reuse, second: size allocated by memory plan, 0 if not planned.
+     */
+    std::pair<size_t, size_t> getSessionMemoryUsage(const Session* session) const;
+
+    /**
+     * @brief keep resize results of recent input shapes for session, including tensor shapes, prepared ops and
+     *        memory. resizing inputs back to a kept shape then costs no more than swapping pointers in resizeSession.
+     *        each kept shape holds its own activation memory, weights are shared. CPU only.
+     * @param session   given session.
+     * @param capacity  max number of input shapes kept, 0 disables the cache.
+     */
+    void setSessionResizeCache(Session* session, int capacity);
+
+    /**
+     * @brief get statistics of session's resize cache.
+     * @param session   given session.
+     * @return first: number of resize served by cache, second: number of resize computed again.
+     */
+    std::pair<int, int> getSessionResizeCacheStats(const Session* session) const;
+
+    /**
+     * @brief pad session inputs up to bucket sizes and crop outputs to the real sizes. input and output tensors of
+     *        buckets are replaced by tensors of real sizes, which should be retrieved again after the call. resize
+     *        of these inputs within current bucket doesn't resize session, use with setSessionResizeCache to keep
+     *        prepared shapes of all buckets. padded values are zero, so a padded mask input masks padded positions.
+     *        only supports inputs and outputs in CPU memory.
+     * @param session   given session.
+     * @param buckets   bucket of each padded input, empty to disable.
+     * @return result code.
+     */
+    ErrorCode setSessionShapeBuckets(Session* session, const std::vector<ShapeBucket>& buckets);
+
+    /**
+     * @brief record timeline of session: spans of resize, run, creating, resizing and running of every op and work
+     *        items of CPU thread pool on every thread, along with dynamic and static memory size of backends.
+     *        enabling takes effect on next resizeSession, which creates executions of ops again to record them.
+     * @param session   given session.
+     * @param enable    record or not, disabling drops recorded events.
+     */
+    void setSessionTrace(Session* session, bool enable);
+
+    /**
+     * @brief get recorded timeline of session in chrome trace event json, load it in chrome://tracing or perfetto.
+     * @param session   given session.
+     * @return json string, empty if trace is not enabled.
+     */
+    std::string getSessionTrace(const Session* session) const;
+
+    /**
+     * @brief benchmark candidate algorithms of convolution and matmul on CPU for their shapes when session is
+     *        resized, and use the fastest instead of the estimated one. winners are kept by op parameters, thread
+     *        number and cpu id in process, and in cache file if given, so later resizes and loads reuse them.
+     *        enabling takes effect on next resizeSession, which creates executions of ops again.
+     * @param session   given session.
+     * @param enable    tune or not.
+     * @param cacheFile file to load winners from and save new winners to, empty to keep them in memory only.
+     */
+    void setSessionTuning(Session* session, bool enable, const std::string& cacheFile = "");
+
     /**
      * @brief call this function if don't need resize or create session any more, it will save a few memory that equal
-     * to the size of model buffer
+     * to the size of model buffer. the mapping of createFromMappedFile is kept until all sessions are released.
      */
     void releaseModel();
 
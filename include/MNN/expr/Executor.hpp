@@ -11,6 +11,7 @@
 #include <MNN/expr/Expr.hpp>
 #include <MNN/Tensor.hpp>
 #include <vector>
+#include <atomic>
 #include <mutex>
 #include <set>
 #include <MNN/MNNForwardType.h>
@@ -45,8 +46,9 @@ public:
         virtual Tensor* getTensor(int index, bool host) = 0;
         void _setShapeDirty();
         friend class Executor;
-        bool mContentDirty = true;
-        bool mShapeDirty = true;
+        // Checked before taking the lock of the cache, the release store of false publishes the computed content
+        std::atomic<bool> mContentDirty{true};
+        std::atomic<bool> mShapeDirty{true};
     };
     struct Requirement {
         std::vector<bool> contentNeedContent;
@@ -65,6 +67,11 @@ public:
     };
     void gc(GCFlag flag = FULL);
     static std::shared_ptr<Executor> getGlobalExecutor();
+    /**
+     * @brief create an executor with its own backend, which can be bound to a thread or model by ExecutorScope.
+     * Expressions of different executors are computed in parallel without sharing any lock.
+     */
+    static std::shared_ptr<Executor> newExecutor(MNNForwardType type, const BackendConfig& config, int numberThread);
     void resetProfile();
     void dumpProfile();
     void addOpCostTime(int op, float costTime);
@@ -80,12 +87,25 @@ private:
     Executor(std::shared_ptr<Backend> backend);
     std::shared_ptr<Backend> mBackend;
     std::shared_ptr<Backend> mBackupBackend;
-    std::mutex mMutex;
-    std::vector<std::shared_ptr<Tensor>> mStack;
-    std::vector<Tensor*> mStackInputs;
-    std::vector<Tensor*> mStackOutputs;
+    // Guard the backends, shared with the caches which compute on them
+    std::shared_ptr<std::mutex> mMutex;
     std::shared_ptr<Profiler> mProfiler;
 };
+
+/**
+ * Bind the executor to current thread until the scope is destroyed, scopes can be nested.
+ * Expressions created and computed in the scope use the executor instead of the global one.
+ */
+class MNN_PUBLIC ExecutorScope {
+public:
+    explicit ExecutorScope(std::shared_ptr<Executor> executor);
+    ~ExecutorScope();
+    // Each scope pops the executor once when destroyed
+    ExecutorScope(const ExecutorScope&) = delete;
+    ExecutorScope& operator=(const ExecutorScope&) = delete;
+    // The executor of the innermost scope of current thread, or the global executor if there is no scope
+    static std::shared_ptr<Executor> Current();
+};
 } // namespace Express
 } // namespace MNN
 #endif
@@ -8,9 +8,12 @@
 
 #include "backend/cpu/CPUArgMax.hpp"
 #include <float.h>
+#include <algorithm>
 #include "backend/cpu/CPUBackend.hpp"
 #include "backend/cpu/compute/CommonOptFunction.h"
+#include "core/Concurrency.h"
 #include "core/TensorUtils.hpp"
+#include "math/Vec4.hpp"
 #include <vector>
 
 namespace MNN {
@@ -99,6 +102,123 @@ ErrorCode CPUArgMax::onResize(const std::vector<Tensor *> &inputs, const std::ve
     return NO_ERROR;
 }
 
+template <bool isMax>
+static inline bool _better(float a, float b) {
+    return isMax ? a > b : a < b;
+}
+
+// The first index of the max (min) value in [begin, end), -1 if no value is larger (smaller) than -FLT_MAX (FLT_MAX)
+template <bool isMax>
+static int _argMaxSpan(const float* values, int begin, int end, float* bestValue) {
+    using Math::Vec4;
+    const float initValue = isMax ? -FLT_MAX : FLT_MAX;
+    Vec4 best(initValue);
+    int i = begin;
+    for (; i + 4 <= end; i += 4) {
+        best = isMax ? Vec4::max(best, Vec4::load(values + i)) : Vec4::min(best, Vec4::load(values + i));
+    }
+    float result = initValue;
+    for (int j = 0; j < 4; ++j) {
+        result = _better<isMax>(best[j], result) ? best[j] : result;
+    }
+    for (; i < end; ++i) {
+        result = _better<isMax>(values[i], result) ? values[i] : result;
+    }
+    *bestValue = result;
+    if (!_better<isMax>(result, initValue)) {
+        return -1;
+    }
+    for (int j = begin; j < end; ++j) {
+        if (values[j] == result) {
+            return j;
+        }
+    }
+    // Only for nan
+    int index = -1;
+    result    = initValue;
+    for (int j = begin; j < end; ++j) {
+        if (_better<isMax>(values[j], result)) {
+            result = values[j];
+            index  = j;
+        }
+    }
+    *bestValue = result;
+    return index;
+}
+
+// Index of max (min) value of [num, dim, keyExtent] along dim, the first one is chosen for the same values
+template <bool isMax>
+static void _argMax(const float* srcOrigin, int* dstOrigin, int num, int dim, int keyExtent, Backend* bn) {
+    auto backend           = [bn]() { return bn; };
+    const int threadNumber = static_cast<CPUBackend*>(bn)->threadNumber();
+    if (keyExtent == 1) {
+        if (num >= threadNumber || dim < 16384) {
+            MNN_CONCURRENCY_BEGIN(tId, threadNumber) {
+                for (int i = (int)tId; i < num; i += threadNumber) {
+                    float value;
+                    auto index   = _argMaxSpan<isMax>(srcOrigin + i * dim, 0, dim, &value);
+                    dstOrigin[i] = index >= 0 ? index : 0;
+                }
+            }
+            MNN_CONCURRENCY_END();
+            return;
+        }
+        // Split the row among threads
+        std::vector<int> indexes(threadNumber);
+        std::vector<float> values(threadNumber);
+        const int segmentSize = UP_DIV(dim, threadNumber);
+        for (int i = 0; i < num; ++i) {
+            auto src = srcOrigin + i * dim;
+            MNN_CONCURRENCY_BEGIN(tId, threadNumber) {
+                auto start   = (int)tId * segmentSize;
+                auto end     = std::min(start + segmentSize, dim);
+                indexes[tId] = start < end ? _argMaxSpan<isMax>(src, start, end, &values[tId]) : -1;
+            }
+            MNN_CONCURRENCY_END();
+            int index = -1;
+            for (int t = 0; t < threadNumber; ++t) {
+                if (indexes[t] >= 0 && (index < 0 || _better<isMax>(values[t], src[index]))) {
+                    index = indexes[t];
+                }
+            }
+            dstOrigin[i] = index >= 0 ? index : 0;
+        }
+        return;
+    }
+    // Compare the rows of dim for contiguous keys, the keys are split if there are not enough num
+    int keyChunks = 1;
+    if (num < threadNumber) {
+        keyChunks = std::min(keyExtent, UP_DIV(threadNumber, num));
+    }
+    const int chunkSize = UP_DIV(keyExtent, keyChunks);
+    keyChunks           = UP_DIV(keyExtent, chunkSize);
+    const int taskSize  = num * keyChunks;
+    MNN_CONCURRENCY_BEGIN(tId, threadNumber) {
+        std::vector<float> bestValues(chunkSize);
+        for (int task = (int)tId; task < taskSize; task += threadNumber) {
+            auto i     = task / keyChunks;
+            auto start = (task % keyChunks) * chunkSize;
+            auto count = std::min(chunkSize, keyExtent - start);
+            auto iptr  = srcOrigin + i * dim * keyExtent + start;
+            auto optr  = dstOrigin + i * keyExtent + start;
+            for (int k = 0; k < count; ++k) {
+                bestValues[k] = isMax ? -FLT_MAX : FLT_MAX;
+                optr[k]       = 0;
+            }
+            for (int j = 0; j < dim; ++j) {
+                auto src = iptr + j * keyExtent;
+                for (int k = 0; k < count; ++k) {
+                    if (_better<isMax>(src[k], bestValues[k])) {
+                        bestValues[k] = src[k];
+                        optr[k]       = j;
+                    }
+                }
+            }
+        }
+    }
+    MNN_CONCURRENCY_END();
+}
+
 ErrorCode CPUArgMax::onExecute(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs) {
     auto input  = inputs[0];
     auto output = outputs[0];
@@ -114,47 +234,10 @@ ErrorCode CPUArgMax::onExecute(const std::vector<Tensor *> &inputs, const std::v
 
     if (mFromNHWC) {
         if (mMode == ARGMAX) {
-            auto srcOrigin = input->host<float>();
-            auto dstOrigin = output->host<int>();
-            for (int i = 0; i < mNum; ++i) {
-                auto iptr = srcOrigin + i * mDim * mKeyExtent;
-                auto optr = dstOrigin + i * mKeyExtent;
-
-                for(int k = 0; k < mKeyExtent; ++k){
-                    int index      = 0;
-                    float maxValue = -FLT_MAX;
-                    for (int j = 0; j < mDim; ++j) {
-                        auto val = iptr[k + j * mKeyExtent];
-                        if (val > maxValue) {
-                            maxValue = val;
-                            index    = j;
-                        }
-                    }
-                    optr[k] = index;
-                }
-            }
+            _argMax<true>(input->host<float>(), output->host<int>(), mNum, mDim, mKeyExtent, backend());
         } else {
-            auto srcOrigin = input->host<float>();
-            auto dstOrigin = output->host<int>();
-            for (int i = 0; i < mNum; ++i) {
-                auto iptr = srcOrigin + i * mDim * mKeyExtent;
-                auto optr = dstOrigin + i * mKeyExtent;
-
-                for(int k = 0; k < mKeyExtent; ++k){
-                    int index      = 0;
-                    float minValue = FLT_MAX;
-                    for (int j = 0; j < mDim; ++j) {
-                        auto val = iptr[k + j * mKeyExtent];
-                        if (val < minValue) {
-                            minValue = val;
-                            index    = j;
-                        }
-                    }
-                    optr[k] = index;
-                }
-            }
+            _argMax<false>(input->host<float>(), output->host<int>(), mNum, mDim, mKeyExtent, backend());
         }
-
     } else {
         MNN_ASSERT(mMode == ARGMAX); // caffe does not have argmin layer
         // Legacy code for CAFFE
@@ -10,8 +10,11 @@
 #include <cmath>
 #include <mutex>
 #include "core/BufferAllocator.hpp"
+#include "core/Concurrency.h"
 #include "backend/cpu/CPUConcat.hpp"
+#include "backend/cpu/CPUFusedElementwise.hpp"
 #include "backend/cpu/CPUTensorConvert.hpp"
+#include "backend/cpu/CPUTuner.hpp"
 #include "backend/cpu/compute/CommonOptFunction.h"
 #include "core/TensorUtils.hpp"
 #include "backend/cpu/ThreadPool.hpp"
@@ -117,6 +120,13 @@ void CPUBackend::onExecuteBegin() const {
 #endif
 #endif
 }
+void CPUBackend::onResizeEnd() {
+    if (mTuning) {
+        // Keep results of ops tuned in this resize
+        CPUTuner::get()->save();
+    }
+}
+
 void CPUBackend::onExecuteEnd() const {
 #ifdef MNN_USE_THREAD_POOL
     if (mTaskIndex >= 0 && mPower != BackendConfig::Power_High) {
@@ -270,6 +280,10 @@ Execution* CPUBackend::onCreate(const std::vector<Tensor*>& inputs, const std::v
     return exe;
 }
 
+std::vector<Backend::Fusion> CPUBackend::onFuse(const std::vector<FuseUnit>& units) {
+    return CPUFusedElementwise::fuse(this, units);
+}
+
 bool CPUBackend::onAllocateBuffer() {
     mStaticAllocator->release(false);
     return true;
@@ -289,6 +303,48 @@ std::pair<int, int> CPUBackend::multiThreadDivide(int size) const {
     }
     return std::make_pair(sizeDivide, scheduleNumber);
 }
+void CPUBackend::copyRows(uint8_t* dst, int dstStride, const uint8_t* src, int srcStride, int rows, int bytes) const {
+    if (dst == src && (dstStride == srcStride || rows <= 1)) {
+        return;
+    }
+    // Small copies are not worth to split
+    int threadNumber = mThreadNumber;
+    if ((int64_t)rows * bytes < 64 * 1024) {
+        threadNumber = 1;
+    }
+    if (1 == threadNumber) {
+        for (int r = 0; r < rows; ++r) {
+            ::memcpy(dst + r * dstStride, src + r * srcStride, bytes);
+        }
+        return;
+    }
+    auto backend = [this]() { return this; };
+    if (rows >= threadNumber) {
+        MNN_CONCURRENCY_BEGIN(tId, threadNumber) {
+            const int start = (int)((int64_t)rows * tId / threadNumber);
+            const int end   = (int)((int64_t)rows * (tId + 1) / threadNumber);
+            for (int r = start; r < end; ++r) {
+                ::memcpy(dst + r * dstStride, src + r * srcStride, bytes);
+            }
+        }
+        MNN_CONCURRENCY_END();
+        return;
+    }
+    // Few long rows, split every row among threads
+    const int chunk = UP_DIV(UP_DIV(bytes, threadNumber), 64) * 64;
+    for (int r = 0; r < rows; ++r) {
+        auto dstRow = dst + r * dstStride;
+        auto srcRow = src + r * srcStride;
+        MNN_CONCURRENCY_BEGIN(tId, threadNumber) {
+            const int start = (int)tId * chunk;
+            if (start < bytes) {
+                ::memcpy(dstRow + start, srcRow + start, std::min(chunk, bytes - start));
+            }
+        }
+        MNN_CONCURRENCY_END();
+    }
+}
+
 void CPUBackend::onCopyBuffer(const Tensor* srcTensor, const Tensor* dstTensor) const {
     auto& srcBuffer = srcTensor->buffer();
     auto& dstBuffer = dstTensor->buffer();
@@ -310,6 +366,11 @@ void CPUBackend::onCopyBuffer(const Tensor* srcTensor, const Tensor* dstTensor)
     }
 }
 
+void CPUBackend::initFunctions() {
+    static std::once_flag sFuncflag;
+    std::call_once(sFuncflag, [&]() { MNNFunctionInit(); });
+}
+
 struct CPUBackendCreator : BackendCreator {
     Backend* onCreate(const Backend::Info& info) const override {
         auto power   = BackendConfig::Power_Normal;
@@ -320,8 +381,7 @@ struct CPUBackendCreator : BackendCreator {
             memory = info.user->memory;
             flags  = info.user->flags;
         }
-        static std::once_flag sFuncflag;
-        std::call_once(sFuncflag, [&]() { MNNFunctionInit(); });
+        CPUBackend::initFunctions();
 #ifdef MNN_CODEGEN_REGISTER
         static std::once_flag s_flag;
         std::call_once(s_flag, [&]() { registerCPUOps(); });
@@ -27,6 +27,16 @@ public:
 
     // Return sizeDivide, scheduleNumber aligned memory
     std::pair<int, int> multiThreadDivide(int size) const;
+    /**
+     * @brief copy rows of bytes with threads, nothing is copied if dst is src, which is a view aliased by pipeline.
+     * @param dst       first row of destination.
+     * @param dstStride bytes between rows of destination.
+     * @param src       first row of source.
+     * @param srcStride bytes between rows of source.
+     * @param rows      number of rows.
+     * @param bytes     bytes of each row.
+     */
+    void copyRows(uint8_t* dst, int dstStride, const uint8_t* src, int srcStride, int rows, int bytes) const;
 public:
     virtual bool onAcquireBuffer(const Tensor* nativeTensor, StorageType storageType) override;
     virtual bool onReleaseBuffer(const Tensor* nativeTensor, StorageType storageType) override;
@@ -38,8 +48,10 @@ public:
 
     virtual Execution* onCreate(const std::vector<Tensor*>& inputs, const std::vector<Tensor*>& outputs,
                                 const MNN::Op* op) override;
+    virtual std::vector<Fusion> onFuse(const std::vector<FuseUnit>& units) override;
     virtual void onExecuteBegin() const override;
     virtual void onExecuteEnd() const override;
+    virtual void onResizeEnd() override;
     
     virtual void* getAllocator(StorageType type = DYNAMIC) const override{
         if(type == STATIC){
@@ -55,6 +67,8 @@ public:
     };
 
     static bool addCreator(OpType t, Creator* c);
+    /** init the functions of cpu once, such as the SSE / AVX2 kernels chosen by cpu flags on x86 */
+    static void initFunctions();
 
     int threadNumber() const {
         return mThreadNumber;
@@ -70,6 +84,16 @@ public:
     BackendConfig::PowerMode powerMode() const {
         return mPower;
     }
+    /**
+     * @brief measure candidate algorithms of ops supporting tuning when creating them and choose the fastest.
+     * @param enable    tune or not.
+     */
+    void setTuning(bool enable) {
+        mTuning = enable;
+    }
+    bool tuning() const {
+        return mTuning;
+    }
 #ifdef MNN_USE_THREAD_POOL
     inline int taskIndex() const {return mTaskIndex;}
 #endif
@@ -84,6 +108,7 @@ private:
     const BackendConfig::MemoryMode mMemory;
     const BackendConfig::PowerMode mPower;
     bool mCheckNAN = false;
+    bool mTuning   = false;
     float mFlops = 0.0f;
 };
 
@@ -7,72 +7,193 @@
 //
 
 #include "backend/cpu/CPUBatchMatMul.hpp"
+#include <algorithm>
 #include "backend/cpu/CPUBackend.hpp"
-#include "math/Matrix.hpp"
+#include "backend/cpu/compute/CommonOptFunction.h"
+#include "core/Concurrency.h"
+#include "core/Macro.h"
 
 namespace MNN {
 
-CPUBatchMatMul::CPUBatchMatMul(Backend* backend, bool adjX, bool adjY) : Execution(backend) {
-    mMatMul.reset(new CPUMatMul(backend, adjX, adjY, true));
+CPUBatchMatMul::CPUBatchMatMul(Backend* backend, bool adjX, bool adjY)
+    : Execution(backend), mTransposeA(adjX), mTransposeB(adjY) {
+    // Do nothing
+}
+
+// Columns [eStart, eStart + eCount) of A [l, e] -> [UP_DIV(l, 4), eCount, 4]
+static void _packTransposeA(float* dst, const float* A, int eStart, int eCount, int e, int l) {
+    for (int z = 0; z < l; z += 4) {
+        auto dstZ  = dst + z * eCount;
+        int remain = std::min(4, l - z);
+        for (int i = 0; i < remain; ++i) {
+            auto src = A + (z + i) * e + eStart;
+            for (int x = 0; x < eCount; ++x) {
+                dstZ[4 * x + i] = src[x];
+            }
+        }
+        for (int i = remain; i < 4; ++i) {
+            for (int x = 0; x < eCount; ++x) {
+                dstZ[4 * x + i] = 0.0f;
+            }
+        }
+    }
 }
 
 ErrorCode CPUBatchMatMul::onResize(const std::vector<Tensor*>& inputs, const std::vector<Tensor*>& outputs) {
-    auto input0          = inputs[0];
-    auto input1          = inputs[1];
-    auto output          = outputs[0];
+    auto input0 = inputs[0];
+    auto input1 = inputs[1];
+    auto output = outputs[0];
     // Fill output by zero if one of inputs is empty.
     if (input0->elementSize() == 0 || input1->elementSize() == 0) {
         return NO_ERROR;
     }
-    auto dimensions = input0->dimensions();
-    mMatrixA.reset(Tensor::createDevice<float>({input0->length(input0->dimensions()-2), input0->length(input0->dimensions()-1)}));
-    mMatrixB.reset(Tensor::createDevice<float>({input1->length(input1->dimensions()-2), input1->length(input0->dimensions()-1)}));
-    mMatrixC.reset(Tensor::createDevice<float>({output->length(output->dimensions()-2), output->length(output->dimensions()-1)}));
-    mTempInputs = {mMatrixA.get(), mMatrixB.get()};
-    mTempOutputs = {mMatrixC.get()};
-    auto res = backend()->onAcquireBuffer(mMatrixA.get(), Backend::DYNAMIC);
-    res = res && backend()->onAcquireBuffer(mMatrixB.get(), Backend::DYNAMIC);
-    res = res && backend()->onAcquireBuffer(mMatrixC.get(), Backend::DYNAMIC);
+    auto i0Dim = input0->dimensions();
+    auto i1Dim = input1->dimensions();
+    auto oDim  = output->dimensions();
+    mE         = output->length(oDim - 2);
+    mH         = output->length(oDim - 1);
+    mL         = mTransposeA ? input0->length(i0Dim - 2) : input0->length(i0Dim - 1);
 
+    // Broadcast the batch dimensions aligned from the last one
+    const int batchDimensions = oDim - 2;
+    int batch                 = 1;
+    for (int i = 0; i < batchDimensions; ++i) {
+        batch *= output->length(i);
+    }
+    mAIndexes.resize(batch);
+    mBIndexes.resize(batch);
+    for (int index = 0; index < batch; ++index) {
+        int c      = index;
+        int aIndex = 0, aStride = 1;
+        int bIndex = 0, bStride = 1;
+        for (int i = batchDimensions - 1; i >= 0; --i) {
+            auto cord = c % output->length(i);
+            c         = c / output->length(i);
+            auto a    = i - (oDim - i0Dim);
+            if (a >= 0) {
+                auto length = input0->length(a);
+                aIndex += (length > 1 ? cord : 0) * aStride;
+                aStride *= length;
+            }
+            auto b = i - (oDim - i1Dim);
+            if (b >= 0) {
+                auto length = input1->length(b);
+                bIndex += (length > 1 ? cord : 0) * bStride;
+                bStride *= length;
+            }
+        }
+        mAIndexes[index] = aIndex;
+        mBIndexes[index] = bIndex;
+    }
+    mBBatch = input1->elementSize() / mL / mH;
+
+    int eP, lP, hP;
+    MNNGetMatMulPackMode(&eP, &lP, &hP);
+    mThreadNumber = static_cast<CPUBackend*>(backend())->threadNumber();
+    auto eUnit    = UP_DIV(mE, eP);
+    int block     = 1;
+    if (batch < mThreadNumber) {
+        block = std::min(eUnit, UP_DIV(mThreadNumber, batch));
+    }
+    auto unitPerBlock = UP_DIV(eUnit, block);
+    mBlockNumber      = UP_DIV(eUnit, unitPerBlock);
+    mBlockSize        = std::min(mE, unitPerBlock * eP);
+
+    auto lC4 = UP_DIV(mL, 4);
+    auto hC4 = UP_DIV(mH, 4);
+    mPackedB.reset(Tensor::createDevice<float>({mBBatch, UP_DIV(mH, hP) * mL * hP}));
+    int cacheSize = 0;
+    if (hP % 4 != 0) {
+        cacheSize = eP * MNNGetC4DivNumber(hP) * 4 + hC4 * eP * 4;
+    }
+    int threadBufferSize = lC4 * mBlockSize * 4 + hC4 * mBlockSize * 4 + mL * eP + cacheSize;
+    mThreadBuffer.reset(Tensor::createDevice<float>({mThreadNumber, threadBufferSize}));
+    auto res = backend()->onAcquireBuffer(mPackedB.get(), Backend::DYNAMIC);
+    res      = res && backend()->onAcquireBuffer(mThreadBuffer.get(), Backend::DYNAMIC);
     if (!res) {
         return OUT_OF_MEMORY;
     }
-    int batch = 1;
-    for (int i = 0; i < dimensions - 2; ++i) {
-        batch *= input0->length(i);
-    }
-    mBatch = batch;
-    auto code = mMatMul->onResize(mTempInputs, mTempOutputs);
-    backend()->onReleaseBuffer(mMatrixA.get(), Backend::DYNAMIC);
-    backend()->onReleaseBuffer(mMatrixB.get(), Backend::DYNAMIC);
-    backend()->onReleaseBuffer(mMatrixC.get(), Backend::DYNAMIC);
-    return code;
+    backend()->onReleaseBuffer(mPackedB.get(), Backend::DYNAMIC);
+    backend()->onReleaseBuffer(mThreadBuffer.get(), Backend::DYNAMIC);
+    return NO_ERROR;
 }
 
 ErrorCode CPUBatchMatMul::onExecute(const std::vector<Tensor*>& inputs, const std::vector<Tensor*>& outputs) {
-    auto input0          = inputs[0];
-    auto input1          = inputs[1];
-    auto output          = outputs[0];
+    auto input0 = inputs[0];
+    auto input1 = inputs[1];
+    auto output = outputs[0];
     // Fill output by zero if one of inputs is empty.
     if (input0->elementSize() == 0 || input1->elementSize() == 0) {
         ::memset(output->host<float>(), 0, output->size());
         return NO_ERROR;
     }
-    const int dimensions = input0->dimensions();
-    MNN_ASSERT(dimensions >= 3);
-    const int input0Stride = input0->stride(dimensions - 3);
-    const int input1Stride = input1->stride(dimensions - 3);
-    const int outputStride = output->stride(dimensions - 3);
-    const auto input0Ptr   = input0->host<float>();
-    const auto input1Ptr   = input1->host<float>();
-    float* const outputPtr = output->host<float>();
+    const auto e          = mE;
+    const auto l          = mL;
+    const auto h          = mH;
+    const auto transposeA = mTransposeA;
+    const auto transposeB = mTransposeB;
+    const auto APtr       = input0->host<float>();
+    const auto BPtr       = input1->host<float>();
+    auto CPtr             = output->host<float>();
+    auto packedB          = mPackedB->host<float>();
+    auto packedBStride    = mPackedB->stride(0);
+    int eP, lP, hP;
+    MNNGetMatMulPackMode(&eP, &lP, &hP);
+    const int numberThread = mThreadNumber;
+
+    // Every batch of B is packed once, even if it is broadcasted
+    MNN_CONCURRENCY_BEGIN(tId, numberThread) {
+        for (int b = (int)tId; b < mBBatch; b += numberThread) {
+            MNNPackForMatMul_B(packedB + b * packedBStride, BPtr + b * l * h, h, l, transposeB);
+        }
+    }
+    MNN_CONCURRENCY_END();
 
-    for (int i = 0; i < mBatch; ++i) {
-        ::memcpy(mMatrixA->host<float>(), input0Ptr + i * input0Stride, input0Stride * sizeof(float));
-        ::memcpy(mMatrixB->host<float>(), input1Ptr + i * input1Stride, input1Stride * sizeof(float));
-        mMatMul->onExecute(mTempInputs, mTempOutputs);
-        ::memcpy(outputPtr + i * outputStride, mMatrixC->host<float>(), outputStride * sizeof(float));
+    const auto lC4        = UP_DIV(l, 4);
+    const auto hC4        = UP_DIV(h, 4);
+    const int taskNumber  = (int)mAIndexes.size() * mBlockNumber;
+    const auto bufferHost = mThreadBuffer->host<float>();
+    const auto bufferSize = mThreadBuffer->stride(0);
+    MNN_CONCURRENCY_BEGIN(tId, numberThread) {
+        auto AT    = bufferHost + tId * bufferSize;
+        auto CT    = AT + lC4 * mBlockSize * 4;
+        auto tile  = CT + hC4 * mBlockSize * 4;
+        auto cache = tile + l * eP;
+        std::vector<size_t> parameters(6);
+        parameters[1] = l;
+        parameters[2] = std::min(hC4 * 4, UP_DIV(h, hP) * hP);
+        parameters[4] = 0;
+        parameters[5] = 0;
+        for (int task = (int)tId; task < taskNumber; task += numberThread) {
+            auto index  = task / mBlockNumber;
+            auto eStart = (task % mBlockNumber) * mBlockSize;
+            auto eCount = std::min(mBlockSize, e - eStart);
+            auto A      = APtr + mAIndexes[index] * e * l;
+            auto B      = packedB + mBIndexes[index] * packedBStride;
+            auto C      = CPtr + index * e * h;
+            // A -> [lC4, eCount, 4]
+            if (transposeA) {
+                _packTransposeA(AT, A, eStart, eCount, e, l);
+            } else {
+                MNNUnpackTranspose(AT, A + eStart * l, eCount, l);
+            }
+            parameters[0] = eCount * sizeof(float);
+            parameters[3] = eCount * 4 * sizeof(float);
+            int xStart    = 0;
+            for (; xStart + eP <= eCount; xStart += eP) {
+                MNNPackC4ForMatMul_A(tile, AT + xStart * 4, eP, l, eCount);
+                MNNPackedMatMul(CT + xStart * 4, tile, B, parameters.data(), cache, nullptr, nullptr);
+            }
+            if (xStart < eCount) {
+                auto xCount = eCount - xStart;
+                MNNPackC4ForMatMul_A(tile, AT + xStart * 4, xCount, l, eCount);
+                MNNPackedMatMulRemain(CT + xStart * 4, tile, B, xCount, parameters.data(), cache, nullptr, nullptr);
+            }
+            // [hC4, eCount, 4] -> C
+            MNNPackTranspose(C + eStart * h, CT, eCount, h);
+        }
     }
+    MNN_CONCURRENCY_END();
     return NO_ERROR;
 }
 
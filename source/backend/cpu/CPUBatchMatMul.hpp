@@ -9,10 +9,13 @@
 #ifndef CPUBatchMatMul_hpp
 #define CPUBatchMatMul_hpp
 
-#include "backend/cpu/CPUMatMul.hpp"
+#include <vector>
+#include "core/Execution.hpp"
 
 namespace MNN {
 
+// Batched C = A * B with numpy broadcast of the batch dimensions, used by BatchMatMul and MatMul with more than two
+// dimensions. The matrices are read from the inputs in place, the batches and the rows of C are split by threads
 class CPUBatchMatMul : public Execution {
 public:
     CPUBatchMatMul(Backend *backend, bool adjX, bool adjY);
@@ -21,13 +24,23 @@ public:
     virtual ErrorCode onResize(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs) override;
 
 private:
-    int mBatch;
-    std::shared_ptr<Execution> mMatMul;
-    std::vector<Tensor*> mTempInputs;
-    std::vector<Tensor*> mTempOutputs;
-    std::shared_ptr<Tensor> mMatrixA;
-    std::shared_ptr<Tensor> mMatrixB;
-    std::shared_ptr<Tensor> mMatrixC;
+    bool mTransposeA;
+    bool mTransposeB;
+    int mE;
+    int mL;
+    int mH;
+    int mThreadNumber;
+    // Rows of C computed by one task, a batch is split into mBlockNumber tasks if there are fewer batches than threads
+    int mBlockSize;
+    int mBlockNumber;
+    // Batch index of A and B for each batch of C
+    std::vector<int> mAIndexes;
+    std::vector<int> mBIndexes;
+    int mBBatch;
+    // Every batch of B packed once, [mBBatch, UP_DIV(h, hP) * l * hP]
+    std::shared_ptr<Tensor> mPackedB;
+    // Pack buffer of A and C for each thread
+    std::shared_ptr<Tensor> mThreadBuffer;
 };
 
 } // namespace MNN
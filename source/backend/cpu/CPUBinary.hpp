@@ -9,33 +9,30 @@
 #ifndef CPUBinary_hpp
 #define CPUBinary_hpp
 
+#include <vector>
 #include "core/Execution.hpp"
 
 namespace MNN {
 
-class CPUBinaryFloat : public Execution {
+// Element-wise binary op with numpy broadcast. Broadcast dimensions are collapsed into a nested stride loop
+// in onResize, the innermost span is computed by a vectorized proc and the output is split among threads.
+class CPUBinary : public Execution {
 public:
-    CPUBinaryFloat(Backend *b, int32_t type);
-    virtual ~CPUBinaryFloat() = default;
+    // broadcastIndex is -1 if both inputs are contiguous, 0 or 1 if that input is a scalar for the span
+    typedef void (*BinaryProc)(void* C, const void* A, const void* B, int size, int broadcastIndex);
+    CPUBinary(Backend *b, BinaryProc proc);
+    virtual ~CPUBinary() = default;
     virtual ErrorCode onResize(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs) override;
     virtual ErrorCode onExecute(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs) override;
+    static BinaryProc selectProc(int32_t type, halide_type_t dataType);
 
 protected:
-    int32_t mType;
-    void (*mElementProc)(float* C, const float* A, const float* B, size_t width, size_t cStride, size_t aStride, size_t bStride, size_t height) = nullptr;
-    bool mSupportScale = false;
-    int mOutside = 1;
-    int mInside = 1;
-    int mAxis = 1;
-};
-class CPUBinaryInt : public Execution {
-public:
-    CPUBinaryInt(Backend *b, int32_t type);
-    virtual ~CPUBinaryInt() = default;
-    virtual ErrorCode onExecute(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs) override;
-
-protected:
-    int32_t mType;
+    BinaryProc mProc;
+    // Collapsed output dimensions and input strides in elements, 0 for broadcasted dimension
+    std::vector<int> mDims;
+    std::vector<int> mStride0;
+    std::vector<int> mStride1;
+    int mTotal = 0;
 };
 } // namespace MNN
 #endif /* CPUBinary_hpp */
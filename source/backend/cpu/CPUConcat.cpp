@@ -50,7 +50,7 @@ static int _concatWidth(const Tensor* outputTensor, const vector<Tensor*>& input
     return 0;
 }
 
-static int _concatHeight(const Tensor* outputTensor, const vector<Tensor*>& inputTensors) {
+static int _concatHeight(const Tensor* outputTensor, const vector<Tensor*>& inputTensors, const CPUBackend* bn) {
     auto outputDim              = outputTensor->buffer().dim;
     const int batchSize         = outputDim[0].extent;
     const int depthQuad         = UP_DIV(outputDim[1].extent, 4);
@@ -66,37 +66,32 @@ static int _concatHeight(const Tensor* outputTensor, const vector<Tensor*>& inpu
             float* inputOrigin   = reinterpret_cast<float*>(inputTensor.host) + inputTensor.dim[0].stride * batchIndex;
             int inputPlaneStride = inputTensor.dim[2].extent * inputTensor.dim[3].extent * 4;
             int inputH           = inputTensor.dim[2].extent;
-            for (int z = 0; z < depthQuad; ++z) {
-                float* dstZ = outputOrigin + outputPlaneStride * z;
-                float* srcZ = inputOrigin + inputPlaneStride * z;
-
-                memcpy(dstZ + currentPositionH * outputLineStride, srcZ, inputPlaneStride * sizeof(float));
-            }
+            bn->copyRows((uint8_t*)(outputOrigin + currentPositionH * outputLineStride),
+                         outputPlaneStride * sizeof(float), (const uint8_t*)inputOrigin,
+                         inputPlaneStride * sizeof(float), depthQuad, inputPlaneStride * sizeof(float));
             currentPositionH += inputH;
         }
     }
     return 0;
 }
 
-static int _concatBatch(const Tensor* outputTensor, const vector<Tensor*>& inputTensors) {
+static int _concatBatch(const Tensor* outputTensor, const vector<Tensor*>& inputTensors, const CPUBackend* bn) {
     auto outputDim      = outputTensor->buffer().dim;
     int currentPositionB = 0;
     for (size_t b = 0; b < inputTensors.size(); b++) {
         auto& inputTensor   = inputTensors[b]->buffer();
         const int batchSize = inputTensor.dim[0].extent;
-        for (int batchIndex = 0; batchIndex < batchSize; ++batchIndex) {
-            float* inputOrigin = reinterpret_cast<float*>(inputTensor.host) + inputTensor.dim[0].stride * batchIndex;
-            float* outputOrigin = reinterpret_cast<float*>(outputTensor->buffer().host) +
-                                  outputDim[0].stride * (currentPositionB + batchIndex);
-            ::memcpy(outputOrigin, inputOrigin, inputTensor.dim[0].stride * sizeof(float));
-        }
+        float* outputOrigin = reinterpret_cast<float*>(outputTensor->buffer().host) + outputDim[0].stride * currentPositionB;
+        // The batches of input are contiguous in output
+        bn->copyRows((uint8_t*)outputOrigin, 0, inputTensor.host, 0, 1,
+                     inputTensor.dim[0].stride * batchSize * sizeof(float));
         currentPositionB += batchSize;
     }
     return 0;
 }
 
 static int _concatChannel(const Tensor* outputTensor, const vector<Tensor*>& inputTensors, bool useSlowMethod,
-                          const Tensor* tempOutputTensor) {
+                          const Tensor* tempOutputTensor, const CPUBackend* bn) {
     auto outputDim        = outputTensor->buffer().dim;
     float* outputOrigin   = reinterpret_cast<float*>(outputTensor->buffer().host);
     int batchSize         = outputDim[0].extent;
@@ -119,24 +114,21 @@ static int _concatChannel(const Tensor* outputTensor, const vector<Tensor*>& inp
         }
         return 0;
     }
-    for (int batchIndex = 0; batchIndex < batchSize; ++batchIndex) {
-        int currentPositionZ = 0;
-        for (size_t b = 0; b < inputTensors.size(); b++) {
-            auto& inputTensor  = inputTensors[b]->buffer();
-            float* inputOrigin = reinterpret_cast<float*>(inputTensor.host) + inputTensor.dim[0].stride * batchIndex;
-            int inputZ         = UP_DIV(inputTensor.dim[1].extent, 4);
-            float* dst         = outputOrigin + outputDim[1].stride * currentPositionZ * 4 + outputDim[0].stride * batchIndex;
-            float* src         = inputOrigin;
-
-            memcpy(dst, src, outputDim[1].stride * 4 * inputZ * sizeof(float));
-            currentPositionZ += inputZ;
-        }
+    int currentPositionZ = 0;
+    for (size_t b = 0; b < inputTensors.size(); b++) {
+        auto& inputTensor = inputTensors[b]->buffer();
+        int inputZ        = UP_DIV(inputTensor.dim[1].extent, 4);
+        float* dst        = outputOrigin + outputDim[1].stride * currentPositionZ * 4;
+        bn->copyRows((uint8_t*)dst, outputDim[0].stride * sizeof(float), inputTensor.host,
+                     inputTensor.dim[0].stride * sizeof(float), batchSize,
+                     outputDim[1].stride * 4 * inputZ * sizeof(float));
+        currentPositionZ += inputZ;
     }
 
     return 0;
 }
 
-static int _concatTf(const Tensor* outputTensor, const vector<Tensor*>& inputTensors, int axis) {
+static int _concatTf(const Tensor* outputTensor, const vector<Tensor*>& inputTensors, int axis, const CPUBackend* bn) {
     auto& ob        = outputTensor->buffer();
     int outsideSize = 1;
     for (int i = 0; i < axis; ++i) {
@@ -157,13 +149,8 @@ static int _concatTf(const Tensor* outputTensor, const vector<Tensor*>& inputTen
         }
         uint8_t* inputOrigin = reinterpret_cast<uint8_t*>(inputTensor.host);
         int inputPlaneStride = inputTensor.dim[axis].extent * insideStride;
-
-        for (int z = 0; z < outsideSize; ++z) {
-            uint8_t* dstZ = outputOrigin + outsideStride * z + sumAxis * insideStride;
-            uint8_t* srcZ = inputOrigin + inputPlaneStride * z;
-
-            memcpy(dstZ, srcZ, inputPlaneStride);
-        }
+        bn->copyRows(outputOrigin + sumAxis * insideStride, outsideStride, inputOrigin, inputPlaneStride, outsideSize,
+                     inputPlaneStride);
         sumAxis += inputTensor.dim[axis].extent;
     }
     return 0;
@@ -203,16 +190,18 @@ ErrorCode CPUConcat::onExecute(const vector<Tensor*>& inputs, const std::vector<
     MNN_ASSERT(1 == outputs.size());
     MNN_ASSERT(inputs.size() >= 2);
     auto input = inputs[0];
+    auto bn    = static_cast<CPUBackend*>(backend());
+    // The inputs planned as views of output are copied by their producers, see Pipeline::planViews
     if (input->buffer().dimensions > 1 && TensorUtils::getDescribe(input)->dimensionFormat == MNN_DATA_FORMAT_NC4HW4) {
         switch (mAxis) {
             case 0:
-                _concatBatch(outputs[0], inputs);
+                _concatBatch(outputs[0], inputs, bn);
                 break;
             case 1:
-                _concatChannel(outputs[0], inputs, mUseSlowMethod, mTempOutput.get());
+                _concatChannel(outputs[0], inputs, mUseSlowMethod, mTempOutput.get(), bn);
                 break;
             case 2:
-                _concatHeight(outputs[0], inputs);
+                _concatHeight(outputs[0], inputs, bn);
                 break;
             case 3:
                 _concatWidth(outputs[0], inputs);
@@ -224,7 +213,7 @@ ErrorCode CPUConcat::onExecute(const vector<Tensor*>& inputs, const std::vector<
     } else {
         int axis = mAxis;
         // tf concat
-        _concatTf(outputs[0], inputs, axis);
+        _concatTf(outputs[0], inputs, axis, bn);
     }
 
     return NO_ERROR;
@@ -26,6 +26,10 @@ static void *_blobData(const Blob *b) {
         case DataType_DT_QUINT8:
             return (void *)b->uint8s()->Data();
             break;
+        case DataType_DT_INT8:
+            // Quantized tables, such as int8 embedding
+            result = (void *)b->int8s()->Data();
+            break;
         default:
             MNN_ASSERT(false);
             break;
@@ -46,6 +50,11 @@ ErrorCode CPUConst::onResize(const std::vector<Tensor *> &inputs, const std::vec
         if (nullptr == parameter->uint8s()) {
             return NOT_SUPPORT;
         }
+        if (output->getType().bits == 16) {
+            // Table kept in half for gather
+            ::memcpy(output->host<void>(), parameter->uint8s()->data(), output->size());
+            return NO_ERROR;
+        }
         auto outputPtr = output->host<float>();
         auto src = (half_float::half*)parameter->uint8s()->data();
         auto size = output->elementSize();
@@ -18,6 +18,15 @@
 
 namespace MNN {
 
+CPUConvolution::Resource::~Resource() {
+    if (nullptr != mBias) {
+        backend->onReleaseBuffer(mBias.get(), Backend::STATIC);
+    }
+    if (nullptr != mWeight) {
+        backend->onReleaseBuffer(mWeight.get(), Backend::STATIC);
+    }
+}
+
 CPUConvolution::CPUConvolution(const Convolution2DCommon *convOp, Backend *b) : MNN::Execution(b), mCommon(convOp) {
     mPostFunction = getPostFunction();
 }
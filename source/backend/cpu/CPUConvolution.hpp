@@ -14,6 +14,13 @@
 namespace MNN {
 class CPUConvolution : public Execution {
 public:
+    /** constant weight and bias, shared between executions cloned by onClone */
+    struct Resource {
+        std::shared_ptr<Tensor> mWeight;
+        std::shared_ptr<Tensor> mBias;
+        Backend* backend;
+        ~Resource();
+    };
     CPUConvolution(const Convolution2DCommon *convOp, Backend *b);
     virtual ~CPUConvolution() = default;
     virtual ErrorCode onResize(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs) override;
@@ -78,6 +78,19 @@ CPUConvolutionDepthwise::CPUConvolutionDepthwise(const Op* op, Backend* backend)
     mSubExecution.reset(new FloatExecution(conv2d->common(), backend, originWeight, originWeightSize,
                                            conv2d->bias()->data(), conv2d->bias()->size()));
 }
+CPUConvolutionDepthwise::CPUConvolutionDepthwise(Execution* subExecution, Backend* backend) : Execution(backend) {
+    mSubExecution.reset(subExecution);
+}
+bool CPUConvolutionDepthwise::onClone(Backend* bn, const Op* op, Execution** dst) {
+    Execution* subExecution = nullptr;
+    if (!mSubExecution->onClone(bn, op, nullptr == dst ? nullptr : &subExecution)) {
+        return false;
+    }
+    if (nullptr != dst) {
+        *dst = new CPUConvolutionDepthwise(subExecution, bn);
+    }
+    return true;
+}
 ErrorCode CPUConvolutionDepthwise::onResize(const std::vector<Tensor*>& inputs, const std::vector<Tensor*>& outputs) {
     return mSubExecution->onResize(inputs, outputs);
 }
@@ -96,30 +109,42 @@ CPUConvolutionDepthwise::FloatExecution::FloatExecution(const Convolution2DCommo
     int kw          = layer->kernelX();
     int kh          = layer->kernelY();
     int outputCount = (int)biasSize;
-    mBias.reset(Tensor::createDevice<float>(std::vector<int>{ALIGN_UP4(outputCount)}));
+    mResource.reset(new Resource);
+    mResource->backend = b;
+    mResource->mBias.reset(Tensor::createDevice<float>(std::vector<int>{ALIGN_UP4(outputCount)}));
     int depthQuad   = UP_DIV(outputCount, 4);
     int planeStride = kw * kh * 4;
     int kernelSize  = depthQuad * 4 * kw * kh;
-    mWeight.reset(Tensor::createDevice<float>(std::vector<int>{kernelSize}));
-    bool success =
-        b->onAcquireBuffer(mBias.get(), Backend::STATIC) && b->onAcquireBuffer(mWeight.get(), Backend::STATIC);
+    mResource->mWeight.reset(Tensor::createDevice<float>(std::vector<int>{kernelSize}));
+    bool success = b->onAcquireBuffer(mResource->mBias.get(), Backend::STATIC) &&
+                   b->onAcquireBuffer(mResource->mWeight.get(), Backend::STATIC);
     if (!success) {
         MNN_ERROR("Error for alloc memory for CPUConvolutionDepthwise\n");
         mValid = false;
         return;
     }
-    ::memset(mBias->host<float>(), 0, mBias->size());
-    ::memcpy(mBias->host<float>(), bias, biasSize * sizeof(float));
+    ::memset(mResource->mBias->host<float>(), 0, mResource->mBias->size());
+    ::memcpy(mResource->mBias->host<float>(), bias, biasSize * sizeof(float));
 
     const float* tempWeight = originWeight;
     // Reorder weight from whc -> pwhc4
-    ::memset(mWeight->host<float>(), 0, kernelSize * sizeof(float));
-    auto weight = mWeight->host<float>();
+    ::memset(mResource->mWeight->host<float>(), 0, kernelSize * sizeof(float));
+    auto weight = mResource->mWeight->host<float>();
     MNNPackC4(weight, tempWeight, kh * kw, outputCount);
 }
-CPUConvolutionDepthwise::FloatExecution::~FloatExecution() {
-    backend()->onReleaseBuffer(mWeight.get(), Backend::STATIC);
-    backend()->onReleaseBuffer(mBias.get(), Backend::STATIC);
+CPUConvolutionDepthwise::FloatExecution::FloatExecution(std::shared_ptr<Resource> resource,
+                                                        const Convolution2DCommon* common, Backend* b)
+    : MNN::CPUConvolution(common, b), mResource(resource) {
+    mOrigin.reset(new BasicFloatExecution(common, b));
+}
+bool CPUConvolutionDepthwise::FloatExecution::onClone(Backend* bn, const Op* op, Execution** dst) {
+    if (!mValid) {
+        return false;
+    }
+    if (nullptr != dst) {
+        *dst = new FloatExecution(mResource, mCommon, bn);
+    }
+    return true;
 }
 ErrorCode CPUConvolutionDepthwise::MultiInputFloatExecution::onResize(const std::vector<Tensor*>& inputs,
                                                                       const std::vector<Tensor*>& outputs) {
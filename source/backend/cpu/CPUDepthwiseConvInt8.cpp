@@ -9,24 +9,16 @@
 #include "backend/cpu/CPUDepthwiseConvInt8.hpp"
 #include "backend/cpu/CPUBackend.hpp"
 #include "backend/cpu/compute/CommonOptFunction.h"
+#include "backend/cpu/compute/Int8FunctionsOpt.h"
 #include "core/Concurrency.h"
 #include "core/Macro.h"
 #include <math.h>
 
 #define UNIT 4
 
-extern "C" {
-void MNNDepthWiseInt8AddBiasScaleUnit(int8_t* dst, const int8_t* src, const int8_t* weight, const int32_t* bias,
-                                      size_t fw, size_t fh, size_t weight_y_step, size_t dilateX_step,
-                                      size_t dilateY_step, const float* scale);
-void MNNLineDepthWiseInt8AddBiasScaleUnit(int8_t* dst, const int8_t* src, const int8_t* weight, const int32_t* bias_z,
-                                          size_t width, size_t src_w_step, size_t fw, size_t fh, size_t dilateX_step,
-                                          size_t dilateY_step, const float* scale_z, size_t mode);
-}
-
 namespace MNN {
 
-#ifndef MNN_USE_NEON
+#if !defined(MNN_USE_NEON) && !defined(MNN_USE_SSE)
 inline int8_t int32ToInt8(int data, int bias, float scale) {
     float value = (float)(data + bias) * scale;
     value       = std::max(value, -127.0f);
@@ -17,7 +17,9 @@
 //#define MNN_OPEN_TIME_TRACE
 #include <MNN/AutoTime.hpp>
 #include "backend/cpu/CPUBackend.hpp"
+#include "backend/cpu/CPUNonMaxSuppressionV2.hpp"
 #include "backend/cpu/compute/CommonOptFunction.h"
+#include "core/Concurrency.h"
 #include "core/TensorUtils.hpp"
 
 namespace MNN {
@@ -46,54 +48,6 @@ using score_box_t = std::tuple<float, float, float, float, int, float>;
 #define box_label(rect) (std::get<4>(rect))
 #define box_score(rect) (std::get<5>(rect))
 
-static inline float intersectionArea(const score_box_t& a, const score_box_t& b) {
-    float axmin = box_rect_xmin(a), bxmin = box_rect_xmin(b);
-    float axmax = box_rect_xmax(a), bxmax = box_rect_xmax(b);
-    float aymin = box_rect_ymin(a), bymin = box_rect_ymin(b);
-    float aymax = box_rect_ymax(a), bymax = box_rect_ymax(b);
-    if (axmin > bxmax || axmax < bxmin || aymin > bymax || aymax < bymin)
-        return 0.f;
-
-    float interWidth  = fmin(axmax, bxmax) - fmax(axmin, bxmin);
-    float interHeight = fmin(aymax, bymax) - fmax(aymin, bymin);
-    return interWidth * interHeight;
-}
-
-static void pickBoxes(const std::vector<score_box_t> &boxes, std::vector<int> &picked, float nmsThreshold, int topK) {
-    long n = boxes.size();
-    std::vector<float> areas;
-    areas.resize(n);
-    for (int i = 0; i < n; i++) {
-        auto& box     = boxes[i];
-        float width  = box_rect_xmax(box) - box_rect_xmin(box);
-        float height = box_rect_ymax(box) - box_rect_ymin(box);
-        areas[i]     = width * height;
-    }
-
-    for (int i = 0; i < n; i++) {
-        auto& a = boxes[i];
-
-        bool keep = true;
-        for (auto pick : picked) {
-            auto& b = boxes[pick];
-
-            // intersection over union
-            float interArea = intersectionArea(a, b);
-            float unionArea = areas[i] + areas[pick] - interArea;
-            if (interArea / unionArea > nmsThreshold) {
-                keep = false;
-                break;
-            }
-        }
-        if (keep) {
-            picked.push_back(i);
-            if (picked.size() >= topK) {
-                break;
-            }
-        }
-    }
-}
-
 ErrorCode CPUDetectionOutput::onResize(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs) {
     auto &location = inputs[0];
     auto &priorbox = inputs[2];
@@ -163,29 +117,34 @@ ErrorCode CPUDetectionOutput::onExecute(const std::vector<Tensor *> &inputs, con
     auto armlocationPtr   = refineDet ? mArmLocation.host<const float>() : NULL;
     auto armconfidencePtr = refineDet ? mArmConfidence.host<const float>() : NULL;
 
-    auto boxes      = std::shared_ptr<float>(new float[4 * priorCount], [](float *p) { delete[] p; });
-    auto decodeBoxs = [&boxes, priorCount, variancePtr](const float *priorboxPtr, const float *locationPtr) {
-        for (int i = 0; i < priorCount; i++) {
-            auto loc = locationPtr + i * 4;
-            auto pb  = priorboxPtr + i * 4;
-            auto var = variancePtr + i * 4;
-            auto box = boxes.get() + i * 4;
-
-            float pbW  = pb[2] - pb[0];
-            float pbH  = pb[3] - pb[1];
-            float pbCX = (pb[0] + pb[2]) * 0.5f;
-            float pbCY = (pb[1] + pb[3]) * 0.5f;
-
-            float boxCX = var[0] * loc[0] * pbW + pbCX;
-            float boxCY = var[1] * loc[1] * pbH + pbCY;
-            float boxW  = exp(var[2] * loc[2]) * pbW;
-            float boxH  = exp(var[3] * loc[3]) * pbH;
-
-            box[0] = boxCX - boxW * 0.5f;
-            box[1] = boxCY - boxH * 0.5f;
-            box[2] = boxCX + boxW * 0.5f;
-            box[3] = boxCY + boxH * 0.5f;
+    int threadNumber = static_cast<CPUBackend*>(backend())->threadNumber();
+    auto boxes       = std::shared_ptr<float>(new float[4 * priorCount], [](float *p) { delete[] p; });
+    auto decodeBoxs  = [this, &boxes, priorCount, variancePtr, threadNumber](const float *priorboxPtr,
+                                                                           const float *locationPtr) {
+        MNN_CONCURRENCY_BEGIN(tId, threadNumber) {
+            for (int i = (int)tId; i < priorCount; i += threadNumber) {
+                auto loc = locationPtr + i * 4;
+                auto pb  = priorboxPtr + i * 4;
+                auto var = variancePtr + i * 4;
+                auto box = boxes.get() + i * 4;
+
+                float pbW  = pb[2] - pb[0];
+                float pbH  = pb[3] - pb[1];
+                float pbCX = (pb[0] + pb[2]) * 0.5f;
+                float pbCY = (pb[1] + pb[3]) * 0.5f;
+
+                float boxCX = var[0] * loc[0] * pbW + pbCX;
+                float boxCY = var[1] * loc[1] * pbH + pbCY;
+                float boxW  = exp(var[2] * loc[2]) * pbW;
+                float boxH  = exp(var[3] * loc[3]) * pbH;
+
+                box[0] = boxCX - boxW * 0.5f;
+                box[1] = boxCY - boxH * 0.5f;
+                box[2] = boxCX + boxW * 0.5f;
+                box[3] = boxCY + boxH * 0.5f;
+            }
         }
+        MNN_CONCURRENCY_END();
     };
     if (refineDet) {
         decodeBoxs(priorboxPtr, armlocationPtr);
@@ -194,39 +153,39 @@ ErrorCode CPUDetectionOutput::onExecute(const std::vector<Tensor *> &inputs, con
         decodeBoxs(priorboxPtr, locationPtr);
     }
 
-    // sort and nms for each class
-    std::vector<score_box_t> allClassBoxes;
-    auto compareFunction = [](const score_box_t &a, const score_box_t &b) { return box_score(a) > box_score(b); };
+    // sort and nms for each class, classes are split among threads and merged in order
+    const int maxDetections = mKeepTopK > 0 ? mKeepTopK : priorCount;
+    std::vector<std::vector<int>> classPicked(mClassCount);
     {
         AUTOTIME;
-        for (int i = 1; i < mClassCount; i++) { // start from 1 to ignore background class
-            std::vector<score_box_t> classBoxes;
-            classBoxes.reserve(priorCount);
-            // filter by confidenceThreshold
-            for (int j = 0; j < priorCount; j++) {
-                float score = confidencePtr[j * mClassCount + i];
-                if (refineDet && (armconfidencePtr[j * 2 + 1] < mObjectnessScoreThreshold)) {
-                    score = 0.0;
-                }
-                if (score > mConfidenceThreshold) {
-                    const float *box = boxes.get() + 4 * j;
-                    classBoxes.push_back(box_rect(box[0], box[1], box[2], box[3], i, score));
+        MNN_CONCURRENCY_BEGIN(tId, threadNumber) {
+            std::vector<float> scores(priorCount);
+            for (int i = 1 + (int)tId; i < mClassCount; i += threadNumber) { // start from 1 to ignore background class
+                for (int j = 0; j < priorCount; j++) {
+                    float score = confidencePtr[j * mClassCount + i];
+                    if (refineDet && (armconfidencePtr[j * 2 + 1] < mObjectnessScoreThreshold)) {
+                        score = 0.0;
+                    }
+                    scores[j] = score;
                 }
-            }
-
-            // sort inplace
-            std::sort(classBoxes.begin(), classBoxes.end(), compareFunction);
-
-            // apply nms
-            std::vector<int> picked;
-            pickBoxes(classBoxes, picked, mNMSThreshold, mKeepTopK);
-
-            // select
-            for (auto index : picked) {
-                allClassBoxes.push_back(classBoxes[index]);
+                // boxes are [xmin, ymin, xmax, ymax], the iou is the same as [ymin, xmin, ymax, xmax]
+                NonMaxSuppressionImpl(boxes.get(), scores.data(), priorCount, maxDetections, mNMSThreshold,
+                                      mConfidenceThreshold, &classPicked[i]);
             }
         }
+        MNN_CONCURRENCY_END();
     }
+    std::vector<score_box_t> allClassBoxes;
+    for (int i = 1; i < mClassCount; i++) {
+        for (auto j : classPicked[i]) {
+            float score = refineDet && (armconfidencePtr[j * 2 + 1] < mObjectnessScoreThreshold)
+                              ? 0.0f
+                              : confidencePtr[j * mClassCount + i];
+            const float *box = boxes.get() + 4 * j;
+            allClassBoxes.push_back(box_rect(box[0], box[1], box[2], box[3], i, score));
+        }
+    }
+    auto compareFunction = [](const score_box_t &a, const score_box_t &b) { return box_score(a) > box_score(b); };
 
     // set width
     int numDetected = (int)allClassBoxes.size();
@@ -11,11 +11,12 @@
 #include "backend/cpu/CPUBackend.hpp"
 #include "backend/cpu/CPUDetectionPostProcess.hpp"
 #include "backend/cpu/CPUNonMaxSuppressionV2.hpp"
+#include "core/Concurrency.h"
 
 namespace MNN {
 
 static void _decodeBoxes(const Tensor* boxesEncoding, const Tensor* anchors, const CenterSizeEncoding& scaleValues,
-                         Tensor* decodeBoxes) {
+                         Tensor* decodeBoxes, Backend* bn) {
     const int numBoxes        = boxesEncoding->length(1);
     const int boxCoordNum     = boxesEncoding->length(2);
     const int numAnchors      = anchors->length(0);
@@ -28,28 +29,33 @@ static void _decodeBoxes(const Tensor* boxesEncoding, const Tensor* anchors, con
     const auto anchorsPtr = reinterpret_cast<const CenterSizeEncoding*>(anchors->host<float>());
     auto decodeBoxesPtr   = reinterpret_cast<BoxCornerEncoding*>(decodeBoxes->host<float>());
 
-    CenterSizeEncoding boxCenterSize;
-    CenterSizeEncoding anchor;
-    for (int idx = 0; idx < numBoxes; ++idx) {
-        const int boxIndex = idx * boxCoordNum;
-        boxCenterSize      = *reinterpret_cast<const CenterSizeEncoding*>(boxesPtr + boxIndex);
-        anchor             = anchorsPtr[idx];
-        float ycenter      = boxCenterSize.y / scaleValues.y * anchor.h + anchor.y;
-        float xcenter      = boxCenterSize.x / scaleValues.x * anchor.w + anchor.x;
-        float halfh        = 0.5f * static_cast<float>(exp(boxCenterSize.h / scaleValues.h)) * anchor.h;
-        float halfw        = 0.5f * static_cast<float>(exp(boxCenterSize.w / scaleValues.w)) * anchor.w;
-        auto& curBox       = decodeBoxesPtr[idx];
-        curBox.ymin        = ycenter - halfh;
-        curBox.xmin        = xcenter - halfw;
-        curBox.ymax        = ycenter + halfh;
-        curBox.xmax        = xcenter + halfw;
+    const int threadNumber = static_cast<CPUBackend*>(bn)->threadNumber();
+    auto backend           = [bn]() { return bn; };
+    MNN_CONCURRENCY_BEGIN(tId, threadNumber) {
+        CenterSizeEncoding boxCenterSize;
+        CenterSizeEncoding anchor;
+        for (int idx = (int)tId; idx < numBoxes; idx += threadNumber) {
+            const int boxIndex = idx * boxCoordNum;
+            boxCenterSize      = *reinterpret_cast<const CenterSizeEncoding*>(boxesPtr + boxIndex);
+            anchor             = anchorsPtr[idx];
+            float ycenter      = boxCenterSize.y / scaleValues.y * anchor.h + anchor.y;
+            float xcenter      = boxCenterSize.x / scaleValues.x * anchor.w + anchor.x;
+            float halfh        = 0.5f * static_cast<float>(exp(boxCenterSize.h / scaleValues.h)) * anchor.h;
+            float halfw        = 0.5f * static_cast<float>(exp(boxCenterSize.w / scaleValues.w)) * anchor.w;
+            auto& curBox       = decodeBoxesPtr[idx];
+            curBox.ymin        = ycenter - halfh;
+            curBox.xmin        = xcenter - halfw;
+            curBox.ymax        = ycenter + halfh;
+            curBox.xmax        = xcenter + halfw;
+        }
     }
+    MNN_CONCURRENCY_END();
 }
 
 static void _NonMaxSuppressionMultiClassFastImpl(const DetectionPostProcessParamT& postProcessParam,
                                                  const Tensor* decodedBoxes, const Tensor* classPredictions,
                                                  Tensor* detectionBoxes, Tensor* detectionClass,
-                                                 Tensor* detectionScores, Tensor* numDetections) {
+                                                 Tensor* detectionScores, Tensor* numDetections, Backend* bn) {
     // decoded_boxes shape is [numBoxes, 4]
     const int numBoxes               = decodedBoxes->length(0);
     const int numClasses             = postProcessParam.numClasses;
@@ -65,19 +71,25 @@ static void _NonMaxSuppressionMultiClassFastImpl(const DetectionPostProcessParam
     sortedClassIndices.resize(numBoxes * numClasses);
     const auto scoresStartPtr = classPredictions->host<float>();
     // sort scores on every anchor
-    for (int idx = 0; idx < numBoxes; ++idx) {
-        const auto boxScores = scoresStartPtr + idx * numClassWithBackground + labelOffset;
-        auto classIndices    = sortedClassIndices.data() + idx * numClasses;
-
-        std::iota(classIndices, classIndices + numClasses, 0);
-        std::partial_sort(classIndices, classIndices + numCategoriesPerAnchor, classIndices + numClasses,
-                          [&boxScores](const int i, const int j) { return boxScores[i] > boxScores[j]; });
-        maxScores[idx] = boxScores[classIndices[0]];
+    const int threadNumber = static_cast<CPUBackend*>(bn)->threadNumber();
+    auto backend           = [bn]() { return bn; };
+    MNN_CONCURRENCY_BEGIN(tId, threadNumber) {
+        for (int idx = (int)tId; idx < numBoxes; idx += threadNumber) {
+            const auto boxScores = scoresStartPtr + idx * numClassWithBackground + labelOffset;
+            auto classIndices    = sortedClassIndices.data() + idx * numClasses;
+
+            std::iota(classIndices, classIndices + numClasses, 0);
+            std::partial_sort(classIndices, classIndices + numCategoriesPerAnchor, classIndices + numClasses,
+                              [&boxScores](const int i, const int j) { return boxScores[i] > boxScores[j]; });
+            maxScores[idx] = boxScores[classIndices[0]];
+        }
     }
+    MNN_CONCURRENCY_END();
 
     std::vector<int> seleted;
     NonMaxSuppressionSingleClasssImpl(decodedBoxes, maxScores.data(), postProcessParam.maxDetections,
-                                      postProcessParam.iouThreshold, postProcessParam.nmsScoreThreshold, &seleted);
+                                      postProcessParam.iouThreshold, postProcessParam.nmsScoreThreshold, &seleted,
+                                      bn);
 
     const auto decodedBoxesPtr = reinterpret_cast<const BoxCornerEncoding*>(decodedBoxes->host<float>());
     auto detectionBoxesPtr     = reinterpret_cast<BoxCornerEncoding*>(detectionBoxes->host<float>());
@@ -129,14 +141,14 @@ ErrorCode CPUDetectionPostProcess::onExecute(const std::vector<Tensor*>& inputs,
     scaleValues.x = mParam.centerSizeEncoding[1];
     scaleValues.h = mParam.centerSizeEncoding[2];
     scaleValues.w = mParam.centerSizeEncoding[3];
-    _decodeBoxes(inputs[0], inputs[2], scaleValues, mDecodedBoxes.get());
+    _decodeBoxes(inputs[0], inputs[2], scaleValues, mDecodedBoxes.get(), backend());
 
     if (mParam.useRegularNMS) {
         return NOT_SUPPORT;
     } else {
         // perform NMS on max scores
         _NonMaxSuppressionMultiClassFastImpl(mParam, mDecodedBoxes.get(), inputs[1], outputs[0], outputs[1], outputs[2],
-                                             outputs[3]);
+                                             outputs[3], backend());
     }
 
     return NO_ERROR;
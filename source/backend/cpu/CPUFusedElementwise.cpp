@@ -0,0 +1,521 @@
+//
+//  CPUFusedElementwise.cpp
+//  MNN
+//
+//  Created by MNN on 2020/05/12.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include "backend/cpu/CPUFusedElementwise.hpp"
+#include <math.h>
+#include <algorithm>
+#include <map>
+#include "backend/cpu/CPUBackend.hpp"
+#include "backend/cpu/compute/CommonOptFunction.h"
+#include "backend/cpu/compute/ConvOpt.h"
+#include "core/Concurrency.h"
+#include "core/Macro.h"
+#include "core/TensorUtils.hpp"
+
+namespace MNN {
+// Floats of one block, the intermediate results of a block stay in L1 cache
+static const int gBlockSize = 1024;
+
+static void _abs(float* dst, const float* src, size_t size) {
+    MNNReluWithSlopeCommon(dst, src, size, -1.0f);
+}
+static void _neg(float* dst, const float* src, size_t size) {
+    MNNScaleAndAddBiasScalar(dst, src, 0.0f, -1.0f, size);
+}
+static void _square(float* dst, const float* src, size_t size) {
+    MNNMatrixProdCommon(dst, src, src, size, 0, 0, 0, 1);
+}
+
+// The same functions as CPUUnary, nullptr for the ones computed by scalar functor
+static void (*_unaryFunction(int type))(float*, const float*, size_t) {
+    switch (type) {
+        case UnaryOpOperation_ABS:
+            return _abs;
+        case UnaryOpOperation_NEG:
+            return _neg;
+        case UnaryOpOperation_SQUARE:
+            return _square;
+        case UnaryOpOperation_SQRT:
+            return MNNMathSqrt;
+        case UnaryOpOperation_RSQRT:
+            return MNNMathRsqrt;
+        case UnaryOpOperation_EXP:
+            return MNNMathExp;
+        case UnaryOpOperation_LOG:
+            return MNNMathLog;
+        case UnaryOpOperation_SIN:
+            return MNNMathSin;
+        case UnaryOpOperation_COS:
+            return MNNMathCos;
+        case UnaryOpOperation_ERF:
+            return MNNMathErf;
+        default:
+            break;
+    }
+    return nullptr;
+}
+
+// Float tensor without the channel padding of NC4HW4, so the ops of CPU compute it as a linear array
+static bool _isDense(const Tensor* t) {
+    return t->getType() == halide_type_of<float>() && t->size() == t->elementSize() * (int)sizeof(float);
+}
+
+static bool _sameShape(const Tensor* a, const Tensor* b) {
+    if (a->dimensions() != b->dimensions() ||
+        TensorUtils::getDescribe(a)->dimensionFormat != TensorUtils::getDescribe(b)->dimensionFormat) {
+        return false;
+    }
+    for (int i = 0; i < a->dimensions(); ++i) {
+        if (a->length(i) != b->length(i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Index of the input computed by the chain, the other inputs are operands read from memory
+static int _sourceIndex(const CPUFusedElementwise::Link& link, const Tensor* source) {
+    auto& inputs = link.inputs;
+    if (nullptr != source) {
+        if (1 != std::count(inputs.begin(), inputs.end(), source)) {
+            return -1;
+        }
+        return (int)(std::find(inputs.begin(), inputs.end(), source) - inputs.begin());
+    }
+    for (int i = 0; i < inputs.size(); ++i) {
+        if (_sameShape(inputs[i], link.output)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+CPUFusedElementwise::CPUFusedElementwise(Backend* backend, const std::vector<Link>& links)
+    : Execution(backend), mLinks(links) {
+    // Do nothing
+}
+
+bool CPUFusedElementwise::canFuse(const Link& link, const Tensor* source) {
+    CPUFusedElementwise fused(nullptr, {});
+    return fused._addLink(link, source);
+}
+
+CPUFusedElementwise* CPUFusedElementwise::create(Backend* backend, const std::vector<Link>& links) {
+    if (links.empty()) {
+        return nullptr;
+    }
+    std::unique_ptr<CPUFusedElementwise> fused(new CPUFusedElementwise(backend, links));
+    const Tensor* source = nullptr;
+    for (auto& link : links) {
+        if (nullptr == link.execution || !fused->_addLink(link, source)) {
+            return nullptr;
+        }
+        source = link.output;
+    }
+    fused->mInput  = links[0].inputs[_sourceIndex(links[0], nullptr)];
+    fused->mOutput = links[links.size() - 1].output;
+    fused->_fusePatterns();
+    return fused.release();
+}
+
+std::vector<Backend::Fusion> CPUFusedElementwise::fuse(Backend* backend, const std::vector<Backend::FuseUnit>& units) {
+    std::map<const Tensor*, std::vector<int>> consumers;
+    for (int i = 0; i < units.size(); ++i) {
+        for (auto t : units[i].inputs) {
+            auto& indexes = consumers[t];
+            if (indexes.empty() || indexes.back() != i) {
+                indexes.emplace_back(i);
+            }
+        }
+    }
+    auto fusable = [&](int index) {
+        auto& u = units[index];
+        if (nullptr == u.execution || u.isConst || 1 != u.outputs.size() || u.execution->backend() != backend) {
+            return false;
+        }
+        // Wrapped execution copies its inputs from other backend
+        for (auto t : u.inputs) {
+            if (TensorUtils::getDescribe(t)->backend != backend) {
+                return false;
+            }
+        }
+        return true;
+    };
+    auto makeLink = [&](int index) {
+        auto& u = units[index];
+        Link link;
+        link.op        = u.op;
+        link.inputs    = u.inputs;
+        link.output    = u.outputs[0];
+        link.execution = u.execution;
+        return link;
+    };
+    std::vector<Backend::Fusion> fusions;
+    for (int i = 0; i < units.size();) {
+        if (!fusable(i) || !canFuse(makeLink(i), nullptr)) {
+            ++i;
+            continue;
+        }
+        std::vector<Link> links = {makeLink(i)};
+        std::vector<int> indexes = {i};
+        while (units[indexes.back()].internal) {
+            auto t    = units[indexes.back()].outputs[0];
+            auto iter = consumers.find(t);
+            if (iter == consumers.end() || 1 != iter->second.size()) {
+                break;
+            }
+            // Running units between them may reuse the memory of released inputs, only constant units are skipped
+            auto next    = iter->second[0];
+            bool between = false;
+            for (int j = indexes.back() + 1; j < next; ++j) {
+                between = between || !units[j].isConst;
+            }
+            if (between || !fusable(next)) {
+                break;
+            }
+            auto link = makeLink(next);
+            if (!canFuse(link, t)) {
+                break;
+            }
+            links.emplace_back(link);
+            indexes.emplace_back(next);
+        }
+        if (links.size() >= 2) {
+            std::shared_ptr<Execution> execution(create(backend, links));
+            if (nullptr != execution) {
+                Backend::Fusion fusion;
+                fusion.execution = execution;
+                fusion.units     = indexes;
+                fusions.emplace_back(std::move(fusion));
+            }
+        }
+        i = indexes.back() + 1;
+    }
+    return fusions;
+}
+
+bool CPUFusedElementwise::_addLink(const Link& link, const Tensor* source) {
+    if (nullptr == link.op || nullptr == link.output || !_isDense(link.output)) {
+        return false;
+    }
+    auto& inputs = link.inputs;
+    auto index   = _sourceIndex(link, source);
+    if (index < 0 || !_isDense(inputs[index]) || !_sameShape(inputs[index], link.output)) {
+        return false;
+    }
+    for (int i = 0; i < inputs.size(); ++i) {
+        auto t = inputs[i];
+        if (i == index) {
+            continue;
+        }
+        bool scalar = t->getType() == halide_type_of<float>() && 1 == t->elementSize();
+        if (!scalar && !(_isDense(t) && _sameShape(t, link.output))) {
+            return false;
+        }
+    }
+    auto op = link.op;
+    Step step;
+    switch (op->type()) {
+        case OpType_UnaryOp: {
+            if (1 != inputs.size() || nullptr == op->main_as_UnaryOp()) {
+                return false;
+            }
+            step.type  = Step::UNARY;
+            step.unary = _unaryFunction(op->main_as_UnaryOp()->opType());
+            if (nullptr == step.unary) {
+                return false;
+            }
+            break;
+        }
+        case OpType_Sigmoid:
+        case OpType_TanH:
+            if (1 != inputs.size()) {
+                return false;
+            }
+            step.type  = Step::UNARY;
+            step.unary = OpType_Sigmoid == op->type() ? MNNMathSigmoid : MNNTanh;
+            break;
+        case OpType_ReLU:
+            if (1 != inputs.size()) {
+                return false;
+            }
+            step.type = Step::RELU;
+            if (nullptr != op->main() && OpParameter_Relu == op->main_type()) {
+                step.parameters[0] = op->main_as_Relu()->slope();
+            }
+            break;
+        case OpType_PReLU: {
+            auto param = op->main_as_PRelu();
+            if (1 != inputs.size() || nullptr == param || 1 != param->slopeCount() || nullptr == param->slope()) {
+                return false;
+            }
+            step.type          = Step::RELU;
+            step.parameters[0] = param->slope()->data()[0];
+            break;
+        }
+        case OpType_ReLU6: {
+            if (1 != inputs.size()) {
+                return false;
+            }
+            step.type          = Step::CLAMP;
+            step.parameters[0] = 0.0f;
+            step.parameters[1] = 6.0f;
+            auto param         = op->main_as_Relu6();
+            if (nullptr != param) {
+                step.parameters[0] = param->minValue();
+                step.parameters[1] = param->maxValue();
+            }
+            break;
+        }
+        case OpType_BinaryOp: {
+            if (2 != inputs.size() || nullptr == op->main_as_BinaryOp()) {
+                return false;
+            }
+            return _addBinary(op->main_as_BinaryOp()->opType(), inputs[1 - index], 1 == index);
+        }
+        case OpType_Eltwise: {
+            auto param = op->main_as_Eltwise();
+            if (inputs.size() < 2 || nullptr == param || (nullptr != param->coeff() && param->coeff()->size() > 0)) {
+                return false;
+            }
+            int binaryType = -1;
+            switch (param->type()) {
+                case EltwiseType_SUM:
+                    binaryType = BinaryOpOperation_ADD;
+                    break;
+                case EltwiseType_PROD:
+                    binaryType = BinaryOpOperation_MUL;
+                    break;
+                case EltwiseType_MAXIMUM:
+                    binaryType = BinaryOpOperation_MAXIMUM;
+                    break;
+                case EltwiseType_SUB:
+                    binaryType = BinaryOpOperation_SUB;
+                    break;
+                default:
+                    return false;
+            }
+            // The inputs are accumulated in order, keep it to get the same rounding
+            if (index > 1) {
+                return false;
+            }
+            for (auto t : inputs) {
+                if (!_sameShape(t, link.output)) {
+                    return false;
+                }
+            }
+            if (!_addBinary(binaryType, inputs[1 - index], 1 == index)) {
+                return false;
+            }
+            for (int i = 2; i < inputs.size(); ++i) {
+                _addBinary(binaryType, inputs[i], false);
+            }
+            return true;
+        }
+        default:
+            return false;
+    }
+    mSteps.emplace_back(step);
+    return true;
+}
+
+bool CPUFusedElementwise::_addBinary(int binaryType, const Tensor* operand, bool operandFirst) {
+    switch (binaryType) {
+        case BinaryOpOperation_ADD:
+        case BinaryOpOperation_SUB:
+        case BinaryOpOperation_MUL:
+        case BinaryOpOperation_REALDIV:
+        case BinaryOpOperation_MINIMUM:
+        case BinaryOpOperation_MAXIMUM:
+        case BinaryOpOperation_SquaredDifference:
+            break;
+        default:
+            return false;
+    }
+    Step step;
+    step.type         = Step::BINARY;
+    step.binaryType   = binaryType;
+    step.proc         = CPUBinary::selectProc(binaryType, halide_type_of<float>());
+    step.operand      = operand;
+    step.operandFirst = operandFirst;
+    step.scalar       = 1 == operand->elementSize();
+    if (nullptr == step.proc) {
+        return false;
+    }
+    mSteps.emplace_back(step);
+    return true;
+}
+
+// Binary step with constant scalar operand near expect, the operand can be the first one if the op is commutative
+bool CPUFusedElementwise::_constValue(int index, int binaryType, float expect) const {
+    if (index >= mSteps.size()) {
+        return false;
+    }
+    auto& step = mSteps[index];
+    if (Step::BINARY != step.type || binaryType != step.binaryType || !step.scalar) {
+        return false;
+    }
+    bool commutative = BinaryOpOperation_ADD == binaryType || BinaryOpOperation_MUL == binaryType;
+    if (step.operandFirst && !commutative) {
+        return false;
+    }
+    if (TensorUsage::CONST != TensorUtils::getDescribe(step.operand)->usage || nullptr == step.operand->host<float>()) {
+        return false;
+    }
+    return fabsf(step.operand->host<float>()[0] - expect) <= 1e-5f * fabsf(expect);
+}
+
+// Multiply by the input of chain
+bool CPUFusedElementwise::_isInputProduct(int index) const {
+    if (index >= mSteps.size()) {
+        return false;
+    }
+    auto& step = mSteps[index];
+    return Step::BINARY == step.type && BinaryOpOperation_MUL == step.binaryType && mInput == step.operand;
+}
+
+// Steps of x * scale in either order from index, return the number of matched steps
+int CPUFusedElementwise::_matchScale(int index, float scale) const {
+    auto isScale = [this, scale](int i) {
+        return _constValue(i, BinaryOpOperation_MUL, scale) || _constValue(i, BinaryOpOperation_REALDIV, 1.0f / scale);
+    };
+    if ((_isInputProduct(index) && isScale(index + 1)) || (isScale(index) && _isInputProduct(index + 1))) {
+        return 2;
+    }
+    return 0;
+}
+
+void CPUFusedElementwise::_fusePatterns() {
+    // The patterns start from the chain, where the buffer is the input of chain
+    void (*function)(float*, const float*, size_t) = nullptr;
+    int number = 0;
+    int scaleNumber = 0;
+    if (mSteps.size() >= 2 && Step::UNARY == mSteps[0].type && MNNMathSigmoid == mSteps[0].unary &&
+        _isInputProduct(1)) {
+        // x * sigmoid(x)
+        function = MNNMathSwish;
+        number   = 2;
+    } else if (mSteps.size() >= 4 && _constValue(0, BinaryOpOperation_ADD, 3.0f) && Step::CLAMP == mSteps[1].type &&
+               0.0f == mSteps[1].parameters[0] && 6.0f == mSteps[1].parameters[1] &&
+               (scaleNumber = _matchScale(2, 1.0f / 6.0f)) > 0) {
+        // x * relu6(x + 3) / 6
+        function = MNNMathHardSwish;
+        number   = 2 + scaleNumber;
+    } else if (mSteps.size() >= 5 &&
+               (_constValue(0, BinaryOpOperation_REALDIV, 1.41421356f) ||
+                _constValue(0, BinaryOpOperation_MUL, 0.70710678f)) &&
+               Step::UNARY == mSteps[1].type && MNNMathErf == mSteps[1].unary &&
+               _constValue(2, BinaryOpOperation_ADD, 1.0f) && (scaleNumber = _matchScale(3, 0.5f)) > 0) {
+        // x * (1 + erf(x / sqrt(2))) / 2
+        function = MNNMathGelu;
+        number   = 3 + scaleNumber;
+    }
+    if (nullptr == function) {
+        return;
+    }
+    Step step;
+    step.type  = Step::UNARY;
+    step.unary = function;
+    mSteps.erase(mSteps.begin(), mSteps.begin() + number);
+    mSteps.insert(mSteps.begin(), step);
+}
+
+void CPUFusedElementwise::_computeBlock(float* dst, const float* src, float* buffer, int offset, int size) const {
+    for (int i = 0; i < mSteps.size(); ++i) {
+        auto& step   = mSteps[i];
+        float* target = i == mSteps.size() - 1 ? dst : buffer;
+        switch (step.type) {
+            case Step::UNARY:
+                step.unary(target, src, size);
+                break;
+            case Step::RELU:
+                MNNReluWithSlopeCommon(target, src, size, step.parameters[0]);
+                break;
+            case Step::CLAMP: {
+                // The same as CPURelu6
+                const float parameters[4] = {1.0f, 0.0f, step.parameters[0], step.parameters[1]};
+                const float bias[4]       = {0.0f, 0.0f, 0.0f, 0.0f};
+                const int sizeC4          = size / 4;
+                if (sizeC4 > 0) {
+                    MNNAxByClampBroadcastC4(target, src, bias, sizeC4, 0, 0, 1, parameters);
+                }
+                const int remain = sizeC4 * 4;
+                if (remain < size) {
+                    MNNAxByClamp(target + remain, src + remain, src + remain, size - remain, 0, 0, 0, 1, parameters);
+                }
+                break;
+            }
+            case Step::BINARY: {
+                const float* operand = step.scalar ? &step.value : step.operand->host<float>() + offset;
+                if (step.operandFirst) {
+                    step.proc(target, operand, src, size, step.scalar ? 0 : -1);
+                } else {
+                    step.proc(target, src, operand, size, step.scalar ? 1 : -1);
+                }
+                break;
+            }
+            default:
+                break;
+        }
+        src = target;
+    }
+}
+
+ErrorCode CPUFusedElementwise::_executeLinks() {
+    for (auto& link : mLinks) {
+        auto code = link.execution->onExecute(link.inputs, {link.output});
+        if (NO_ERROR != code) {
+            return code;
+        }
+    }
+    return NO_ERROR;
+}
+
+ErrorCode CPUFusedElementwise::onExecute(const std::vector<Tensor*>& inputs, const std::vector<Tensor*>& outputs) {
+    const int total = mOutput->elementSize();
+    if (total <= 0) {
+        return NO_ERROR;
+    }
+    auto input      = mInput->host<float>();
+    auto output     = mOutput->host<float>();
+    // A block of output is written after its inputs are read, so only the same memory can be shared
+    auto overlap = [output, total](const Tensor* t) {
+        auto ptr = t->host<float>();
+        return ptr != output && ptr < output + total && output < ptr + total;
+    };
+    if (overlap(mInput)) {
+        return _executeLinks();
+    }
+    for (auto& step : mSteps) {
+        if (Step::BINARY == step.type && !step.scalar && overlap(step.operand)) {
+            return _executeLinks();
+        }
+    }
+    for (auto& step : mSteps) {
+        if (Step::BINARY == step.type && step.scalar) {
+            step.value = step.operand->host<float>()[0];
+        }
+    }
+    const int blockNumber    = UP_DIV(total, gBlockSize);
+    const int threadNumber   = std::min(static_cast<CPUBackend*>(backend())->threadNumber(), blockNumber);
+    const int blockPerThread = UP_DIV(blockNumber, threadNumber);
+    MNN_CONCURRENCY_BEGIN(tId, threadNumber) {
+        float buffer[gBlockSize];
+        int start = (int)tId * blockPerThread;
+        int end   = std::min(start + blockPerThread, blockNumber);
+        for (int b = start; b < end; ++b) {
+            int offset = b * gBlockSize;
+            int size   = std::min(gBlockSize, total - offset);
+            _computeBlock(output + offset, input + offset, buffer, offset, size);
+        }
+    }
+    MNN_CONCURRENCY_END();
+    return NO_ERROR;
+}
+
+} // namespace MNN
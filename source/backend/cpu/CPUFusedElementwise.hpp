@@ -0,0 +1,89 @@
+//
+//  CPUFusedElementwise.hpp
+//  MNN
+//
+//  Created by MNN on 2020/05/12.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#ifndef CPUFusedElementwise_hpp
+#define CPUFusedElementwise_hpp
+
+#include <memory>
+#include <vector>
+#include "backend/cpu/CPUBinary.hpp"
+#include "core/Backend.hpp"
+#include "core/Execution.hpp"
+#include "MNN_generated.h"
+
+namespace MNN {
+
+// Chain of element-wise ops, each intermediate result is only used by the next op. The chain is computed block by
+// block in the cache of each thread, only the input and operands are read and only the last output is written.
+// The chains of swish, hard swish and gelu are computed at once by their fused math functions.
+class CPUFusedElementwise : public Execution {
+public:
+    /** prepared unit of the chain */
+    struct Link {
+        const Op* op;
+        std::vector<Tensor*> inputs;
+        Tensor* output;
+        /** run one by one instead if the memory of output partially overlaps the tensors to read */
+        std::shared_ptr<Execution> execution;
+    };
+    /**
+     * @brief find chains of element-wise units run by backend, whose intermediates are internal and only read by the
+     *        next unit of the chain.
+     * @param backend   CPU backend.
+     * @param units     all units of pipeline in running order.
+     * @return fused executions of chains.
+     */
+    static std::vector<Backend::Fusion> fuse(Backend* backend, const std::vector<Backend::FuseUnit>& units);
+    /**
+     * @brief whether link can be computed in a chain.
+     * @param link      given link.
+     * @param source    output of the previous link, nullptr if link starts the chain.
+     */
+    static bool canFuse(const Link& link, const Tensor* source);
+    /**
+     * @brief create execution computing links in order, the output of each link is the source of next one.
+     * @return execution, nullptr if any link can't be fused.
+     */
+    static CPUFusedElementwise* create(Backend* backend, const std::vector<Link>& links);
+    virtual ~CPUFusedElementwise() = default;
+    // The tensors of links are used, inputs and outputs are ignored
+    virtual ErrorCode onExecute(const std::vector<Tensor*>& inputs, const std::vector<Tensor*>& outputs) override;
+
+private:
+    struct Step {
+        enum Type { UNARY = 0, RELU, CLAMP, BINARY };
+        Type type;
+        void (*unary)(float* dst, const float* src, size_t size) = nullptr;
+        // slope of relu, min and max of clamp
+        float parameters[2] = {0.0f, 0.0f};
+        int binaryType                = -1;
+        CPUBinary::BinaryProc proc    = nullptr;
+        // The other input of binary op, the value of scalar operand is loaded before computing
+        const Tensor* operand         = nullptr;
+        bool operandFirst             = false;
+        bool scalar                   = false;
+        float value                   = 0.0f;
+    };
+    CPUFusedElementwise(Backend* backend, const std::vector<Link>& links);
+    bool _addLink(const Link& link, const Tensor* source);
+    bool _addBinary(int binaryType, const Tensor* operand, bool operandFirst);
+    bool _constValue(int index, int binaryType, float expect) const;
+    bool _isInputProduct(int index) const;
+    int _matchScale(int index, float scale) const;
+    void _fusePatterns();
+    void _computeBlock(float* dst, const float* src, float* buffer, int offset, int size) const;
+    ErrorCode _executeLinks();
+
+    std::vector<Link> mLinks;
+    std::vector<Step> mSteps;
+    const Tensor* mInput = nullptr;
+    Tensor* mOutput      = nullptr;
+};
+
+} // namespace MNN
+#endif /* CPUFusedElementwise_hpp */
@@ -8,6 +8,7 @@
 
 #include "backend/cpu/CPUGather.hpp"
 #include "backend/cpu/CPUBackend.hpp"
+#include "backend/cpu/CPUGatherV2.hpp"
 #include "backend/cpu/compute/CommonOptFunction.h"
 #include "core/Macro.h"
 
@@ -22,28 +23,9 @@ ErrorCode CPUGather::onResize(const std::vector<Tensor *> &inputs, const std::ve
 }
 
 ErrorCode CPUGather::onExecute(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs) {
-    auto embedding = inputs[0];
-    auto indices   = inputs[1];
-    auto output    = outputs[0];
-
-    auto bytes = embedding->buffer().type.bytes();
-
-    const size_t indicesCount = indices->elementSize();
-    const auto limit          = embedding->length(0);
-
-    auto outputData          = output->host<uint8_t>();
-    const auto *inputData   = embedding->host<uint8_t>();
-    const int firstDimStride = embedding->buffer().dim[0].stride * bytes;
-    const int *indicesData   = indices->host<int32_t>();
-
-    for (int i = 0; i < indicesCount; i++) {
-        if (indicesData[i] < 0 || indicesData[i] > limit) {
-            return INPUT_DATA_ERROR;
-        }
-        memcpy(outputData + i * firstDimStride, inputData + firstDimStride * indicesData[i],
-               firstDimStride);
-    }
-    return NO_ERROR;
+    // Gather is GatherV2 along the first axis, the optional third input is scales of int8 embedding
+    const Tensor *scales = inputs.size() > 2 ? inputs[2] : nullptr;
+    return CPUGatherV2::gather(backend(), inputs[0], inputs[1], scales, outputs[0], 0);
 }
 
 class CPUGatherCreator : public CPUBackend::Creator {
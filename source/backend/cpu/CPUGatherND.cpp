@@ -13,6 +13,8 @@
 
 #include "backend/cpu/CPUGatherND.hpp"
 #include <string.h>
+#include "core/Concurrency.h"
+#include "core/Macro.h"
 
 namespace MNN {
 ErrorCode CPUGatherND::onResize(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs) {
@@ -44,14 +46,43 @@ ErrorCode CPUGatherND::onExecute(const std::vector<Tensor *> &inputs, const std:
     auto indiceData = indice->host<int32_t>();
     auto output = outputs[0];
     auto bytes = output->getType().bytes();
+    if (0 == mSliceN || 0 == mSliceSize) {
+        return NO_ERROR;
+    }
 
+    // Check the indices once and compute the offset of slices
+    mOffsets.resize(mSliceN);
     for (int i=0; i<mSliceN; ++i) {
         int fromPos = 0;
         for (int j=0; j<indiceNd; ++j) {
-            fromPos += mDimsToCount[j] * indiceData[i*indiceNd + j];
+            auto index = indiceData[i*indiceNd + j];
+            if (index < 0 || index >= params->length(j)) {
+                return INPUT_DATA_ERROR;
+            }
+            fromPos += mDimsToCount[j] * index;
+        }
+        mOffsets[i] = fromPos;
+    }
+
+    const int sliceBytes = bytes * mSliceSize;
+    const auto srcPtr    = params->host<uint8_t>();
+    auto dstPtr          = output->host<uint8_t>();
+    int threadNumber     = static_cast<CPUBackend*>(backend())->threadNumber();
+    if ((int64_t)mSliceN * sliceBytes < 64 * 1024) {
+        threadNumber = 1;
+    }
+    const int prefetchDistance = 4;
+    MNN_CONCURRENCY_BEGIN(tId, threadNumber) {
+        const int start = (int)((int64_t)mSliceN * tId / threadNumber);
+        const int end   = (int)((int64_t)mSliceN * (tId + 1) / threadNumber);
+        for (int i = start; i < end; ++i) {
+            if (i + prefetchDistance < end) {
+                MNN_PREFETCH(srcPtr + (size_t)bytes * mOffsets[i + prefetchDistance]);
+            }
+            ::memcpy(dstPtr + (size_t)sliceBytes * i, srcPtr + (size_t)bytes * mOffsets[i], sliceBytes);
         }
-        ::memcpy(output->host<uint8_t>() + bytes * i * mSliceSize, params->host<uint8_t>() + bytes * fromPos, bytes * mSliceSize);
     }
+    MNN_CONCURRENCY_END();
     return NO_ERROR;
 }
 
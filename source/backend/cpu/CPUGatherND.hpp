@@ -11,5 +11,7 @@ namespace MNN {
         std::vector<int> mDimsToCount;
         int mSliceN = 0;
         int mSliceSize = 0;
+        // Offset in params of each slice
+        std::vector<int> mOffsets;
     };
 }
@@ -7,9 +7,12 @@
 //
 
 #include "backend/cpu/CPUGatherV2.hpp"
+#include <algorithm>
 #include "backend/cpu/CPUBackend.hpp"
 #include "backend/cpu/compute/CommonOptFunction.h"
+#include "core/Concurrency.h"
 #include "core/Macro.h"
+#include "half.hpp"
 
 namespace MNN {
 
@@ -20,7 +23,7 @@ CPUGatherV2::CPUGatherV2(Backend *b) : MNN::Execution(b) {
 ErrorCode CPUGatherV2::onResize(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs) {
     auto params  = inputs[0];
     mAxis = 0;
-    if (inputs.size() == 3) {
+    if (inputs.size() >= 3) {
         const Tensor *axisTensor = inputs[2];
         mAxis                     = axisTensor->host<int32_t>()[0];
     }
@@ -32,41 +35,94 @@ ErrorCode CPUGatherV2::onResize(const std::vector<Tensor *> &inputs, const std::
     return NO_ERROR;
 }
 
-ErrorCode CPUGatherV2::onExecute(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs) {
-    auto params  = inputs[0];
-    auto indices = inputs[1];
-    auto output  = outputs[0];
-    int axis     = mAxis;
-    const int N             = indices->elementSize();
-    int inside = 1;
+static void _halfToFloat(float *dst, const half_float::half *src, int size) {
+    for (int i = 0; i < size; ++i) {
+        dst[i] = src[i];
+    }
+}
+
+static void _dequantInt8(float *dst, const int8_t *src, float scale, int size) {
+    for (int i = 0; i < size; ++i) {
+        dst[i] = (float)src[i] * scale;
+    }
+}
+
+ErrorCode CPUGatherV2::gather(Backend *bn, const Tensor *params, const Tensor *indices, const Tensor *scales,
+                              Tensor *output, int axis) {
+    const int N = indices->elementSize();
+    int inside  = 1;
     int outside = 1;
-    for (int i=0; i<axis; ++i) {
+    for (int i = 0; i < axis; ++i) {
         outside *= params->length(i);
     }
-    for (int i=axis+1; i<params->dimensions(); ++i) {
+    for (int i = axis + 1; i < params->dimensions(); ++i) {
         inside *= params->length(i);
     }
-    const int limit          = params->length(axis);
-    auto bytes = output->buffer().type.bytes();
-    const int insideStride = inside * bytes;
-    const int outputOutsideStride = inside * N * bytes;
-    const int inputOutsideStride = inside * bytes *inputs[0]->length(axis);
-    const int *indicesPtr    = indices->host<int32_t>();
-    const auto inputPtr      = params->host<uint8_t>();
-    auto outputPtr           = output->host<uint8_t>();
-    for (int o=0; o<outside; ++o) {
-        auto outputO = outputPtr + outputOutsideStride * o;
-        auto inputO = inputPtr + inputOutsideStride * o;
-        for (int i = 0; i < N; i++) {
-            if (indicesPtr[i] < 0 || indicesPtr[i] > limit) {
-                return INPUT_DATA_ERROR;
+    const int limit = params->length(axis);
+    if (0 == N || 0 == inside || 0 == outside) {
+        return NO_ERROR;
+    }
+    // Check the range of indices once instead of every row
+    const int32_t *indicesPtr = indices->host<int32_t>();
+    int32_t minIndex          = indicesPtr[0];
+    int32_t maxIndex          = indicesPtr[0];
+    for (int i = 1; i < N; ++i) {
+        minIndex = std::min(minIndex, indicesPtr[i]);
+        maxIndex = std::max(maxIndex, indicesPtr[i]);
+    }
+    if (minIndex < 0 || maxIndex >= limit) {
+        return INPUT_DATA_ERROR;
+    }
+    const bool isInt8 = nullptr != scales;
+    // Half tables of express, or the DT_HALF blobs only read by gather in sessions
+    const bool isHalf = params->getType() == halide_type_t(halide_type_float, 16) &&
+                        output->getType() == halide_type_of<float>();
+    if (isInt8 && (params->getType() != halide_type_of<int8_t>() || scales->elementSize() < limit)) {
+        return INPUT_DATA_ERROR;
+    }
+    const float *scalesPtr = isInt8 ? scales->host<float>() : nullptr;
+    const int srcStride    = inside * params->getType().bytes();
+    const int dstStride    = inside * output->getType().bytes();
+    const auto srcPtr      = params->host<uint8_t>();
+    auto dstPtr            = output->host<uint8_t>();
+
+    const int total  = outside * N;
+    int threadNumber = static_cast<CPUBackend *>(bn)->threadNumber();
+    if ((int64_t)total * dstStride < 64 * 1024) {
+        threadNumber = 1;
+    }
+    auto backend = [bn]() { return bn; };
+    // Indices are random in a big table, so fetch the rows of following indices early
+    const int prefetchDistance = 4;
+    MNN_CONCURRENCY_BEGIN(tId, threadNumber) {
+        const int start = (int)((int64_t)total * tId / threadNumber);
+        const int end   = (int)((int64_t)total * (tId + 1) / threadNumber);
+        for (int r = start; r < end; ++r) {
+            if (r + prefetchDistance < end) {
+                const int next = r + prefetchDistance;
+                MNN_PREFETCH(srcPtr + ((size_t)(next / N) * limit + indicesPtr[next % N]) * srcStride);
+            }
+            const int index = indicesPtr[r % N];
+            auto src        = srcPtr + ((size_t)(r / N) * limit + index) * srcStride;
+            auto dst        = dstPtr + (size_t)r * dstStride;
+            if (isInt8) {
+                _dequantInt8((float *)dst, (const int8_t *)src, scalesPtr[index], inside);
+            } else if (isHalf) {
+                _halfToFloat((float *)dst, (const half_float::half *)src, inside);
+            } else {
+                ::memcpy(dst, src, srcStride);
             }
-            memcpy(outputO + i * insideStride, inputO + insideStride * indicesPtr[i], insideStride);
         }
     }
+    MNN_CONCURRENCY_END();
     return NO_ERROR;
 }
 
+ErrorCode CPUGatherV2::onExecute(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs) {
+    const Tensor *scales = inputs.size() > 3 ? inputs[3] : nullptr;
+    return gather(backend(), inputs[0], inputs[1], scales, outputs[0], mAxis);
+}
+
 class CPUGatherV2Creator : public CPUBackend::Creator {
 public:
     virtual Execution *onCreate(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs,
@@ -12,12 +12,23 @@
 #include "core/Execution.hpp"
 
 namespace MNN {
+// Inputs are params, indices, axis (optional) and scales. The scales are given only for int8 params, rows of them are
+// dequantized by the scale of their index along axis. float16 params are IEEE half and converted to float.
 class CPUGatherV2 : public Execution {
 public:
     CPUGatherV2(Backend *b);
     virtual ~CPUGatherV2() = default;
     virtual ErrorCode onResize(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs) override;
     virtual ErrorCode onExecute(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs) override;
+
+    /**
+     * @brief copy the slices of params along axis selected by indices to output with threads of backend.
+     * @param scales    scales of int8 params for each index along axis, nullptr for other params.
+     * @return INPUT_DATA_ERROR if any index is out of range.
+     */
+    static ErrorCode gather(Backend *bn, const Tensor *params, const Tensor *indices, const Tensor *scales,
+                            Tensor *output, int axis);
+
 private:
     int mAxis;
 };
@@ -17,7 +17,7 @@ namespace MNN {
 
 class CPUMatMul : public Execution {
 public:
-    CPUMatMul(Backend *backend, bool transposeA, bool transposeB, bool multiThread);
+    CPUMatMul(Backend *backend, bool transposeA, bool transposeB, bool multiThread, int maxDepth = 5);
     virtual ~CPUMatMul() = default;
     virtual ErrorCode onResize(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs) override;
     virtual ErrorCode onExecute(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs) override;
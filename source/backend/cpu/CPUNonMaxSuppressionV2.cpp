@@ -13,10 +13,14 @@
 // edited from tensorflow - non_max_suppression_op.cc by MNN.
 
 #include "backend/cpu/CPUNonMaxSuppressionV2.hpp"
+#include <float.h>
 #include <math.h>
-#include <queue>
+#include <string.h>
+#include <algorithm>
 #include "backend/cpu/CPUBackend.hpp"
+#include "core/Concurrency.h"
 #include "core/Macro.h"
+#include "math/Vec4.hpp"
 
 namespace MNN {
 
@@ -24,93 +28,207 @@ CPUNonMaxSuppressionV2::CPUNonMaxSuppressionV2(Backend* backend, const Op* op) :
     // nothing to do
 }
 
-// Return intersection-over-union overlap between boxes i and j
-static inline float IOU(const float* boxes, int i, int j) {
-    const float yMinI = std::min<float>(boxes[i * 4 + 0], boxes[i * 4 + 2]);
-    const float xMinI = std::min<float>(boxes[i * 4 + 1], boxes[i * 4 + 3]);
-    const float yMaxI = std::max<float>(boxes[i * 4 + 0], boxes[i * 4 + 2]);
-    const float xMaxI = std::max<float>(boxes[i * 4 + 1], boxes[i * 4 + 3]);
-    const float yMinJ = std::min<float>(boxes[j * 4 + 0], boxes[j * 4 + 2]);
-    const float xMinJ = std::min<float>(boxes[j * 4 + 1], boxes[j * 4 + 3]);
-    const float yMaxJ = std::max<float>(boxes[j * 4 + 0], boxes[j * 4 + 2]);
-    const float xMaxJ = std::max<float>(boxes[j * 4 + 1], boxes[j * 4 + 3]);
-    const float areaI = (yMaxI - yMinI) * (xMaxI - xMinI);
-    const float areaJ = (yMaxJ - yMinJ) * (xMaxJ - xMinJ);
-    if (areaI <= 0 || areaJ <= 0)
-        return 0.0;
-    const float intersectionYMin = std::max<float>(yMinI, yMinJ);
-    const float intersectionXMin = std::max<float>(xMinI, xMinJ);
-    const float intersectionYMax = std::min<float>(yMaxI, yMaxJ);
-    const float intersectionXMax = std::min<float>(xMaxI, xMaxJ);
-    const float intersectionArea = std::max<float>(intersectionYMax - intersectionYMin, 0.0) *
-                                   std::max<float>(intersectionXMax - intersectionXMin, 0.0);
-    return intersectionArea / (areaI + areaJ - intersectionArea);
+// Boxes in SoA layout with min / max corners, the size is padded to 4 by empty boxes. A box of non-positive area is
+// stored as an empty box at the origin, so its intersection with any box is zero, as its iou is defined as zero.
+struct NMSBoxes {
+    std::vector<float> y0, x0, y1, x1, area;
+    void resize(int size) {
+        auto sizeC4 = UP_DIV(size, 4) * 4;
+        for (auto v : {&y0, &x0, &y1, &x1, &area}) {
+            v->assign(sizeC4, 0.0f);
+        }
+    }
+    void set(int i, const float* box) {
+        y0[i]   = std::min(box[0], box[2]);
+        x0[i]   = std::min(box[1], box[3]);
+        y1[i]   = std::max(box[0], box[2]);
+        x1[i]   = std::max(box[1], box[3]);
+        area[i] = (y1[i] - y0[i]) * (x1[i] - x0[i]);
+        if (area[i] <= 0.0f) {
+            y0[i] = x0[i] = y1[i] = x1[i] = area[i] = 0.0f;
+        }
+    }
+    void copy(int i, const NMSBoxes& src, int j) {
+        y0[i]   = src.y0[j];
+        x0[i]   = src.x0[j];
+        y1[i]   = src.y1[j];
+        x1[i]   = src.x1[j];
+        area[i] = src.area[j];
+    }
+};
+
+// iou of box i in a with boxes [j, j + 4) in b
+static inline void _iouC4(const NMSBoxes& a, int i, const NMSBoxes& b, int j, float* iou) {
+    using Math::Vec4;
+    Vec4 y0(a.y0[i]), x0(a.x0[i]), y1(a.y1[i]), x1(a.x1[i]), area(a.area[i]);
+    Vec4 zero(0.0f), minUnion(FLT_MIN);
+    auto h     = Vec4::max(Vec4::min(y1, Vec4::load(b.y1.data() + j)) - Vec4::max(y0, Vec4::load(b.y0.data() + j)), zero);
+    auto w     = Vec4::max(Vec4::min(x1, Vec4::load(b.x1.data() + j)) - Vec4::max(x0, Vec4::load(b.x0.data() + j)), zero);
+    auto inter = h * w;
+    auto uni   = Vec4::max(area + Vec4::load(b.area.data() + j) - inter, minUnion);
+    Vec4::save(iou, inter / uni);
 }
 
-void NonMaxSuppressionSingleClasssImpl(const Tensor* decodedBoxes, const float* scores, int maxDetections,
-                                       float iouThreshold, float scoreThreshold, std::vector<int32_t>* selected) {
+void NonMaxSuppressionImpl(const float* boxes, const float* scores, int numBoxes, int maxDetections,
+                           float iouThreshold, float scoreThreshold, std::vector<int32_t>* selected, Backend* bn) {
     MNN_ASSERT(iouThreshold >= 0.0f && iouThreshold <= 1.0f);
-    MNN_ASSERT(decodedBoxes->dimensions() == 2);
-    const int numBoxes = decodedBoxes->length(0);
-    MNN_ASSERT(decodedBoxes->length(1) == 4)
-
     const int outputNum = std::min(maxDetections, numBoxes);
-    std::vector<float> scoresData(numBoxes);
-    std::copy_n(scores, numBoxes, scoresData.begin());
-
-    struct Candidate {
-        int boxIndex;
-        float score;
+    if (outputNum <= 0) {
+        return;
+    }
+    // Filter by score, blocks of 16 below the threshold are skipped by vector max
+    std::vector<int32_t> candidates;
+    {
+        using Math::Vec4;
+        int i = 0;
+        for (; i + 16 <= numBoxes; i += 16) {
+            auto m = Vec4::max(Vec4::max(Vec4::load(scores + i), Vec4::load(scores + i + 4)),
+                               Vec4::max(Vec4::load(scores + i + 8), Vec4::load(scores + i + 12)));
+            if (!(std::max(std::max(m[0], m[1]), std::max(m[2], m[3])) > scoreThreshold)) {
+                continue;
+            }
+            for (int j = i; j < i + 16; ++j) {
+                if (scores[j] > scoreThreshold) {
+                    candidates.emplace_back(j);
+                }
+            }
+        }
+        for (; i < numBoxes; ++i) {
+            if (scores[i] > scoreThreshold) {
+                candidates.emplace_back(i);
+            }
+        }
+    }
+    const int candidateNum = (int)candidates.size();
+    auto compare           = [scores](int32_t a, int32_t b) {
+        if (scores[a] != scores[b]) {
+            return scores[a] > scores[b];
+        }
+        return a < b;
     };
-
-    auto cmp = [](const Candidate bsI, const Candidate bsJ) { return bsI.score < bsJ.score; };
-
-    std::priority_queue<Candidate, std::deque<Candidate>, decltype(cmp)> candidatePriorityQueue(cmp);
-
-    for (int i = 0; i < scoresData.size(); ++i) {
-        if (scoresData[i] > scoreThreshold) {
-            candidatePriorityQueue.emplace(Candidate({i, scoresData[i]}));
+    // Candidates in [0, sortedEnd) are sorted, the others are sorted by chunks when they are reached
+    int sortedEnd = 0;
+    auto sortTo   = [&](int end) {
+        end = std::min(candidateNum, std::max(end, sortedEnd * 2));
+        if (end < candidateNum) {
+            std::nth_element(candidates.begin() + sortedEnd, candidates.begin() + end, candidates.end(), compare);
         }
+        std::sort(candidates.begin() + sortedEnd, candidates.begin() + end, compare);
+        sortedEnd = end;
+    };
+    sortTo(std::max(4 * outputNum, 256));
+
+    NMSBoxes selectedBoxes;
+    selectedBoxes.resize(outputNum);
+    int threadNumber = nullptr != bn ? static_cast<CPUBackend*>(bn)->threadNumber() : 1;
+    if (threadNumber > 1 && candidateNum >= 1024) {
+        // Candidates are visited by tiles. For each tile, threads test the candidates with the selected boxes and
+        // compute the bitmask of suppression inside the tile, then the tile is resolved in order by the bitmask
+        const int tile  = 256;
+        const int words = tile / 64;
+        NMSBoxes tileBoxes;
+        tileBoxes.resize(tile);
+        std::vector<uint8_t> suppressed(tile);
+        std::vector<uint64_t> mask(tile * words);
+        auto backend = [bn]() { return bn; };
+        for (int tileStart = 0; tileStart < candidateNum && (int)selected->size() < outputNum; tileStart += tile) {
+            const int tileSize = std::min(tile, candidateNum - tileStart);
+            if (tileStart + tileSize > sortedEnd) {
+                sortTo(tileStart + tileSize);
+            }
+            for (int i = 0; i < tileSize; ++i) {
+                tileBoxes.set(i, boxes + 4 * candidates[tileStart + i]);
+            }
+            const int selectedNum = (int)selected->size();
+            MNN_CONCURRENCY_BEGIN(tId, threadNumber) {
+                float iou[4];
+                for (int i = (int)tId; i < tileSize; i += threadNumber) {
+                    bool remove = false;
+                    for (int j = UP_DIV(selectedNum, 4) * 4 - 4; j >= 0 && !remove; j -= 4) {
+                        _iouC4(tileBoxes, i, selectedBoxes, j, iou);
+                        for (int v = 0; v < 4 && j + v < selectedNum; ++v) {
+                            remove = remove || iou[v] > iouThreshold;
+                        }
+                    }
+                    suppressed[i] = remove;
+                    if (remove) {
+                        continue;
+                    }
+                    auto maskRow = mask.data() + i * words;
+                    ::memset(maskRow, 0, words * sizeof(uint64_t));
+                    for (int j = ((i + 1) / 4) * 4; j < tileSize; j += 4) {
+                        _iouC4(tileBoxes, i, tileBoxes, j, iou);
+                        for (int v = 0; v < 4; ++v) {
+                            auto index = j + v;
+                            if (index > i && index < tileSize && iou[v] > iouThreshold) {
+                                maskRow[index / 64] |= ((uint64_t)1) << (index % 64);
+                            }
+                        }
+                    }
+                }
+            }
+            MNN_CONCURRENCY_END();
+            uint64_t removed[words] = {0};
+            for (int i = 0; i < tileSize && (int)selected->size() < outputNum; ++i) {
+                if (suppressed[i] || (removed[i / 64] & (((uint64_t)1) << (i % 64)))) {
+                    continue;
+                }
+                selectedBoxes.copy((int)selected->size(), tileBoxes, i);
+                selected->push_back(candidates[tileStart + i]);
+                auto maskRow = mask.data() + i * words;
+                for (int w = 0; w < words; ++w) {
+                    removed[w] |= maskRow[w];
+                }
+            }
+        }
+        return;
     }
-
-    // std::vector<float> selectedScores;
-    Candidate nextCandidate;
-    float iou, originalScore;
-
-    const auto boxesPtr = decodedBoxes->host<float>();
-    while (selected->size() < outputNum && !candidatePriorityQueue.empty()) {
-        nextCandidate = candidatePriorityQueue.top();
-        originalScore = nextCandidate.score;
-        candidatePriorityQueue.pop();
-
+    NMSBoxes current;
+    current.resize(1);
+    float iou[4];
+    for (int i = 0; i < candidateNum && (int)selected->size() < outputNum; ++i) {
+        if (i >= sortedEnd) {
+            sortTo(i + 1);
+        }
+        current.set(0, boxes + 4 * candidates[i]);
         // Overlapping boxes are likely to have similar scores,
         // therefore we iterate through the previously selected boxes backwards
         // in order to see if `next_candidate` should be suppressed.
-        bool shouldSelect = true;
-        for (int j = (int)selected->size() - 1; j >= 0; --j) {
-            iou = IOU(boxesPtr, nextCandidate.boxIndex, selected->at(j));
-            if (iou == 0.0) {
-                continue;
-            }
-            if (iou > iouThreshold) {
-                shouldSelect = false;
+        const int selectedNum = (int)selected->size();
+        bool shouldSelect     = true;
+        for (int j = UP_DIV(selectedNum, 4) * 4 - 4; j >= 0 && shouldSelect; j -= 4) {
+            _iouC4(current, 0, selectedBoxes, j, iou);
+            for (int v = 0; v < 4 && j + v < selectedNum; ++v) {
+                if (iou[v] > iouThreshold) {
+                    shouldSelect = false;
+                }
             }
         }
-
         if (shouldSelect) {
-            selected->push_back(nextCandidate.boxIndex);
-            // selectedScores.push_back(nextCandidate.score);
+            selectedBoxes.copy(selectedNum, current, 0);
+            selected->push_back(candidates[i]);
         }
     }
 }
 
+void NonMaxSuppressionSingleClasssImpl(const Tensor* decodedBoxes, const float* scores, int maxDetections,
+                                       float iouThreshold, float scoreThreshold, std::vector<int32_t>* selected,
+                                       Backend* backend) {
+    MNN_ASSERT(decodedBoxes->dimensions() == 2);
+    const int numBoxes = decodedBoxes->length(0);
+    MNN_ASSERT(decodedBoxes->length(1) == 4);
+    NonMaxSuppressionImpl(decodedBoxes->host<float>(), scores, numBoxes, maxDetections, iouThreshold, scoreThreshold,
+                          selected, backend);
+}
+
 ErrorCode CPUNonMaxSuppressionV2::onExecute(const std::vector<Tensor*>& inputs, const std::vector<Tensor*>& outputs) {
     std::vector<int> selected;
     const int maxDetections    = inputs[2]->host<int32_t>()[0];
     const float iouThreshold   = inputs[3]->host<float>()[0];
     const float scoreThreshold = std::numeric_limits<float>::lowest();
     const auto scores          = inputs[1]->host<float>();
-    NonMaxSuppressionSingleClasssImpl(inputs[0], scores, maxDetections, iouThreshold, scoreThreshold, &selected);
+    NonMaxSuppressionSingleClasssImpl(inputs[0], scores, maxDetections, iouThreshold, scoreThreshold, &selected,
+                                      backend());
     std::copy_n(selected.begin(), selected.size(), outputs[0]->host<int32_t>());
 
     return NO_ERROR;
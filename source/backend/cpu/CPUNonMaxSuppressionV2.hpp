@@ -13,6 +13,21 @@
 
 namespace MNN {
 
+/**
+ * @brief apply greedy non_max_suppression, candidates are visited by score descending and index ascending
+ * @param boxes, float*, shape is [num_boxes, 4], where 4 represent two corners [y0, x0, y1, x1] in any order
+ * @param scores, float*, length is [num_boxes]
+ * @param numBoxes, int
+ * @param maxDetections, output at most maxDetections boxes
+ * @param iouThreshold: float, a candidate is suppressed if its iou with a selected box is larger than it
+ * @param scoreThreshold: float, only the box whose score is larger than it is candidate
+ * @param selected:std::vector<int32_t>*
+ * @param backend: Backend*, split iou computation among threads for many candidates, nullptr for single thread
+ */
+void NonMaxSuppressionImpl(const float* boxes, const float* scores, int numBoxes, int maxDetections,
+                           float iouThreshold, float scoreThreshold, std::vector<int32_t>* selected,
+                           Backend* backend = nullptr);
+
 /**
  * @brief apply non_max_suppression, output the selected boxes index
  * @param decodedBoxes, Tensor, shape is [num_boxes, 4], where 4 represent [ymin, xmin, ymax, xmax]
@@ -21,8 +36,11 @@ namespace MNN {
  * @param iouThreshold: float
  * @param scoreThreshold: float
  * @param selected:std::vector<int32_t>*
+ * @param backend: Backend*, see NonMaxSuppressionImpl
  */
-void NonMaxSuppressionSingleClasssImpl(const Tensor* decodedBoxes, const float* scores, int maxDetections, float iouThreshold, float scoreThreshold, std::vector<int>* selected);
+void NonMaxSuppressionSingleClasssImpl(const Tensor* decodedBoxes, const float* scores, int maxDetections,
+                                       float iouThreshold, float scoreThreshold, std::vector<int>* selected,
+                                       Backend* backend = nullptr);
 
 
 class CPUNonMaxSuppressionV2 : public Execution {
@@ -9,6 +9,7 @@
 #include "backend/cpu/CPUPermute.hpp"
 #include "backend/cpu/CPUTranspose.hpp"
 #include "backend/cpu/compute/CommonOptFunction.h"
+#include "core/Concurrency.h"
 #include "core/Macro.h"
 #include "core/TensorUtils.hpp"
 
@@ -92,38 +93,46 @@ inputIndex = inputIndex##i + strides[i - 1][var % 4]; \
     PTR_DEFINE(3)
     PTR_DEFINE(4)
     PTR_DEFINE(5)
-    for (int ob = 0, outputIndex = 0, inputIndex = 0; ob < output->length(0); ++ob) {
-        const int inputIndex1 = inputIndex;
-        for (int oz = 0; oz <= outputChannel - 4; oz += 4) {
-            const int inputIndex2 = inputIndex;
-            PTR_BEGIN(od, 3)
-            PTR_BEGIN(oy, 4)
-            PTR_BEGIN(ox, 5)
-            originOutput[outputIndex++] = originInput[inputIndex];
-            originOutput[outputIndex++] = originInput[inputIndex + strides[1][0]];
-            originOutput[outputIndex++] = originInput[inputIndex + strides[1][1]];
-            originOutput[outputIndex++] = originInput[inputIndex + strides[1][2]];
-            PTR_END(ox, 5)
-            PTR_END(oy, 4)
-            PTR_END(od, 3)
-            inputIndex = inputIndex2 + ocTotalStride;
-        }
-        if (outputChannel % 4 != 0) {
-            PTR_BEGIN(od, 3)
-            PTR_BEGIN(oy, 4)
-            PTR_BEGIN(ox, 5)
-            originOutput[outputIndex++] = originInput[inputIndex];
-            for (int oz = 0; oz < outputChannel % 4 - 1; ++oz) {
-                originOutput[outputIndex++] = originInput[inputIndex + strides[1][oz]];
-            }
-            for (int oz = outputChannel % 4; oz < 4; ++oz) {
-                originOutput[outputIndex++] = 0.0f;
+    // Blocks of 4 output channels are split among threads
+    const int plane        = outputLength3 * outputLength4 * outputLength5;
+    const int ocBlocks     = UP_DIV(outputChannel, 4);
+    const int threadNumber = static_cast<CPUBackend *>(backend())->threadNumber();
+    for (int ob = 0, inputIndex1 = 0; ob < output->length(0); ++ob) {
+        MNN_CONCURRENCY_BEGIN(tId, threadNumber) {
+            for (int oc4 = (int)tId; oc4 < ocBlocks; oc4 += threadNumber) {
+                int inputIndex   = inputIndex1 + oc4 * ocTotalStride;
+                int outputIndex  = (ob * ocBlocks + oc4) * plane * 4;
+                const int remain = outputChannel - oc4 * 4;
+                if (remain >= 4) {
+                    PTR_BEGIN(od, 3)
+                    PTR_BEGIN(oy, 4)
+                    PTR_BEGIN(ox, 5)
+                    originOutput[outputIndex++] = originInput[inputIndex];
+                    originOutput[outputIndex++] = originInput[inputIndex + strides[1][0]];
+                    originOutput[outputIndex++] = originInput[inputIndex + strides[1][1]];
+                    originOutput[outputIndex++] = originInput[inputIndex + strides[1][2]];
+                    PTR_END(ox, 5)
+                    PTR_END(oy, 4)
+                    PTR_END(od, 3)
+                } else {
+                    PTR_BEGIN(od, 3)
+                    PTR_BEGIN(oy, 4)
+                    PTR_BEGIN(ox, 5)
+                    originOutput[outputIndex++] = originInput[inputIndex];
+                    for (int oz = 0; oz < remain - 1; ++oz) {
+                        originOutput[outputIndex++] = originInput[inputIndex + strides[1][oz]];
+                    }
+                    for (int oz = remain; oz < 4; ++oz) {
+                        originOutput[outputIndex++] = 0.0f;
+                    }
+                    PTR_END(ox, 5)
+                    PTR_END(oy, 4)
+                    PTR_END(od, 3)
+                }
             }
-            PTR_END(ox, 5)
-            PTR_END(oy, 4)
-            PTR_END(od, 3)
         }
-        inputIndex = inputIndex1 + strides[0][ob % 4];
+        MNN_CONCURRENCY_END();
+        inputIndex1 += strides[0][ob % 4];
     }
 #undef PTR_DEFINE
 #undef PTR_BEGIN
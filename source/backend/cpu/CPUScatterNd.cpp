@@ -8,11 +8,12 @@
 
 #include "backend/cpu/CPUScatterNd.hpp"
 #include "backend/cpu/CPUBackend.hpp"
+#include "core/Concurrency.h"
 
 namespace MNN {
 
 template <typename T>
-void ScatterNdImpl(const Tensor* indices, const Tensor* updates, const Tensor* shape, Tensor* output) {
+ErrorCode ScatterNdImpl(const Tensor* indices, const Tensor* updates, Tensor* output, CPUBackend* bn) {
     const auto indicesPtr      = indices->host<int32_t>();
     const auto updatesPtr      = updates->host<T>();
     auto outputPtr             = output->host<T>();
@@ -31,41 +32,84 @@ void ScatterNdImpl(const Tensor* indices, const Tensor* updates, const Tensor* s
         dimsToCount[i] = remainSize / output->length(i);
         remainSize     = dimsToCount[i];
     }
+    if (0 == indexes || 0 == accNumber) {
+        return NO_ERROR;
+    }
 
+    // Check the indices once and compute the position of rows
+    std::vector<int> positions(indexes);
     for (int i = 0; i < indexes; ++i) {
         int pos = 0;
         for (int j = 0; j < indicesLastDim; ++j) {
             auto curIndex = indicesPtr[i * indicesLastDim + j];
-            MNN_ASSERT(curIndex >= 0 && curIndex < output->length(j));
+            if (curIndex < 0 || curIndex >= output->length(j)) {
+                return INPUT_DATA_ERROR;
+            }
             pos += curIndex * dimsToCount[j];
         }
-        for (int k = 0; k < accNumber; ++k) {
-            outputPtr[pos + k] += updatesPtr[i * accNumber + k];
+        positions[i] = pos;
+    }
+
+    int threadNumber = bn->threadNumber();
+    if ((int64_t)indexes * accNumber * sizeof(T) < 64 * 1024) {
+        threadNumber = 1;
+    }
+    auto backend = [bn]() { return bn; };
+    // Indices may repeat, so every element of output is only added by one thread in order of updates
+    if (1 == threadNumber || accNumber >= threadNumber * 16) {
+        // Split the columns of rows
+        MNN_CONCURRENCY_BEGIN(tId, threadNumber) {
+            const int start = (int)((int64_t)accNumber * tId / threadNumber);
+            const int end   = (int)((int64_t)accNumber * (tId + 1) / threadNumber);
+            for (int i = 0; i < indexes; ++i) {
+                auto dst = outputPtr + positions[i];
+                auto src = updatesPtr + (size_t)i * accNumber;
+                for (int k = start; k < end; ++k) {
+                    dst[k] += src[k];
+                }
+            }
         }
+        MNN_CONCURRENCY_END();
+        return NO_ERROR;
     }
+    // Short rows, split the rows of output
+    const int rows = outputElementSize / accNumber;
+    MNN_CONCURRENCY_BEGIN(tId, threadNumber) {
+        const int start = (int)((int64_t)rows * tId / threadNumber) * accNumber;
+        const int end   = (int)((int64_t)rows * (tId + 1) / threadNumber) * accNumber;
+        for (int i = 0; i < indexes; ++i) {
+            const int pos = positions[i];
+            if (pos < start || pos >= end) {
+                continue;
+            }
+            auto src = updatesPtr + (size_t)i * accNumber;
+            for (int k = 0; k < accNumber; ++k) {
+                outputPtr[pos + k] += src[k];
+            }
+        }
+    }
+    MNN_CONCURRENCY_END();
+    return NO_ERROR;
 }
 
 ErrorCode CPUScatterNd::onExecute(const std::vector<Tensor*>& inputs, const std::vector<Tensor*>& outputs) {
     auto indices         = inputs[0];
     auto updates         = inputs[1];
-    auto shape           = inputs[2];
     auto output          = outputs[0];
     const int outputSize = output->size();
+    auto bn              = static_cast<CPUBackend*>(backend());
 
     auto outputRawPtr = output->host<int8_t>();
     memset(outputRawPtr, 0, outputSize);
 
     auto updatesDataType = updates->getType();
     if (updatesDataType == halide_type_of<int32_t>()) {
-        ScatterNdImpl<int32_t>(indices, updates, shape, output);
+        return ScatterNdImpl<int32_t>(indices, updates, output, bn);
     } else if (updatesDataType == halide_type_of<float>()) {
-        ScatterNdImpl<float>(indices, updates, shape, output);
-    } else {
-        MNN_ERROR("TODO, ScatterNd support data type: %d\n", updatesDataType.code);
-        return NOT_SUPPORT;
+        return ScatterNdImpl<float>(indices, updates, output, bn);
     }
-
-    return NO_ERROR;
+    MNN_ERROR("TODO, ScatterNd support data type: %d\n", updatesDataType.code);
+    return NOT_SUPPORT;
 }
 
 class CPUScatterNdCreator : public CPUBackend::Creator {
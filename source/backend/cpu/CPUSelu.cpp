@@ -9,6 +9,8 @@
 #include "backend/cpu/CPUSelu.hpp"
 #include <math.h>
 #include "backend/cpu/CPUBackend.hpp"
+#include "backend/cpu/compute/CommonOptFunction.h"
+#include "core/Concurrency.h"
 #include "core/Macro.h"
 
 namespace MNN {
@@ -27,13 +29,31 @@ ErrorCode CPUSelu::onExecute(const std::vector<Tensor *> &inputs, const std::vec
     auto ptr        = inputs[0]->host<float>();
     auto outptr     = outputs[0]->host<float>();
     int size        = inputs[0]->size() / sizeof(float);
-    for (int i = 0; i < size; i++) {
-        if (ptr[i] < 0.f) {
-            outptr[i] = scaleAlpha * (::expf(ptr[i]) - 1.f);
-        } else {
-            outptr[i] = mScale * ptr[i];
+    auto schedule   = static_cast<CPUBackend *>(backend())->multiThreadDivide(size);
+    MNN_CONCURRENCY_BEGIN(tId, schedule.second) {
+        int start    = schedule.first * (int)tId;
+        int realSize = schedule.first;
+        if (tId == schedule.second - 1) {
+            realSize = size - start;
+        }
+        // exp is computed by blocks into a buffer, so input and output can be the same
+        const int blockSize = 256;
+        float expBuffer[blockSize];
+        for (int block = 0; block < realSize; block += blockSize) {
+            auto src   = ptr + start + block;
+            auto dst   = outptr + start + block;
+            auto count = ALIMIN(blockSize, realSize - block);
+            MNNMathExp(expBuffer, src, count);
+            for (int i = 0; i < count; i++) {
+                if (src[i] < 0.f) {
+                    dst[i] = scaleAlpha * (expBuffer[i] - 1.f);
+                } else {
+                    dst[i] = mScale * src[i];
+                }
+            }
         }
     }
+    MNN_CONCURRENCY_END();
 
     return NO_ERROR;
 }
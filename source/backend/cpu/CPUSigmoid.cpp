@@ -10,6 +10,7 @@
 #include <math.h>
 #include "backend/cpu/CPUBackend.hpp"
 #include "backend/cpu/compute/CommonOptFunction.h"
+#include "core/Concurrency.h"
 #include "core/Macro.h"
 
 namespace MNN {
@@ -20,10 +21,18 @@ ErrorCode CPUSigmoid::onExecute(const std::vector<Tensor*>& inputs, const std::v
     auto outputData = outputs[0]->host<float>();
 
     const int dataSize = outputs[0]->elementSize();
-    MNNExp(outputData, inputData, dataSize);
-    for (int i = 0; i < dataSize; ++i) {
-        outputData[i] = 1.0f / (1.0f + outputData[i]);
+    auto schedule      = static_cast<CPUBackend*>(backend())->multiThreadDivide(dataSize);
+    MNN_CONCURRENCY_BEGIN(tId, schedule.second) {
+        int start    = schedule.first * (int)tId;
+        int realSize = schedule.first;
+        if (tId == schedule.second - 1) {
+            realSize = dataSize - start;
+        }
+        if (realSize > 0) {
+            MNNMathSigmoid(outputData + start, inputData + start, realSize);
+        }
     }
+    MNN_CONCURRENCY_END();
     return NO_ERROR;
 }
 
@@ -16,7 +16,8 @@ using namespace std;
 
 namespace MNN {
 
-static void _sliceInAxis(const Tensor* inputTensor, const vector<Tensor*>& outputTensors, int axis) {
+static void _sliceInAxis(const Tensor* inputTensor, const vector<Tensor*>& outputTensors, int axis,
+                         const CPUBackend* bn) {
     int outsideSize = 1;
     for (int i = 0; i < axis; ++i) {
         if (i == 1) {
@@ -42,16 +43,14 @@ static void _sliceInAxis(const Tensor* inputTensor, const vector<Tensor*>& outpu
         if (axis > 0) {
             dstOutputStride *= outputTensors[b]->stride(axis - 1) * 4;
         }
-        for (int o = 0; o < outsideSize; ++o) {
-            auto src = srcCurrent + o * inputStride;
-            auto dst = dstCurrent + o * dstOutputStride;
-            ::memcpy(dst, src, length * axisStride);
-        }
+        bn->copyRows((uint8_t*)dstCurrent, dstOutputStride, (const uint8_t*)srcCurrent, inputStride, outsideSize,
+                     length * axisStride);
         currentPos += length;
     }
 }
 
-static void _sliceInAxisTf(const Tensor* inputTensor, const vector<Tensor*>& outputTensors, int axis) {
+static void _sliceInAxisTf(const Tensor* inputTensor, const vector<Tensor*>& outputTensors, int axis,
+                           const CPUBackend* bn) {
     int outsideSize = 1;
     for (int i = 0; i < axis; ++i) {
         outsideSize *= inputTensor->length(i);
@@ -72,50 +71,46 @@ static void _sliceInAxisTf(const Tensor* inputTensor, const vector<Tensor*>& out
         if (axis > 0) {
             dstOutputStride *= outputTensors[b]->stride(axis - 1);
         }
-        for (int o = 0; o < outsideSize; ++o) {
-            auto src = srcCurrent + o * inputStride;
-            auto dst = dstCurrent + o * dstOutputStride;
-            ::memcpy(dst, src, length * axisStride);
-        }
+        bn->copyRows((uint8_t*)dstCurrent, dstOutputStride, (const uint8_t*)srcCurrent, inputStride, outsideSize,
+                     length * axisStride);
         currentPos += length;
     }
 }
 
 static int _sliceChannel(const Tensor* inputTensor, const vector<Tensor*>& outputTensors,
-                         const Tensor* tempInputTensor) {
+                         const Tensor* tempInputTensor, const CPUBackend* bn) {
     MNN_ASSERT(inputTensor->getType().bytes() == sizeof(float));
     auto inputDim        = inputTensor->buffer().dim;
     int height           = std::max(inputDim[2].extent, 1);
     int width            = std::max(inputDim[3].extent, 1);
     int inputPlaneStride = 4 * height * width;
     float* inputOrigin   = (float*)inputTensor->buffer().host;
-    for (int batchIndex = 0; batchIndex < inputTensor->batch(); ++batchIndex) {
-        if (nullptr != tempInputTensor) {
-            float* tempinput = tempInputTensor->host<float>();
-            MNN_ASSERT(nullptr != tempinput);
-            MNNUnpackC4(tempinput, inputTensor->host<float>() + batchIndex * inputTensor->stride(0), width * height,
-                        inputTensor->channel());
-            float* currentinput = tempinput;
-            for (int b = 0; b < outputTensors.size(); b++) {
-                auto outputTensor = outputTensors[b];
-                int size          = outputTensor->width() * outputTensor->height() * outputTensor->channel();
-                MNNPackC4(outputTensor->host<float>() + batchIndex * outputTensor->stride(0), currentinput,
-                          width * height, outputTensor->channel());
-                currentinput += size;
-            }
-            return 0;
-        }
+    if (nullptr == tempInputTensor) {
         int currentPositionZ = 0;
         for (size_t b = 0; b < outputTensors.size(); b++) {
-            auto& outputTensor  = outputTensors[b]->buffer();
-            float* outputOrigin = (float*)outputTensor.host + batchIndex * outputTensor.dim[0].stride;
-            int outputZ         = UP_DIV(outputTensor.dim[1].extent, 4);
-            float* dst = inputOrigin + inputPlaneStride * currentPositionZ + batchIndex * inputTensor->stride(0);
-            float* src = outputOrigin;
-
-            memcpy(src, dst, inputPlaneStride * outputZ * sizeof(float));
+            auto& outputTensor = outputTensors[b]->buffer();
+            int outputZ        = UP_DIV(outputTensor.dim[1].extent, 4);
+            float* src         = inputOrigin + inputPlaneStride * currentPositionZ;
+            bn->copyRows(outputTensor.host, outputTensor.dim[0].stride * sizeof(float), (const uint8_t*)src,
+                         inputTensor->stride(0) * sizeof(float), inputTensor->batch(),
+                         inputPlaneStride * outputZ * sizeof(float));
             currentPositionZ += outputZ;
         }
+        return 0;
+    }
+    float* tempinput = tempInputTensor->host<float>();
+    MNN_ASSERT(nullptr != tempinput);
+    for (int batchIndex = 0; batchIndex < inputTensor->batch(); ++batchIndex) {
+        MNNUnpackC4(tempinput, inputTensor->host<float>() + batchIndex * inputTensor->stride(0), width * height,
+                    inputTensor->channel());
+        float* currentinput = tempinput;
+        for (int b = 0; b < outputTensors.size(); b++) {
+            auto outputTensor = outputTensors[b];
+            int size          = outputTensor->width() * outputTensor->height() * outputTensor->channel();
+            MNNPackC4(outputTensor->host<float>() + batchIndex * outputTensor->stride(0), currentinput,
+                      width * height, outputTensor->channel());
+            currentinput += size;
+        }
     }
     return 0;
 }
@@ -154,15 +149,17 @@ ErrorCode CPUSlice::onResize(const std::vector<Tensor*>& inputs, const std::vect
 
 ErrorCode CPUSlice::onExecute(const std::vector<Tensor*>& inputs, const std::vector<Tensor*>& outputs) {
     auto input = inputs[0];
+    auto bn    = static_cast<CPUBackend*>(backend());
+    // The outputs aliased with input by pipeline are not copied
     const auto tensorFormat = TensorUtils::getDescribe(input)->dimensionFormat;
     if (MNN_DATA_FORMAT_NC4HW4 == tensorFormat) {
         if (mAxis == 1) {
-            _sliceChannel(inputs[0], outputs, mTempInput.get());
+            _sliceChannel(inputs[0], outputs, mTempInput.get(), bn);
             return NO_ERROR;
         }
-        _sliceInAxis(inputs[0], outputs, mAxis);
+        _sliceInAxis(inputs[0], outputs, mAxis, bn);
     } else {
-        _sliceInAxisTf(inputs[0], outputs, mAxis);
+        _sliceInAxisTf(inputs[0], outputs, mAxis, bn);
     }
 
     return NO_ERROR;
@@ -9,6 +9,7 @@
 #include "backend/cpu/CPUSliceTf.hpp"
 #include <cmath>
 #include "backend/cpu/CPUBackend.hpp"
+#include "core/Concurrency.h"
 #include "core/Macro.h"
 
 namespace MNN {
@@ -28,25 +29,39 @@ ErrorCode CPUSliceTf::onExecute(const std::vector<Tensor *> &inputs, const std::
         return NO_ERROR;
     }
 
-    const int numElements = output->elementSize();
-    int r, inputOffset;
-    for (int offset = 0; offset < numElements; offset++) {
-        r           = offset;
-        inputOffset = 0;
-        for (int j = 0, outputCord; j < outputDims; j++) {
-            outputCord = r / output->buffer().dim[j].stride;
-
-            // add the begin_tensor to get the input_cord
-            // reuse output_cord as input_cord
-            outputCord += begin->host<int32_t>()[j];
-
-            // get input offset
-            inputOffset += outputCord * input->buffer().dim[j].stride;
+    // Aliased with input by pipeline, see Pipeline::Unit::prepare
+    auto src = input->host<uint8_t>();
+    auto dst = output->host<uint8_t>();
+    if (dst >= src && dst < src + input->size()) {
+        return NO_ERROR;
+    }
 
-            r = offset % output->buffer().dim[j].stride;
+    // Copy the rows of last axis, which are contiguous in input
+    const int rowSize = output->length(outputDims - 1);
+    if (rowSize <= 0) {
+        return NO_ERROR;
+    }
+    const int rowCount = output->elementSize() / rowSize;
+    auto beginPtr      = begin->host<int32_t>();
+    int threadNumber   = static_cast<CPUBackend*>(backend())->threadNumber();
+    if (output->size() < 64 * 1024) {
+        threadNumber = 1;
+    }
+    MNN_CONCURRENCY_BEGIN(tId, threadNumber) {
+        const int start = (int)((int64_t)rowCount * tId / threadNumber);
+        const int end   = (int)((int64_t)rowCount * (tId + 1) / threadNumber);
+        for (int r = start; r < end; ++r) {
+            int index       = r;
+            int inputOffset = beginPtr[outputDims - 1] * input->stride(outputDims - 1);
+            for (int j = outputDims - 2; j >= 0; --j) {
+                inputOffset += (index % output->length(j) + beginPtr[j]) * input->stride(j);
+                index /= output->length(j);
+            }
+            ::memcpy(output->host<int32_t>() + r * rowSize, input->host<int32_t>() + inputOffset,
+                     rowSize * sizeof(int32_t));
         }
-        output->host<int32_t>()[offset] = input->host<int32_t>()[inputOffset];
     }
+    MNN_CONCURRENCY_END();
 
     return NO_ERROR;
 }
@@ -10,6 +10,7 @@
 #include <math.h>
 #include "backend/cpu/compute/CommonOptFunction.h"
 #include "backend/cpu/CPUBackend.hpp"
+#include "core/Concurrency.h"
 #include "core/Macro.h"
 
 namespace MNN {
@@ -21,7 +22,18 @@ ErrorCode CPUTanh::onExecute(const std::vector<Tensor *> &inputs, const std::vec
     auto outputData = outputs[0]->host<float>();
 
     const int dataSize = outputs[0]->elementSize();
-    MNNTanh(outputData, inputData, dataSize);
+    auto schedule      = static_cast<CPUBackend *>(backend())->multiThreadDivide(dataSize);
+    MNN_CONCURRENCY_BEGIN(tId, schedule.second) {
+        int start    = schedule.first * (int)tId;
+        int realSize = schedule.first;
+        if (tId == schedule.second - 1) {
+            realSize = dataSize - start;
+        }
+        if (realSize > 0) {
+            MNNTanh(outputData + start, inputData + start, realSize);
+        }
+    }
+    MNN_CONCURRENCY_END();
     return NO_ERROR;
 }
 
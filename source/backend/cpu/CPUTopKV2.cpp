@@ -7,81 +7,142 @@
 //
 
 #include "backend/cpu/CPUTopKV2.hpp"
+#include <algorithm>
+#include <vector>
 #include "backend/cpu/CPUBackend.hpp"
+#include "core/Concurrency.h"
 #include "core/Macro.h"
+#include "math/Vec4.hpp"
 
 namespace MNN {
 
+// Values are compared by block to skip the block that can't enter the top k
+#define TOPK_BLOCK 16
+
 template <typename T>
-class TopContainer {
-public:
-    TopContainer() = delete;
-    TopContainer(int32_t k, int32_t rowSize) : mK(k) {
-        mContainer.reserve(std::min(k, rowSize) + 1);
+static inline T _blockMax(const T* values) {
+    T result = values[0];
+    for (int i = 1; i < TOPK_BLOCK; ++i) {
+        result = std::max(result, values[i]);
     }
+    return result;
+}
 
-    void startCollecting(const T* values) {
-        mValues = values;
-        mContainer.clear();
-    }
-    void push(int32_t a) {
-        auto comparator = [this](int32_t a, int32_t b) { return compareFunc(a, b); };
-        if (mContainer.size() <= mK) {
-            mContainer.push_back(a);
-            if (mContainer.size() == mK + 1) {
-                std::make_heap(mContainer.begin(), mContainer.end(), comparator);
-                std::pop_heap(mContainer.begin(), mContainer.end(), comparator);
-            }
-        } else if (comparator(a, mContainer.front())) {
-            mContainer.back() = a;
-            std::push_heap(mContainer.begin(), mContainer.end(), comparator);
-            std::pop_heap(mContainer.begin(), mContainer.end(), comparator);
-        }
-    }
+template <>
+inline float _blockMax<float>(const float* values) {
+    using Math::Vec4;
+    auto m0 = Vec4::max(Vec4::load(values), Vec4::load(values + 4));
+    auto m1 = Vec4::max(Vec4::load(values + 8), Vec4::load(values + 12));
+    auto m  = Vec4::max(m0, m1);
+    return std::max(std::max(m[0], m[1]), std::max(m[2], m[3]));
+}
 
-    const std::vector<int32_t>& sortedResult() {
-        auto comparator = [this](int32_t a, int32_t b) { return compareFunc(a, b); };
-        if (mContainer.size() <= mK) {
-            std::sort(mContainer.begin(), mContainer.end(), comparator);
-        } else {
-            std::sort_heap(mContainer.begin(), mContainer.end() - 1, comparator);
-            mContainer.resize(mK);
+// Larger value first, smaller index first for the same value
+template <typename T>
+struct TopKCompare {
+    const T* values;
+    bool operator()(int32_t a, int32_t b) const {
+        if (values[a] != values[b]) {
+            return values[a] > values[b];
         }
-        return mContainer;
+        return a < b;
     }
+};
 
-private:
-    int32_t mK;
-    std::vector<int32_t> mContainer;
-    const T* mValues = nullptr;
-
-    bool compareFunc(int32_t a, int32_t b) const {
-        if (mValues[b] < mValues[a]) {
-            return true;
-        } else if (mValues[b] > mValues[a]) {
-            return false;
-        } else {
-            return a < b;
-        }
+// Keep the top k of candidates and sort them
+template <typename T>
+static void _sortTopK(const T* values, std::vector<int32_t>& candidates, int k) {
+    TopKCompare<T> compare = {values};
+    if ((int)candidates.size() > k) {
+        std::nth_element(candidates.begin(), candidates.begin() + k - 1, candidates.end(), compare);
+        candidates.resize(k);
     }
-};
+    std::sort(candidates.begin(), candidates.end(), compare);
+}
 
+// Sorted indexes of the top k values in [begin, end). Once k candidates are collected, the k-th value is used as
+// threshold: an element after them enters only if it is larger, as the tie is broken by index. The candidates are
+// reduced to k by partial selection when they reach the capacity.
 template <typename T>
-void findTopK(int32_t rowSize, int32_t numRows, const T* data, int32_t k, int32_t* outputIndexes, T* outputValues) {
-    TopContainer<T> topc(k, rowSize);
-    for (int row = 0; row < numRows; row++) {
-        const T* valuesRow = data + row * rowSize;
-        topc.startCollecting(valuesRow);
-        for (int c = 0; c < rowSize; c++) {
-            topc.push(c);
+static void _selectTopK(const T* values, int begin, int end, int k, std::vector<int32_t>& candidates) {
+    TopKCompare<T> compare = {values};
+    const int capacity     = std::max(2 * k, k + 1024);
+    candidates.clear();
+    candidates.reserve(capacity + TOPK_BLOCK);
+    int i = begin;
+    for (; i < end && (int)candidates.size() < k; ++i) {
+        candidates.emplace_back(i);
+    }
+    if (i < end) {
+        std::nth_element(candidates.begin(), candidates.begin() + k - 1, candidates.end(), compare);
+        T threshold = values[candidates[k - 1]];
+        while (i < end) {
+            if (i + TOPK_BLOCK <= end && !(_blockMax(values + i) > threshold)) {
+                i += TOPK_BLOCK;
+                continue;
+            }
+            const int blockEnd = std::min(i + TOPK_BLOCK, end);
+            for (; i < blockEnd; ++i) {
+                if (values[i] > threshold) {
+                    candidates.emplace_back(i);
+                }
+            }
+            if ((int)candidates.size() >= capacity) {
+                std::nth_element(candidates.begin(), candidates.begin() + k - 1, candidates.end(), compare);
+                candidates.resize(k);
+                threshold = values[candidates[k - 1]];
+            }
         }
+    }
+    _sortTopK(values, candidates, k);
+}
 
+template <typename T>
+static void _findTopK(int32_t rowSize, int32_t numRows, const T* data, int32_t k, int32_t* outputIndexes,
+                      T* outputValues, Backend* bn) {
+    auto backend           = [bn]() { return bn; };
+    const int threadNumber = static_cast<CPUBackend*>(bn)->threadNumber();
+    auto output = [&](int row, const std::vector<int32_t>& topK) {
+        const T* valuesRow  = data + row * rowSize;
         int32_t* indexesRow = outputIndexes + row * k;
         T* ouputRow         = outputValues + row * k;
-
-        const auto& topK = topc.sortedResult();
-        std::copy(topK.begin(), topK.end(), indexesRow);
-        std::transform(topK.begin(), topK.end(), ouputRow, [valuesRow](const int32_t loc) { return valuesRow[loc]; });
+        for (int i = 0; i < k; ++i) {
+            indexesRow[i] = topK[i];
+            ouputRow[i]   = valuesRow[topK[i]];
+        }
+    };
+    // Split the row among threads if there are not enough rows
+    if (numRows >= threadNumber || rowSize < 16384 || rowSize < 8 * k) {
+        MNN_CONCURRENCY_BEGIN(tId, threadNumber) {
+            std::vector<int32_t> candidates;
+            for (int row = (int)tId; row < numRows; row += threadNumber) {
+                _selectTopK(data + row * rowSize, 0, rowSize, k, candidates);
+                output(row, candidates);
+            }
+        }
+        MNN_CONCURRENCY_END();
+        return;
+    }
+    std::vector<std::vector<int32_t>> segmentResults(threadNumber);
+    const int segmentSize = UP_DIV(rowSize, threadNumber);
+    std::vector<int32_t> merged;
+    for (int row = 0; row < numRows; ++row) {
+        const T* valuesRow = data + row * rowSize;
+        MNN_CONCURRENCY_BEGIN(tId, threadNumber) {
+            auto start = (int)tId * segmentSize;
+            auto end   = std::min(start + segmentSize, rowSize);
+            segmentResults[tId].clear();
+            if (start < end) {
+                _selectTopK(valuesRow, start, end, std::min(k, end - start), segmentResults[tId]);
+            }
+        }
+        MNN_CONCURRENCY_END();
+        merged.clear();
+        for (auto& r : segmentResults) {
+            merged.insert(merged.end(), r.begin(), r.end());
+        }
+        _sortTopK(valuesRow, merged, k);
+        output(row, merged);
     }
 }
 
@@ -99,17 +160,20 @@ ErrorCode CPUTopKV2::onExecute(const std::vector<Tensor*>& inputs, const std::ve
 
     const int rowSize = inputTensor->buffer().dim[inputDimension - 1].extent;
     MNN_ASSERT(k <= rowSize);
+    if (k <= 0 || inputTensor->elementSize() <= 0) {
+        return NO_ERROR;
+    }
     const int numRows = inputTensor->elementSize() / rowSize;
     if (halide_type_float == inputTensor->getType().code) {
         auto inputData   = inputTensor->host<float>();
         auto topkData    = outputData->host<float>();
         int* indicesData = outputIndices->host<int32_t>();
-        findTopK<float>(rowSize, numRows, inputData, k, indicesData, topkData);
+        _findTopK<float>(rowSize, numRows, inputData, k, indicesData, topkData, backend());
     } else if(halide_type_int == inputTensor->getType().code && 32 == inputTensor->getType().bits) {
         auto inputData   = inputTensor->host<int32_t>();
         auto topkData    = outputData->host<int32_t>();
         int* indicesData = outputIndices->host<int32_t>();
-        findTopK<int32_t>(rowSize, numRows, inputData, k, indicesData, topkData);
+        _findTopK<int32_t>(rowSize, numRows, inputData, k, indicesData, topkData, backend());
     } else {
         MNN_PRINT("TODO\n");
         MNN_ASSERT(false);
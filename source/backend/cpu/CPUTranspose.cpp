@@ -7,8 +7,11 @@
 //
 
 #include "backend/cpu/CPUTranspose.hpp"
+#include <string.h>
 #include "backend/cpu/CPUBackend.hpp"
+#include "core/Concurrency.h"
 #include "core/Macro.h"
+#include "math/Vec4.hpp"
 
 namespace MNN {
 
@@ -16,155 +19,276 @@ CPUTranspose::CPUTranspose(Backend* backend, DataType dataType) : Execution(back
     permDateType = dataType;
 }
 
-inline bool NonSingletonDimensionsAlign(const Tensor* input, const std::vector<int32_t>& permutation) {
-    int lastNonsingletonPermDim = -1;
-    for (int permDim : permutation) {
-        if (input->buffer().dim[permDim].extent == 1) {
-            continue;
+// Iterate the offsets of input and output over some axes in row major order
+class OffsetIterator {
+public:
+    OffsetIterator(const std::vector<int>& dims, const std::vector<int>& srcStride, const std::vector<int>& dstStride,
+                   int index)
+        : mDims(dims), mSrcStride(srcStride), mDstStride(dstStride), mIndex(dims.size()) {
+        for (int i = (int)dims.size() - 1; i >= 0; --i) {
+            mIndex[i] = index % dims[i];
+            index     = index / dims[i];
+            src += mIndex[i] * srcStride[i];
+            dst += mIndex[i] * dstStride[i];
+        }
+    }
+    void next() {
+        for (int i = (int)mDims.size() - 1; i >= 0; --i) {
+            mIndex[i]++;
+            src += mSrcStride[i];
+            dst += mDstStride[i];
+            if (mIndex[i] < mDims[i]) {
+                return;
+            }
+            src -= mIndex[i] * mSrcStride[i];
+            dst -= mIndex[i] * mDstStride[i];
+            mIndex[i] = 0;
         }
-        if (permDim < lastNonsingletonPermDim) {
-            return false;
+    }
+    int src = 0;
+    int dst = 0;
+
+private:
+    const std::vector<int>& mDims;
+    const std::vector<int>& mSrcStride;
+    const std::vector<int>& mDstStride;
+    std::vector<int> mIndex;
+};
+
+// dst[y * dstStride + x] = src[x * srcStride + y] for y < h and x < w, visited by tiles fit in L1 cache
+template <typename T>
+static void _transposeBlock(void* dstPtr, const void* srcPtr, int h, int w, int srcStride, int dstStride) {
+    auto dst       = (T*)dstPtr;
+    auto src       = (const T*)srcPtr;
+    const int tile = 64 / sizeof(T) * 4;
+    for (int y0 = 0; y0 < h; y0 += tile) {
+        const int ye = std::min(y0 + tile, h);
+        for (int x0 = 0; x0 < w; x0 += tile) {
+            const int xe = std::min(x0 + tile, w);
+            for (int y = y0; y < ye; ++y) {
+                for (int x = x0; x < xe; ++x) {
+                    dst[y * dstStride + x] = src[x * srcStride + y];
+                }
+            }
         }
-        lastNonsingletonPermDim = permDim;
     }
-    return true;
 }
-ErrorCode CPUTranspose::onExecute(const std::vector<Tensor*>& inputs, const std::vector<Tensor*>& outputs) {
+
+// 4 bytes types are moved as float, 4 x 4 blocks are transposed in registers
+template <>
+void _transposeBlock<float>(void* dstPtr, const void* srcPtr, int h, int w, int srcStride, int dstStride) {
+    using Math::Vec4;
+    auto dst       = (float*)dstPtr;
+    auto src       = (const float*)srcPtr;
+    const int tile = 32;
+    for (int y0 = 0; y0 < h; y0 += tile) {
+        const int ye = std::min(y0 + tile, h);
+        for (int x0 = 0; x0 < w; x0 += tile) {
+            const int xe = std::min(x0 + tile, w);
+            int y        = y0;
+            for (; y + 3 < ye; y += 4) {
+                int x = x0;
+                for (; x + 3 < xe; x += 4) {
+                    auto s  = src + x * srcStride + y;
+                    auto v0 = Vec4::load(s);
+                    auto v1 = Vec4::load(s + srcStride);
+                    auto v2 = Vec4::load(s + 2 * srcStride);
+                    auto v3 = Vec4::load(s + 3 * srcStride);
+                    Vec4::transpose4(v0, v1, v2, v3);
+                    auto d = dst + y * dstStride + x;
+                    Vec4::save(d, v0);
+                    Vec4::save(d + dstStride, v1);
+                    Vec4::save(d + 2 * dstStride, v2);
+                    Vec4::save(d + 3 * dstStride, v3);
+                }
+                for (; x < xe; ++x) {
+                    for (int k = 0; k < 4; ++k) {
+                        dst[(y + k) * dstStride + x] = src[x * srcStride + y + k];
+                    }
+                }
+            }
+            for (; y < ye; ++y) {
+                for (int x = x0; x < xe; ++x) {
+                    dst[y * dstStride + x] = src[x * srcStride + y];
+                }
+            }
+        }
+    }
+}
+
+typedef void (*TransposeBlockProc)(void* dst, const void* src, int h, int w, int srcStride, int dstStride);
+static TransposeBlockProc _selectTransposeBlock(int bytes) {
+    switch (bytes) {
+        case 1:
+            return _transposeBlock<uint8_t>;
+        case 2:
+            return _transposeBlock<uint16_t>;
+        case 4:
+            return _transposeBlock<float>;
+        case 8:
+            return _transposeBlock<uint64_t>;
+        default:
+            break;
+    }
+    return nullptr;
+}
+
+ErrorCode CPUTranspose::onResize(const std::vector<Tensor*>& inputs, const std::vector<Tensor*>& outputs) {
     const Tensor* input = inputs[0];
     const Tensor* perm  = inputs[1];
-    auto output         = outputs[0];
     const int dims      = input->buffer().dimensions;
     MNN_ASSERT(dims == perm->buffer().dim[0].extent);
-
-    std::vector<int32_t> permutation;
-    for (int i = 0; i < perm->buffer().dim[0].extent; i++) {
-        permutation.push_back(perm->host<int32_t>()[i]);
+    mBytes = input->getType().bytes();
+    if (nullptr == _selectTransposeBlock(mBytes)) {
+        MNN_ERROR("Transpose don't support %d bytes type\n", mBytes);
+        return NOT_SUPPORT;
     }
 
-    std::vector<int32_t> shape;
-    shape.resize(dims);
-
-    bool isIdentity = true;
-
+    std::vector<int> inputStride(dims);
+    for (int i = dims - 1, stride = 1; i >= 0; --i) {
+        inputStride[i] = stride;
+        stride *= input->length(i);
+    }
+    mDims.clear();
+    mSrcStride.clear();
     std::vector<bool> bits(dims);
     for (int i = 0; i < dims; ++i) {
-        const int32_t d = permutation[i];
+        const int32_t d = perm->host<int32_t>()[i];
         MNN_ASSERT(0 <= d && d < dims);
-        bits[d]            = true;
-        const auto dimSize = input->buffer().dim[d].extent;
-        shape.push_back(dimSize);
-        if (d != i) {
-            isIdentity = false;
+        bits[d]          = true;
+        const int extent = input->length(d);
+        if (extent == 1) {
+            continue;
         }
+        // The axis follows the previous one in input too, merge them
+        if (!mDims.empty() && mSrcStride.back() == extent * inputStride[d]) {
+            mDims.back() *= extent;
+            mSrcStride.back() = inputStride[d];
+            continue;
+        }
+        mDims.emplace_back(extent);
+        mSrcStride.emplace_back(inputStride[d]);
     }
-
     for (int i = 0; i < dims; ++i) {
         MNN_ASSERT(bits[i]);
     }
+    if (mDims.empty()) {
+        mDims      = {1};
+        mSrcStride = {1};
+    }
+    mInnerAxis = -1;
+    if (mSrcStride.back() != 1) {
+        for (int i = 0; i < mDims.size(); ++i) {
+            if (mSrcStride[i] == 1) {
+                mInnerAxis = i;
+            }
+        }
+    }
+    return NO_ERROR;
+}
 
-    const auto src = input->host<float>();
-    float* dst         = output->host<float>();
-
-    if ((dims <= 1 || isIdentity)) {
-        memcpy(dst, src, input->size());
-        return NO_ERROR;
-    } else if (NonSingletonDimensionsAlign(input, permutation)) {
-        memcpy(dst, src, input->size());
+ErrorCode CPUTranspose::onExecute(const std::vector<Tensor*>& inputs, const std::vector<Tensor*>& outputs) {
+    const auto src  = inputs[0]->host<uint8_t>();
+    auto dst        = outputs[0]->host<uint8_t>();
+    const int bytes = mBytes;
+    const int dims  = (int)mDims.size();
+    int total       = 1;
+    for (auto d : mDims) {
+        total *= d;
+    }
+    if (total <= 0) {
         return NO_ERROR;
     }
+    // Small tensors are not worth to split
+    int threadNumber = static_cast<CPUBackend*>(backend())->threadNumber();
+    if (total * bytes < 64 * 1024) {
+        threadNumber = 1;
+    }
+    std::vector<int> dstStride(dims);
+    for (int i = dims - 1, stride = 1; i >= 0; --i) {
+        dstStride[i] = stride;
+        stride *= mDims[i];
+    }
 
-    if (2 == dims) {
-        MNN_ASSERT(permutation.size() == 2);
-        const int stride0 = input->stride(permutation[0]);
-        const int stride1 = input->stride(permutation[1]);
-        const int output0 = output->length(0);
-        const int output1 = output->length(1);
-        for (int i = 0; i < output0; i++) {
-            for (int j = 0; j < output1; j++) {
-                dst[i * output1 + j] = src[i * stride0 + j * stride1];
+    // The order is not changed, just copy
+    if (1 == dims) {
+        const int size  = total * bytes;
+        const int chunk = UP_DIV(size, threadNumber);
+        MNN_CONCURRENCY_BEGIN(tId, threadNumber) {
+            const int start = (int)tId * chunk;
+            if (start < size) {
+                ::memcpy(dst + start, src + start, std::min(chunk, size - start));
             }
         }
-    } else if (3 == dims) {
-        MNN_ASSERT(permutation.size() == 3);
-        const int stride0 = input->stride(permutation[0]);
-        const int stride1 = input->stride(permutation[1]);
-        const int stride2 = input->stride(permutation[2]);
-
-        const int output0    = output->length(0);
-        const int output1    = output->length(1);
-        const int output2    = output->length(2);
-        const int outStride0 = output->stride(0);
-        const int outStride1 = output->stride(1);
-
-        for (int i = 0; i < output0; i++) {
-            for (int j = 0; j < output1; j++) {
-                for (int k = 0; k < output2; k++) {
-                    dst[i * outStride0 + j * outStride1 + k] = src[i * stride0 + j * stride1 + k * stride2];
-                }
+        MNN_CONCURRENCY_END();
+        return NO_ERROR;
+    }
+
+    // The last axis is contiguous in input, copy the rows
+    if (mInnerAxis < 0) {
+        const int rowSize  = mDims[dims - 1];
+        const int rowCount = total / rowSize;
+        std::vector<int> outerDims(mDims.begin(), mDims.end() - 1);
+        std::vector<int> outerSrc(mSrcStride.begin(), mSrcStride.end() - 1);
+        std::vector<int> outerDst(dstStride.begin(), dstStride.end() - 1);
+        MNN_CONCURRENCY_BEGIN(tId, threadNumber) {
+            const int start = (int)((int64_t)rowCount * tId / threadNumber);
+            const int end   = (int)((int64_t)rowCount * (tId + 1) / threadNumber);
+            OffsetIterator iter(outerDims, outerSrc, outerDst, start);
+            for (int i = start; i < end; ++i) {
+                ::memcpy(dst + iter.dst * bytes, src + iter.src * bytes, rowSize * bytes);
+                iter.next();
             }
         }
+        MNN_CONCURRENCY_END();
+        return NO_ERROR;
+    }
 
-    } else if (4 == dims) {
-        MNN_ASSERT(permutation.size() == 4);
-
-        const int stride0 = input->stride(permutation[0]);
-        const int stride1 = input->stride(permutation[1]);
-        const int stride2 = input->stride(permutation[2]);
-        const int stride3 = input->stride(permutation[3]);
-
-        const int output0    = output->length(0);
-        const int output1    = output->length(1);
-        const int output2    = output->length(2);
-        const int output3    = output->length(3);
-        const int outStride0 = output->stride(0);
-        const int outStride1 = output->stride(1);
-        const int outStride2 = output->stride(2);
-
-        for (int i = 0; i < output0; i++) {
-            for (int j = 0; j < output1; j++) {
-                for (int k = 0; k < output2; k++) {
-                    for (int m = 0; m < output3; m++) {
-                        dst[i * outStride0 + j * outStride1 + k * outStride2 + m] =
-                            src[i * stride0 + j * stride1 + k * stride2 + m * stride3];
-                    }
-                }
+    // Transpose the blocks of [mInnerAxis, last axis]
+    const int h         = mDims[mInnerAxis];
+    const int w         = mDims[dims - 1];
+    const int srcLd     = mSrcStride[dims - 1];
+    const int dstLd     = dstStride[mInnerAxis];
+    const int blockSize = h * w;
+    const int outer     = total / blockSize;
+    auto transposeBlock = _selectTransposeBlock(bytes);
+    std::vector<int> outerDims, outerSrc, outerDst;
+    for (int i = 0; i < dims - 1; ++i) {
+        if (i != mInnerAxis) {
+            outerDims.emplace_back(mDims[i]);
+            outerSrc.emplace_back(mSrcStride[i]);
+            outerDst.emplace_back(dstStride[i]);
+        }
+    }
+    if (outer >= threadNumber) {
+        MNN_CONCURRENCY_BEGIN(tId, threadNumber) {
+            const int start = (int)((int64_t)outer * tId / threadNumber);
+            const int end   = (int)((int64_t)outer * (tId + 1) / threadNumber);
+            OffsetIterator iter(outerDims, outerSrc, outerDst, start);
+            for (int i = start; i < end; ++i) {
+                transposeBlock(dst + iter.dst * bytes, src + iter.src * bytes, h, w, srcLd, dstLd);
+                iter.next();
             }
         }
-    } else if (5 == dims) {
-        MNN_ASSERT(permutation.size() == 5);
-        const int stride0 = input->stride(permutation[0]);
-        const int stride1 = input->stride(permutation[1]);
-        const int stride2 = input->stride(permutation[2]);
-        const int stride3 = input->stride(permutation[3]);
-        const int stride4 = input->stride(permutation[4]);
-
-        const int output0    = output->length(0);
-        const int output1    = output->length(1);
-        const int output2    = output->length(2);
-        const int output3    = output->length(3);
-        const int output4    = output->length(4);
-        const int outStride0 = output->stride(0);
-        const int outStride1 = output->stride(1);
-        const int outStride2 = output->stride(2);
-        const int outStride3 = output->stride(3);
-
-        for (int i = 0; i < output0; i++) {
-            for (int j = 0; j < output1; j++) {
-                for (int k = 0; k < output2; k++) {
-                    for (int m = 0; m < output3; m++) {
-                        for (int n = 0; n < output4; n++) {
-                            dst[i * outStride0 + j * outStride1 + k * outStride2 + m * outStride3 + n] =
-                                src[i * stride0 + j * stride1 + k * stride2 + m * stride3 + n * stride4];
-                        }
-                    }
-                }
+        MNN_CONCURRENCY_END();
+        return NO_ERROR;
+    }
+    // Few blocks, split the rows of output among threads
+    const int hStep = UP_DIV(UP_DIV(h, threadNumber), 4) * 4;
+    OffsetIterator iter(outerDims, outerSrc, outerDst, 0);
+    for (int i = 0; i < outer; ++i) {
+        auto blockSrc = src + iter.src * bytes;
+        auto blockDst = dst + iter.dst * bytes;
+        MNN_CONCURRENCY_BEGIN(tId, threadNumber) {
+            const int y0 = (int)tId * hStep;
+            if (y0 < h) {
+                transposeBlock(blockDst + y0 * dstLd * bytes, blockSrc + y0 * bytes, std::min(hStep, h - y0), w,
+                               srcLd, dstLd);
             }
         }
-    } else {
-        MNN_PRINT("Transpose Only Support dimension <= 5!\n");
-        MNN_ASSERT(false);
+        MNN_CONCURRENCY_END();
+        iter.next();
     }
-
     return NO_ERROR;
 }
 
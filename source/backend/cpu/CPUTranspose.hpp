@@ -18,10 +18,18 @@ class CPUTranspose : public Execution {
 public:
     CPUTranspose(Backend *backend, DataType dataType);
     virtual ~CPUTranspose() = default;
+    virtual ErrorCode onResize(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs) override;
     virtual ErrorCode onExecute(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs) override;
 
 private:
     DataType permDateType;
+    // The permutation after removing the axes of extent 1 and merging the axes adjacent in both input and output,
+    // mDims is the extents in output order and mSrcStride is the input stride of them
+    std::vector<int> mDims;
+    std::vector<int> mSrcStride;
+    // The output axis read contiguously from input, -1 if the last output axis is contiguous in input
+    int mInnerAxis = -1;
+    int mBytes     = 4;
 };
 
 } // namespace MNN
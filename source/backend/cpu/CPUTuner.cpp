@@ -0,0 +1,231 @@
+//
+//  CPUTuner.cpp
+//  MNN
+//
+//  Created by MNN on 2020/05/02.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include "backend/cpu/CPUTuner.hpp"
+#include <float.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <memory>
+#include <MNN/AutoTime.hpp>
+#include "backend/cpu/CPUBackend.hpp"
+#include "core/Macro.h"
+#include "core/TensorUtils.hpp"
+#ifdef MNN_USE_SSE
+#include "backend/cpu/x86_x64/cpu_id.h"
+#endif
+
+// Measure candidate at most this number of times, or until it has run for the time in us
+#define MNN_TUNE_MAX_RUN 10
+#define MNN_TUNE_MAX_TIME 20000
+
+namespace MNN {
+CPUTuner* CPUTuner::get() {
+    static CPUTuner gTuner;
+    return &gTuner;
+}
+
+const std::string& CPUTuner::cpuId() {
+    static std::string gId;
+    static std::once_flag gFlag;
+    std::call_once(gFlag, []() {
+        std::string id;
+#ifdef MNN_USE_SSE
+        int info[4];
+        libyuv::CpuId(0x80000000, 0, info);
+        if ((unsigned int)info[0] >= 0x80000004) {
+            char brand[49];
+            for (int i = 0; i < 3; ++i) {
+                libyuv::CpuId(0x80000002 + i, 0, info);
+                ::memcpy(brand + 16 * i, info, 16);
+            }
+            brand[48] = 0;
+            id        = brand;
+        }
+#else
+        // Hardware is the soc on android, CPU part is the core type of arm
+        auto file = fopen("/proc/cpuinfo", "r");
+        if (nullptr != file) {
+            char line[256];
+            std::string part;
+            while (nullptr != fgets(line, sizeof(line), file)) {
+                auto value = strchr(line, ':');
+                if (nullptr == value) {
+                    continue;
+                }
+                if (id.empty() && (0 == strncmp(line, "Hardware", 8) || 0 == strncmp(line, "model name", 10))) {
+                    id = value + 1;
+                } else if (part.empty() && 0 == strncmp(line, "CPU part", 8)) {
+                    part = value + 1;
+                }
+            }
+            fclose(file);
+            id += part;
+        }
+#endif
+        for (auto c : id) {
+            bool valid = (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '-';
+            if (valid) {
+                gId.push_back(c);
+            } else if (!gId.empty() && gId.back() != '_') {
+                gId.push_back('_');
+            }
+        }
+        while (!gId.empty() && gId.back() == '_') {
+            gId.pop_back();
+        }
+        if (gId.empty()) {
+            gId = "unknown";
+        }
+    });
+    return gId;
+}
+
+float CPUTuner::_measure(Execution* execution, const std::vector<Tensor*>& inputs, const std::vector<Tensor*>& outputs,
+                         Backend* backend) {
+    if (!execution->valid()) {
+        return FLT_MAX;
+    }
+    backend->onResizeBegin();
+    auto code = execution->onResize(inputs, outputs);
+    backend->onResizeEnd();
+    if (NO_ERROR != code) {
+        return FLT_MAX;
+    }
+    backend->onExecuteBegin();
+    // The first run warms up cache and memory
+    code           = execution->onExecute(inputs, outputs);
+    float minTime  = FLT_MAX;
+    uint64_t total = 0;
+    for (int i = 0; i < MNN_TUNE_MAX_RUN && NO_ERROR == code && total < MNN_TUNE_MAX_TIME; ++i) {
+        Timer timer;
+        code      = execution->onExecute(inputs, outputs);
+        auto cost = timer.durationInUs();
+        total += cost;
+        minTime = std::min(minTime, (float)cost);
+    }
+    backend->onExecuteEnd();
+    if (NO_ERROR != code) {
+        return FLT_MAX;
+    }
+    return minTime;
+}
+
+int CPUTuner::choose(const std::string& key, int number, const Creator& creator, const std::vector<Tensor*>& inputs,
+                     const std::vector<Tensor*>& outputs, const CPUBackend* backend) {
+    if (number <= 1) {
+        return 0;
+    }
+    auto fullKey = key + ";thread=" + std::to_string(backend->threadNumber()) + ";cpu=" + cpuId();
+    {
+        std::lock_guard<std::mutex> _l(mLock);
+        auto iter = mResults.find(fullKey);
+        if (iter != mResults.end() && iter->second < number) {
+            return iter->second;
+        }
+    }
+
+    // Measure on a backend of the same config, so that memory of the session is not touched
+    CPUBackend measureBackend(backend->threadNumber(), backend->memoryMode(), backend->powerMode());
+    std::vector<std::shared_ptr<Tensor>> tensors;
+    auto copyTensors = [&](const std::vector<Tensor*>& srcs, std::vector<Tensor*>& dsts) {
+        for (auto t : srcs) {
+            std::shared_ptr<Tensor> copy(new Tensor(t->dimensions()));
+            TensorUtils::copyShape(t, copy.get(), true);
+            TensorUtils::setLinearLayout(copy.get());
+            copy->buffer().type = t->getType();
+            if (copy->elementSize() <= 0 || !measureBackend.onAcquireBuffer(copy.get(), Backend::STATIC)) {
+                return false;
+            }
+            if (copy->getType() == halide_type_of<float>()) {
+                auto size = copy->size() / sizeof(float);
+                for (int i = 0; i < size; ++i) {
+                    copy->host<float>()[i] = (float)(i % 17 - 8) / 8.0f;
+                }
+            } else {
+                ::memset(copy->host<void>(), 0, copy->size());
+            }
+            tensors.emplace_back(copy);
+            dsts.emplace_back(copy.get());
+        }
+        return true;
+    };
+    std::vector<Tensor*> measureInputs, measureOutputs;
+    if (!copyTensors(inputs, measureInputs) || !copyTensors(outputs, measureOutputs)) {
+        return 0;
+    }
+    int best       = 0;
+    float bestTime = FLT_MAX;
+    for (int i = 0; i < number; ++i) {
+        std::unique_ptr<Execution> execution(creator(&measureBackend, i));
+        if (nullptr == execution) {
+            continue;
+        }
+        auto time = _measure(execution.get(), measureInputs, measureOutputs, &measureBackend);
+        if (time < bestTime) {
+            bestTime = time;
+            best     = i;
+        }
+    }
+    std::lock_guard<std::mutex> _l(mLock);
+    mResults[fullKey] = best;
+    mDirty            = true;
+    return best;
+}
+
+void CPUTuner::setCacheFile(const std::string& path) {
+    std::lock_guard<std::mutex> _l(mLock);
+    if (path == mCacheFile) {
+        return;
+    }
+    mCacheFile = path;
+    if (path.empty()) {
+        return;
+    }
+    auto file = fopen(path.c_str(), "r");
+    if (nullptr == file) {
+        // Created on save
+        mDirty = !mResults.empty();
+        return;
+    }
+    // Each line is key and index of the winner separated by space
+    char line[1024];
+    while (nullptr != fgets(line, sizeof(line), file)) {
+        auto split = strrchr(line, ' ');
+        if (nullptr == split) {
+            continue;
+        }
+        mResults[std::string(line, split - line)] = atoi(split + 1);
+    }
+    fclose(file);
+}
+
+bool CPUTuner::save() {
+    std::lock_guard<std::mutex> _l(mLock);
+    if (!mDirty || mCacheFile.empty()) {
+        return true;
+    }
+    auto file = fopen(mCacheFile.c_str(), "w");
+    if (nullptr == file) {
+        MNN_ERROR("Can't write tuning cache to %s\n", mCacheFile.c_str());
+        return false;
+    }
+    for (auto& iter : mResults) {
+        fprintf(file, "%s %d\n", iter.first.c_str(), iter.second);
+    }
+    fclose(file);
+    mDirty = false;
+    return true;
+}
+
+size_t CPUTuner::size() {
+    std::lock_guard<std::mutex> _l(mLock);
+    return mResults.size();
+}
+} // namespace MNN
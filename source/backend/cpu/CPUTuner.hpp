@@ -0,0 +1,77 @@
+//
+//  CPUTuner.hpp
+//  MNN
+//
+//  Created by MNN on 2020/05/02.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#ifndef CPUTuner_hpp
+#define CPUTuner_hpp
+
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "core/Execution.hpp"
+
+namespace MNN {
+class CPUBackend;
+/**
+ chooses algorithm of op by running the candidates on the machine. the winner of every op parameter is kept in a
+ process wide cache keyed by op parameters, thread number and cpu id, which can be saved to and loaded from file.
+ */
+class CPUTuner {
+public:
+    /** create candidate execution of given index on given backend */
+    typedef std::function<Execution*(Backend* backend, int index)> Creator;
+
+    static CPUTuner* get();
+
+    /**
+     * @brief choose the fastest candidate, measure them if the key is not tuned before.
+     * @param key       op parameters, thread number and cpu id are appended.
+     * @param number    number of candidates.
+     * @param creator   creator of candidates.
+     * @param inputs    inputs of op, only shape and format are used.
+     * @param outputs   outputs of op, only shape and format are used.
+     * @param backend   backend which runs the op, candidates are measured on a backend of the same config.
+     * @return index of the fastest candidate, 0 if all candidates fail.
+     */
+    int choose(const std::string& key, int number, const Creator& creator, const std::vector<Tensor*>& inputs,
+               const std::vector<Tensor*>& outputs, const CPUBackend* backend);
+
+    /**
+     * @brief set cache file. tuned results in the file are loaded, new results are saved to it by save.
+     * @param path      path of cache file, empty to keep results in memory only.
+     */
+    void setCacheFile(const std::string& path);
+    /**
+     * @brief save tuned results to cache file if there are new ones.
+     * @return false if writing file fails.
+     */
+    bool save();
+    /**
+     * @brief get number of tuned results, including loaded ones.
+     */
+    size_t size();
+
+    /**
+     * @brief get id of cpu model, such as brand string on x86.
+     */
+    static const std::string& cpuId();
+
+private:
+    CPUTuner() = default;
+    float _measure(Execution* execution, const std::vector<Tensor*>& inputs, const std::vector<Tensor*>& outputs,
+                   Backend* backend);
+
+    std::mutex mLock;
+    std::map<std::string, int> mResults;
+    std::string mCacheFile;
+    bool mDirty = false;
+};
+} // namespace MNN
+
+#endif /* CPUTuner_hpp */
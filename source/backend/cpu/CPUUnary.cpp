@@ -37,9 +37,14 @@ static ErrorCode _unaryOp(void* inputPtr, void* outputPtr, int elementSize, Back
     };
     const T *inputData = (T*)inputPtr;
     T *outputData      = (T *)outputPtr;
-    auto numberThread = ((CPUBackend*)bn)->threadNumber();
-    MNN_CONCURRENCY_BEGIN(tId, numberThread) {
-        for (int i=tId; i<elementSize; i+=numberThread) {
+    auto schedule = ((CPUBackend*)bn)->multiThreadDivide(elementSize);
+    MNN_CONCURRENCY_BEGIN(tId, schedule.second) {
+        int start = schedule.first * (int)tId;
+        int end   = schedule.first * ((int)tId + 1);
+        if (tId == schedule.second - 1) {
+            end = elementSize;
+        }
+        for (int i = start; i < end; ++i) {
             outputData[i] = f(inputData[i]);
         }
     }
@@ -47,24 +52,31 @@ static ErrorCode _unaryOp(void* inputPtr, void* outputPtr, int elementSize, Back
     return NO_ERROR;
 }
 
-template <typename T>
-struct UnarySquare : std::unary_function<T, T> {
-    T operator()(const T &x) const {
-        return x * x;
-    }
-};
-
-template <typename T>
-struct UnaryRsqrt : std::unary_function<T, T> {
-    T operator()(const T &x) const {
-        return 1.f / sqrt(x);
+// Each thread runs the vectorized function of MathFunctions.hpp on its own contiguous part
+static ErrorCode _unaryVectorOp(void (*func)(float* dst, const float* src, size_t size), const float* inputData,
+                                float* outputData, int elementSize, Backend* bn) {
+    auto backend = [bn]() {
+        return bn;
+    };
+    auto schedule = ((CPUBackend*)bn)->multiThreadDivide(elementSize);
+    MNN_CONCURRENCY_BEGIN(tId, schedule.second) {
+        int start    = schedule.first * (int)tId;
+        int realSize = schedule.first;
+        if (tId == schedule.second - 1) {
+            realSize = elementSize - start;
+        }
+        if (realSize > 0) {
+            func(outputData + start, inputData + start, realSize);
+        }
     }
-};
+    MNN_CONCURRENCY_END();
+    return NO_ERROR;
+}
 
 template <typename T>
-struct UnarySqrt : std::unary_function<T, T> {
+struct UnarySquare : std::unary_function<T, T> {
     T operator()(const T &x) const {
-        return sqrt(x);
+        return x * x;
     }
 };
 
@@ -75,13 +87,6 @@ struct UnaryNeg {
     }
 };
 
-template <typename T>
-struct UnaryExp : std::unary_function<T, T> {
-    T operator()(const T &x) const {
-        return exp(x);
-    }
-};
-
 template <typename T>
 struct UnaryAbs : std::unary_function<T, T> {
     T operator()(const T &x) const {
@@ -108,24 +113,6 @@ struct UnaryLog1p : std::unary_function<T, T> {
     }
 };
 template <typename T>
-struct UnaryLog : std::unary_function<T, T> {
-    T operator()(const T &x) const {
-        return (T)log((T)(x));
-    }
-};
-template <typename T>
-struct UnaryCos : std::unary_function<T, T> {
-    T operator()(const T &x) const {
-        return (T)cosf((T)(x));
-    }
-};
-template <typename T>
-struct UnarySin : std::unary_function<T, T> {
-    T operator()(const T &x) const {
-        return (T)sinf((T)(x));
-    }
-};
-template <typename T>
 struct UnaryTan : std::unary_function<T, T> {
     T operator()(const T &x) const {
         return (T)tanf((T)(x));
@@ -267,17 +254,6 @@ T erfcImpl(T x) {
     }
 }
 
-template <typename T>
-struct UnaryErf : std::unary_function<T, T> {
-    T operator()(const T &x) const {
-        if (abs(x) < T(1.)) {
-            return erfImpl(x);
-        } else {
-            return T(1.) - erfcImpl(x);
-        }
-    }
-};
-
 template <typename T>
 struct UnaryErfc : std::unary_function<T, T> {
     T operator()(const T &x) const {
@@ -407,7 +383,7 @@ ErrorCode CPUUnary::onExecute(const std::vector<Tensor *> &inputs, const std::ve
             return NO_ERROR;
         }
         case UnaryOpOperation_RSQRT:
-            return _unaryOp<UnaryRsqrt<float>, float>(input->host<void>(), output->host<void>(), input->elementSize(), backend());
+            return _unaryVectorOp(MNNMathRsqrt, inputPtr, outputPtr, size, backend());
         case UnaryOpOperation_NEG: {
             MNN_CONCURRENCY_BEGIN(tId, schedule.second) {
                 int start = schedule.first * (int)tId;
@@ -423,17 +399,17 @@ ErrorCode CPUUnary::onExecute(const std::vector<Tensor *> &inputs, const std::ve
             return NO_ERROR;
         }
         case UnaryOpOperation_EXP:
-            return _unaryOp<UnaryExp<float>, float>(input->host<void>(), output->host<void>(), input->elementSize(), backend());
+            return _unaryVectorOp(MNNMathExp, inputPtr, outputPtr, size, backend());
         case UnaryOpOperation_COS:
-            return _unaryOp<UnaryCos<float>, float>(input->host<void>(), output->host<void>(), input->elementSize(), backend());
+            return _unaryVectorOp(MNNMathCos, inputPtr, outputPtr, size, backend());
         case UnaryOpOperation_SIN:
-            return _unaryOp<UnarySin<float>, float>(input->host<void>(), output->host<void>(), input->elementSize(), backend());
+            return _unaryVectorOp(MNNMathSin, inputPtr, outputPtr, size, backend());
         case UnaryOpOperation_TAN:
             return _unaryOp<UnaryTan<float>, float>(input->host<void>(), output->host<void>(), input->elementSize(), backend());
         case UnaryOpOperation_ATAN:
             return _unaryOp<UnaryATan<float>, float>(input->host<void>(), output->host<void>(), input->elementSize(), backend());
         case UnaryOpOperation_SQRT:
-            return _unaryOp<UnarySqrt<float>, float>(input->host<void>(), output->host<void>(), input->elementSize(), backend());
+            return _unaryVectorOp(MNNMathSqrt, inputPtr, outputPtr, size, backend());
         case UnaryOpOperation_CEIL:
             return _unaryOp<UnaryCeil<float>, float>(input->host<void>(), output->host<void>(), input->elementSize(), backend());
         case UnaryOpOperation_RECIPROCAL:
@@ -441,7 +417,7 @@ ErrorCode CPUUnary::onExecute(const std::vector<Tensor *> &inputs, const std::ve
         case UnaryOpOperation_LOG1P:
             return _unaryOp<UnaryLog1p<float>, float>(input->host<void>(), output->host<void>(), input->elementSize(), backend());
         case UnaryOpOperation_LOG:
-            return _unaryOp<UnaryLog<float>, float>(input->host<void>(), output->host<void>(), input->elementSize(), backend());
+            return _unaryVectorOp(MNNMathLog, inputPtr, outputPtr, size, backend());
         case UnaryOpOperation_FLOOR:
             return _unaryOp<UnaryFloor<float>, float>(input->host<void>(), output->host<void>(), input->elementSize(), backend());
         case UnaryOpOperation_BNLL:
@@ -461,7 +437,7 @@ ErrorCode CPUUnary::onExecute(const std::vector<Tensor *> &inputs, const std::ve
         case UnaryOpOperation_COSH:
             return _unaryOp<UnaryCosh<float>, float>(input->host<void>(), output->host<void>(), input->elementSize(), backend());
         case UnaryOpOperation_ERF:
-            return _unaryOp<UnaryErf<float>, float>(input->host<void>(), output->host<void>(), input->elementSize(), backend());
+            return _unaryVectorOp(MNNMathErf, inputPtr, outputPtr, size, backend());
         case UnaryOpOperation_ERFC:
             return _unaryOp<UnaryErfc<float>, float>(input->host<void>(), output->host<void>(), input->elementSize(), backend());
         case UnaryOpOperation_ERFINV:
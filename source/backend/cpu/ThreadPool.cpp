@@ -8,7 +8,9 @@
 #ifdef MNN_USE_THREAD_POOL
 #include "backend/cpu/ThreadPool.hpp"
 #include <string.h>
+#include <algorithm>
 #include <MNN/MNNDefine.h>
+#include "core/Tracer.hpp"
 #ifdef __ANDROID__
 #include <stdint.h>
 #include <sys/syscall.h>
@@ -17,10 +19,21 @@
 #endif
 //#define MNN_THREAD_LOCK_CPU
 
-#define MNN_THREAD_POOL_MAX_TASKS 2
+// Number of queues shared by threads outside the pool
+#define MNN_THREAD_POOL_OUTER_QUEUES 4
 namespace MNN {
 ThreadPool* ThreadPool::gInstance = nullptr;
 static std::mutex gInitMutex;
+// Queue index of pool worker, -1 for threads outside the pool
+static thread_local int gWorkerQueue = -1;
+
+struct ThreadPool::Region {
+    const std::function<void(int)>* function;
+    int grain;
+    std::atomic_int remain;
+    // Tracer of the thread enqueued the task, bound to threads running its ranges
+    Tracer* tracer;
+};
 int ThreadPool::init(int number) {
     if (1 >= number) {
         return 1;
@@ -152,34 +165,29 @@ static int setSchedAffinity(const std::vector<int>& cpuIDs) {
 ThreadPool::ThreadPool(int numberThread) {
     mNumberThread = numberThread;
     mActiveCount  = 0;
-    mTaskAvailable.resize(MNN_THREAD_POOL_MAX_TASKS);
-    mTasks.resize(MNN_THREAD_POOL_MAX_TASKS);
-    for (int t = 0; t < mTasks.size(); ++t) {
-        mTaskAvailable[t] = true;
-        for (int i = 0; i < mNumberThread; ++i) {
-            mTasks[t].second.emplace_back(new std::atomic_bool{false});
-        }
+    for (int i = 0; i < mNumberThread - 1 + MNN_THREAD_POOL_OUTER_QUEUES; ++i) {
+        mQueues.emplace_back(new Queue);
     }
 #ifdef MNN_THREAD_LOCK_CPU
     std::vector<int> sortedCPUIDs = sortCPUIDByMaxFrequency(numberThread);
 #endif
     for (int i = 1; i < mNumberThread; ++i) {
-        int threadIndex = i;
+        int queueIndex = i - 1;
 #ifdef MNN_THREAD_LOCK_CPU
-        mWorkers.emplace_back([this, sortedCPUIDs, threadIndex]() {
+        mWorkers.emplace_back([this, sortedCPUIDs, queueIndex]() {
 #else
-        mWorkers.emplace_back([this, threadIndex]() {
+        mWorkers.emplace_back([this, queueIndex]() {
 #endif
 #ifdef MNN_THREAD_LOCK_CPU
             int res = setSchedAffinity(sortedCPUIDs);
 #endif
+            gWorkerQueue = queueIndex;
             while (!mStop) {
-                while (mActiveCount > 0) {
-                    for (int i = 0; i < MNN_THREAD_POOL_MAX_TASKS; ++i) {
-                        if (*mTasks[i].second[threadIndex]) {
-                            mTasks[i].first.first(threadIndex);
-                            { *mTasks[i].second[threadIndex] = false; }
-                        }
+                while (mActiveCount > 0 && !mStop) {
+                    Range range;
+                    if (pop(queueIndex, range) || steal(queueIndex, range)) {
+                        runRange(queueIndex, range);
+                        continue;
                     }
                     std::this_thread::yield();
                 }
@@ -192,39 +200,23 @@ ThreadPool::ThreadPool(int numberThread) {
 
 ThreadPool::~ThreadPool() {
     mStop = true;
-    mCondition.notify_all();
+    {
+        std::lock_guard<std::mutex> _l(mQueueMutex);
+        mCondition.notify_all();
+    }
     for (auto& worker : mWorkers) {
         worker.join();
     }
-    for (auto& task : mTasks) {
-        for (auto c : task.second) {
-            delete c;
-        }
-    }
 }
 
 int ThreadPool::acquireWorkIndex() {
     if (nullptr == gInstance) {
         return -1;
     }
-    std::lock_guard<std::mutex> _l(gInstance->mQueueMutex);
-    for (int i = 0; i < MNN_THREAD_POOL_MAX_TASKS; ++i) {
-        if (gInstance->mTaskAvailable[i]) {
-            gInstance->mTaskAvailable[i] = false;
-            return i;
-        }
-    }
-    return -1;
+    return 0;
 }
 void ThreadPool::releaseWorkIndex(int index) {
-    if (nullptr == gInstance) {
-        return;
-    }
-    if (index < 0 || index >= MNN_THREAD_POOL_MAX_TASKS) {
-        return;
-    }
-    std::lock_guard<std::mutex> _l(gInstance->mQueueMutex);
-    gInstance->mTaskAvailable[index] = true;
+    // Nothing to do
 }
 
 void ThreadPool::active() {
@@ -242,6 +234,73 @@ void ThreadPool::deactive() {
     gInstance->mActiveCount--;
 }
 
+int ThreadPool::currentQueue() {
+    if (gWorkerQueue >= 0 && gWorkerQueue < mNumberThread - 1) {
+        return gWorkerQueue;
+    }
+    auto outer = std::hash<std::thread::id>()(std::this_thread::get_id()) % MNN_THREAD_POOL_OUTER_QUEUES;
+    return mNumberThread - 1 + (int)outer;
+}
+
+void ThreadPool::push(int queueIndex, const Range& range) {
+    auto& queue = *mQueues[queueIndex];
+    std::lock_guard<std::mutex> _l(queue.lock);
+    queue.ranges.push_back(range);
+    mPendingRanges++;
+}
+
+bool ThreadPool::pop(int queueIndex, Range& range) {
+    auto& queue = *mQueues[queueIndex];
+    std::lock_guard<std::mutex> _l(queue.lock);
+    if (queue.ranges.empty()) {
+        return false;
+    }
+    range = queue.ranges.back();
+    queue.ranges.pop_back();
+    mPendingRanges--;
+    return true;
+}
+
+bool ThreadPool::steal(int queueIndex, Range& range) {
+    const int queueNumber = (int)mQueues.size();
+    for (int i = 1; i < queueNumber && mPendingRanges > 0; ++i) {
+        auto& queue = *mQueues[(queueIndex + i) % queueNumber];
+        std::lock_guard<std::mutex> _l(queue.lock);
+        if (queue.ranges.empty()) {
+            continue;
+        }
+        // Steal the oldest range, which is the largest one
+        range = queue.ranges.front();
+        queue.ranges.pop_front();
+        mPendingRanges--;
+        return true;
+    }
+    return false;
+}
+
+void ThreadPool::runRange(int queueIndex, Range range) {
+    auto region = range.region;
+    while (range.end - range.begin > region->grain) {
+        int middle = range.begin + (range.end - range.begin) / 2;
+        push(queueIndex, {region, middle, range.end});
+        range.end = middle;
+    }
+    if (nullptr != region->tracer) {
+        Tracer::Bind _b(region->tracer);
+        Tracer::Scope _s("threadpool", "work");
+        _s.event()->numbers = {{"begin", (double)range.begin}, {"end", (double)range.end}};
+        for (int i = range.begin; i < range.end; ++i) {
+            (*region->function)(i);
+        }
+    } else {
+        for (int i = range.begin; i < range.end; ++i) {
+            (*region->function)(i);
+        }
+    }
+    // The region may be released by its owner once remain is zero, don't touch it after
+    region->remain -= (range.end - range.begin);
+}
+
 void ThreadPool::enqueue(TASK&& task, int index) {
     if (1 >= task.second || 0 > index) {
         for (int i = 0; i < task.second; ++i) {
@@ -250,46 +309,32 @@ void ThreadPool::enqueue(TASK&& task, int index) {
         return;
     }
     MNN_ASSERT(nullptr != gInstance);
-    gInstance->enqueueInternal(std::move(task), index);
+    gInstance->enqueueInternal(std::move(task));
 }
-void ThreadPool::enqueueInternal(TASK&& task, int index) {
+void ThreadPool::enqueueInternal(TASK&& task) {
     if (mActiveCount == 0) {
         for (int i = 0; i < task.second; ++i) {
             task.first(i);
         }
         return;
     }
-    int workSize = task.second;
-    if (workSize > mNumberThread) {
-        mTasks[index].first = std::make_pair(
-            [workSize, &task, this](int tId) {
-                for (int v = tId; v < workSize; v += mNumberThread) {
-                    task.first(v);
-                }
-            },
-            mNumberThread);
-        workSize = mNumberThread;
-    } else {
-        mTasks[index].first = std::move(task);
-    }
-    {
-        for (int i = 1; i < workSize; ++i) {
-            *mTasks[index].second[i] = true;
+    Region region;
+    region.function = &task.first;
+    region.grain    = std::max(1, task.second / (4 * mNumberThread));
+    region.remain   = task.second;
+    region.tracer   = Tracer::current();
+    auto queueIndex = currentQueue();
+    runRange(queueIndex, {&region, 0, task.second});
+
+    // Help running ranges until the region is done, nested regions are run here as well
+    while (region.remain > 0) {
+        Range range;
+        if (pop(queueIndex, range) || steal(queueIndex, range)) {
+            runRange(queueIndex, range);
+            continue;
         }
-    }
-    mTasks[index].first.first(0);
-    bool complete = true;
-    do {
         std::this_thread::yield();
-        complete = true;
-        for (int i = 1; i < workSize; ++i) {
-            if (*mTasks[index].second[i]) {
-                complete = false;
-                break;
-            }
-        }
-        // FUNC_PRINT(notComplete);
-    } while (!complete);
+    }
 }
 } // namespace MNN
 #endif
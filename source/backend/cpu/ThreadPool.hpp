@@ -10,7 +10,9 @@
 #define CPU_INTHREADPOOL_H
 #ifdef MNN_USE_THREAD_POOL
 #include <condition_variable>
+#include <deque>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <thread>
 #include <vector>
@@ -18,6 +20,13 @@
 #include <MNN/MNNDefine.h>
 namespace MNN {
 
+/**
+ work-stealing thread pool.
+ each enqueued task is a range of work indices. a thread running a range keeps splitting it in half and pushes the
+ upper half to the bottom of its own deque, idle threads steal ranges from the top of other deques.
+ the thread calling enqueue helps running ranges until the task is done, so a task can enqueue nested tasks
+ and any number of threads can enqueue at the same time.
+ */
 class MNN_PUBLIC ThreadPool {
 public:
     typedef std::pair<std::function<void(int)>, int> TASK;
@@ -30,6 +39,10 @@ public:
     static void active();
     static void deactive();
 
+    /**
+     * @brief acquire work index for a backend. work indices are not limited, so it never fails after init.
+     * @return work index, -1 if thread pool is not inited.
+     */
     static int acquireWorkIndex();
     static void releaseWorkIndex(int index);
 
@@ -37,17 +50,34 @@ public:
     static void destroy();
 
 private:
-    void enqueueInternal(TASK&& task, int index);
+    struct Region;
+    struct Range {
+        Region* region;
+        int begin;
+        int end;
+    };
+    struct Queue {
+        std::mutex lock;
+        std::deque<Range> ranges;
+    };
+
+    void enqueueInternal(TASK&& task);
+    void push(int queueIndex, const Range& range);
+    bool pop(int queueIndex, Range& range);
+    bool steal(int queueIndex, Range& range);
+    void runRange(int queueIndex, Range range);
+    int currentQueue();
 
     static ThreadPool* gInstance;
     ThreadPool(int number = 0);
     ~ThreadPool();
 
     std::vector<std::thread> mWorkers;
-    std::vector<bool> mTaskAvailable;
     std::atomic<bool> mStop = {false};
 
-    std::vector<std::pair<TASK, std::vector<std::atomic_bool*>>> mTasks;
+    // One queue for each worker, then queues shared by outer threads
+    std::vector<std::unique_ptr<Queue>> mQueues;
+    std::atomic_int mPendingRanges = {0};
     std::condition_variable mCondition;
     std::mutex mQueueMutex;
 
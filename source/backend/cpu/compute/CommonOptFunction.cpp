@@ -687,59 +687,6 @@ void MNNRelu6(float* dst, const float* src, size_t size) {
     }
 }
 
-void MNNExp(float* dst, const float* src, size_t dataSize) {
-    int countC8        = (int)dataSize / 8;
-    if (countC8 > 0) {
-        // Align to eight so asm is easier to write
-        static float parameters[] = {
-            (float)log(2.0f), 1.0f / (float)log(2.0f), 1.0f, 1.0f, 0.5f, 1.0f / 6.0f, 1.0f / 24.0f, 1.0f / 120.0f};
-        MNNExpC8(dst, src, parameters, countC8);
-    }
-    int remain = countC8 * 8;
-    auto param = log(2.0f);
-    float xLimit = 87;
-    for (int i = remain; i < dataSize; i++) {
-        /*Origin Function*/
-        //dst[i] = expf(-src[i]);
-        /*Approciate Function*/
-        
-        auto x         = -src[i];
-        x = ALIMAX(x, -xLimit);
-        x = ALIMIN(x, xLimit);
-        
-        int div        = (x / param);
-        int div2       = (div + 127) << 23;
-        auto xReamin   = x - div * param;
-        float expBasic = *(float*)(&div2);
-        
-        auto t         = xReamin;
-        auto expRemain = ((((1.0f / 120 * t + 1.0f / 24) * t + 1.0f / 6) * t + 0.5f) * t + 1.0f) * t + 1.0f;
-        dst[i]  = expBasic * expRemain;
-    }
-}
-
-// Lambert's series with 7 divisions
-// reference from
-// https://varietyofsound.wordpress.com/2011/02/14/efficient-tanh-computation-using-lamberts-continued-fraction/
-inline float tanhf_poly(float value) {
-    if (value > 5.0) {
-        return 1.0;
-    } else if (value <= -5.0) {
-        return -1.0;
-    } else {
-        float x2 = value * value;
-        float a  = value * (135135.0f + x2 * (17325.0f + x2 * (378.0f + x2)));
-        float b  = 135135.0f + x2 * (62370.0f + x2 * (3150.0f + x2 * 28.0f));
-        return a / b;
-    }
-}
-void MNNTanh(float* dst, const float* src, size_t dataSize) {
-    for (int i = 0; i < dataSize; i++) {
-        // outputData[i] = 1 - 2 / (expf(2 * inputData[i]) + 1);
-        dst[i] = tanhf_poly(src[i]);
-    }
-}
-
 void MNNReluWithSlope(float* dst, const float* src, size_t sizeQuad, float slope) {
     float slopeValue[4];
     for (int i=0; i<4; ++i) {
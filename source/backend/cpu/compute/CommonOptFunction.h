@@ -67,8 +67,22 @@ void MNNExpC8(float* dest, const float* source, const float* parameters, size_t
 void MNNPowC8(float* dest, const float* source, const float* powfParam, size_t betaInt, size_t countC8);
 
 
+// Element-wise math of MathFunctions.hpp, vectorized for each instruction set, the error bound is documented there
+// dst = exp(-src)
 void MNNExp(float* dst, const float* src, size_t dataSize);
 void MNNTanh(float* dst, const float* src, size_t dataSize);
+void MNNMathExp(float* dst, const float* src, size_t dataSize);
+void MNNMathLog(float* dst, const float* src, size_t dataSize);
+void MNNMathSigmoid(float* dst, const float* src, size_t dataSize);
+void MNNMathErf(float* dst, const float* src, size_t dataSize);
+// Fused activations: x * sigmoid(x), x * relu6(x + 3) / 6 and x * (1 + erf(x / sqrt(2))) / 2
+void MNNMathSwish(float* dst, const float* src, size_t dataSize);
+void MNNMathHardSwish(float* dst, const float* src, size_t dataSize);
+void MNNMathGelu(float* dst, const float* src, size_t dataSize);
+void MNNMathSqrt(float* dst, const float* src, size_t dataSize);
+void MNNMathRsqrt(float* dst, const float* src, size_t dataSize);
+void MNNMathSin(float* dst, const float* src, size_t dataSize);
+void MNNMathCos(float* dst, const float* src, size_t dataSize);
 void MNNReluWithSlopeCommon(float* dst, const float* src, size_t size, float slope);
 bool MNNReorder4x4ByPlatform(float* dst, size_t size);
 
@@ -138,24 +138,26 @@ ConvolutionDepthwise3x3::ConvolutionDepthwise3x3(const Convolution2DCommon *comm
     MNN_ASSERT(3 == common->kernelX() && 3 == common->kernelY());
     MNN_ASSERT(1 == common->strideX() && 1 == common->strideY());
     MNN_ASSERT(1 == common->dilateX() && 1 == common->dilateY());
-    mBias.reset(Tensor::createDevice<float>({(int)ALIGN_UP4(biasSize)}));
-    mValid = backend()->onAcquireBuffer(mBias.get(), Backend::STATIC);
+    mResource.reset(new Resource);
+    mResource->backend = b;
+    mResource->mBias.reset(Tensor::createDevice<float>({(int)ALIGN_UP4(biasSize)}));
+    mValid = backend()->onAcquireBuffer(mResource->mBias.get(), Backend::STATIC);
     if (!mValid) {
         MNN_ERROR("Error for alloc memory in ConvolutionDepthwise3x3\n");
         return;
     }
-    ::memset(mBias->host<float>(), 0, mBias->size());
-    ::memcpy(mBias->host<float>(), bias, biasSize * sizeof(float));
+    ::memset(mResource->mBias->host<float>(), 0, mResource->mBias->size());
+    ::memcpy(mResource->mBias->host<float>(), bias, biasSize * sizeof(float));
     auto channel   = common->outputCount();
     auto channelC4 = UP_DIV(channel, 4);
-    mWeight.reset(Tensor::createDevice<float>({channelC4, 3, 4, 4}));
-    mValid = backend()->onAcquireBuffer(mWeight.get(), Backend::STATIC);
+    mResource->mWeight.reset(Tensor::createDevice<float>({channelC4, 3, 4, 4}));
+    mValid = backend()->onAcquireBuffer(mResource->mWeight.get(), Backend::STATIC);
     if (!mValid) {
         MNN_ERROR("Error for alloc memory in ConvolutionDepthwise3x3\n");
         return;
     }
-    auto weightHost = mWeight->host<float>();
-    ::memset(weightHost, 0, mWeight->size());
+    auto weightHost = mResource->mWeight->host<float>();
+    ::memset(weightHost, 0, mResource->mWeight->size());
 
     /* 1D-Winograd F(2,3) and tiling */
     for (int c = 0; c < channel; ++c) {
@@ -181,13 +183,19 @@ ConvolutionDepthwise3x3::ConvolutionDepthwise3x3(const Convolution2DCommon *comm
     }
 }
 
-ConvolutionDepthwise3x3::~ConvolutionDepthwise3x3() {
-    if (nullptr != mBias) {
-        backend()->onReleaseBuffer(mBias.get(), Backend::STATIC);
+ConvolutionDepthwise3x3::ConvolutionDepthwise3x3(std::shared_ptr<Resource> resource, const Convolution2DCommon *common,
+                                                 Backend *b)
+    : CPUConvolution(common, b), mResource(resource) {
+}
+
+bool ConvolutionDepthwise3x3::onClone(Backend *bn, const Op *op, Execution **dst) {
+    if (!mValid) {
+        return false;
     }
-    if (nullptr != mWeight) {
-        backend()->onReleaseBuffer(mWeight.get(), Backend::STATIC);
+    if (nullptr != dst) {
+        *dst = new ConvolutionDepthwise3x3(mResource, mCommon, bn);
     }
+    return true;
 }
 
 ErrorCode ConvolutionDepthwise3x3::onResize(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs) {
@@ -224,7 +232,7 @@ ErrorCode ConvolutionDepthwise3x3::onExecute(const std::vector<Tensor *> &inputs
 
     auto iw           = input->width();
     auto ih           = input->height();
-    auto kernelOrigin = mWeight->host<float>();
+    auto kernelOrigin = mResource->mWeight->host<float>();
 
     /*oy-mPadY>=0*/
     int middelYStart = mPadY;
@@ -243,7 +251,7 @@ ErrorCode ConvolutionDepthwise3x3::onExecute(const std::vector<Tensor *> &inputs
             for (int z = (int)tId; z < channelC4; z += threadNumber) {
                 auto inputZ     = inputOrigin + 4 * z * iw * ih;
                 auto outputZ    = outputOrigin + 4 * z * ow * oh;
-                auto kernelZ    = kernelOrigin + z * mWeight->stride(0);
+                auto kernelZ    = kernelOrigin + z * mResource->mWeight->stride(0);
                 auto cacheLine0 = cacheLineStart + 16 * owUnit * 0;
                 auto cacheLine1 = cacheLineStart + 16 * owUnit * 1;
                 auto cacheLine2 = cacheLineStart + 16 * owUnit * 2;
@@ -295,7 +303,7 @@ ErrorCode ConvolutionDepthwise3x3::onExecute(const std::vector<Tensor *> &inputs
                     cacheLine[0] = cacheLine[1];
                     cacheLine[1] = cacheLine[2];
                 }
-                mPostFunction(outputZ, mBias->host<float>() + 4 * z, ow * oh, 1);
+                mPostFunction(outputZ, mResource->mBias->host<float>() + 4 * z, ow * oh, 1);
             }
         }
         MNN_CONCURRENCY_END();
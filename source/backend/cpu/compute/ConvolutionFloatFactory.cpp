@@ -8,6 +8,7 @@
 
 #include "backend/cpu/compute/ConvolutionFloatFactory.h"
 #include "backend/cpu/CPUConvolutionDepthwise.hpp"
+#include "backend/cpu/CPUTuner.hpp"
 #include "backend/cpu/compute/ConvOpt.h"
 #include "backend/cpu/compute/Convolution1x1Strassen.hpp"
 #include "backend/cpu/compute/ConvolutionGroup.hpp"
@@ -17,9 +18,59 @@
 #include "core/Macro.h"
 namespace MNN {
 
+// Algorithm of candidate: tiled, strassen for 1x1, or winograd of the unit
+#define MNN_CONV_TILED 0
+#define MNN_CONV_STRASSEN 1
+
+static Execution* _createCandidate(int candidate, const Tensor* input, const Tensor* output, Backend* backend,
+                                   const Convolution2DCommon* common, const float* originWeight,
+                                   size_t originWeightSize, const float* bias, size_t biasSize) {
+    if (MNN_CONV_TILED == candidate) {
+        return new ConvolutionTiledExecutor(common, backend, originWeight, originWeightSize, bias, biasSize);
+    }
+    if (MNN_CONV_STRASSEN == candidate) {
+        return new Convolution1x1Strassen(common, backend, originWeight, originWeightSize, bias, biasSize);
+    }
+    return new ConvolutionWinograd(common, input, output, backend, originWeight, originWeightSize, bias, biasSize,
+                                   candidate);
+}
+
+static Execution* _createTunedUnit(const Tensor* input, const Tensor* output, CPUBackend* backend,
+                                   const Convolution2DCommon* common, const float* originWeight,
+                                   size_t originWeightSize, const float* bias, size_t biasSize) {
+    std::vector<int> candidates = {MNN_CONV_TILED};
+    if (common->kernelY() == 1 && common->kernelX() == 1) {
+        candidates.emplace_back(MNN_CONV_STRASSEN);
+    } else if (ConvolutionWinograd::canUseWinograd(common) && backend->memoryMode() != BackendConfig::Memory_Low) {
+        auto units = ConvolutionWinograd::supportUnits(common);
+        candidates.insert(candidates.end(), units.begin(), units.end());
+    }
+    char key[256];
+    snprintf(key, sizeof(key), "conv:k%dx%d,s%dx%d,d%dx%d,in%dx%dx%dx%d,out%dx%dx%dx%d", common->kernelX(),
+             common->kernelY(), common->strideX(), common->strideY(), common->dilateX(), common->dilateY(),
+             input->batch(), input->channel(), input->height(), input->width(), output->batch(), output->channel(),
+             output->height(), output->width());
+    // Candidates are measured with tensors in NC4HW4 of the same shapes
+    std::shared_ptr<Tensor> measureInput(Tensor::createDevice<float>(input->shape(), Tensor::CAFFE_C4));
+    std::shared_ptr<Tensor> measureOutput(Tensor::createDevice<float>(output->shape(), Tensor::CAFFE_C4));
+    auto index = CPUTuner::get()->choose(
+        key, (int)candidates.size(),
+        [&](Backend* bn, int i) {
+            return _createCandidate(candidates[i], input, output, bn, common, originWeight, originWeightSize, bias,
+                                    biasSize);
+        },
+        {measureInput.get()}, {measureOutput.get()}, backend);
+    return _createCandidate(candidates[index], input, output, backend, common, originWeight, originWeightSize, bias,
+                            biasSize);
+}
+
 static Execution* _createUnit(const Tensor* input, const Tensor* output, Backend* backend,
                               const Convolution2DCommon* common, const float* originWeight, size_t originWeightSize,
                               const float* bias, size_t biasSize) {
+    if (static_cast<CPUBackend*>(backend)->tuning()) {
+        return _createTunedUnit(input, output, static_cast<CPUBackend*>(backend), common, originWeight,
+                                originWeightSize, bias, biasSize);
+    }
     auto layer   = common;
     bool fastWay = layer->kernelY() == 1 && layer->kernelX() == 1;
     if (fastWay) {
@@ -27,6 +27,21 @@ ConvolutionGroup::ConvolutionGroup(Backend *b, const std::vector<std::shared_ptr
     mOutputUnitWrap.push_back(mOutputUnit.get());
 }
 
+bool ConvolutionGroup::onClone(Backend *bn, const Op *op, Execution **dst) {
+    std::vector<std::shared_ptr<Execution>> subConvolution;
+    for (auto &sub : mSubConvolution) {
+        Execution *subClone = nullptr;
+        if (!sub->onClone(bn, op, nullptr == dst ? nullptr : &subClone)) {
+            return false;
+        }
+        subConvolution.emplace_back(subClone);
+    }
+    if (nullptr != dst) {
+        *dst = new ConvolutionGroup(bn, subConvolution);
+    }
+    return true;
+}
+
 ErrorCode ConvolutionGroup::onResize(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs) {
     auto ib = inputs[0]->buffer();
     auto ob = outputs[0]->buffer();
@@ -46,18 +46,21 @@ class ConvolutionTiledExecutor : public Execution {
 public:
     ConvolutionTiledExecutor(const Convolution2DCommon *common, Backend *b, const float *originWeight,
                              size_t originWeightSize, const float *bias, size_t biasSize);
-    virtual ~ConvolutionTiledExecutor();
+    ConvolutionTiledExecutor(std::shared_ptr<CPUConvolution::Resource> res, const Convolution2DCommon *common,
+                             Backend *b);
+    virtual ~ConvolutionTiledExecutor() = default;
     virtual ErrorCode onExecute(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs) override {
         return mProxy->onExecute(inputs, outputs);
     }
     virtual ErrorCode onResize(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs) override {
-        mInputs = {inputs[0], mWeight.get(), mBias.get()};
+        mInputs = {inputs[0], mResource->mWeight.get(), mResource->mBias.get()};
         return mProxy->onResize(mInputs, outputs);
     }
+    virtual bool onClone(Backend *bn, const Op *op, Execution **dst) override;
 
 protected:
-    std::shared_ptr<Tensor> mWeight;
-    std::shared_ptr<Tensor> mBias;
+    const Convolution2DCommon *mCommon;
+    std::shared_ptr<CPUConvolution::Resource> mResource;
     std::shared_ptr<ConvolutionTiledExecutorBasic> mProxy;
     std::vector<Tensor *> mInputs;
 };
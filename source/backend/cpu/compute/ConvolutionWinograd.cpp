@@ -28,17 +28,47 @@ ConvolutionWinograd::ConvolutionWinograd(const Convolution2DCommon *convOp, cons
                                          Backend *b, const float *originWeight, size_t originWeightSize,
                                          const float *bias, size_t biasSize, int unit)
     : MNN::CPUConvolution(convOp, b) {
-    mBias.reset(Tensor::createDevice<float>({ALIGN_UP4((int)biasSize)}));
-    mValid = backend()->onAcquireBuffer(mBias.get(), Backend::STATIC);
+    mResource.reset(new CPUConvolution::Resource);
+    mResource->backend = b;
+    mResource->mBias.reset(Tensor::createDevice<float>({ALIGN_UP4((int)biasSize)}));
+    mValid = backend()->onAcquireBuffer(mResource->mBias.get(), Backend::STATIC);
     if (!mValid) {
         return;
     }
 
-    ::memset(mBias->host<float>(), 0, mBias->size());
-    ::memcpy(mBias->host<float>(), bias, biasSize * sizeof(float));
+    ::memset(mResource->mBias->host<float>(), 0, mResource->mBias->size());
+    ::memcpy(mResource->mBias->host<float>(), bias, biasSize * sizeof(float));
+    MNN_ASSERT(mCommon->kernelX() == mCommon->kernelY());
+
+    int srcCount    = input->channel();
+    int outputCount = output->channel();
+    _initBuffers(srcCount, outputCount, unit);
+
+    // Transform Kernel
+    auto kernelSize = mCommon->kernelY();
+    int ePack, hPack, lPack;
+    MNNGetMatMulPackMode(&ePack, &lPack, &hPack);
+    WinogradGenerater generator(unit, kernelSize, 1, true);
+    std::shared_ptr<Tensor> sourceWeight(Tensor::create<float>(
+        std::vector<int>{outputCount, srcCount, kernelSize, kernelSize}, (void *)originWeight, Tensor::CAFFE));
+    mResource->mWeight = generator.allocTransformWeight(sourceWeight.get(), 1, hPack, false);
+    mValid  = backend()->onAcquireBuffer(mResource->mWeight.get(), Backend::STATIC);
+    if (!mValid) {
+        return;
+    }
+    generator.transformWeight(mResource->mWeight.get(), sourceWeight.get());
+}
+ConvolutionWinograd::ConvolutionWinograd(std::shared_ptr<CPUConvolution::Resource> resource,
+                                         const Convolution2DCommon *convOp, Backend *b, int srcCount, int outputCount,
+                                         int unit)
+    : MNN::CPUConvolution(convOp, b), mResource(resource) {
+    _initBuffers(srcCount, outputCount, unit);
+}
+void ConvolutionWinograd::_initBuffers(int srcCount, int outputCount, int unit) {
+    mSrcCount                         = srcCount;
+    mOutputCount                      = outputCount;
     mTempBuffer.buffer().type         = halide_type_of<float>();
     mTransformMidBuffer.buffer().type = halide_type_of<float>();
-    MNN_ASSERT(mCommon->kernelX() == mCommon->kernelY());
 
     int threadNumber = ((CPUBackend *)backend())->threadNumber();
 
@@ -50,8 +80,6 @@ ConvolutionWinograd::ConvolutionWinograd(const Convolution2DCommon *convOp, cons
     mSourceTransform = WinogradFunction::chooseSourceTransform(alpha, alpha);
     mDestTransform   = WinogradFunction::chooseDestTransform(alpha, unit);
 
-    int srcCount                       = input->channel();
-    int outputCount                    = output->channel();
     auto ic4 = UP_DIV(srcCount, 4);
     auto oc4 = UP_DIV(outputCount, 4);
     int ePack, hPack, lPack;
@@ -84,26 +112,15 @@ ConvolutionWinograd::ConvolutionWinograd(const Convolution2DCommon *convOp, cons
     TensorUtils::setLinearLayout(&mGemmMidBuffer);
     mA = generator.A();
     mB = generator.B();
-    
-
-    // Transform Kernel
-    auto G = generator.G();
-    std::shared_ptr<Tensor> sourceWeight(Tensor::create<float>(
-        std::vector<int>{outputCount, srcCount, kernelSize, kernelSize}, (void *)originWeight, Tensor::CAFFE));
-    mWeight = generator.allocTransformWeight(sourceWeight.get(), 1, hPack, false);
-    mValid  = backend()->onAcquireBuffer(mWeight.get(), Backend::STATIC);
-    if (!mValid) {
-        return;
-    }
-    generator.transformWeight(mWeight.get(), sourceWeight.get());
 }
-ConvolutionWinograd::~ConvolutionWinograd() {
-    if (nullptr != mBias) {
-        backend()->onReleaseBuffer(mBias.get(), Backend::STATIC);
+bool ConvolutionWinograd::onClone(Backend *bn, const Op *op, Execution **dst) {
+    if (!mValid) {
+        return false;
     }
-    if (nullptr != mWeight) {
-        backend()->onReleaseBuffer(mWeight.get(), Backend::STATIC);
+    if (nullptr != dst) {
+        *dst = new ConvolutionWinograd(mResource, mCommon, bn, mSrcCount, mOutputCount, mA->length(1));
     }
+    return true;
 }
 ErrorCode ConvolutionWinograd::onExecute(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs) {
     auto input   = inputs[0];
@@ -154,8 +171,8 @@ ErrorCode ConvolutionWinograd::onExecute(const std::vector<Tensor *> &inputs, co
         auto srcOrigin = input->host<float>() + batchIndex * input->stride(0);
         auto dstOrigin = output->host<float>() + batchIndex * output->stride(0);
 
-        auto weight    = mWeight->host<float>();
-        auto bias      = mBias->host<float>();
+        auto weight    = mResource->mWeight->host<float>();
+        auto bias      = mResource->mBias->host<float>();
         auto tFunction = [&](int tId) {
             auto _srcOrigin = mTempBuffer.host<float>() + tId * mTempBuffer.stride(0);
             auto gemmBuffer = mGemmMidBuffer.host<float>() + tId * mGemmMidBuffer.stride(0);
@@ -242,12 +259,12 @@ ErrorCode ConvolutionWinograd::onExecute(const std::vector<Tensor *> &inputs, co
                 if (xC == ePack) {
                     for (int i = 0; i < srcUnit2; ++i) {
                         MNNPackC4ForMatMul_A(gemmBuffer, _srcOrigin + i * ic_4 * 4 * xC, ePack, ic_4 * 4, ePack);
-                        MNNPackedMatMul(_dstOrigin + i * dc_4 * 4 * xC, gemmBuffer, weight + i * mWeight->stride(0), parameters.data(), cache, nullptr, nullptr);
+                        MNNPackedMatMul(_dstOrigin + i * dc_4 * 4 * xC, gemmBuffer, weight + i * mResource->mWeight->stride(0), parameters.data(), cache, nullptr, nullptr);
                     }
                 } else {
                     for (int i = 0; i < srcUnit2; ++i) {
                         MNNPackC4ForMatMul_A(gemmBuffer, _srcOrigin + i * ic_4 * 4 * xC, xC, ic_4 * 4, xC);
-                        MNNPackedMatMulRemain(_dstOrigin + i * dc_4 * 4 * xC, gemmBuffer, weight + i * mWeight->stride(0), xC, parametersRemain.data(), cache, nullptr, nullptr);
+                        MNNPackedMatMulRemain(_dstOrigin + i * dc_4 * 4 * xC, gemmBuffer, weight + i * mResource->mWeight->stride(0), xC, parametersRemain.data(), cache, nullptr, nullptr);
                     }
                 }
 #ifndef MNN_WINO_TRANFORM_TEST_CLOSE
@@ -376,6 +393,20 @@ int ConvolutionWinograd::bestWinogradUnit(const Convolution2DCommon *common, con
     return unit;
 }
 
+std::vector<int> ConvolutionWinograd::supportUnits(const Convolution2DCommon *common) {
+    std::vector<int> units;
+    auto kernelSize = common->kernelY();
+    static std::set<int> supportSu{4, 6, 8};
+    for (int u = CONVOLUTION_WINOGRAD_MIN_UNIT; u <= CONVOLUTION_WINOGRAD_MAX_UNIT; ++u) {
+        auto su = u + kernelSize - 1;
+        if (supportSu.find(su) == supportSu.end() || nullptr == WinogradFunction::chooseDestTransform(su, u)) {
+            continue;
+        }
+        units.emplace_back(u);
+    }
+    return units;
+}
+
 bool ConvolutionWinograd::canUseWinograd(const Convolution2DCommon *common) {
     if (common->kernelY() != common->kernelX() || common->kernelY() <= 1) {
         return false;
@@ -19,19 +19,29 @@ public:
     ConvolutionWinograd(const Convolution2DCommon *convOp, const Tensor *input, const Tensor *output, Backend *b,
                         const float *originWeight, size_t originWeightSize, const float *bias, size_t biasSize,
                         int unit);
-    virtual ~ConvolutionWinograd();
+    virtual ~ConvolutionWinograd() = default;
     virtual ErrorCode onExecute(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs) override;
     virtual ErrorCode onResize(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs) override;
+    virtual bool onClone(Backend *bn, const Op *op, Execution **dst) override;
 
     static bool canUseWinograd(const Convolution2DCommon *convOp);
     static int bestWinogradUnit(const Convolution2DCommon *convOp, const Tensor *input, const Tensor *output,
                                 int threadnumber);
+    /**
+     * @brief get all units supported for the convolution, used to measure them instead of estimating.
+     */
+    static std::vector<int> supportUnits(const Convolution2DCommon *convOp);
 
 private:
-    std::shared_ptr<Tensor> mBias;
+    ConvolutionWinograd(std::shared_ptr<CPUConvolution::Resource> resource, const Convolution2DCommon *convOp,
+                        Backend *b, int srcCount, int outputCount, int unit);
+    void _initBuffers(int srcCount, int outputCount, int unit);
+
+    std::shared_ptr<CPUConvolution::Resource> mResource;
     std::shared_ptr<Tensor> mA;
     std::shared_ptr<Tensor> mB;
-    std::shared_ptr<Tensor> mWeight;
+    int mSrcCount;
+    int mOutputCount;
 
     Tensor mTempBuffer;
     Tensor mTransformMidBuffer;
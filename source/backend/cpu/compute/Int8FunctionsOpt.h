@@ -34,6 +34,12 @@ void MNNGemmInt8AddBiasScale_16x4_Unit(int8_t* dst, const int8_t* src, const int
 // int8x16 * int8x16
 void MNNGemmInt8AddBiasScale_16x4_Unit_FAST(int8_t* dst, const int8_t* src, const int8_t* weight, const int32_t* bias,
 const float* scale, size_t src_depth_quad, size_t dst_step, size_t dst_depth_quad);
+void MNNDepthWiseInt8AddBiasScaleUnit(int8_t* dst, const int8_t* src, const int8_t* weight, const int32_t* bias,
+                                      size_t fw, size_t fh, size_t weight_y_step, size_t dilateX_step,
+                                      size_t dilateY_step, const float* scale);
+void MNNLineDepthWiseInt8AddBiasScaleUnit(int8_t* dst, const int8_t* src, const int8_t* weight, const int32_t* bias_z,
+                                          size_t width, size_t src_w_step, size_t fw, size_t fh, size_t dilateX_step,
+                                          size_t dilateY_step, const float* scale_z, size_t mode);
 
 #define GEMM_INT8_UNIT 4
 #define GEMM_INT8_SRC_UNIT 16
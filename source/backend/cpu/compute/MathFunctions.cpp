@@ -0,0 +1,269 @@
+//
+//  MathFunctions.cpp
+//  MNN
+//
+//  Created by MNN on 2020/05/05.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#ifndef MNN_USE_SSE
+#include <stdint.h>
+#include "backend/cpu/compute/CommonOptFunction.h"
+#include "backend/cpu/compute/MathFunctions.hpp"
+#ifdef MNN_USE_NEON
+#include <arm_neon.h>
+
+struct VecNEON {
+    typedef float32x4_t F;
+    typedef int32x4_t I;
+    typedef uint32x4_t M;
+    static const int lanes = 4;
+    static inline F load(const float* addr) {
+        return vld1q_f32(addr);
+    }
+    static inline void save(float* addr, F v) {
+        vst1q_f32(addr, v);
+    }
+    static inline F set1(float v) {
+        return vdupq_n_f32(v);
+    }
+    static inline I seti(int32_t v) {
+        return vdupq_n_s32(v);
+    }
+    static inline F add(F a, F b) {
+        return vaddq_f32(a, b);
+    }
+    static inline F sub(F a, F b) {
+        return vsubq_f32(a, b);
+    }
+    static inline F mul(F a, F b) {
+        return vmulq_f32(a, b);
+    }
+#ifdef __aarch64__
+    static inline F div(F a, F b) {
+        return vdivq_f32(a, b);
+    }
+    static inline F fma(F a, F b, F c) {
+        return vfmaq_f32(c, a, b);
+    }
+    static inline F sqrt(F a) {
+        return vsqrtq_f32(a);
+    }
+    static inline I roundToInt(F a) {
+        return vcvtnq_s32_f32(a);
+    }
+    static inline bool any(M m) {
+        return vmaxvq_u32(m) != 0;
+    }
+#else
+    static inline F div(F a, F b) {
+        auto r = vrecpeq_f32(b);
+        r      = vmulq_f32(vrecpsq_f32(b, r), r);
+        r      = vmulq_f32(vrecpsq_f32(b, r), r);
+        return vmulq_f32(a, r);
+    }
+    static inline F fma(F a, F b, F c) {
+        return vmlaq_f32(c, a, b);
+    }
+    static inline F sqrt(F a) {
+        auto r = vrsqrteq_f32(a);
+        r      = vmulq_f32(vrsqrtsq_f32(vmulq_f32(a, r), r), r);
+        r      = vmulq_f32(vrsqrtsq_f32(vmulq_f32(a, r), r), r);
+        // sqrt(0) = 0 and sqrt(inf) = inf instead of nan
+        auto result = vmulq_f32(a, r);
+        result      = vbslq_f32(vceqq_f32(a, vdupq_n_f32(0.0f)), a, result);
+        return vbslq_f32(vceqq_f32(a, vdupq_n_f32(INFINITY)), a, result);
+    }
+    static inline I roundToInt(F a) {
+        // Round half away from zero
+        auto half = vbslq_f32(vdupq_n_u32(0x80000000), a, vdupq_n_f32(0.5f));
+        return vcvtq_s32_f32(vaddq_f32(a, half));
+    }
+    static inline bool any(M m) {
+        auto v = vpmax_u32(vget_low_u32(m), vget_high_u32(m));
+        v      = vpmax_u32(v, v);
+        return vget_lane_u32(v, 0) != 0;
+    }
+#endif
+    static inline F max(F a, F b) {
+        return vmaxq_f32(a, b);
+    }
+    static inline F min(F a, F b) {
+        return vminq_f32(a, b);
+    }
+    static inline I truncToInt(F a) {
+        return vcvtq_s32_f32(a);
+    }
+    static inline F toFloat(I a) {
+        return vcvtq_f32_s32(a);
+    }
+    static inline I addi(I a, I b) {
+        return vaddq_s32(a, b);
+    }
+    static inline I subi(I a, I b) {
+        return vsubq_s32(a, b);
+    }
+    static inline I andi(I a, I b) {
+        return vandq_s32(a, b);
+    }
+    static inline I ori(I a, I b) {
+        return vorrq_s32(a, b);
+    }
+    static inline M equali(I a, I b) {
+        return vceqq_s32(a, b);
+    }
+    static inline I srai1(I a) {
+        return vshrq_n_s32(a, 1);
+    }
+    static inline I shl23(I a) {
+        return vshlq_n_s32(a, 23);
+    }
+    static inline I shr23(I a) {
+        return vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_s32(a), 23));
+    }
+    static inline I castToInt(F a) {
+        return vreinterpretq_s32_f32(a);
+    }
+    static inline F castToFloat(I a) {
+        return vreinterpretq_f32_s32(a);
+    }
+    static inline F andf(F a, F b) {
+        return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b)));
+    }
+    static inline F orf(F a, F b) {
+        return vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b)));
+    }
+    static inline F xorf(F a, F b) {
+        return vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b)));
+    }
+    static inline M less(F a, F b) {
+        return vcltq_f32(a, b);
+    }
+    static inline M greater(F a, F b) {
+        return vcgtq_f32(a, b);
+    }
+    static inline M equal(F a, F b) {
+        return vceqq_f32(a, b);
+    }
+    static inline F select(M m, F a, F b) {
+        return vbslq_f32(m, a, b);
+    }
+};
+MNN_DEFINE_MATH_FUNCTIONS(, VecNEON)
+
+#else
+
+struct VecScalar {
+    typedef float F;
+    typedef int32_t I;
+    typedef bool M;
+    static const int lanes = 1;
+    static inline F load(const float* addr) {
+        return *addr;
+    }
+    static inline void save(float* addr, F v) {
+        *addr = v;
+    }
+    static inline F set1(float v) {
+        return v;
+    }
+    static inline I seti(int32_t v) {
+        return v;
+    }
+    static inline F add(F a, F b) {
+        return a + b;
+    }
+    static inline F sub(F a, F b) {
+        return a - b;
+    }
+    static inline F mul(F a, F b) {
+        return a * b;
+    }
+    static inline F div(F a, F b) {
+        return a / b;
+    }
+    static inline F fma(F a, F b, F c) {
+        return a * b + c;
+    }
+    static inline F sqrt(F a) {
+        return ::sqrtf(a);
+    }
+    static inline F max(F a, F b) {
+        return a > b ? a : b;
+    }
+    static inline F min(F a, F b) {
+        return a < b ? a : b;
+    }
+    // Converting nan or out of range float is undefined in C++, callers only need an arbitrary value for them
+    static inline I roundToInt(F a) {
+        return (a > -2147483648.0f && a < 2147483648.0f) ? (I)::nearbyintf(a) : 0;
+    }
+    static inline I truncToInt(F a) {
+        return (a > -2147483648.0f && a < 2147483648.0f) ? (I)a : 0;
+    }
+    static inline F toFloat(I a) {
+        return (F)a;
+    }
+    static inline I addi(I a, I b) {
+        return (I)((uint32_t)a + (uint32_t)b);
+    }
+    static inline I subi(I a, I b) {
+        return (I)((uint32_t)a - (uint32_t)b);
+    }
+    static inline I andi(I a, I b) {
+        return a & b;
+    }
+    static inline I ori(I a, I b) {
+        return a | b;
+    }
+    static inline M equali(I a, I b) {
+        return a == b;
+    }
+    static inline I srai1(I a) {
+        return a >> 1;
+    }
+    static inline I shl23(I a) {
+        return (I)((uint32_t)a << 23);
+    }
+    static inline I shr23(I a) {
+        return (I)((uint32_t)a >> 23);
+    }
+    static inline I castToInt(F a) {
+        I result;
+        ::memcpy(&result, &a, sizeof(I));
+        return result;
+    }
+    static inline F castToFloat(I a) {
+        F result;
+        ::memcpy(&result, &a, sizeof(F));
+        return result;
+    }
+    static inline F andf(F a, F b) {
+        return castToFloat(castToInt(a) & castToInt(b));
+    }
+    static inline F orf(F a, F b) {
+        return castToFloat(castToInt(a) | castToInt(b));
+    }
+    static inline F xorf(F a, F b) {
+        return castToFloat(castToInt(a) ^ castToInt(b));
+    }
+    static inline M less(F a, F b) {
+        return a < b;
+    }
+    static inline M greater(F a, F b) {
+        return a > b;
+    }
+    static inline M equal(F a, F b) {
+        return a == b;
+    }
+    static inline F select(M m, F a, F b) {
+        return m ? a : b;
+    }
+    static inline bool any(M m) {
+        return m;
+    }
+};
+MNN_DEFINE_MATH_FUNCTIONS(, VecScalar)
+
+#endif
+#endif
@@ -0,0 +1,323 @@
+//
+//  MathFunctions.hpp
+//  MNN
+//
+//  Created by MNN on 2020/05/05.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#ifndef MathFunctions_hpp
+#define MathFunctions_hpp
+
+#include <math.h>
+#include <string.h>
+
+namespace MNN {
+namespace Math {
+
+/*
+ Element-wise float math written once over a vector type V, and instantiated for each instruction set. V provides:
+   F, I, M: float, int32 and compare mask vectors, lanes: number of float in F
+   load, save, set1, seti
+   add, sub, mul, div, fma(a, b, c) = a * b + c, max, min, sqrt. max / min return b if one of them is nan
+   roundToInt (to nearest), truncToInt, toFloat
+   addi, subi, andi, ori, equali, srai1 (>> 1), shl23, shr23 (logical)
+   castToInt, castToFloat, andf, orf, xorf
+   less, greater, equal, select(m, a, b) = m ? a : b, any(m)
+
+ Max error against the exact result on normal inputs, checked by MathFunctionsTest:
+   exp      1 ulp, overflow to inf over 88.72, gradual underflow to zero under -103.9
+   log      1 ulp, log(0) = -inf, log(x < 0) = nan
+   tanh     2 ulp
+   sigmoid  2 ulp
+   erf      3 ulp, or 1e-7 absolute error for |x| >= 1
+   rsqrt    2 ulp, sqrt is correctly rounded
+   sin, cos 2 ulp or 6e-8 absolute error for |x| <= 8192, larger input use the scalar libm function
+   swish    3 ulp, hardSwish 2 ulp, gelu 4 ulp or 1e-7 absolute error
+ nan input gives nan. The bounds need the files instantiating it to be built without fast math.
+ Without native division (armv7), div and sqrt are Newton-Raphson estimates and add about 2 ulp.
+ */
+template <typename V>
+struct MathFunctions {
+    typedef typename V::F F;
+    typedef typename V::I I;
+    typedef typename V::M M;
+
+    static inline F neg(F x) {
+        return V::xorf(x, V::set1(-0.0f));
+    }
+    static inline F abs(F x) {
+        return V::andf(x, V::castToFloat(V::seti(0x7fffffff)));
+    }
+    // 2^n for n in [-126, 127]
+    static inline F pow2(I n) {
+        return V::castToFloat(V::shl23(V::addi(n, V::seti(127))));
+    }
+
+    // exp(x) = 2^n * exp(r), |r| <= ln2 / 2, polynomial from Cephes
+    static F exp(F x) {
+        auto xc = V::min(V::set1(88.8f), V::max(V::set1(-104.0f), x));
+        auto n  = V::roundToInt(V::mul(xc, V::set1(1.44269504088896341f)));
+        auto nf = V::toFloat(n);
+        auto r  = V::fma(nf, V::set1(-0.693359375f), xc);
+        r       = V::fma(nf, V::set1(2.12194440e-4f), r);
+        auto z  = V::mul(r, r);
+        auto p  = V::set1(1.9875691500E-4f);
+        p       = V::fma(p, r, V::set1(1.3981999507E-3f));
+        p       = V::fma(p, r, V::set1(8.3334519073E-3f));
+        p       = V::fma(p, r, V::set1(4.1665795894E-2f));
+        p       = V::fma(p, r, V::set1(1.6666665459E-1f));
+        p       = V::fma(p, r, V::set1(5.0000001201E-1f));
+        p       = V::add(V::fma(p, z, r), V::set1(1.0f));
+        // n is in [-150, 128], scale in two steps so that both factors are normal
+        auto n1 = V::srai1(n);
+        auto n2 = V::subi(n, n1);
+        return V::mul(V::mul(p, pow2(n1)), pow2(n2));
+    }
+    static F expNeg(F x) {
+        return exp(neg(x));
+    }
+
+    // log(x) = e * ln2 + log(m), m in [sqrt(0.5), sqrt(2)), polynomial from Cephes
+    static F log(F x) {
+        auto zero = V::set1(0.0f);
+        auto tiny = V::less(x, V::set1(1.17549435e-38f));
+        auto xs   = V::select(tiny, V::mul(x, V::set1(8388608.0f)), x);
+        auto ix   = V::castToInt(xs);
+        auto e    = V::toFloat(V::subi(V::shr23(ix), V::seti(126)));
+        e         = V::sub(e, V::select(tiny, V::set1(23.0f), zero));
+        auto m    = V::castToFloat(V::ori(V::andi(ix, V::seti(0x007fffff)), V::seti(0x3f000000)));
+        auto less = V::less(m, V::set1(0.707106781186547524f));
+        e         = V::sub(e, V::select(less, V::set1(1.0f), zero));
+        m         = V::sub(V::add(m, V::select(less, m, zero)), V::set1(1.0f));
+        auto z    = V::mul(m, m);
+        auto y    = V::set1(7.0376836292E-2f);
+        y         = V::fma(y, m, V::set1(-1.1514610310E-1f));
+        y         = V::fma(y, m, V::set1(1.1676998740E-1f));
+        y         = V::fma(y, m, V::set1(-1.2420140846E-1f));
+        y         = V::fma(y, m, V::set1(1.4249322787E-1f));
+        y         = V::fma(y, m, V::set1(-1.6668057665E-1f));
+        y         = V::fma(y, m, V::set1(2.0000714765E-1f));
+        y         = V::fma(y, m, V::set1(-2.4999993993E-1f));
+        y         = V::fma(y, m, V::set1(3.3333331174E-1f));
+        y         = V::mul(V::mul(y, m), z);
+        y         = V::fma(e, V::set1(-2.12194440e-4f), y);
+        y         = V::fma(z, V::set1(-0.5f), y);
+        auto r    = V::fma(e, V::set1(0.693359375f), V::add(m, y));
+        auto special = V::select(V::equal(x, zero), V::set1(-INFINITY), V::set1(NAN));
+        r            = V::select(V::greater(x, zero), r, special);
+        return V::select(V::equal(x, V::set1(INFINITY)), x, r);
+    }
+
+    // Odd polynomial from Cephes for |x| < 0.625, else 1 - 2 / (exp(2|x|) + 1)
+    static F tanh(F x) {
+        auto ax = abs(x);
+        auto z  = V::mul(x, x);
+        auto p  = V::set1(-5.70498872745E-3f);
+        p       = V::fma(p, z, V::set1(2.06390887954E-2f));
+        p       = V::fma(p, z, V::set1(-5.37397155531E-2f));
+        p       = V::fma(p, z, V::set1(1.33314422036E-1f));
+        p       = V::fma(p, z, V::set1(-3.33332819422E-1f));
+        auto small = V::fma(V::mul(p, z), x, x);
+        auto one   = V::set1(1.0f);
+        auto e     = exp(V::add(ax, ax));
+        auto large = V::sub(one, V::div(V::set1(2.0f), V::add(e, one)));
+        large      = V::orf(large, V::andf(x, V::set1(-0.0f)));
+        return V::select(V::less(ax, V::set1(0.625f)), small, large);
+    }
+
+    static F sigmoid(F x) {
+        auto one = V::set1(1.0f);
+        return V::div(one, V::add(one, expNeg(x)));
+    }
+
+    // erf(x) = x * T(x^2) for |x| < 1, else 1 - exp(-x^2) / |x| * P(1 / x^2) with the sign of x. Cephes coefficients
+    static F erf(F x) {
+        auto ax    = abs(x);
+        auto z     = V::mul(x, x);
+        auto t     = V::set1(7.853861353153693E-5f);
+        t          = V::fma(t, z, V::set1(-8.010193625184903E-4f));
+        t          = V::fma(t, z, V::set1(5.188327685732524E-3f));
+        t          = V::fma(t, z, V::set1(-2.685381193529856E-2f));
+        t          = V::fma(t, z, V::set1(1.128358514861418E-1f));
+        t          = V::fma(t, z, V::set1(-3.761262582423300E-1f));
+        t          = V::fma(t, z, V::set1(1.128379165726710E+0f));
+        auto small = V::mul(x, t);
+
+        auto q = V::div(V::set1(1.0f), ax);
+        auto y = V::mul(q, q);
+        // 1 <= |x| < 2
+        auto p = V::set1(2.326819970068386E-2f);
+        p      = V::fma(p, y, V::set1(-1.387039388740657E-1f));
+        p      = V::fma(p, y, V::set1(3.687424674597105E-1f));
+        p      = V::fma(p, y, V::set1(-5.824733027278666E-1f));
+        p      = V::fma(p, y, V::set1(6.210004621745983E-1f));
+        p      = V::fma(p, y, V::set1(-4.944515323274145E-1f));
+        p      = V::fma(p, y, V::set1(3.404879937665872E-1f));
+        p      = V::fma(p, y, V::set1(-2.741127028184656E-1f));
+        p      = V::fma(p, y, V::set1(5.638259427386472E-1f));
+        // |x| >= 2
+        auto r = V::set1(-1.047766399936249E+1f);
+        r      = V::fma(r, y, V::set1(1.297719955372516E+1f));
+        r      = V::fma(r, y, V::set1(-7.495518717768503E+0f));
+        r      = V::fma(r, y, V::set1(2.921019019210786E+0f));
+        r      = V::fma(r, y, V::set1(-1.015265279202700E+0f));
+        r      = V::fma(r, y, V::set1(4.218463358204948E-1f));
+        r      = V::fma(r, y, V::set1(-2.820767439740514E-1f));
+        r      = V::fma(r, y, V::set1(5.641895067754075E-1f));
+        p      = V::select(V::less(ax, V::set1(2.0f)), p, r);
+        auto erfc  = V::mul(V::mul(expNeg(z), q), p);
+        auto large = V::orf(V::sub(V::set1(1.0f), erfc), V::andf(x, V::set1(-0.0f)));
+        return V::select(V::less(ax, V::set1(1.0f)), small, large);
+    }
+
+    // Activations exported by frameworks as chains of element-wise ops, computed at once by fused execution
+    // x * sigmoid(x)
+    static F swish(F x) {
+        return V::mul(x, sigmoid(x));
+    }
+    // x * relu6(x + 3) / 6
+    static F hardSwish(F x) {
+        auto r = V::min(V::set1(6.0f), V::max(V::set1(0.0f), V::add(x, V::set1(3.0f))));
+        return V::mul(V::mul(x, r), V::set1(1.0f / 6.0f));
+    }
+    // x * (1 + erf(x / sqrt(2))) / 2
+    static F gelu(F x) {
+        auto e = erf(V::mul(x, V::set1(0.707106781186547524f)));
+        return V::mul(V::mul(x, V::add(e, V::set1(1.0f))), V::set1(0.5f));
+    }
+
+    static F sqrt(F x) {
+        return V::sqrt(x);
+    }
+    static F rsqrt(F x) {
+        return V::div(V::set1(1.0f), V::sqrt(x));
+    }
+
+    // Reduce by pi / 4 in three parts and choose the sin or cos polynomial of Cephes by the octant
+    static F sinCos(F x, bool isCos) {
+        auto ax = abs(x);
+        auto j  = V::truncToInt(V::mul(ax, V::set1(1.27323954473516f)));
+        j       = V::andi(V::addi(j, V::seti(1)), V::seti(~1));
+        auto y  = V::toFloat(j);
+        if (isCos) {
+            j = V::subi(j, V::seti(2));
+        }
+        auto flip     = V::equali(V::andi(j, V::seti(4)), V::seti(isCos ? 0 : 4));
+        auto usePolyS = V::equali(V::andi(j, V::seti(2)), V::seti(0));
+        auto r        = V::fma(y, V::set1(-0.78515625f), ax);
+        r             = V::fma(y, V::set1(-2.4187564849853515625e-4f), r);
+        r             = V::fma(y, V::set1(-3.77489497744594108e-8f), r);
+        auto z        = V::mul(r, r);
+        auto c        = V::set1(2.443315711809948E-005f);
+        c             = V::fma(c, z, V::set1(-1.388731625493765E-003f));
+        c             = V::fma(c, z, V::set1(4.166664568298827E-002f));
+        c             = V::fma(V::mul(c, z), z, V::fma(z, V::set1(-0.5f), V::set1(1.0f)));
+        auto s        = V::set1(-1.9515295891E-4f);
+        s             = V::fma(s, z, V::set1(8.3321608736E-3f));
+        s             = V::fma(s, z, V::set1(-1.6666654611E-1f));
+        s             = V::fma(V::mul(s, z), r, r);
+        auto result   = V::select(usePolyS, s, c);
+        result        = V::select(flip, neg(result), result);
+        if (!isCos) {
+            result = V::xorf(result, V::andf(x, V::set1(-0.0f)));
+        }
+        return result;
+    }
+    static F sin(F x) {
+        return sinCos(x, false);
+    }
+    static F cos(F x) {
+        return sinCos(x, true);
+    }
+
+    template <F (*function)(F)>
+    static void apply(float* dst, const float* src, size_t size) {
+        size_t i = 0;
+        for (; i + V::lanes <= size; i += V::lanes) {
+            V::save(dst + i, function(V::load(src + i)));
+        }
+        if (i < size) {
+            float temp[V::lanes];
+            ::memset(temp, 0, sizeof(temp));
+            ::memcpy(temp, src + i, (size - i) * sizeof(float));
+            V::save(temp, function(V::load(temp)));
+            ::memcpy(dst + i, temp, (size - i) * sizeof(float));
+        }
+    }
+
+    // The vector sin / cos reduce the input in float, so large input goes to the scalar function
+    template <F (*function)(F), float (*scalar)(float)>
+    static void applyTrigonometric(float* dst, const float* src, size_t size) {
+        const auto limit = V::set1(8192.0f);
+        size_t i         = 0;
+        for (; i + V::lanes <= size; i += V::lanes) {
+            auto x = V::load(src + i);
+            if (V::any(V::greater(abs(x), limit))) {
+                for (int j = 0; j < V::lanes; ++j) {
+                    dst[i + j] = scalar(src[i + j]);
+                }
+                continue;
+            }
+            V::save(dst + i, function(x));
+        }
+        for (; i < size; ++i) {
+            dst[i] = scalar(src[i]);
+        }
+    }
+};
+
+static inline float _scalarSin(float x) {
+    return ::sinf(x);
+}
+static inline float _scalarCos(float x) {
+    return ::cosf(x);
+}
+} // namespace Math
+} // namespace MNN
+
+// Define the functions declared in CommonOptFunction.h with vector type V, prefix is the instruction set
+#define MNN_DEFINE_MATH_FUNCTIONS(prefix, V)                                                               \
+    void prefix##MNNExp(float* dst, const float* src, size_t size) {                                       \
+        MNN::Math::MathFunctions<V>::apply<MNN::Math::MathFunctions<V>::expNeg>(dst, src, size);          \
+    }                                                                                                      \
+    void prefix##MNNTanh(float* dst, const float* src, size_t size) {                                      \
+        MNN::Math::MathFunctions<V>::apply<MNN::Math::MathFunctions<V>::tanh>(dst, src, size);            \
+    }                                                                                                      \
+    void prefix##MNNMathExp(float* dst, const float* src, size_t size) {                                   \
+        MNN::Math::MathFunctions<V>::apply<MNN::Math::MathFunctions<V>::exp>(dst, src, size);             \
+    }                                                                                                      \
+    void prefix##MNNMathLog(float* dst, const float* src, size_t size) {                                   \
+        MNN::Math::MathFunctions<V>::apply<MNN::Math::MathFunctions<V>::log>(dst, src, size);             \
+    }                                                                                                      \
+    void prefix##MNNMathSigmoid(float* dst, const float* src, size_t size) {                               \
+        MNN::Math::MathFunctions<V>::apply<MNN::Math::MathFunctions<V>::sigmoid>(dst, src, size);         \
+    }                                                                                                      \
+    void prefix##MNNMathErf(float* dst, const float* src, size_t size) {                                   \
+        MNN::Math::MathFunctions<V>::apply<MNN::Math::MathFunctions<V>::erf>(dst, src, size);             \
+    }                                                                                                      \
+    void prefix##MNNMathSwish(float* dst, const float* src, size_t size) {                                 \
+        MNN::Math::MathFunctions<V>::apply<MNN::Math::MathFunctions<V>::swish>(dst, src, size);           \
+    }                                                                                                      \
+    void prefix##MNNMathHardSwish(float* dst, const float* src, size_t size) {                             \
+        MNN::Math::MathFunctions<V>::apply<MNN::Math::MathFunctions<V>::hardSwish>(dst, src, size);       \
+    }                                                                                                      \
+    void prefix##MNNMathGelu(float* dst, const float* src, size_t size) {                                  \
+        MNN::Math::MathFunctions<V>::apply<MNN::Math::MathFunctions<V>::gelu>(dst, src, size);            \
+    }                                                                                                      \
+    void prefix##MNNMathSqrt(float* dst, const float* src, size_t size) {                                  \
+        MNN::Math::MathFunctions<V>::apply<MNN::Math::MathFunctions<V>::sqrt>(dst, src, size);            \
+    }                                                                                                      \
+    void prefix##MNNMathRsqrt(float* dst, const float* src, size_t size) {                                 \
+        MNN::Math::MathFunctions<V>::apply<MNN::Math::MathFunctions<V>::rsqrt>(dst, src, size);           \
+    }                                                                                                      \
+    void prefix##MNNMathSin(float* dst, const float* src, size_t size) {                                   \
+        MNN::Math::MathFunctions<V>::applyTrigonometric<MNN::Math::MathFunctions<V>::sin,                 \
+                                                        MNN::Math::_scalarSin>(dst, src, size);           \
+    }                                                                                                      \
+    void prefix##MNNMathCos(float* dst, const float* src, size_t size) {                                   \
+        MNN::Math::MathFunctions<V>::applyTrigonometric<MNN::Math::MathFunctions<V>::cos,                 \
+                                                        MNN::Math::_scalarCos>(dst, src, size);           \
+    }
+
+#endif /* MathFunctions_hpp */
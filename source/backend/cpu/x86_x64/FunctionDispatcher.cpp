@@ -11,6 +11,9 @@
 #include <limits>
 #include "sse/FunctionSummary.hpp"
 #include "avx/FunctionSummary.hpp"
+#ifdef MNN_AVX512
+#include "avx512/FunctionSummary.hpp"
+#endif
 #include "cpu_id.h"
 // https://stackoverflow.com/a/11230437
 #if defined(_MSC_VER)
@@ -53,6 +56,59 @@ struct FunctionGroup {
                               size_t dst_depth_quad, size_t width, size_t weight_depth_offset) = _SSE_MNNGemmFloatCommon_4;
     void (*MNNPackedMatMul)(float* C, const float* A, const float* B, const size_t* parameter, float* cache, const float* postParameters, const float* bias) = _SSE_MNNPackedMatMul;
     void (*MNNPackedMatMulRemain)(float* C, const float* A, const float* B, size_t eSize, const size_t* parameter, float* cache, const float* postParameters, const float* bias) = _SSE_MNNPackedMatMulRemain;
+    void (*MNNPackC4ForMatMul_A)(float* dest, const float* source, size_t e, size_t l, size_t eReal) = _SSE_MNNPackC4ForMatMul_A;
+    void (*MNNPackForMatMul_B)(float* dest, const float* source, size_t h, size_t l, bool transpose) = _SSE_MNNPackForMatMul_B;
+    // Pack mode of MNNPackedMatMul, the pack functions above must match it
+    int eP = 16;
+    int lP = 1;
+    int hP = 6;
+
+    void (*MNNGemmInt8AddBiasScale_16x4_Unit)(int8_t* dst, const int8_t* src, const int8_t* weight, const int32_t* bias, const float* scale,
+                                              size_t src_depth_quad, size_t dst_step, size_t dst_depth_quad) = _SSE_MNNGemmInt8AddBiasScale_16x4_Unit;
+    void (*MNNLineDepthWiseInt8AddBiasScaleUnit)(int8_t* dst, const int8_t* src, const int8_t* weight, const int32_t* bias_z, size_t width,
+                                                 size_t src_w_step, size_t fw, size_t fh, size_t dilateX_step, size_t dilateY_step,
+                                                 const float* scale_z, size_t mode) = _SSE_MNNLineDepthWiseInt8AddBiasScaleUnit;
+
+    // Element-wise math of MathFunctions.hpp
+    void (*MNNExp)(float* dst, const float* src, size_t size) = _SSE_MNNExp;
+    void (*MNNTanh)(float* dst, const float* src, size_t size) = _SSE_MNNTanh;
+    void (*MNNMathExp)(float* dst, const float* src, size_t size) = _SSE_MNNMathExp;
+    void (*MNNMathLog)(float* dst, const float* src, size_t size) = _SSE_MNNMathLog;
+    void (*MNNMathSigmoid)(float* dst, const float* src, size_t size) = _SSE_MNNMathSigmoid;
+    void (*MNNMathErf)(float* dst, const float* src, size_t size) = _SSE_MNNMathErf;
+    void (*MNNMathSwish)(float* dst, const float* src, size_t size) = _SSE_MNNMathSwish;
+    void (*MNNMathHardSwish)(float* dst, const float* src, size_t size) = _SSE_MNNMathHardSwish;
+    void (*MNNMathGelu)(float* dst, const float* src, size_t size) = _SSE_MNNMathGelu;
+    void (*MNNMathSqrt)(float* dst, const float* src, size_t size) = _SSE_MNNMathSqrt;
+    void (*MNNMathRsqrt)(float* dst, const float* src, size_t size) = _SSE_MNNMathRsqrt;
+    void (*MNNMathSin)(float* dst, const float* src, size_t size) = _SSE_MNNMathSin;
+    void (*MNNMathCos)(float* dst, const float* src, size_t size) = _SSE_MNNMathCos;
+
+    // Samplers and blitters of ImageProcess
+    void (*MNNSamplerC4Bilinear)(const unsigned char* source, unsigned char* dest, float* points, size_t count,
+                                 size_t xMax, size_t yMax, size_t yStride) = _SSE_MNNSamplerC4Bilinear;
+    void (*MNNSamplerC1Bilinear)(const unsigned char* source, unsigned char* dest, float* points, size_t count,
+                                 size_t xMax, size_t yMax, size_t yStride) = _SSE_MNNSamplerC1Bilinear;
+    void (*MNNSamplerC4Nearest)(const unsigned char* source, unsigned char* dest, float* points, size_t count,
+                                size_t xMax, size_t yMax, size_t yStride) = _SSE_MNNSamplerC4Nearest;
+    void (*MNNSamplerC1Nearest)(const unsigned char* source, unsigned char* dest, float* points, size_t count,
+                                size_t xMax, size_t yMax, size_t yStride) = _SSE_MNNSamplerC1Nearest;
+    void (*MNNNV21ToRGBUnit)(const unsigned char* source, unsigned char* dest, size_t countDiv16,
+                             const unsigned char* uv) = _SSE_MNNNV21ToRGBUnit;
+    void (*MNNNV21ToBGRUnit)(const unsigned char* source, unsigned char* dest, size_t countDiv16,
+                             const unsigned char* uv) = _SSE_MNNNV21ToBGRUnit;
+    void (*MNNNV21ToRGBAUnit)(const unsigned char* source, unsigned char* dest, size_t countDiv16,
+                              const unsigned char* uv) = _SSE_MNNNV21ToRGBAUnit;
+    void (*MNNBlitC1ToFloatC1)(const unsigned char* source, float* dest, const float* mean, const float* normal,
+                               size_t count) = _SSE_MNNBlitC1ToFloatC1;
+    void (*MNNBlitC3ToFloatC3)(const unsigned char* source, float* dest, const float* mean, const float* normal,
+                               size_t count) = _SSE_MNNBlitC3ToFloatC3;
+    void (*MNNBlitC4ToFloatC4)(const unsigned char* source, float* dest, const float* mean, const float* normal,
+                               size_t count) = _SSE_MNNBlitC4ToFloatC4;
+    void (*MNNBlitC1ToFloatRGBA)(const unsigned char* source, float* dest, const float* mean, const float* normal,
+                                 size_t count) = _SSE_MNNBlitC1ToFloatRGBA;
+    void (*MNNBlitC3ToFloatRGBA)(const unsigned char* source, float* dest, const float* mean, const float* normal,
+                                 size_t count) = _SSE_MNNBlitC3ToFloatRGBA;
 };
 
 static FunctionGroup gFunc;
@@ -68,13 +124,71 @@ void MNNFunctionInit() {
         gFunc.MNNGemmFloatCommon_4 = _AVX_MNNGemmFloatCommon_4;
         gFunc.MNNPackedMatMul = _AVX_MNNPackedMatMul;
         gFunc.MNNPackedMatMulRemain = _AVX_MNNPackedMatMulRemain;
+        gFunc.MNNGemmInt8AddBiasScale_16x4_Unit = _AVX_MNNGemmInt8AddBiasScale_16x4_Unit;
+        gFunc.MNNLineDepthWiseInt8AddBiasScaleUnit = _AVX_MNNLineDepthWiseInt8AddBiasScaleUnit;
+        gFunc.MNNSamplerC4Bilinear = _AVX_MNNSamplerC4Bilinear;
+        gFunc.MNNSamplerC1Bilinear = _AVX_MNNSamplerC1Bilinear;
+        gFunc.MNNSamplerC4Nearest = _AVX_MNNSamplerC4Nearest;
+        gFunc.MNNSamplerC1Nearest = _AVX_MNNSamplerC1Nearest;
+        gFunc.MNNNV21ToRGBUnit = _AVX_MNNNV21ToRGBUnit;
+        gFunc.MNNNV21ToBGRUnit = _AVX_MNNNV21ToBGRUnit;
+        gFunc.MNNNV21ToRGBAUnit = _AVX_MNNNV21ToRGBAUnit;
+        gFunc.MNNBlitC1ToFloatC1 = _AVX_MNNBlitC1ToFloatC1;
+        gFunc.MNNBlitC3ToFloatC3 = _AVX_MNNBlitC3ToFloatC3;
+        gFunc.MNNBlitC4ToFloatC4 = _AVX_MNNBlitC4ToFloatC4;
+        gFunc.MNNBlitC1ToFloatRGBA = _AVX_MNNBlitC1ToFloatRGBA;
+        gFunc.MNNBlitC3ToFloatRGBA = _AVX_MNNBlitC3ToFloatRGBA;
         if (cpuFlags & libyuv::kCpuHasFMA3) {
             gFunc.MNNGemmFloatUnit_4 = _AVX_MNNGemmFloatUnitFMA_4;
             gFunc.MNNGemmFloatCommon_4 = _AVX_MNNGemmFloatCommonFMA_4;
             gFunc.MNNPackedMatMul = _AVX_MNNPackedMatMulFMA;
             gFunc.MNNPackedMatMulRemain = _AVX_MNNPackedMatMulRemainFMA;
+            gFunc.MNNExp = _AVX_MNNExp;
+            gFunc.MNNTanh = _AVX_MNNTanh;
+            gFunc.MNNMathExp = _AVX_MNNMathExp;
+            gFunc.MNNMathLog = _AVX_MNNMathLog;
+            gFunc.MNNMathSigmoid = _AVX_MNNMathSigmoid;
+            gFunc.MNNMathErf = _AVX_MNNMathErf;
+            gFunc.MNNMathSwish = _AVX_MNNMathSwish;
+            gFunc.MNNMathHardSwish = _AVX_MNNMathHardSwish;
+            gFunc.MNNMathGelu = _AVX_MNNMathGelu;
+            gFunc.MNNMathSqrt = _AVX_MNNMathSqrt;
+            gFunc.MNNMathRsqrt = _AVX_MNNMathRsqrt;
+            gFunc.MNNMathSin = _AVX_MNNMathSin;
+            gFunc.MNNMathCos = _AVX_MNNMathCos;
         }
     }
+#ifdef MNN_AVX512
+    if (cpuFlags & libyuv::kCpuHasAVX512F) {
+        gFunc.MNNAddBias = _AVX512_MNNAddBias;
+        gFunc.MNNAddBiasRelu = _AVX512_MNNAddBiasRelu;
+        gFunc.MNNAddBiasRelu6 = _AVX512_MNNAddBiasRelu6;
+        gFunc.MNNPackedMatMul = _AVX512_MNNPackedMatMul;
+        gFunc.MNNPackedMatMulRemain = _AVX512_MNNPackedMatMulRemain;
+        gFunc.MNNPackC4ForMatMul_A = _AVX512_MNNPackC4ForMatMul_A;
+        gFunc.MNNPackForMatMul_B = _AVX512_MNNPackForMatMul_B;
+        _AVX512_MNNGetMatMulPackMode(&gFunc.eP, &gFunc.lP, &gFunc.hP);
+        gFunc.MNNExp = _AVX512_MNNExp;
+        gFunc.MNNTanh = _AVX512_MNNTanh;
+        gFunc.MNNMathExp = _AVX512_MNNMathExp;
+        gFunc.MNNMathLog = _AVX512_MNNMathLog;
+        gFunc.MNNMathSigmoid = _AVX512_MNNMathSigmoid;
+        gFunc.MNNMathErf = _AVX512_MNNMathErf;
+        gFunc.MNNMathSwish = _AVX512_MNNMathSwish;
+        gFunc.MNNMathHardSwish = _AVX512_MNNMathHardSwish;
+        gFunc.MNNMathGelu = _AVX512_MNNMathGelu;
+        gFunc.MNNMathSqrt = _AVX512_MNNMathSqrt;
+        gFunc.MNNMathRsqrt = _AVX512_MNNMathRsqrt;
+        gFunc.MNNMathSin = _AVX512_MNNMathSin;
+        gFunc.MNNMathCos = _AVX512_MNNMathCos;
+    }
+#endif
+#ifdef MNN_AVX512_VNNI
+    if (cpuFlags & libyuv::kCpuHasAVX512VNNI) {
+        gFunc.MNNGemmInt8AddBiasScale_16x4_Unit = _AVX512_MNNGemmInt8AddBiasScale_16x4_Unit;
+        gFunc.MNNLineDepthWiseInt8AddBiasScaleUnit = _AVX512_MNNLineDepthWiseInt8AddBiasScaleUnit;
+    }
+#endif
 }
 
 // ========= CommonOptFunction.cpp ===========
@@ -121,238 +235,156 @@ void MNNMatrixSub(float* C, const float* A, const float* B, size_t widthC4, size
     gFunc.MNNMatrixSub(C, A, B, widthC4, cStride, aStride, bStride, height);
 }
 
-#include <algorithm>
-#include <cmath>
-inline int8_t int32ToInt8(int data, int bias, float scale) {
-    float value = (float)(data + bias) * scale;
-    value       = std::max(value, -127.0f);
-    value       = std::min(value, 127.0f);
-    return static_cast<int8_t>(roundf(value));
-}
+// ========= GemmInt8.cpp ===========
 void MNNGemmInt8AddBiasScale_16x4_Unit(int8_t* dst, const int8_t* src, const int8_t* weight, const int32_t* bias,
                                        const float* scale, size_t src_depth_quad, size_t dst_step, size_t dst_depth_quad) {
-    {
-        const auto dst_step_tmp = dst_step / sizeof(int8_t);
-        for (int dz = 0; dz < dst_depth_quad; ++dz) {
-            const auto weight_dz = weight + dz * src_depth_quad * (GEMM_INT8_UNIT * GEMM_INT8_SRC_UNIT);
-            const auto bias_dz   = bias + dz * GEMM_INT8_UNIT;
-            const auto scale_dz  = scale + dz * GEMM_INT8_UNIT;
-            auto dst_z           = dst + dz * dst_step_tmp;
-            for (int w = 0; w < GEMM_INT8_DST_XUNIT; ++w) {
-                const auto src_x   = src + w * GEMM_INT8_SRC_UNIT;
-                auto dst_x         = dst_z + w * GEMM_INT8_UNIT;
-                int32_t dstTemp[4] = {0, 0, 0, 0};
-
-                for (int sz = 0; sz < src_depth_quad; ++sz) {
-                    const auto weight_sz = weight_dz + (GEMM_INT8_UNIT * GEMM_INT8_SRC_UNIT) * sz;
-                    const auto src_z     = src_x + sz * GEMM_INT8_DST_XUNIT * GEMM_INT8_SRC_UNIT;
-
-                    for (int j = 0; j < GEMM_INT8_UNIT; ++j) {
-                        const auto weight_j = weight_sz + j * GEMM_INT8_SRC_UNIT;
-                        for (int i = 0; i < GEMM_INT8_SRC_UNIT; ++i) {
-                            dstTemp[j] += (int32_t)src_z[i] * (int32_t)weight_j[i];
-                        }
-                    }
-                }
-
-                for (int j = 0; j < 4; ++j) {
-                    dst_x[j] = int32ToInt8(dstTemp[j], bias_dz[j], scale_dz[j]);
-                }
-            }
-        }
-    }
- }
+    gFunc.MNNGemmInt8AddBiasScale_16x4_Unit(dst, src, weight, bias, scale, src_depth_quad, dst_step, dst_depth_quad);
+}
 
 void MNNGemmInt8AddBiasScale_16x4_Unit_FAST(int8_t* dst, const int8_t* src, const int8_t* weight, const int32_t* bias, const float* scale, size_t src_depth_quad, size_t dst_step, size_t dst_depth_quad){
     return MNNGemmInt8AddBiasScale_16x4_Unit(dst, src, weight, bias, scale, src_depth_quad, dst_step, dst_depth_quad);
 }
 
+void MNNDepthWiseInt8AddBiasScaleUnit(int8_t* dst, const int8_t* src, const int8_t* weight, const int32_t* bias,
+                                      size_t fw, size_t fh, size_t weight_y_step, size_t dilateX_step,
+                                      size_t dilateY_step, const float* scale) {
+    _SSE_MNNDepthWiseInt8AddBiasScaleUnit(dst, src, weight, bias, fw, fh, weight_y_step, dilateX_step, dilateY_step,
+                                          scale);
+}
+
+void MNNLineDepthWiseInt8AddBiasScaleUnit(int8_t* dst, const int8_t* src, const int8_t* weight, const int32_t* bias_z,
+                                          size_t width, size_t src_w_step, size_t fw, size_t fh, size_t dilateX_step,
+                                          size_t dilateY_step, const float* scale_z, size_t mode) {
+    gFunc.MNNLineDepthWiseInt8AddBiasScaleUnit(dst, src, weight, bias_z, width, src_w_step, fw, fh, dilateX_step,
+                                               dilateY_step, scale_z, mode);
+}
+
 void MNNReluWithSlopeChannel(float* dst, const float* src, const float* slope, size_t sizeQuad, size_t depthQuad) {
     return _SSE_MNNReluWithSlopeChannel(dst, src, slope, sizeQuad, depthQuad);
 }
 
 void MNNPackC4ForMatMul_A(float* dest, const float* source, size_t e, size_t l, size_t eReal) {
-    const int mid = 1;
-    auto ePack = e / 16;
-    auto eDiv = UP_DIV(e, 16);
-    auto lC4 = l / 4;
-    auto lDiv = UP_DIV(l, 4);
-    auto eRemain = ePack * 16;
-    auto lRemain = lC4 * 4;
-    if (eRemain != e) {
-        ::memset(dest, 0, eDiv * l * 16 * mid * sizeof(float));
-    }
-    for (int y=0; y<ePack; ++y) {
-        auto dstY = dest + y * l * 16;
-        auto srcY = source + y * 64;
-        for (int x=0; x<lC4 * mid; ++x) {
-            auto srcX = srcY + x * 4 * eReal;
-            auto dstX = dstY + x * 64;
-            auto s00 = _mm_loadu_ps(srcX + 0 * 4);
-            auto s01 = _mm_loadu_ps(srcX + 1 * 4);
-            auto s02 = _mm_loadu_ps(srcX + 2 * 4);
-            auto s03 = _mm_loadu_ps(srcX + 3 * 4);
-            auto s10 = _mm_loadu_ps(srcX + 4 * 4);
-            auto s11 = _mm_loadu_ps(srcX + 5 * 4);
-            auto s12 = _mm_loadu_ps(srcX + 6 * 4);
-            auto s13 = _mm_loadu_ps(srcX + 7 * 4);
-            auto s20 = _mm_loadu_ps(srcX + 8 * 4);
-            auto s21 = _mm_loadu_ps(srcX + 9 * 4);
-            auto s22 = _mm_loadu_ps(srcX + 10 * 4);
-            auto s23 = _mm_loadu_ps(srcX + 11 * 4);
-            auto s30 = _mm_loadu_ps(srcX + 12 * 4);
-            auto s31 = _mm_loadu_ps(srcX + 13 * 4);
-            auto s32 = _mm_loadu_ps(srcX + 14 * 4);
-            auto s33 = _mm_loadu_ps(srcX + 15 * 4);
-            
-            _MM_TRANSPOSE4_PS(s00, s01, s02, s03);
-            _MM_TRANSPOSE4_PS(s10, s11, s12, s13);
-            _MM_TRANSPOSE4_PS(s20, s21, s22, s23);
-            _MM_TRANSPOSE4_PS(s30, s31, s32, s33);
-            
-            _mm_storeu_ps(dstX + 4 * 0, s00);
-            _mm_storeu_ps(dstX + 4 * 4, s01);
-            _mm_storeu_ps(dstX + 4 * 8, s02);
-            _mm_storeu_ps(dstX + 4 * 12, s03);
-            _mm_storeu_ps(dstX + 4 * 1, s10);
-            _mm_storeu_ps(dstX + 4 * 5, s11);
-            _mm_storeu_ps(dstX + 4 * 9, s12);
-            _mm_storeu_ps(dstX + 4 * 13, s13);
-            _mm_storeu_ps(dstX + 4 * 2, s20);
-            _mm_storeu_ps(dstX + 4 * 6, s21);
-            _mm_storeu_ps(dstX + 4 * 10, s22);
-            _mm_storeu_ps(dstX + 4 * 14, s23);
-            _mm_storeu_ps(dstX + 4 * 3, s30);
-            _mm_storeu_ps(dstX + 4 * 7, s31);
-            _mm_storeu_ps(dstX + 4 * 11, s32);
-            _mm_storeu_ps(dstX + 4 * 15, s33);
-        }
-    }
-    // Right
-    for (int y=0; y<e; ++y) {
-        auto yR = y % 16;
-        auto yC = y / 16;
-        for (int z=0; z<mid; ++z) {
-            for (int x=lRemain; x<l; ++x) {
-                auto xR = x % 4;
-                auto xC = x / 4;
-                dest[(x * mid + z) * 16 + yR + yC * 16 * l * mid] = source[(xC * mid + z) * eReal * 4 + y * 4 + xR];
-            }
-        }
-    }
-    // Down
-    {
-        auto yC = ePack;
-        for (int y=eRemain; y<e; ++y) {
-            auto yR = y - eRemain;
-            for (int z=0; z<mid; ++z) {
-                for (int x=0; x<lRemain; ++x) {
-                    auto xR = x % 4;
-                    auto xC = x / 4;
-                    dest[(x * mid + z) * 16 + yR + yC * 16 * l * mid] = source[(xC + z * lDiv) * eReal * 4 + y * 4 + xR];
-                }
-            }
-        }
-    }
+    gFunc.MNNPackC4ForMatMul_A(dest, source, e, l, eReal);
 }
 
 void MNNPackForMatMul_B(float* dest, const float* source, size_t h, size_t l, bool transpose) {
-    auto hP = h / 6;
-    auto hR = hP * 6;
-    if (hR != h) {
-        ::memset(dest, 0, UP_DIV(h, 6)*6*l*sizeof(float));
-    }
-    if (!transpose) {
-        for (int y=0; y<hP; ++y) {
-            auto destY = dest + y * 6 * l;
-            auto sourceY = source + y * 6;
-            for (int x=0; x<l; ++x) {
-                ::memcpy(destY + 6 * x, sourceY + x * h, 6 * sizeof(float));
-            }
-        }
-        auto hRemain = h - hR;
-        if (hRemain > 0) {
-            auto destY = dest + hP * 6 * l;
-            auto sourceY = source + hP * 6;
-            for (int x=0; x<l; ++x) {
-                ::memcpy(destY + 6 * x, sourceY + x * h, hRemain * sizeof(float));
-            }
-        }
-        return;
-    }
-    // h, l -> h/6, l, 6, use 12 x 4 transpose
-    hP = h / 12;
-    hR = hP * 12;
-    auto lC4 = l / 4;
-    auto lR = lC4 * 4;
-    for (int y=0; y<hP; ++y) {
-        auto dstY = dest + y * l * 12;
-        auto srcY = source + y * l * 12;
-        for (int x=0; x<lC4; ++x) {
-            auto srcX = srcY + x * 4;
-            auto dstX = dstY + x * 48;
-            auto s00 = _mm_loadu_ps(srcX + 0 * l);
-            auto s01 = _mm_loadu_ps(srcX + 1 * l);
-            auto s02 = _mm_loadu_ps(srcX + 2 * l);
-            auto s03 = _mm_loadu_ps(srcX + 3 * l);
-            auto s04 = _mm_loadu_ps(srcX + 4 * l);
-            auto s05 = _mm_loadu_ps(srcX + 5 * l);
-            auto s06 = _mm_loadu_ps(srcX + 6 * l);
-            auto s07 = _mm_loadu_ps(srcX + 7 * l);
-            auto s08 = _mm_loadu_ps(srcX + 8 * l);
-            auto s09 = _mm_loadu_ps(srcX + 9 * l);
-            auto s10 = _mm_loadu_ps(srcX + 10 * l);
-            auto s11 = _mm_loadu_ps(srcX + 11 * l);
-            
-            _MM_TRANSPOSE4_PS(s00, s03, s06, s09);
-            _MM_TRANSPOSE4_PS(s01, s04, s07, s10);
-            _MM_TRANSPOSE4_PS(s02, s05, s08, s11);
-            
-            _mm_storeu_ps(dstX + 4 * 0, s00);
-            _mm_storeu_ps(dstX + 4 * 1, s01);
-            _mm_storeu_ps(dstX + 4 * 2, s02);
-            _mm_storeu_ps(dstX + 4 * 3, s03);
-            _mm_storeu_ps(dstX + 4 * 4, s04);
-            _mm_storeu_ps(dstX + 4 * 5, s05);
-            _mm_storeu_ps(dstX + 4 * 6, s06);
-            _mm_storeu_ps(dstX + 4 * 7, s07);
-            _mm_storeu_ps(dstX + 4 * 8, s08);
-            _mm_storeu_ps(dstX + 4 * 9, s09);
-            _mm_storeu_ps(dstX + 4 * 10, s10);
-            _mm_storeu_ps(dstX + 4 * 11, s11);
-        }
-    }
-    
-    // Right
-    for (int y=0; y<h; ++y) {
-        auto yR = y % 6;
-        auto yC = y / 6;
-        for (int x=lR; x<l; ++x) {
-            dest[x * 6 + yR + yC * 6 * l] = source[x + y * l];
-        }
-    }
-    // Down
-    for (int y=0; y<h; ++y) {
-        auto yR = y % 6;
-        auto yC = y / 6;
-        for (int x=0; x<l; ++x) {
-            dest[x * 6 + yR + yC * 6 * l] = source[x + y * l];
-        }
-    }
+    gFunc.MNNPackForMatMul_B(dest, source, h, l, transpose);
 }
 
 void MNNGetMatMulPackMode(int* eP, int *lP, int* hP) {
-    *eP = 16;
-    *lP = 1;
-    *hP = 6;
+    *eP = gFunc.eP;
+    *lP = gFunc.lP;
+    *hP = gFunc.hP;
 }
 
 int MNNGetConvolutionTileNumber() {
     return gFunc.tileNumber;
 }
+
+void MNNExp(float* dst, const float* src, size_t dataSize) {
+    gFunc.MNNExp(dst, src, dataSize);
+}
+
+void MNNTanh(float* dst, const float* src, size_t dataSize) {
+    gFunc.MNNTanh(dst, src, dataSize);
+}
+
+void MNNMathExp(float* dst, const float* src, size_t dataSize) {
+    gFunc.MNNMathExp(dst, src, dataSize);
+}
+
+void MNNMathLog(float* dst, const float* src, size_t dataSize) {
+    gFunc.MNNMathLog(dst, src, dataSize);
+}
+
+void MNNMathSigmoid(float* dst, const float* src, size_t dataSize) {
+    gFunc.MNNMathSigmoid(dst, src, dataSize);
+}
+
+void MNNMathErf(float* dst, const float* src, size_t dataSize) {
+    gFunc.MNNMathErf(dst, src, dataSize);
+}
+
+void MNNMathSwish(float* dst, const float* src, size_t dataSize) {
+    gFunc.MNNMathSwish(dst, src, dataSize);
+}
+
+void MNNMathHardSwish(float* dst, const float* src, size_t dataSize) {
+    gFunc.MNNMathHardSwish(dst, src, dataSize);
+}
+
+void MNNMathGelu(float* dst, const float* src, size_t dataSize) {
+    gFunc.MNNMathGelu(dst, src, dataSize);
+}
+
+void MNNMathSqrt(float* dst, const float* src, size_t dataSize) {
+    gFunc.MNNMathSqrt(dst, src, dataSize);
+}
+
+void MNNMathRsqrt(float* dst, const float* src, size_t dataSize) {
+    gFunc.MNNMathRsqrt(dst, src, dataSize);
+}
+
+void MNNMathSin(float* dst, const float* src, size_t dataSize) {
+    gFunc.MNNMathSin(dst, src, dataSize);
+}
+
+void MNNMathCos(float* dst, const float* src, size_t dataSize) {
+    gFunc.MNNMathCos(dst, src, dataSize);
+}
 void MNNPackedMatMul(float* C, const float* A, const float* B, const size_t* parameter, float* cache, const float* postParameters, const float* bias) {
     return gFunc.MNNPackedMatMul(C, A, B, parameter, cache, postParameters, bias);
 }
 void MNNPackedMatMulRemain(float* C, const float* A, const float* B, size_t eSize, const size_t* parameter, float* cache, const float* postParameters, const float* bias) {
     return gFunc.MNNPackedMatMulRemain(C, A, B, eSize, parameter, cache, postParameters, bias);
 }
+
+// ========= ImageProcessFunctions.cpp ===========
+// Same symbols as the arm assembly used by cv/ImageSampler.cpp, cv/ImageBlitter.cpp and cv/ImageFloatBlitter.cpp
+extern "C" {
+void MNNSamplerC4BilinearOpt(const unsigned char* source, unsigned char* dest, float* points, size_t count, size_t xMax,
+                             size_t yMax, size_t yStride) {
+    gFunc.MNNSamplerC4Bilinear(source, dest, points, count, xMax, yMax, yStride);
+}
+void MNNSamplerC1BilinearOpt(const unsigned char* source, unsigned char* dest, float* points, size_t count, size_t xMax,
+                             size_t yMax, size_t yStride) {
+    gFunc.MNNSamplerC1Bilinear(source, dest, points, count, xMax, yMax, yStride);
+}
+void MNNSamplerC4NearestOpt(const unsigned char* source, unsigned char* dest, float* points, size_t count, size_t iw,
+                            size_t ih, size_t yStride) {
+    gFunc.MNNSamplerC4Nearest(source, dest, points, count, iw, ih, yStride);
+}
+void MNNSamplerC1NearestOpt(const unsigned char* source, unsigned char* dest, float* points, size_t count, size_t iw,
+                            size_t ih, size_t yStride) {
+    gFunc.MNNSamplerC1Nearest(source, dest, points, count, iw, ih, yStride);
+}
+void MNNNV21ToRGBUnit(const unsigned char* source, unsigned char* dest, size_t countDiv8, const unsigned char* uv) {
+    gFunc.MNNNV21ToRGBUnit(source, dest, countDiv8, uv);
+}
+void MNNNV21ToBGRUnit(const unsigned char* source, unsigned char* dest, size_t countDiv8, const unsigned char* uv) {
+    gFunc.MNNNV21ToBGRUnit(source, dest, countDiv8, uv);
+}
+void MNNNV21ToRGBAUnit(const unsigned char* source, unsigned char* dest, size_t countDiv8, const unsigned char* uv) {
+    gFunc.MNNNV21ToRGBAUnit(source, dest, countDiv8, uv);
+}
+void MNNBlitC1ToFloatC1(const unsigned char* source, float* dest, const float* mean, const float* normal,
+                        size_t count) {
+    gFunc.MNNBlitC1ToFloatC1(source, dest, mean, normal, count);
+}
+void MNNBlitC3ToFloatC3(const unsigned char* source, float* dest, const float* mean, const float* normal,
+                        size_t count) {
+    gFunc.MNNBlitC3ToFloatC3(source, dest, mean, normal, count);
+}
+void MNNBlitC4ToFloatC4(const unsigned char* source, float* dest, const float* mean, const float* normal,
+                        size_t count) {
+    gFunc.MNNBlitC4ToFloatC4(source, dest, mean, normal, count);
+}
+void MNNBlitC1ToFloatRGBA(const unsigned char* source, float* dest, const float* mean, const float* normal,
+                          size_t count) {
+    gFunc.MNNBlitC1ToFloatRGBA(source, dest, mean, normal, count);
+}
+void MNNBlitC3ToFloatRGBA(const unsigned char* source, float* dest, const float* mean, const float* normal,
+                          size_t count) {
+    gFunc.MNNBlitC3ToFloatRGBA(source, dest, mean, normal, count);
+}
+}
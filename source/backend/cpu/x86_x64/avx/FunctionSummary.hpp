@@ -71,14 +71,61 @@ void _AVX_MNNMatrixSub(float* C, const float* A, const float* B, size_t widthC4,
 void _AVX_MNNStrassenMergeCFunction(float* c11, float* c12, float* c21, float* c22, float* xAddr, size_t cStride,
                                size_t length, size_t hSub);
 
+// ========= GemmInt8.cpp ===========
 
 void _AVX_MNNGemmInt8AddBiasScale_16x4_Unit(int8_t* dst, const int8_t* src, const int8_t* weight, const int32_t* bias,
                                        const float* scale, size_t src_depth_quad, size_t dst_step, size_t dst_depth_quad);
+void _AVX_MNNLineDepthWiseInt8AddBiasScaleUnit(int8_t* dst, const int8_t* src, const int8_t* weight,
+                                               const int32_t* bias_z, size_t width, size_t src_w_step, size_t fw,
+                                               size_t fh, size_t dilateX_step, size_t dilateY_step,
+                                               const float* scale_z, size_t mode);
+
 void _AVX_MNNPackedMatMul(float* C, const float* A, const float* B, const size_t* parameter, float* cache, const float* postParameters, const float* bias);
 void _AVX_MNNPackedMatMulRemain(float* C, const float* A, const float* B, size_t eSize, const size_t* parameter, float* cache, const float* postParameters, const float* bias);
 
 void _AVX_MNNPackedMatMulFMA(float* C, const float* A, const float* B, const size_t* parameter, float* cache, const float* postParameters, const float* bias);
 void _AVX_MNNPackedMatMulRemainFMA(float* C, const float* A, const float* B, size_t eSize, const size_t* parameter, float* cache, const float* postParameters, const float* bias);
 
-
+// ========= MathFunctions.cpp ===========
+
+void _AVX_MNNExp(float* dst, const float* src, size_t size);
+void _AVX_MNNTanh(float* dst, const float* src, size_t size);
+void _AVX_MNNMathExp(float* dst, const float* src, size_t size);
+void _AVX_MNNMathLog(float* dst, const float* src, size_t size);
+void _AVX_MNNMathSigmoid(float* dst, const float* src, size_t size);
+void _AVX_MNNMathErf(float* dst, const float* src, size_t size);
+void _AVX_MNNMathSwish(float* dst, const float* src, size_t size);
+void _AVX_MNNMathHardSwish(float* dst, const float* src, size_t size);
+void _AVX_MNNMathGelu(float* dst, const float* src, size_t size);
+void _AVX_MNNMathSqrt(float* dst, const float* src, size_t size);
+void _AVX_MNNMathRsqrt(float* dst, const float* src, size_t size);
+void _AVX_MNNMathSin(float* dst, const float* src, size_t size);
+void _AVX_MNNMathCos(float* dst, const float* src, size_t size);
+
+// ========= ImageProcessFunctions.cpp ===========
+
+void _AVX_MNNSamplerC4Bilinear(const unsigned char* source, unsigned char* dest, float* points, size_t count,
+                               size_t xMax, size_t yMax, size_t yStride);
+void _AVX_MNNSamplerC1Bilinear(const unsigned char* source, unsigned char* dest, float* points, size_t count,
+                               size_t xMax, size_t yMax, size_t yStride);
+void _AVX_MNNSamplerC4Nearest(const unsigned char* source, unsigned char* dest, float* points, size_t count,
+                              size_t xMax, size_t yMax, size_t yStride);
+void _AVX_MNNSamplerC1Nearest(const unsigned char* source, unsigned char* dest, float* points, size_t count,
+                              size_t xMax, size_t yMax, size_t yStride);
+void _AVX_MNNNV21ToRGBUnit(const unsigned char* source, unsigned char* dest, size_t countDiv16,
+                           const unsigned char* uv);
+void _AVX_MNNNV21ToBGRUnit(const unsigned char* source, unsigned char* dest, size_t countDiv16,
+                           const unsigned char* uv);
+void _AVX_MNNNV21ToRGBAUnit(const unsigned char* source, unsigned char* dest, size_t countDiv16,
+                            const unsigned char* uv);
+void _AVX_MNNBlitC1ToFloatC1(const unsigned char* source, float* dest, const float* mean, const float* normal,
+                             size_t count);
+void _AVX_MNNBlitC3ToFloatC3(const unsigned char* source, float* dest, const float* mean, const float* normal,
+                             size_t count);
+void _AVX_MNNBlitC4ToFloatC4(const unsigned char* source, float* dest, const float* mean, const float* normal,
+                             size_t count);
+void _AVX_MNNBlitC1ToFloatRGBA(const unsigned char* source, float* dest, const float* mean, const float* normal,
+                               size_t count);
+void _AVX_MNNBlitC3ToFloatRGBA(const unsigned char* source, float* dest, const float* mean, const float* normal,
+                               size_t count);
 }
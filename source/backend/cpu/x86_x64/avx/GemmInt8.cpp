@@ -0,0 +1,125 @@
+//
+//  GemmInt8.cpp
+//  MNN
+//
+//  Created by MNN on 2020/05/03.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include "FunctionSummary.hpp"
+#include "backend/cpu/compute/Int8FunctionsOpt.h"
+
+// (sum + bias) * scale, clamped to [-127, 127] and rounded half away from zero as roundf
+static inline __m256i _postInt8(__m256i sum, __m256i bias, __m256 scale) {
+    auto value = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_add_epi32(sum, bias)), scale);
+    value      = _mm256_min_ps(_mm256_max_ps(value, _mm256_set1_ps(-127.0f)), _mm256_set1_ps(127.0f));
+    auto half  = _mm256_or_ps(_mm256_and_ps(value, _mm256_set1_ps(-0.0f)), _mm256_set1_ps(0.5f));
+    return _mm256_cvttps_epi32(_mm256_add_ps(value, half));
+}
+
+// Store 8 int32 in [-127, 127] as 8 int8
+static inline void _storeInt8x8(int8_t* dst, __m256i value) {
+    auto result = _mm_packs_epi32(_mm256_castsi256_si128(value), _mm256_extracti128_si256(value, 1));
+    _mm_storel_epi64((__m128i*)dst, _mm_packs_epi16(result, result));
+}
+
+/*
+ vpmaddubsw multiplies unsigned int8 by signed int8, so |src| is multiplied by weight with the sign of src. Sum of two
+ products fits in int16 without saturation because quantized values are in [-127, 127].
+ */
+void _AVX_MNNGemmInt8AddBiasScale_16x4_Unit(int8_t* dst, const int8_t* src, const int8_t* weight, const int32_t* bias,
+                                            const float* scale, size_t src_depth_quad, size_t dst_step,
+                                            size_t dst_depth_quad) {
+    static_assert(GEMM_INT8_DST_XUNIT == 2, "Kernel computes two columns of dst");
+    const auto dst_step_tmp = dst_step / sizeof(int8_t);
+    const auto one          = _mm256_set1_epi16(1);
+    for (int dz = 0; dz < dst_depth_quad; ++dz) {
+        const auto weight_dz = weight + dz * src_depth_quad * (GEMM_INT8_UNIT * GEMM_INT8_SRC_UNIT);
+        auto dst_z           = dst + dz * dst_step_tmp;
+        // dWJ keeps partial sums of src row W, weight column J in the low 128 bits and J + 1 in the high
+        auto d00 = _mm256_setzero_si256();
+        auto d02 = _mm256_setzero_si256();
+        auto d10 = _mm256_setzero_si256();
+        auto d12 = _mm256_setzero_si256();
+        for (int sz = 0; sz < src_depth_quad; ++sz) {
+            const auto weight_sz = weight_dz + (GEMM_INT8_UNIT * GEMM_INT8_SRC_UNIT) * sz;
+            const auto src_z     = src + sz * GEMM_INT8_DST_XUNIT * GEMM_INT8_SRC_UNIT;
+            auto w01 = _mm256_loadu_si256((const __m256i*)weight_sz);
+            auto w23 = _mm256_loadu_si256((const __m256i*)(weight_sz + 2 * GEMM_INT8_SRC_UNIT));
+            auto s0  = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)src_z));
+            auto s1  = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)(src_z + GEMM_INT8_SRC_UNIT)));
+            auto a0  = _mm256_abs_epi8(s0);
+            auto a1  = _mm256_abs_epi8(s1);
+            d00 = _mm256_add_epi32(d00, _mm256_madd_epi16(_mm256_maddubs_epi16(a0, _mm256_sign_epi8(w01, s0)), one));
+            d02 = _mm256_add_epi32(d02, _mm256_madd_epi16(_mm256_maddubs_epi16(a0, _mm256_sign_epi8(w23, s0)), one));
+            d10 = _mm256_add_epi32(d10, _mm256_madd_epi16(_mm256_maddubs_epi16(a1, _mm256_sign_epi8(w01, s1)), one));
+            d12 = _mm256_add_epi32(d12, _mm256_madd_epi16(_mm256_maddubs_epi16(a1, _mm256_sign_epi8(w23, s1)), one));
+        }
+        // After two hadd, the low 128 bits are columns (0, 2) of row 0 and 1, the high are columns (1, 3)
+        auto r   = _mm256_hadd_epi32(_mm256_hadd_epi32(d00, d02), _mm256_hadd_epi32(d10, d12));
+        auto lo  = _mm256_castsi256_si128(r);
+        auto hi  = _mm256_extracti128_si256(r, 1);
+        auto sum = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_unpacklo_epi32(lo, hi)), _mm_unpackhi_epi32(lo, hi), 1);
+        auto biasValue  = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)(bias + dz * GEMM_INT8_UNIT)));
+        auto scaleValue = _mm256_broadcast_ps((const __m128*)(scale + dz * GEMM_INT8_UNIT));
+        _storeInt8x8(dst_z, _postInt8(sum, biasValue, scaleValue));
+    }
+}
+
+// Load 4 channels of two pixels and extend to int32
+static inline __m256i _loadPixel2(const int8_t* src, size_t step) {
+    auto x = _mm_unpacklo_epi32(_mm_cvtsi32_si128(*(const int32_t*)src), _mm_cvtsi32_si128(*(const int32_t*)(src + step)));
+    return _mm256_cvtepi8_epi32(x);
+}
+
+void _AVX_MNNLineDepthWiseInt8AddBiasScaleUnit(int8_t* dst, const int8_t* src, const int8_t* weight,
+                                               const int32_t* bias_z, size_t width, size_t src_w_step, size_t fw,
+                                               size_t fh, size_t dilateX_step, size_t dilateY_step,
+                                               const float* scale_z, size_t mode) {
+    (void)mode;
+    // The high half of every int32 lane of weight is cleared, so madd gives the product of each channel
+    const auto mask       = _mm256_set1_epi32(0xffff);
+    const auto biasValue  = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)bias_z));
+    const auto scaleValue = _mm256_broadcast_ps((const __m128*)scale_z);
+    int dx = 0;
+    for (; dx + 8 <= width; dx += 8) {
+        const auto src_z = src + src_w_step * dx;
+        auto d0 = _mm256_setzero_si256();
+        auto d1 = _mm256_setzero_si256();
+        auto d2 = _mm256_setzero_si256();
+        auto d3 = _mm256_setzero_si256();
+        for (int fy = 0; fy < fh; ++fy) {
+            const auto src_y    = src_z + fy * dilateY_step;
+            const auto weight_y = weight + fy * fw * 4;
+            for (int fx = 0; fx < fw; ++fx) {
+                const auto src_x = src_y + fx * dilateX_step;
+                auto w = _mm256_and_si256(_mm256_cvtepi8_epi32(_mm_set1_epi32(*(const int32_t*)(weight_y + 4 * fx))), mask);
+                d0 = _mm256_add_epi32(d0, _mm256_madd_epi16(_loadPixel2(src_x + 0 * src_w_step, src_w_step), w));
+                d1 = _mm256_add_epi32(d1, _mm256_madd_epi16(_loadPixel2(src_x + 2 * src_w_step, src_w_step), w));
+                d2 = _mm256_add_epi32(d2, _mm256_madd_epi16(_loadPixel2(src_x + 4 * src_w_step, src_w_step), w));
+                d3 = _mm256_add_epi32(d3, _mm256_madd_epi16(_loadPixel2(src_x + 6 * src_w_step, src_w_step), w));
+            }
+        }
+        auto dst_x = dst + dx * 4;
+        _storeInt8x8(dst_x + 0, _postInt8(d0, biasValue, scaleValue));
+        _storeInt8x8(dst_x + 8, _postInt8(d1, biasValue, scaleValue));
+        _storeInt8x8(dst_x + 16, _postInt8(d2, biasValue, scaleValue));
+        _storeInt8x8(dst_x + 24, _postInt8(d3, biasValue, scaleValue));
+    }
+    for (; dx < width; ++dx) {
+        const auto src_z = src + src_w_step * dx;
+        auto d0 = _mm256_setzero_si256();
+        for (int fy = 0; fy < fh; ++fy) {
+            const auto src_y    = src_z + fy * dilateY_step;
+            const auto weight_y = weight + fy * fw * 4;
+            for (int fx = 0; fx < fw; ++fx) {
+                auto s = _mm256_cvtepi8_epi32(_mm_cvtsi32_si128(*(const int32_t*)(src_y + fx * dilateX_step)));
+                auto w = _mm256_and_si256(_mm256_cvtepi8_epi32(_mm_cvtsi32_si128(*(const int32_t*)(weight_y + 4 * fx))), mask);
+                d0     = _mm256_add_epi32(d0, _mm256_madd_epi16(s, w));
+            }
+        }
+        auto result = _postInt8(d0, biasValue, scaleValue);
+        auto pack   = _mm_packs_epi32(_mm256_castsi256_si128(result), _mm256_castsi256_si128(result));
+        *((int32_t*)(dst + dx * 4)) = _mm_cvtsi128_si32(_mm_packs_epi16(pack, pack));
+    }
+}
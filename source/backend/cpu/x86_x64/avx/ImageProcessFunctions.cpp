@@ -0,0 +1,375 @@
+//
+//  ImageProcessFunctions.cpp
+//  MNN
+//
+//  Created by MNN on 2020/05/11.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <string.h>
+#include <algorithm>
+#include "FunctionSummary.hpp"
+
+// Needs AVX2. Samplers read points[0] as the first position and points[1] as the step, xMax = iw - 1, yMax = ih - 1
+struct SamplerPosition {
+    __m256i x0, x1, y0, y1;
+    __m256 xF, yF;
+};
+
+static inline void _position(const float* points, size_t i, size_t xMax, size_t yMax, __m256& x, __m256& y) {
+    auto index = _mm256_add_ps(_mm256_set1_ps((float)i), _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f));
+    x          = _mm256_add_ps(_mm256_set1_ps(points[0]), _mm256_mul_ps(index, _mm256_set1_ps(points[2])));
+    y          = _mm256_add_ps(_mm256_set1_ps(points[1]), _mm256_mul_ps(index, _mm256_set1_ps(points[3])));
+    x          = _mm256_min_ps(_mm256_max_ps(x, _mm256_setzero_ps()), _mm256_set1_ps((float)xMax));
+    y          = _mm256_min_ps(_mm256_max_ps(y, _mm256_setzero_ps()), _mm256_set1_ps((float)yMax));
+}
+
+static inline SamplerPosition _bilinearPosition(const float* points, size_t i, size_t xMax, size_t yMax) {
+    __m256 x, y;
+    _position(points, i, xMax, yMax, x, y);
+    SamplerPosition p;
+    p.x0 = _mm256_cvttps_epi32(x);
+    p.y0 = _mm256_cvttps_epi32(y);
+    p.x1 = _mm256_min_epi32(_mm256_add_epi32(p.x0, _mm256_set1_epi32(1)), _mm256_set1_epi32((int)xMax));
+    p.y1 = _mm256_min_epi32(_mm256_add_epi32(p.y0, _mm256_set1_epi32(1)), _mm256_set1_epi32((int)yMax));
+    p.xF = _mm256_sub_ps(x, _mm256_cvtepi32_ps(p.x0));
+    p.yF = _mm256_sub_ps(y, _mm256_cvtepi32_ps(p.y0));
+    return p;
+}
+
+static inline __m256 _lerp2D(__m256 c00, __m256 c01, __m256 c10, __m256 c11, __m256 xF, __m256 yF) {
+    auto top    = _mm256_add_ps(c00, _mm256_mul_ps(_mm256_sub_ps(c01, c00), xF));
+    auto bottom = _mm256_add_ps(c10, _mm256_mul_ps(_mm256_sub_ps(c11, c10), xF));
+    return _mm256_add_ps(top, _mm256_mul_ps(_mm256_sub_ps(bottom, top), yF));
+}
+
+static inline __m256 _channel(__m256i pixels, int c) {
+    return _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(pixels, 8 * c), _mm256_set1_epi32(0xff)));
+}
+
+static inline __m256i _toByte(__m256 v) {
+    return _mm256_min_epi32(_mm256_max_epi32(_mm256_cvttps_epi32(v), _mm256_setzero_si256()), _mm256_set1_epi32(255));
+}
+
+static inline __m256i _offset(__m256i y, __m256i x, size_t yStride, int bpp) {
+    return _mm256_add_epi32(_mm256_mullo_epi32(y, _mm256_set1_epi32((int)yStride)),
+                            _mm256_mullo_epi32(x, _mm256_set1_epi32(bpp)));
+}
+
+static inline __m256i _gather(const unsigned char* source, __m256i offset) {
+    return _mm256_i32gather_epi32((const int*)source, offset, 1);
+}
+
+// Gather of one byte reads 4 bytes, the block with any offset over limit is loaded by bytes
+static inline __m256i _gatherC1(const unsigned char* source, __m256i offset, bool safe) {
+    if (safe) {
+        return _mm256_and_si256(_gather(source, offset), _mm256_set1_epi32(0xff));
+    }
+    int32_t o[8];
+    _mm256_storeu_si256((__m256i*)o, offset);
+    return _mm256_setr_epi32(source[o[0]], source[o[1]], source[o[2]], source[o[3]], source[o[4]], source[o[5]],
+                             source[o[6]], source[o[7]]);
+}
+
+static inline bool _safeC1(__m256i maxOffset, size_t xMax, size_t yMax, size_t yStride) {
+    // The last byte of source is at yMax * yStride + xMax
+    auto limit = _mm256_set1_epi32((int)(yMax * yStride + xMax) - 3);
+    return 0 == _mm256_movemask_epi8(_mm256_cmpgt_epi32(maxOffset, limit));
+}
+
+static inline void _storeC4(unsigned char* dest, __m256i v, size_t count) {
+    if (count >= 8) {
+        _mm256_storeu_si256((__m256i*)dest, v);
+        return;
+    }
+    int32_t temp[8];
+    _mm256_storeu_si256((__m256i*)temp, v);
+    ::memcpy(dest, temp, 4 * count);
+}
+
+// Save the low byte of 8 lanes
+static inline void _storeC1(unsigned char* dest, __m256i v, size_t count) {
+    auto packed = _mm256_packus_epi16(_mm256_packus_epi32(v, v), v);
+    int32_t result[2];
+    result[0] = _mm_cvtsi128_si32(_mm256_castsi256_si128(packed));
+    result[1] = _mm_cvtsi128_si32(_mm256_extracti128_si256(packed, 1));
+    ::memcpy(dest, result, std::min(count, (size_t)8));
+}
+
+void _AVX_MNNSamplerC4Bilinear(const unsigned char* source, unsigned char* dest, float* points, size_t count,
+                               size_t xMax, size_t yMax, size_t yStride) {
+    for (size_t i = 0; i < count; i += 8) {
+        auto p      = _bilinearPosition(points, i, xMax, yMax);
+        auto p00    = _gather(source, _offset(p.y0, p.x0, yStride, 4));
+        auto p01    = _gather(source, _offset(p.y0, p.x1, yStride, 4));
+        auto p10    = _gather(source, _offset(p.y1, p.x0, yStride, 4));
+        auto p11    = _gather(source, _offset(p.y1, p.x1, yStride, 4));
+        auto result = _mm256_setzero_si256();
+        for (int c = 0; c < 4; ++c) {
+            auto v = _lerp2D(_channel(p00, c), _channel(p01, c), _channel(p10, c), _channel(p11, c), p.xF, p.yF);
+            result = _mm256_or_si256(result, _mm256_slli_epi32(_toByte(v), 8 * c));
+        }
+        _storeC4(dest + 4 * i, result, count - i);
+    }
+}
+
+void _AVX_MNNSamplerC1Bilinear(const unsigned char* source, unsigned char* dest, float* points, size_t count,
+                               size_t xMax, size_t yMax, size_t yStride) {
+    for (size_t i = 0; i < count; i += 8) {
+        auto p    = _bilinearPosition(points, i, xMax, yMax);
+        auto o00  = _offset(p.y0, p.x0, yStride, 1);
+        auto o10  = _offset(p.y1, p.x0, yStride, 1);
+        auto dx   = _mm256_sub_epi32(p.x1, p.x0);
+        // x1 is x0 + 1 unless x0 is xMax, then the weight of x1 is zero
+        bool safe = _safeC1(o10, xMax, yMax, yStride);
+        __m256 c00, c01, c10, c11;
+        if (safe) {
+            auto top    = _gather(source, o00);
+            auto bottom = _gather(source, o10);
+            c00         = _channel(top, 0);
+            c01         = _channel(top, 1);
+            c10         = _channel(bottom, 0);
+            c11         = _channel(bottom, 1);
+        } else {
+            c00 = _mm256_cvtepi32_ps(_gatherC1(source, o00, false));
+            c01 = _mm256_cvtepi32_ps(_gatherC1(source, _mm256_add_epi32(o00, dx), false));
+            c10 = _mm256_cvtepi32_ps(_gatherC1(source, o10, false));
+            c11 = _mm256_cvtepi32_ps(_gatherC1(source, _mm256_add_epi32(o10, dx), false));
+        }
+        _storeC1(dest + i, _toByte(_lerp2D(c00, c01, c10, c11, p.xF, p.yF)), count - i);
+    }
+}
+
+static inline __m256i _nearestOffset(const float* points, size_t i, size_t xMax, size_t yMax, size_t yStride,
+                                     int bpp) {
+    __m256 x, y;
+    _position(points, i, xMax, yMax, x, y);
+    // Round half away from zero as roundf for the positive position
+    auto half = _mm256_set1_ps(0.5f);
+    return _offset(_mm256_cvttps_epi32(_mm256_add_ps(y, half)), _mm256_cvttps_epi32(_mm256_add_ps(x, half)), yStride,
+                   bpp);
+}
+
+void _AVX_MNNSamplerC4Nearest(const unsigned char* source, unsigned char* dest, float* points, size_t count,
+                              size_t xMax, size_t yMax, size_t yStride) {
+    for (size_t i = 0; i < count; i += 8) {
+        _storeC4(dest + 4 * i, _gather(source, _nearestOffset(points, i, xMax, yMax, yStride, 4)), count - i);
+    }
+}
+
+void _AVX_MNNSamplerC1Nearest(const unsigned char* source, unsigned char* dest, float* points, size_t count,
+                              size_t xMax, size_t yMax, size_t yStride) {
+    for (size_t i = 0; i < count; i += 8) {
+        auto offset = _nearestOffset(points, i, xMax, yMax, yStride, 1);
+        _storeC1(dest + i, _gatherC1(source, offset, _safeC1(offset, xMax, yMax, yStride)), count - i);
+    }
+}
+
+// YUV to RGB in int16: R = (64Y + 73V) >> 6, G = (64Y - 25U - 37V) >> 6, B = (64Y + 130U) >> 6, saturated.
+// Each 128 bits lane converts 16 pixels as the SSE version, rgba[i] has pixels 4i to 4i + 3 and 16 + 4i to 19 + 4i
+static inline void _nv21ToRGBA32(const unsigned char* y, const unsigned char* uv, __m256i* rgba) {
+    const auto c_6             = _mm256_set1_epi16((1 << 6));
+    const auto c_10            = _mm256_set1_epi16((1 << 10));
+    const auto c_128           = _mm256_set1_epi16(128);
+    const auto zero            = _mm256_setzero_si256();
+    const auto alpha           = _mm256_set1_epi8(-1);
+    const auto crossMask       = _mm256_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15, 0, 2, 4, 6, 8,
+                                            10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15);
+    const auto revertCrossMask = _mm256_setr_epi8(0, 8, 1, 9, 2, 10, 3, 11, 4, 12, 5, 13, 6, 14, 7, 15, 0, 8, 1, 9,
+                                                  2, 10, 3, 11, 4, 12, 5, 13, 6, 14, 7, 15);
+
+    auto Y_  = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i*)y), crossMask);
+    auto UV  = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i*)uv), crossMask);
+    auto y0  = _mm256_mullo_epi16(_mm256_unpacklo_epi8(Y_, zero), c_6);
+    auto y1  = _mm256_mullo_epi16(_mm256_unpackhi_epi8(Y_, zero), c_6);
+    auto U_  = _mm256_sub_epi16(_mm256_unpackhi_epi8(UV, zero), c_128);
+    auto V_  = _mm256_sub_epi16(_mm256_unpacklo_epi8(UV, zero), c_128);
+    auto rUV = _mm256_mullo_epi16(V_, _mm256_set1_epi16(73));
+    auto gUV = _mm256_add_epi16(_mm256_mullo_epi16(U_, _mm256_set1_epi16(25)), _mm256_mullo_epi16(V_, _mm256_set1_epi16(37)));
+    auto bUV = _mm256_mullo_epi16(U_, _mm256_set1_epi16(130));
+    auto r0  = _mm256_mulhi_epi16(_mm256_adds_epi16(y0, rUV), c_10);
+    auto r1  = _mm256_mulhi_epi16(_mm256_adds_epi16(y1, rUV), c_10);
+    auto g0  = _mm256_mulhi_epi16(_mm256_sub_epi16(y0, gUV), c_10);
+    auto g1  = _mm256_mulhi_epi16(_mm256_sub_epi16(y1, gUV), c_10);
+    auto b0  = _mm256_mulhi_epi16(_mm256_adds_epi16(y0, bUV), c_10);
+    auto b1  = _mm256_mulhi_epi16(_mm256_adds_epi16(y1, bUV), c_10);
+    auto dR  = _mm256_shuffle_epi8(_mm256_packus_epi16(r0, r1), revertCrossMask);
+    auto dG  = _mm256_shuffle_epi8(_mm256_packus_epi16(g0, g1), revertCrossMask);
+    auto dB  = _mm256_shuffle_epi8(_mm256_packus_epi16(b0, b1), revertCrossMask);
+    auto RG0 = _mm256_unpacklo_epi8(dR, dG);
+    auto RG1 = _mm256_unpackhi_epi8(dR, dG);
+    auto BA0 = _mm256_unpacklo_epi8(dB, alpha);
+    auto BA1 = _mm256_unpackhi_epi8(dB, alpha);
+    rgba[0]  = _mm256_unpacklo_epi16(RG0, BA0);
+    rgba[1]  = _mm256_unpackhi_epi16(RG0, BA0);
+    rgba[2]  = _mm256_unpacklo_epi16(RG1, BA1);
+    rgba[3]  = _mm256_unpackhi_epi16(RG1, BA1);
+}
+
+// Pack 16 pixels of 3 bytes, selected from RGBA by select, into 48 bytes
+static inline void _storeC3(unsigned char* dst, __m128i p0, __m128i p1, __m128i p2, __m128i p3, __m128i select) {
+    p0 = _mm_shuffle_epi8(p0, select);
+    p1 = _mm_shuffle_epi8(p1, select);
+    p2 = _mm_shuffle_epi8(p2, select);
+    p3 = _mm_shuffle_epi8(p3, select);
+    _mm_storeu_si128((__m128i*)(dst + 16 * 0), _mm_or_si128(p0, _mm_slli_si128(p1, 12)));
+    _mm_storeu_si128((__m128i*)(dst + 16 * 1), _mm_or_si128(_mm_srli_si128(p1, 4), _mm_slli_si128(p2, 8)));
+    _mm_storeu_si128((__m128i*)(dst + 16 * 2), _mm_or_si128(_mm_srli_si128(p2, 8), _mm_slli_si128(p3, 4)));
+}
+
+// Store 32 pixels as RGBA if bpp is 4, otherwise as 3 bytes selected by select
+static inline void _storeYUV(unsigned char* dst, const __m256i* rgba, int bpp, __m128i select) {
+    if (4 == bpp) {
+        _mm256_storeu_si256((__m256i*)(dst + 32 * 0), _mm256_permute2x128_si256(rgba[0], rgba[1], 0x20));
+        _mm256_storeu_si256((__m256i*)(dst + 32 * 1), _mm256_permute2x128_si256(rgba[2], rgba[3], 0x20));
+        _mm256_storeu_si256((__m256i*)(dst + 32 * 2), _mm256_permute2x128_si256(rgba[0], rgba[1], 0x31));
+        _mm256_storeu_si256((__m256i*)(dst + 32 * 3), _mm256_permute2x128_si256(rgba[2], rgba[3], 0x31));
+        return;
+    }
+    _storeC3(dst, _mm256_castsi256_si128(rgba[0]), _mm256_castsi256_si128(rgba[1]), _mm256_castsi256_si128(rgba[2]),
+             _mm256_castsi256_si128(rgba[3]), select);
+    _storeC3(dst + 48, _mm256_extracti128_si256(rgba[0], 1), _mm256_extracti128_si256(rgba[1], 1),
+             _mm256_extracti128_si256(rgba[2], 1), _mm256_extracti128_si256(rgba[3], 1), select);
+}
+
+static void _nv21Convert(const unsigned char* y, unsigned char* dest, size_t countDiv16, const unsigned char* uv,
+                         int bpp, __m128i select) {
+    __m256i rgba[4];
+    const size_t countDiv32 = countDiv16 / 2;
+    for (size_t z = 0; z < countDiv32; ++z) {
+        _nv21ToRGBA32(y + 32 * z, uv + 32 * z, rgba);
+        _storeYUV(dest + 32 * bpp * z, rgba, bpp, select);
+    }
+    if (countDiv16 % 2) {
+        // The last 16 pixels are converted in temp buffers, so that the loads and stores don't exceed the planes
+        unsigned char yTemp[32] = {0}, uvTemp[32] = {0}, dstTemp[128];
+        ::memcpy(yTemp, y + 32 * countDiv32, 16);
+        ::memcpy(uvTemp, uv + 32 * countDiv32, 16);
+        _nv21ToRGBA32(yTemp, uvTemp, rgba);
+        _storeYUV(dstTemp, rgba, bpp, select);
+        ::memcpy(dest + 32 * bpp * countDiv32, dstTemp, 16 * bpp);
+    }
+}
+
+void _AVX_MNNNV21ToRGBUnit(const unsigned char* source, unsigned char* dest, size_t countDiv16,
+                           const unsigned char* uv) {
+    _nv21Convert(source, dest, countDiv16, uv, 3, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1));
+}
+
+void _AVX_MNNNV21ToBGRUnit(const unsigned char* source, unsigned char* dest, size_t countDiv16,
+                           const unsigned char* uv) {
+    _nv21Convert(source, dest, countDiv16, uv, 3, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+}
+
+void _AVX_MNNNV21ToRGBAUnit(const unsigned char* source, unsigned char* dest, size_t countDiv16,
+                            const unsigned char* uv) {
+    _nv21Convert(source, dest, countDiv16, uv, 4, _mm_setzero_si128());
+}
+
+// 8 bytes from source to 8 float, (x - mean) * normal
+static inline __m256 _normalize(const unsigned char* source, __m256 mean, __m256 normal) {
+    auto bytes = _mm_loadl_epi64((const __m128i*)source);
+    return _mm256_mul_ps(_mm256_sub_ps(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(bytes)), mean), normal);
+}
+
+void _AVX_MNNBlitC1ToFloatC1(const unsigned char* source, float* dest, const float* mean, const float* normal,
+                             size_t count) {
+    const auto meanC8   = _mm256_set1_ps(mean[0]);
+    const auto normalC8 = _mm256_set1_ps(normal[0]);
+    size_t i            = 0;
+    for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_ps(dest + i, _normalize(source + i, meanC8, normalC8));
+    }
+    for (; i < count; ++i) {
+        dest[i] = normal[0] * (source[i] - mean[0]);
+    }
+}
+
+void _AVX_MNNBlitC3ToFloatC3(const unsigned char* source, float* dest, const float* mean, const float* normal,
+                             size_t count) {
+    // 8 pixels are 3 vectors, starting from channel 0, 2, 1
+    __m256 means[3], normals[3];
+    for (int v = 0; v < 3; ++v) {
+        float m[8], n[8];
+        for (int j = 0; j < 8; ++j) {
+            m[j] = mean[(8 * v + j) % 3];
+            n[j] = normal[(8 * v + j) % 3];
+        }
+        means[v]   = _mm256_loadu_ps(m);
+        normals[v] = _mm256_loadu_ps(n);
+    }
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        auto src = source + 3 * i;
+        auto dst = dest + 3 * i;
+        _mm256_storeu_ps(dst + 8 * 0, _normalize(src + 8 * 0, means[0], normals[0]));
+        _mm256_storeu_ps(dst + 8 * 1, _normalize(src + 8 * 1, means[1], normals[1]));
+        _mm256_storeu_ps(dst + 8 * 2, _normalize(src + 8 * 2, means[2], normals[2]));
+    }
+    for (; i < count; ++i) {
+        dest[3 * i + 0] = normal[0] * (source[3 * i + 0] - mean[0]);
+        dest[3 * i + 1] = normal[1] * (source[3 * i + 1] - mean[1]);
+        dest[3 * i + 2] = normal[2] * (source[3 * i + 2] - mean[2]);
+    }
+}
+
+void _AVX_MNNBlitC4ToFloatC4(const unsigned char* source, float* dest, const float* mean, const float* normal,
+                             size_t count) {
+    const auto meanC8   = _mm256_setr_ps(mean[0], mean[1], mean[2], mean[3], mean[0], mean[1], mean[2], mean[3]);
+    const auto normalC8 = _mm256_setr_ps(normal[0], normal[1], normal[2], normal[3], normal[0], normal[1], normal[2],
+                                         normal[3]);
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        _mm256_storeu_ps(dest + 4 * i, _normalize(source + 4 * i, meanC8, normalC8));
+    }
+    for (; i < count; ++i) {
+        for (int c = 0; c < 4; ++c) {
+            dest[4 * i + c] = normal[c] * (source[4 * i + c] - mean[c]);
+        }
+    }
+}
+
+void _AVX_MNNBlitC1ToFloatRGBA(const unsigned char* source, float* dest, const float* mean, const float* normal,
+                               size_t count) {
+    // Gray to (v, 0, 0, 0), the mean and normal of other channels are zero
+    const auto meanC8   = _mm256_setr_ps(mean[0], 0.0f, 0.0f, 0.0f, mean[0], 0.0f, 0.0f, 0.0f);
+    const auto normalC8 = _mm256_setr_ps(normal[0], 0.0f, 0.0f, 0.0f, normal[0], 0.0f, 0.0f, 0.0f);
+    const auto spread   = _mm_setr_epi8(0, -1, -1, -1, 1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    size_t i            = 0;
+    for (; i + 2 <= count; i += 2) {
+        uint16_t pair;
+        ::memcpy(&pair, source + i, sizeof(uint16_t));
+        auto bytes = _mm_shuffle_epi8(_mm_cvtsi32_si128(pair), spread);
+        auto v     = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(bytes));
+        _mm256_storeu_ps(dest + 4 * i, _mm256_mul_ps(_mm256_sub_ps(v, meanC8), normalC8));
+    }
+    for (; i < count; ++i) {
+        dest[4 * i + 0] = normal[0] * (source[i] - mean[0]);
+        dest[4 * i + 1] = 0.0f;
+        dest[4 * i + 2] = 0.0f;
+        dest[4 * i + 3] = 0.0f;
+    }
+}
+
+void _AVX_MNNBlitC3ToFloatRGBA(const unsigned char* source, float* dest, const float* mean, const float* normal,
+                               size_t count) {
+    // RGB to (r, g, b, 0), 4 pixels from 16 bytes of source
+    const auto meanC8   = _mm256_setr_ps(mean[0], mean[1], mean[2], 0.0f, mean[0], mean[1], mean[2], 0.0f);
+    const auto normalC8 = _mm256_setr_ps(normal[0], normal[1], normal[2], 0.0f, normal[0], normal[1], normal[2], 0.0f);
+    const auto spread   = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+    size_t i            = 0;
+    // The load of 16 bytes reads 4 bytes after the 4 pixels
+    for (; i + 6 <= count; i += 4) {
+        auto bytes = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(source + 3 * i)), spread);
+        auto v0    = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(bytes));
+        auto v1    = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_srli_si128(bytes, 8)));
+        _mm256_storeu_ps(dest + 4 * i + 8 * 0, _mm256_mul_ps(_mm256_sub_ps(v0, meanC8), normalC8));
+        _mm256_storeu_ps(dest + 4 * i + 8 * 1, _mm256_mul_ps(_mm256_sub_ps(v1, meanC8), normalC8));
+    }
+    for (; i < count; ++i) {
+        dest[4 * i + 0] = normal[0] * (source[3 * i + 0] - mean[0]);
+        dest[4 * i + 1] = normal[1] * (source[3 * i + 1] - mean[1]);
+        dest[4 * i + 2] = normal[2] * (source[3 * i + 2] - mean[2]);
+        dest[4 * i + 3] = 0.0f;
+    }
+}
@@ -0,0 +1,119 @@
+//
+//  MathFunctions.cpp
+//  MNN
+//
+//  Created by MNN on 2020/05/05.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include "FunctionSummary.hpp"
+#include "backend/cpu/compute/MathFunctions.hpp"
+
+// Needs AVX2 and FMA3
+struct VecAVX2 {
+    typedef __m256 F;
+    typedef __m256i I;
+    typedef __m256 M;
+    static const int lanes = 8;
+    static inline F load(const float* addr) {
+        return _mm256_loadu_ps(addr);
+    }
+    static inline void save(float* addr, F v) {
+        _mm256_storeu_ps(addr, v);
+    }
+    static inline F set1(float v) {
+        return _mm256_set1_ps(v);
+    }
+    static inline I seti(int32_t v) {
+        return _mm256_set1_epi32(v);
+    }
+    static inline F add(F a, F b) {
+        return _mm256_add_ps(a, b);
+    }
+    static inline F sub(F a, F b) {
+        return _mm256_sub_ps(a, b);
+    }
+    static inline F mul(F a, F b) {
+        return _mm256_mul_ps(a, b);
+    }
+    static inline F div(F a, F b) {
+        return _mm256_div_ps(a, b);
+    }
+    static inline F fma(F a, F b, F c) {
+        return _mm256_fmadd_ps(a, b, c);
+    }
+    static inline F sqrt(F a) {
+        return _mm256_sqrt_ps(a);
+    }
+    static inline F max(F a, F b) {
+        return _mm256_max_ps(a, b);
+    }
+    static inline F min(F a, F b) {
+        return _mm256_min_ps(a, b);
+    }
+    static inline I roundToInt(F a) {
+        return _mm256_cvtps_epi32(a);
+    }
+    static inline I truncToInt(F a) {
+        return _mm256_cvttps_epi32(a);
+    }
+    static inline F toFloat(I a) {
+        return _mm256_cvtepi32_ps(a);
+    }
+    static inline I addi(I a, I b) {
+        return _mm256_add_epi32(a, b);
+    }
+    static inline I subi(I a, I b) {
+        return _mm256_sub_epi32(a, b);
+    }
+    static inline I andi(I a, I b) {
+        return _mm256_and_si256(a, b);
+    }
+    static inline I ori(I a, I b) {
+        return _mm256_or_si256(a, b);
+    }
+    static inline M equali(I a, I b) {
+        return _mm256_castsi256_ps(_mm256_cmpeq_epi32(a, b));
+    }
+    static inline I srai1(I a) {
+        return _mm256_srai_epi32(a, 1);
+    }
+    static inline I shl23(I a) {
+        return _mm256_slli_epi32(a, 23);
+    }
+    static inline I shr23(I a) {
+        return _mm256_srli_epi32(a, 23);
+    }
+    static inline I castToInt(F a) {
+        return _mm256_castps_si256(a);
+    }
+    static inline F castToFloat(I a) {
+        return _mm256_castsi256_ps(a);
+    }
+    static inline F andf(F a, F b) {
+        return _mm256_and_ps(a, b);
+    }
+    static inline F orf(F a, F b) {
+        return _mm256_or_ps(a, b);
+    }
+    static inline F xorf(F a, F b) {
+        return _mm256_xor_ps(a, b);
+    }
+    static inline M less(F a, F b) {
+        return _mm256_cmp_ps(a, b, _CMP_LT_OQ);
+    }
+    static inline M greater(F a, F b) {
+        return _mm256_cmp_ps(a, b, _CMP_GT_OQ);
+    }
+    static inline M equal(F a, F b) {
+        return _mm256_cmp_ps(a, b, _CMP_EQ_OQ);
+    }
+    static inline F select(M m, F a, F b) {
+        return _mm256_blendv_ps(b, a, m);
+    }
+    static inline bool any(M m) {
+        return _mm256_movemask_ps(m) != 0;
+    }
+};
+
+MNN_DEFINE_MATH_FUNCTIONS(_AVX_, VecAVX2)
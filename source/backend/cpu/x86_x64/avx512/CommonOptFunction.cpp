@@ -0,0 +1,351 @@
+//
+//  CommonOptFunction.cpp
+//  MNN
+//
+//  Created by MNN on 2020/05/04.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <string.h>
+#include <algorithm>
+#include "FunctionSummary.hpp"
+#include "core/Macro.h"
+
+// A is packed as [e / PACK_E, l, PACK_E], B as [h / PACK_H, l, PACK_H]
+#define PACK_E 48
+#define PACK_H 8
+
+static inline __mmask16 _remainMask(int number) {
+    return (__mmask16)((1 << number) - 1);
+}
+
+template <bool relu, bool relu6>
+static void _addBias(float* dst, const float* bias, size_t planeNumber, size_t biasNumber) {
+    const auto zero = _mm512_setzero_ps();
+    const auto six  = _mm512_set1_ps(6.0f);
+    for (int z = 0; z < biasNumber; ++z) {
+        auto biasV   = _mm512_broadcast_f32x4(_mm_loadu_ps(bias + 4 * z));
+        float* dst_z = dst + planeNumber * 4 * z;
+        int p        = 0;
+        for (; p + 4 <= planeNumber; p += 4) {
+            auto dstV = _mm512_add_ps(_mm512_loadu_ps(dst_z + 4 * p), biasV);
+            if (relu) {
+                dstV = _mm512_max_ps(dstV, zero);
+            }
+            if (relu6) {
+                dstV = _mm512_min_ps(dstV, six);
+            }
+            _mm512_storeu_ps(dst_z + 4 * p, dstV);
+        }
+        if (p < planeNumber) {
+            auto mask = _remainMask(4 * (planeNumber - p));
+            auto dstV = _mm512_add_ps(_mm512_maskz_loadu_ps(mask, dst_z + 4 * p), biasV);
+            if (relu) {
+                dstV = _mm512_max_ps(dstV, zero);
+            }
+            if (relu6) {
+                dstV = _mm512_min_ps(dstV, six);
+            }
+            _mm512_mask_storeu_ps(dst_z + 4 * p, mask, dstV);
+        }
+    }
+}
+
+void _AVX512_MNNAddBias(float* dst, const float* bias, size_t planeNumber, size_t biasNumber) {
+    _addBias<false, false>(dst, bias, planeNumber, biasNumber);
+}
+
+void _AVX512_MNNAddBiasRelu(float* dst, const float* bias, size_t planeNumber, size_t biasNumber) {
+    _addBias<true, false>(dst, bias, planeNumber, biasNumber);
+}
+
+void _AVX512_MNNAddBiasRelu6(float* dst, const float* bias, size_t planeNumber, size_t biasNumber) {
+    _addBias<true, true>(dst, bias, planeNumber, biasNumber);
+}
+
+void _AVX512_MNNGetMatMulPackMode(int* eP, int* lP, int* hP) {
+    *eP = PACK_E;
+    *lP = 1;
+    *hP = PACK_H;
+}
+
+// Register i, 128-bit lane j <- register j, lane i
+static inline void _transposeLane(__m512& r0, __m512& r1, __m512& r2, __m512& r3) {
+    auto t0 = _mm512_shuffle_f32x4(r0, r1, 0x44);
+    auto t1 = _mm512_shuffle_f32x4(r2, r3, 0x44);
+    auto t2 = _mm512_shuffle_f32x4(r0, r1, 0xEE);
+    auto t3 = _mm512_shuffle_f32x4(r2, r3, 0xEE);
+    r0      = _mm512_shuffle_f32x4(t0, t1, 0x88);
+    r1      = _mm512_shuffle_f32x4(t0, t1, 0xDD);
+    r2      = _mm512_shuffle_f32x4(t2, t3, 0x88);
+    r3      = _mm512_shuffle_f32x4(t2, t3, 0xDD);
+}
+
+// 4x4 transpose inside each 128-bit lane of the four registers
+static inline void _transposeInLane(__m512& r0, __m512& r1, __m512& r2, __m512& r3) {
+    auto t0 = _mm512_castps_pd(_mm512_unpacklo_ps(r0, r1));
+    auto t1 = _mm512_castps_pd(_mm512_unpackhi_ps(r0, r1));
+    auto t2 = _mm512_castps_pd(_mm512_unpacklo_ps(r2, r3));
+    auto t3 = _mm512_castps_pd(_mm512_unpackhi_ps(r2, r3));
+    r0      = _mm512_castpd_ps(_mm512_unpacklo_pd(t0, t2));
+    r1      = _mm512_castpd_ps(_mm512_unpackhi_pd(t0, t2));
+    r2      = _mm512_castpd_ps(_mm512_unpacklo_pd(t1, t3));
+    r3      = _mm512_castpd_ps(_mm512_unpackhi_pd(t1, t3));
+}
+
+// 4 rows of 16 -> 16 rows of 4, stored in order as r0, r1, r2, r3
+static inline void _transpose4x16(__m512& r0, __m512& r1, __m512& r2, __m512& r3) {
+    _transposeInLane(r0, r1, r2, r3);
+    _transposeLane(r0, r1, r2, r3);
+}
+
+// 16 rows of 4 loaded as r0, r1, r2, r3 -> 4 rows of 16
+static inline void _transpose16x4(__m512& r0, __m512& r1, __m512& r2, __m512& r3) {
+    _transposeLane(r0, r1, r2, r3);
+    _transposeInLane(r0, r1, r2, r3);
+}
+
+// Store 16 e of one C4 block kept as 4 registers of 16 e, only the first eRemain e are written
+static inline void _saveC4(float* dst, __m512 r0, __m512 r1, __m512 r2, __m512 r3, int eRemain,
+                           const float* postParameters, const float* bias) {
+    _transpose4x16(r0, r1, r2, r3);
+    if (nullptr != postParameters) {
+        auto minValue = _mm512_set1_ps(postParameters[2]);
+        auto maxValue = _mm512_set1_ps(postParameters[3]);
+        if (nullptr != bias) {
+            auto biasV = _mm512_broadcast_f32x4(_mm_loadu_ps(bias));
+            r0         = _mm512_add_ps(r0, biasV);
+            r1         = _mm512_add_ps(r1, biasV);
+            r2         = _mm512_add_ps(r2, biasV);
+            r3         = _mm512_add_ps(r3, biasV);
+        }
+        r0 = _mm512_min_ps(_mm512_max_ps(r0, minValue), maxValue);
+        r1 = _mm512_min_ps(_mm512_max_ps(r1, minValue), maxValue);
+        r2 = _mm512_min_ps(_mm512_max_ps(r2, minValue), maxValue);
+        r3 = _mm512_min_ps(_mm512_max_ps(r3, minValue), maxValue);
+    }
+    if (eRemain == 16) {
+        _mm512_storeu_ps(dst + 16 * 0, r0);
+        _mm512_storeu_ps(dst + 16 * 1, r1);
+        _mm512_storeu_ps(dst + 16 * 2, r2);
+        _mm512_storeu_ps(dst + 16 * 3, r3);
+        return;
+    }
+    // Register i holds e in [4 * i, 4 * i + 4)
+    __m512 r[4] = {r0, r1, r2, r3};
+    for (int i = 0; i < 4 && 4 * i < eRemain; ++i) {
+        auto number = std::min(eRemain - 4 * i, 4);
+        _mm512_mask_storeu_ps(dst + 16 * i, _remainMask(4 * number), r[i]);
+    }
+}
+
+template <int EBLOCK>
+static void _packedMatMul(float* C, const float* A, const float* B, size_t eSize, const size_t* parameter,
+                          const float* postParameters, const float* bias) {
+    auto h            = parameter[2];
+    auto l            = parameter[1];
+    auto cStride      = parameter[3] / sizeof(float);
+    auto bExtraStride = parameter[5] / sizeof(float);
+    auto bStride      = bExtraStride + l * PACK_H;
+    auto hC4          = UP_DIV(h, 4);
+    auto hUnit        = UP_DIV(h, PACK_H);
+    int eRemain       = (int)eSize - (EBLOCK - 1) * 16;
+    for (int y = 0; y < hUnit; ++y) {
+        auto weight = B + y * bStride;
+        __m512 z[EBLOCK][PACK_H];
+        for (int k = 0; k < EBLOCK; ++k) {
+            for (int j = 0; j < PACK_H; ++j) {
+                z[k][j] = _mm512_setzero_ps();
+            }
+        }
+        for (int sy = 0; sy < l; ++sy) {
+            __m512 s[EBLOCK];
+            for (int k = 0; k < EBLOCK; ++k) {
+                s[k] = _mm512_loadu_ps(A + sy * PACK_E + 16 * k);
+            }
+            auto w = weight + sy * PACK_H;
+            for (int j = 0; j < PACK_H; ++j) {
+                auto wj = _mm512_set1_ps(w[j]);
+                for (int k = 0; k < EBLOCK; ++k) {
+                    z[k][j] = _mm512_fmadd_ps(s[k], wj, z[k][j]);
+                }
+            }
+        }
+        for (int r = 0; r < PACK_H / 4; ++r) {
+            auto hC4Index = y * (PACK_H / 4) + r;
+            if (hC4Index >= hC4) {
+                break;
+            }
+            auto biasPtr = nullptr != bias ? bias + 4 * hC4Index : nullptr;
+            auto dst     = C + hC4Index * cStride;
+            for (int k = 0; k < EBLOCK; ++k) {
+                _saveC4(dst + 64 * k, z[k][4 * r + 0], z[k][4 * r + 1], z[k][4 * r + 2], z[k][4 * r + 3],
+                        k < EBLOCK - 1 ? 16 : eRemain, postParameters, biasPtr);
+            }
+        }
+    }
+}
+
+void _AVX512_MNNPackedMatMul(float* C, const float* A, const float* B, const size_t* parameter, float* cache,
+                             const float* postParameters, const float* bias) {
+    _packedMatMul<PACK_E / 16>(C, A, B, PACK_E, parameter, postParameters, bias);
+}
+
+void _AVX512_MNNPackedMatMulRemain(float* C, const float* A, const float* B, size_t eSize, const size_t* parameter,
+                                   float* cache, const float* postParameters, const float* bias) {
+    static_assert(PACK_E == 48, "Remain kernel is dispatched for three register blocks");
+    switch (UP_DIV(eSize, 16)) {
+        case 1:
+            _packedMatMul<1>(C, A, B, eSize, parameter, postParameters, bias);
+            break;
+        case 2:
+            _packedMatMul<2>(C, A, B, eSize, parameter, postParameters, bias);
+            break;
+        case 3:
+            _packedMatMul<3>(C, A, B, eSize, parameter, postParameters, bias);
+            break;
+        default:
+            break;
+    }
+}
+
+void _AVX512_MNNPackC4ForMatMul_A(float* dest, const float* source, size_t e, size_t l, size_t eReal) {
+    auto eDiv    = UP_DIV(e, PACK_E);
+    auto lC4     = l / 4;
+    auto lRemain = lC4 * 4;
+    auto eRemain = e / 16 * 16;
+    if (e % PACK_E != 0) {
+        ::memset(dest, 0, eDiv * l * PACK_E * sizeof(float));
+    }
+    for (int y = 0; y < eRemain; y += 16) {
+        auto dstY = dest + (y / PACK_E) * PACK_E * l + (y % PACK_E);
+        auto srcY = source + y * 4;
+        for (int x = 0; x < lC4; ++x) {
+            auto srcX = srcY + x * 4 * eReal;
+            auto dstX = dstY + x * 4 * PACK_E;
+            auto s0   = _mm512_loadu_ps(srcX + 16 * 0);
+            auto s1   = _mm512_loadu_ps(srcX + 16 * 1);
+            auto s2   = _mm512_loadu_ps(srcX + 16 * 2);
+            auto s3   = _mm512_loadu_ps(srcX + 16 * 3);
+            _transpose16x4(s0, s1, s2, s3);
+            _mm512_storeu_ps(dstX + PACK_E * 0, s0);
+            _mm512_storeu_ps(dstX + PACK_E * 1, s1);
+            _mm512_storeu_ps(dstX + PACK_E * 2, s2);
+            _mm512_storeu_ps(dstX + PACK_E * 3, s3);
+        }
+    }
+    // Right
+    for (int y = 0; y < e; ++y) {
+        auto yR = y % PACK_E;
+        auto yC = y / PACK_E;
+        for (int x = lRemain; x < l; ++x) {
+            dest[x * PACK_E + yR + yC * PACK_E * l] = source[(x / 4) * eReal * 4 + y * 4 + x % 4];
+        }
+    }
+    // Down
+    for (int y = eRemain; y < e; ++y) {
+        auto yR = y % PACK_E;
+        auto yC = y / PACK_E;
+        for (int x = 0; x < lRemain; ++x) {
+            dest[x * PACK_E + yR + yC * PACK_E * l] = source[(x / 4) * eReal * 4 + y * 4 + x % 4];
+        }
+    }
+}
+
+static inline void _transpose8x8(__m256& r0, __m256& r1, __m256& r2, __m256& r3, __m256& r4, __m256& r5, __m256& r6,
+                                 __m256& r7) {
+    auto t0  = _mm256_unpacklo_ps(r0, r1);
+    auto t1  = _mm256_unpackhi_ps(r0, r1);
+    auto t2  = _mm256_unpacklo_ps(r2, r3);
+    auto t3  = _mm256_unpackhi_ps(r2, r3);
+    auto t4  = _mm256_unpacklo_ps(r4, r5);
+    auto t5  = _mm256_unpackhi_ps(r4, r5);
+    auto t6  = _mm256_unpacklo_ps(r6, r7);
+    auto t7  = _mm256_unpackhi_ps(r6, r7);
+    auto tt0 = _mm256_shuffle_ps(t0, t2, 0x44);
+    auto tt1 = _mm256_shuffle_ps(t0, t2, 0xEE);
+    auto tt2 = _mm256_shuffle_ps(t1, t3, 0x44);
+    auto tt3 = _mm256_shuffle_ps(t1, t3, 0xEE);
+    auto tt4 = _mm256_shuffle_ps(t4, t6, 0x44);
+    auto tt5 = _mm256_shuffle_ps(t4, t6, 0xEE);
+    auto tt6 = _mm256_shuffle_ps(t5, t7, 0x44);
+    auto tt7 = _mm256_shuffle_ps(t5, t7, 0xEE);
+    r0       = _mm256_permute2f128_ps(tt0, tt4, 0x20);
+    r1       = _mm256_permute2f128_ps(tt1, tt5, 0x20);
+    r2       = _mm256_permute2f128_ps(tt2, tt6, 0x20);
+    r3       = _mm256_permute2f128_ps(tt3, tt7, 0x20);
+    r4       = _mm256_permute2f128_ps(tt0, tt4, 0x31);
+    r5       = _mm256_permute2f128_ps(tt1, tt5, 0x31);
+    r6       = _mm256_permute2f128_ps(tt2, tt6, 0x31);
+    r7       = _mm256_permute2f128_ps(tt3, tt7, 0x31);
+}
+
+void _AVX512_MNNPackForMatMul_B(float* dest, const float* source, size_t h, size_t l, bool transpose) {
+    auto hP = h / PACK_H;
+    auto hR = hP * PACK_H;
+    if (hR != h) {
+        ::memset(dest, 0, UP_DIV(h, PACK_H) * PACK_H * l * sizeof(float));
+    }
+    if (!transpose) {
+        for (int y = 0; y < hP; ++y) {
+            auto destY   = dest + y * PACK_H * l;
+            auto sourceY = source + y * PACK_H;
+            for (int x = 0; x < l; ++x) {
+                _mm256_storeu_ps(destY + PACK_H * x, _mm256_loadu_ps(sourceY + x * h));
+            }
+        }
+        auto hRemain = h - hR;
+        if (hRemain > 0) {
+            auto destY   = dest + hP * PACK_H * l;
+            auto sourceY = source + hP * PACK_H;
+            for (int x = 0; x < l; ++x) {
+                ::memcpy(destY + PACK_H * x, sourceY + x * h, hRemain * sizeof(float));
+            }
+        }
+        return;
+    }
+    // h, l -> h/8, l, 8, use 8 x 8 transpose
+    auto lC8 = l / 8;
+    auto lR  = lC8 * 8;
+    for (int y = 0; y < hP; ++y) {
+        auto dstY = dest + y * l * PACK_H;
+        auto srcY = source + y * l * PACK_H;
+        for (int x = 0; x < lC8; ++x) {
+            auto srcX = srcY + x * 8;
+            auto dstX = dstY + x * 8 * PACK_H;
+            auto s0   = _mm256_loadu_ps(srcX + 0 * l);
+            auto s1   = _mm256_loadu_ps(srcX + 1 * l);
+            auto s2   = _mm256_loadu_ps(srcX + 2 * l);
+            auto s3   = _mm256_loadu_ps(srcX + 3 * l);
+            auto s4   = _mm256_loadu_ps(srcX + 4 * l);
+            auto s5   = _mm256_loadu_ps(srcX + 5 * l);
+            auto s6   = _mm256_loadu_ps(srcX + 6 * l);
+            auto s7   = _mm256_loadu_ps(srcX + 7 * l);
+            _transpose8x8(s0, s1, s2, s3, s4, s5, s6, s7);
+            _mm256_storeu_ps(dstX + 8 * 0, s0);
+            _mm256_storeu_ps(dstX + 8 * 1, s1);
+            _mm256_storeu_ps(dstX + 8 * 2, s2);
+            _mm256_storeu_ps(dstX + 8 * 3, s3);
+            _mm256_storeu_ps(dstX + 8 * 4, s4);
+            _mm256_storeu_ps(dstX + 8 * 5, s5);
+            _mm256_storeu_ps(dstX + 8 * 6, s6);
+            _mm256_storeu_ps(dstX + 8 * 7, s7);
+        }
+    }
+    // Right
+    for (int y = 0; y < hR; ++y) {
+        auto yR = y % PACK_H;
+        auto yC = y / PACK_H;
+        for (int x = lR; x < l; ++x) {
+            dest[x * PACK_H + yR + yC * PACK_H * l] = source[x + y * l];
+        }
+    }
+    // Down
+    for (int y = hR; y < h; ++y) {
+        auto yR = y % PACK_H;
+        auto yC = y / PACK_H;
+        for (int x = 0; x < l; ++x) {
+            dest[x * PACK_H + yR + yC * PACK_H * l] = source[x + y * l];
+        }
+    }
+}
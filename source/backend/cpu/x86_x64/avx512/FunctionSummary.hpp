@@ -0,0 +1,59 @@
+//
+//  FunctionSummary.hpp
+//  MNN
+//
+//  Created by MNN on 2020/05/03.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#include <stdint.h>
+
+extern "C" {
+
+// ========= CommonOptFunction.cpp ===========
+
+void _AVX512_MNNAddBias(float* dst, const float* bias, size_t planeNumber, size_t biasNumber);
+void _AVX512_MNNAddBiasRelu(float* dst, const float* bias, size_t planeNumber, size_t biasNumber);
+void _AVX512_MNNAddBiasRelu6(float* dst, const float* bias, size_t planeNumber, size_t biasNumber);
+
+void _AVX512_MNNGetMatMulPackMode(int* eP, int* lP, int* hP);
+void _AVX512_MNNPackC4ForMatMul_A(float* dest, const float* source, size_t e, size_t l, size_t eReal);
+void _AVX512_MNNPackForMatMul_B(float* dest, const float* source, size_t h, size_t l, bool transpose);
+void _AVX512_MNNPackedMatMul(float* C, const float* A, const float* B, const size_t* parameter, float* cache,
+                             const float* postParameters, const float* bias);
+void _AVX512_MNNPackedMatMulRemain(float* C, const float* A, const float* B, size_t eSize, const size_t* parameter,
+                                   float* cache, const float* postParameters, const float* bias);
+
+// ========= GemmInt8.cpp ===========
+
+
+void _AVX512_MNNGemmInt8AddBiasScale_16x4_Unit(int8_t* dst, const int8_t* src, const int8_t* weight, const int32_t* bias,
+                                               const float* scale, size_t src_depth_quad, size_t dst_step,
+                                               size_t dst_depth_quad);
+
+void _AVX512_MNNLineDepthWiseInt8AddBiasScaleUnit(int8_t* dst, const int8_t* src, const int8_t* weight,
+                                                  const int32_t* bias_z, size_t width, size_t src_w_step, size_t fw,
+                                                  size_t fh, size_t dilateX_step, size_t dilateY_step,
+                                                  const float* scale_z, size_t mode);
+
+// ========= MathFunctions.cpp ===========
+
+void _AVX512_MNNExp(float* dst, const float* src, size_t size);
+void _AVX512_MNNTanh(float* dst, const float* src, size_t size);
+void _AVX512_MNNMathExp(float* dst, const float* src, size_t size);
+void _AVX512_MNNMathLog(float* dst, const float* src, size_t size);
+void _AVX512_MNNMathSigmoid(float* dst, const float* src, size_t size);
+void _AVX512_MNNMathErf(float* dst, const float* src, size_t size);
+void _AVX512_MNNMathSwish(float* dst, const float* src, size_t size);
+void _AVX512_MNNMathHardSwish(float* dst, const float* src, size_t size);
+void _AVX512_MNNMathGelu(float* dst, const float* src, size_t size);
+void _AVX512_MNNMathSqrt(float* dst, const float* src, size_t size);
+void _AVX512_MNNMathRsqrt(float* dst, const float* src, size_t size);
+void _AVX512_MNNMathSin(float* dst, const float* src, size_t size);
+void _AVX512_MNNMathCos(float* dst, const float* src, size_t size);
+}
@@ -0,0 +1,182 @@
+//
+//  GemmInt8.cpp
+//  MNN
+//
+//  Created by MNN on 2020/05/03.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include "FunctionSummary.hpp"
+#include "backend/cpu/compute/Int8FunctionsOpt.h"
+
+#ifdef MNN_AVX512_VNNI
+
+// (sum + bias) * scale, clamped to [-127, 127] and rounded half away from zero as roundf
+static inline __m256i _postInt8(__m256i sum, __m256i bias, __m256 scale) {
+    auto value = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_add_epi32(sum, bias)), scale);
+    value      = _mm256_min_ps(_mm256_max_ps(value, _mm256_set1_ps(-127.0f)), _mm256_set1_ps(127.0f));
+    auto half  = _mm256_or_ps(_mm256_and_ps(value, _mm256_set1_ps(-0.0f)), _mm256_set1_ps(0.5f));
+    return _mm256_cvttps_epi32(_mm256_add_ps(value, half));
+}
+
+static inline __m512i _postInt8(__m512i sum, __m512i bias, __m512 scale) {
+    auto value = _mm512_mul_ps(_mm512_cvtepi32_ps(_mm512_add_epi32(sum, bias)), scale);
+    value      = _mm512_min_ps(_mm512_max_ps(value, _mm512_set1_ps(-127.0f)), _mm512_set1_ps(127.0f));
+    auto half  = _mm512_castsi512_ps(_mm512_or_si512(
+        _mm512_and_si512(_mm512_castps_si512(value), _mm512_set1_epi32(0x80000000)), _mm512_set1_epi32(0x3f000000)));
+    return _mm512_cvttps_epi32(_mm512_add_ps(value, half));
+}
+
+// Reduce partial sums of two rows and store as int8. Every 4 int32 lanes of d0 and d1 are partial sums of a column
+static inline void _storeGemm(int8_t* dst, __m512i d0, __m512i d1, const int32_t* bias, const float* scale) {
+    // The low 256 bits are columns (0, 1) and the high are (2, 3). After two hadd, the low 128 bits are columns (0, 2)
+    // of row 0 and 1, the high are columns (1, 3)
+    auto r   = _mm256_hadd_epi32(_mm256_hadd_epi32(_mm512_castsi512_si256(d0), _mm512_extracti64x4_epi64(d0, 1)),
+                                 _mm256_hadd_epi32(_mm512_castsi512_si256(d1), _mm512_extracti64x4_epi64(d1, 1)));
+    auto lo  = _mm256_castsi256_si128(r);
+    auto hi  = _mm256_extracti128_si256(r, 1);
+    auto sum = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_unpacklo_epi32(lo, hi)), _mm_unpackhi_epi32(lo, hi), 1);
+    auto biasValue  = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)bias));
+    auto scaleValue = _mm256_broadcast_ps((const __m128*)scale);
+    auto result     = _postInt8(sum, biasValue, scaleValue);
+    auto pack       = _mm_packs_epi32(_mm256_castsi256_si128(result), _mm256_extracti128_si256(result, 1));
+    _mm_storel_epi64((__m128i*)dst, _mm_packs_epi16(pack, pack));
+}
+
+/*
+ vpdpbusd multiplies unsigned int8 by signed int8, so src + 128 is used as unsigned and 128 * sum(weight) is subtracted
+ at last. Unlike vpmaddubsw there is no saturation of int16, so it is exact for all int8. Two dz are computed together
+ to share src and hide latency of vpdpbusd.
+ */
+void _AVX512_MNNGemmInt8AddBiasScale_16x4_Unit(int8_t* dst, const int8_t* src, const int8_t* weight, const int32_t* bias,
+                                               const float* scale, size_t src_depth_quad, size_t dst_step,
+                                               size_t dst_depth_quad) {
+    static_assert(GEMM_INT8_DST_XUNIT == 2, "Kernel computes two columns of dst");
+    const auto dst_step_tmp = dst_step / sizeof(int8_t);
+    const auto weight_step  = src_depth_quad * (GEMM_INT8_UNIT * GEMM_INT8_SRC_UNIT);
+    const auto offset       = _mm512_set1_epi8((char)0x80);
+    int dz = 0;
+    for (; dz + 1 < dst_depth_quad; dz += 2) {
+        const auto weight_dz = weight + dz * weight_step;
+        auto d00   = _mm512_setzero_si512();
+        auto d01   = _mm512_setzero_si512();
+        auto d10   = _mm512_setzero_si512();
+        auto d11   = _mm512_setzero_si512();
+        auto dSum0 = _mm512_setzero_si512();
+        auto dSum1 = _mm512_setzero_si512();
+        for (int sz = 0; sz < src_depth_quad; ++sz) {
+            const auto weight_sz = weight_dz + (GEMM_INT8_UNIT * GEMM_INT8_SRC_UNIT) * sz;
+            const auto src_z     = src + sz * GEMM_INT8_DST_XUNIT * GEMM_INT8_SRC_UNIT;
+            auto w0 = _mm512_loadu_si512(weight_sz);
+            auto w1 = _mm512_loadu_si512(weight_sz + weight_step);
+            auto s0 = _mm512_xor_si512(_mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i*)src_z)), offset);
+            auto s1 = _mm512_xor_si512(_mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i*)(src_z + GEMM_INT8_SRC_UNIT))), offset);
+            d00     = _mm512_dpbusd_epi32(d00, s0, w0);
+            d01     = _mm512_dpbusd_epi32(d01, s1, w0);
+            d10     = _mm512_dpbusd_epi32(d10, s0, w1);
+            d11     = _mm512_dpbusd_epi32(d11, s1, w1);
+            dSum0   = _mm512_dpbusd_epi32(dSum0, offset, w0);
+            dSum1   = _mm512_dpbusd_epi32(dSum1, offset, w1);
+        }
+        _storeGemm(dst + dz * dst_step_tmp, _mm512_sub_epi32(d00, dSum0), _mm512_sub_epi32(d01, dSum0),
+                   bias + dz * GEMM_INT8_UNIT, scale + dz * GEMM_INT8_UNIT);
+        _storeGemm(dst + (dz + 1) * dst_step_tmp, _mm512_sub_epi32(d10, dSum1), _mm512_sub_epi32(d11, dSum1),
+                   bias + (dz + 1) * GEMM_INT8_UNIT, scale + (dz + 1) * GEMM_INT8_UNIT);
+    }
+    for (; dz < dst_depth_quad; ++dz) {
+        const auto weight_dz = weight + dz * weight_step;
+        auto d0   = _mm512_setzero_si512();
+        auto d1   = _mm512_setzero_si512();
+        auto dSum = _mm512_setzero_si512();
+        for (int sz = 0; sz < src_depth_quad; ++sz) {
+            const auto weight_sz = weight_dz + (GEMM_INT8_UNIT * GEMM_INT8_SRC_UNIT) * sz;
+            const auto src_z     = src + sz * GEMM_INT8_DST_XUNIT * GEMM_INT8_SRC_UNIT;
+            auto w  = _mm512_loadu_si512(weight_sz);
+            auto s0 = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i*)src_z));
+            auto s1 = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i*)(src_z + GEMM_INT8_SRC_UNIT)));
+            d0      = _mm512_dpbusd_epi32(d0, _mm512_xor_si512(s0, offset), w);
+            d1      = _mm512_dpbusd_epi32(d1, _mm512_xor_si512(s1, offset), w);
+            dSum    = _mm512_dpbusd_epi32(dSum, offset, w);
+        }
+        _storeGemm(dst + dz * dst_step_tmp, _mm512_sub_epi32(d0, dSum), _mm512_sub_epi32(d1, dSum),
+                   bias + dz * GEMM_INT8_UNIT, scale + dz * GEMM_INT8_UNIT);
+    }
+}
+
+// Load 4 channels of four pixels and extend to int32
+static inline __m512i _loadPixel4(const int8_t* src, size_t step) {
+    if (4 == step) {
+        return _mm512_cvtepi8_epi32(_mm_loadu_si128((const __m128i*)src));
+    }
+    auto x = _mm_setr_epi32(*(const int32_t*)src, *(const int32_t*)(src + step), *(const int32_t*)(src + 2 * step),
+                            *(const int32_t*)(src + 3 * step));
+    return _mm512_cvtepi8_epi32(x);
+}
+
+void _AVX512_MNNLineDepthWiseInt8AddBiasScaleUnit(int8_t* dst, const int8_t* src, const int8_t* weight,
+                                                  const int32_t* bias_z, size_t width, size_t src_w_step, size_t fw,
+                                                  size_t fh, size_t dilateX_step, size_t dilateY_step,
+                                                  const float* scale_z, size_t mode) {
+    (void)mode;
+    // The high half of every int32 lane of weight is cleared, so vpdpwssd adds the product of each channel
+    const auto mask       = _mm512_set1_epi32(0xffff);
+    const auto biasValue  = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i*)bias_z));
+    const auto scaleValue = _mm512_broadcast_f32x4(_mm_loadu_ps(scale_z));
+    int dx = 0;
+    for (; dx + 16 <= width; dx += 16) {
+        const auto src_z = src + src_w_step * dx;
+        auto d0 = _mm512_setzero_si512();
+        auto d1 = _mm512_setzero_si512();
+        auto d2 = _mm512_setzero_si512();
+        auto d3 = _mm512_setzero_si512();
+        for (int fy = 0; fy < fh; ++fy) {
+            const auto src_y    = src_z + fy * dilateY_step;
+            const auto weight_y = weight + fy * fw * 4;
+            for (int fx = 0; fx < fw; ++fx) {
+                const auto src_x = src_y + fx * dilateX_step;
+                auto w = _mm512_and_si512(_mm512_cvtepi8_epi32(_mm_set1_epi32(*(const int32_t*)(weight_y + 4 * fx))), mask);
+                d0 = _mm512_dpwssd_epi32(d0, _loadPixel4(src_x + 0 * src_w_step, src_w_step), w);
+                d1 = _mm512_dpwssd_epi32(d1, _loadPixel4(src_x + 4 * src_w_step, src_w_step), w);
+                d2 = _mm512_dpwssd_epi32(d2, _loadPixel4(src_x + 8 * src_w_step, src_w_step), w);
+                d3 = _mm512_dpwssd_epi32(d3, _loadPixel4(src_x + 12 * src_w_step, src_w_step), w);
+            }
+        }
+        auto dst_x = dst + dx * 4;
+        _mm_storeu_si128((__m128i*)(dst_x + 0), _mm512_cvtsepi32_epi8(_postInt8(d0, biasValue, scaleValue)));
+        _mm_storeu_si128((__m128i*)(dst_x + 16), _mm512_cvtsepi32_epi8(_postInt8(d1, biasValue, scaleValue)));
+        _mm_storeu_si128((__m128i*)(dst_x + 32), _mm512_cvtsepi32_epi8(_postInt8(d2, biasValue, scaleValue)));
+        _mm_storeu_si128((__m128i*)(dst_x + 48), _mm512_cvtsepi32_epi8(_postInt8(d3, biasValue, scaleValue)));
+    }
+    for (; dx + 4 <= width; dx += 4) {
+        const auto src_z = src + src_w_step * dx;
+        auto d0 = _mm512_setzero_si512();
+        for (int fy = 0; fy < fh; ++fy) {
+            const auto src_y    = src_z + fy * dilateY_step;
+            const auto weight_y = weight + fy * fw * 4;
+            for (int fx = 0; fx < fw; ++fx) {
+                auto w = _mm512_and_si512(_mm512_cvtepi8_epi32(_mm_set1_epi32(*(const int32_t*)(weight_y + 4 * fx))), mask);
+                d0     = _mm512_dpwssd_epi32(d0, _loadPixel4(src_y + fx * dilateX_step, src_w_step), w);
+            }
+        }
+        _mm_storeu_si128((__m128i*)(dst + dx * 4), _mm512_cvtsepi32_epi8(_postInt8(d0, biasValue, scaleValue)));
+    }
+    for (; dx < width; ++dx) {
+        const auto src_z = src + src_w_step * dx;
+        auto d0 = _mm_setzero_si128();
+        for (int fy = 0; fy < fh; ++fy) {
+            const auto src_y    = src_z + fy * dilateY_step;
+            const auto weight_y = weight + fy * fw * 4;
+            for (int fx = 0; fx < fw; ++fx) {
+                auto s = _mm_cvtepi8_epi32(_mm_cvtsi32_si128(*(const int32_t*)(src_y + fx * dilateX_step)));
+                auto w = _mm_and_si128(_mm_cvtepi8_epi32(_mm_cvtsi32_si128(*(const int32_t*)(weight_y + 4 * fx))),
+                                       _mm512_castsi512_si128(mask));
+                d0     = _mm_add_epi32(d0, _mm_madd_epi16(s, w));
+            }
+        }
+        auto result = _mm512_castsi512_si128(_postInt8(_mm512_zextsi128_si512(d0), biasValue, scaleValue));
+        result      = _mm_packs_epi32(result, result);
+        *((int32_t*)(dst + dx * 4)) = _mm_cvtsi128_si32(_mm_packs_epi16(result, result));
+    }
+}
+
+#endif
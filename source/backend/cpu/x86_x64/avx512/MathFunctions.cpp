@@ -0,0 +1,119 @@
+//
+//  MathFunctions.cpp
+//  MNN
+//
+//  Created by MNN on 2020/05/05.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include "FunctionSummary.hpp"
+#include "backend/cpu/compute/MathFunctions.hpp"
+
+// Only AVX512F is assumed, so float bit operations go through the integer instructions
+struct VecAVX512 {
+    typedef __m512 F;
+    typedef __m512i I;
+    typedef __mmask16 M;
+    static const int lanes = 16;
+    static inline F load(const float* addr) {
+        return _mm512_loadu_ps(addr);
+    }
+    static inline void save(float* addr, F v) {
+        _mm512_storeu_ps(addr, v);
+    }
+    static inline F set1(float v) {
+        return _mm512_set1_ps(v);
+    }
+    static inline I seti(int32_t v) {
+        return _mm512_set1_epi32(v);
+    }
+    static inline F add(F a, F b) {
+        return _mm512_add_ps(a, b);
+    }
+    static inline F sub(F a, F b) {
+        return _mm512_sub_ps(a, b);
+    }
+    static inline F mul(F a, F b) {
+        return _mm512_mul_ps(a, b);
+    }
+    static inline F div(F a, F b) {
+        return _mm512_div_ps(a, b);
+    }
+    static inline F fma(F a, F b, F c) {
+        return _mm512_fmadd_ps(a, b, c);
+    }
+    static inline F sqrt(F a) {
+        return _mm512_sqrt_ps(a);
+    }
+    static inline F max(F a, F b) {
+        return _mm512_max_ps(a, b);
+    }
+    static inline F min(F a, F b) {
+        return _mm512_min_ps(a, b);
+    }
+    static inline I roundToInt(F a) {
+        return _mm512_cvtps_epi32(a);
+    }
+    static inline I truncToInt(F a) {
+        return _mm512_cvttps_epi32(a);
+    }
+    static inline F toFloat(I a) {
+        return _mm512_cvtepi32_ps(a);
+    }
+    static inline I addi(I a, I b) {
+        return _mm512_add_epi32(a, b);
+    }
+    static inline I subi(I a, I b) {
+        return _mm512_sub_epi32(a, b);
+    }
+    static inline I andi(I a, I b) {
+        return _mm512_and_si512(a, b);
+    }
+    static inline I ori(I a, I b) {
+        return _mm512_or_si512(a, b);
+    }
+    static inline M equali(I a, I b) {
+        return _mm512_cmpeq_epi32_mask(a, b);
+    }
+    static inline I srai1(I a) {
+        return _mm512_srai_epi32(a, 1);
+    }
+    static inline I shl23(I a) {
+        return _mm512_slli_epi32(a, 23);
+    }
+    static inline I shr23(I a) {
+        return _mm512_srli_epi32(a, 23);
+    }
+    static inline I castToInt(F a) {
+        return _mm512_castps_si512(a);
+    }
+    static inline F castToFloat(I a) {
+        return _mm512_castsi512_ps(a);
+    }
+    static inline F andf(F a, F b) {
+        return castToFloat(_mm512_and_si512(castToInt(a), castToInt(b)));
+    }
+    static inline F orf(F a, F b) {
+        return castToFloat(_mm512_or_si512(castToInt(a), castToInt(b)));
+    }
+    static inline F xorf(F a, F b) {
+        return castToFloat(_mm512_xor_si512(castToInt(a), castToInt(b)));
+    }
+    static inline M less(F a, F b) {
+        return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ);
+    }
+    static inline M greater(F a, F b) {
+        return _mm512_cmp_ps_mask(a, b, _CMP_GT_OQ);
+    }
+    static inline M equal(F a, F b) {
+        return _mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ);
+    }
+    static inline F select(M m, F a, F b) {
+        return _mm512_mask_blend_ps(m, b, a);
+    }
+    static inline bool any(M m) {
+        return m != 0;
+    }
+};
+
+MNN_DEFINE_MATH_FUNCTIONS(_AVX512_, VecAVX512)
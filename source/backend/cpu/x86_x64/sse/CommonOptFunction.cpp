@@ -9,6 +9,7 @@
 #include <emmintrin.h>
 #include <string.h>
 #include <algorithm>
+#include <limits>
 #include "core/Macro.h"
 
 void _SSE_MNNAddBias(float* dst, const float* bias, size_t planeNumber, size_t biasNumber) {
@@ -135,3 +136,173 @@ void _SSE_MNNPackedMatMulRemain(float* C, const float* A, const float* B, size_t
 void _SSE_MNNPackedMatMul(float* C, const float* A, const float* B, const size_t* parameter, float* cache, const float* postParameters, const float* bias) {
     return _SSE_MNNPackedMatMulRemain(C, A, B, 16, parameter, cache, postParameters, bias);
 }
+
+void _SSE_MNNPackC4ForMatMul_A(float* dest, const float* source, size_t e, size_t l, size_t eReal) {
+    const int mid = 1;
+    auto ePack = e / 16;
+    auto eDiv = UP_DIV(e, 16);
+    auto lC4 = l / 4;
+    auto lDiv = UP_DIV(l, 4);
+    auto eRemain = ePack * 16;
+    auto lRemain = lC4 * 4;
+    if (eRemain != e) {
+        ::memset(dest, 0, eDiv * l * 16 * mid * sizeof(float));
+    }
+    for (int y=0; y<ePack; ++y) {
+        auto dstY = dest + y * l * 16;
+        auto srcY = source + y * 64;
+        for (int x=0; x<lC4 * mid; ++x) {
+            auto srcX = srcY + x * 4 * eReal;
+            auto dstX = dstY + x * 64;
+            auto s00 = _mm_loadu_ps(srcX + 0 * 4);
+            auto s01 = _mm_loadu_ps(srcX + 1 * 4);
+            auto s02 = _mm_loadu_ps(srcX + 2 * 4);
+            auto s03 = _mm_loadu_ps(srcX + 3 * 4);
+            auto s10 = _mm_loadu_ps(srcX + 4 * 4);
+            auto s11 = _mm_loadu_ps(srcX + 5 * 4);
+            auto s12 = _mm_loadu_ps(srcX + 6 * 4);
+            auto s13 = _mm_loadu_ps(srcX + 7 * 4);
+            auto s20 = _mm_loadu_ps(srcX + 8 * 4);
+            auto s21 = _mm_loadu_ps(srcX + 9 * 4);
+            auto s22 = _mm_loadu_ps(srcX + 10 * 4);
+            auto s23 = _mm_loadu_ps(srcX + 11 * 4);
+            auto s30 = _mm_loadu_ps(srcX + 12 * 4);
+            auto s31 = _mm_loadu_ps(srcX + 13 * 4);
+            auto s32 = _mm_loadu_ps(srcX + 14 * 4);
+            auto s33 = _mm_loadu_ps(srcX + 15 * 4);
+            
+            _MM_TRANSPOSE4_PS(s00, s01, s02, s03);
+            _MM_TRANSPOSE4_PS(s10, s11, s12, s13);
+            _MM_TRANSPOSE4_PS(s20, s21, s22, s23);
+            _MM_TRANSPOSE4_PS(s30, s31, s32, s33);
+            
+            _mm_storeu_ps(dstX + 4 * 0, s00);
+            _mm_storeu_ps(dstX + 4 * 4, s01);
+            _mm_storeu_ps(dstX + 4 * 8, s02);
+            _mm_storeu_ps(dstX + 4 * 12, s03);
+            _mm_storeu_ps(dstX + 4 * 1, s10);
+            _mm_storeu_ps(dstX + 4 * 5, s11);
+            _mm_storeu_ps(dstX + 4 * 9, s12);
+            _mm_storeu_ps(dstX + 4 * 13, s13);
+            _mm_storeu_ps(dstX + 4 * 2, s20);
+            _mm_storeu_ps(dstX + 4 * 6, s21);
+            _mm_storeu_ps(dstX + 4 * 10, s22);
+            _mm_storeu_ps(dstX + 4 * 14, s23);
+            _mm_storeu_ps(dstX + 4 * 3, s30);
+            _mm_storeu_ps(dstX + 4 * 7, s31);
+            _mm_storeu_ps(dstX + 4 * 11, s32);
+            _mm_storeu_ps(dstX + 4 * 15, s33);
+        }
+    }
+    // Right
+    for (int y=0; y<e; ++y) {
+        auto yR = y % 16;
+        auto yC = y / 16;
+        for (int z=0; z<mid; ++z) {
+            for (int x=lRemain; x<l; ++x) {
+                auto xR = x % 4;
+                auto xC = x / 4;
+                dest[(x * mid + z) * 16 + yR + yC * 16 * l * mid] = source[(xC * mid + z) * eReal * 4 + y * 4 + xR];
+            }
+        }
+    }
+    // Down
+    {
+        auto yC = ePack;
+        for (int y=eRemain; y<e; ++y) {
+            auto yR = y - eRemain;
+            for (int z=0; z<mid; ++z) {
+                for (int x=0; x<lRemain; ++x) {
+                    auto xR = x % 4;
+                    auto xC = x / 4;
+                    dest[(x * mid + z) * 16 + yR + yC * 16 * l * mid] = source[(xC + z * lDiv) * eReal * 4 + y * 4 + xR];
+                }
+            }
+        }
+    }
+}
+
+void _SSE_MNNPackForMatMul_B(float* dest, const float* source, size_t h, size_t l, bool transpose) {
+    auto hP = h / 6;
+    auto hR = hP * 6;
+    if (hR != h) {
+        ::memset(dest, 0, UP_DIV(h, 6)*6*l*sizeof(float));
+    }
+    if (!transpose) {
+        for (int y=0; y<hP; ++y) {
+            auto destY = dest + y * 6 * l;
+            auto sourceY = source + y * 6;
+            for (int x=0; x<l; ++x) {
+                ::memcpy(destY + 6 * x, sourceY + x * h, 6 * sizeof(float));
+            }
+        }
+        auto hRemain = h - hR;
+        if (hRemain > 0) {
+            auto destY = dest + hP * 6 * l;
+            auto sourceY = source + hP * 6;
+            for (int x=0; x<l; ++x) {
+                ::memcpy(destY + 6 * x, sourceY + x * h, hRemain * sizeof(float));
+            }
+        }
+        return;
+    }
+    // h, l -> h/6, l, 6, use 12 x 4 transpose
+    hP = h / 12;
+    hR = hP * 12;
+    auto lC4 = l / 4;
+    auto lR = lC4 * 4;
+    for (int y=0; y<hP; ++y) {
+        auto dstY = dest + y * l * 12;
+        auto srcY = source + y * l * 12;
+        for (int x=0; x<lC4; ++x) {
+            auto srcX = srcY + x * 4;
+            auto dstX = dstY + x * 48;
+            auto s00 = _mm_loadu_ps(srcX + 0 * l);
+            auto s01 = _mm_loadu_ps(srcX + 1 * l);
+            auto s02 = _mm_loadu_ps(srcX + 2 * l);
+            auto s03 = _mm_loadu_ps(srcX + 3 * l);
+            auto s04 = _mm_loadu_ps(srcX + 4 * l);
+            auto s05 = _mm_loadu_ps(srcX + 5 * l);
+            auto s06 = _mm_loadu_ps(srcX + 6 * l);
+            auto s07 = _mm_loadu_ps(srcX + 7 * l);
+            auto s08 = _mm_loadu_ps(srcX + 8 * l);
+            auto s09 = _mm_loadu_ps(srcX + 9 * l);
+            auto s10 = _mm_loadu_ps(srcX + 10 * l);
+            auto s11 = _mm_loadu_ps(srcX + 11 * l);
+            
+            _MM_TRANSPOSE4_PS(s00, s03, s06, s09);
+            _MM_TRANSPOSE4_PS(s01, s04, s07, s10);
+            _MM_TRANSPOSE4_PS(s02, s05, s08, s11);
+            
+            _mm_storeu_ps(dstX + 4 * 0, s00);
+            _mm_storeu_ps(dstX + 4 * 1, s01);
+            _mm_storeu_ps(dstX + 4 * 2, s02);
+            _mm_storeu_ps(dstX + 4 * 3, s03);
+            _mm_storeu_ps(dstX + 4 * 4, s04);
+            _mm_storeu_ps(dstX + 4 * 5, s05);
+            _mm_storeu_ps(dstX + 4 * 6, s06);
+            _mm_storeu_ps(dstX + 4 * 7, s07);
+            _mm_storeu_ps(dstX + 4 * 8, s08);
+            _mm_storeu_ps(dstX + 4 * 9, s09);
+            _mm_storeu_ps(dstX + 4 * 10, s10);
+            _mm_storeu_ps(dstX + 4 * 11, s11);
+        }
+    }
+    
+    // Right
+    for (int y=0; y<h; ++y) {
+        auto yR = y % 6;
+        auto yC = y / 6;
+        for (int x=lR; x<l; ++x) {
+            dest[x * 6 + yR + yC * 6 * l] = source[x + y * l];
+        }
+    }
+    // Down
+    for (int y=0; y<h; ++y) {
+        auto yR = y % 6;
+        auto yC = y / 6;
+        for (int x=0; x<l; ++x) {
+            dest[x * 6 + yR + yC * 6 * l] = source[x + y * l];
+        }
+    }
+}
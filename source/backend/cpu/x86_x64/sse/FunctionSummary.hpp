@@ -70,3 +70,61 @@ void _SSE_MNNStrassenMergeCFunction(float* c11, float* c12, float* c21, float* c
 
 void _SSE_MNNPackedMatMul(float* C, const float* A, const float* B, const size_t* parameter, float* cache, const float* postParameters, const float* bias);
 void _SSE_MNNPackedMatMulRemain(float* C, const float* A, const float* B, size_t eSize, const size_t* parameter, float* cache, const float* postParameters, const float* bias);
+void _SSE_MNNPackC4ForMatMul_A(float* dest, const float* source, size_t e, size_t l, size_t eReal);
+void _SSE_MNNPackForMatMul_B(float* dest, const float* source, size_t h, size_t l, bool transpose);
+
+// ========= GemmInt8.cpp ===========
+
+void _SSE_MNNGemmInt8AddBiasScale_16x4_Unit(int8_t* dst, const int8_t* src, const int8_t* weight, const int32_t* bias,
+                                            const float* scale, size_t src_depth_quad, size_t dst_step,
+                                            size_t dst_depth_quad);
+void _SSE_MNNDepthWiseInt8AddBiasScaleUnit(int8_t* dst, const int8_t* src, const int8_t* weight, const int32_t* bias,
+                                           size_t fw, size_t fh, size_t weight_y_step, size_t dilateX_step,
+                                           size_t dilateY_step, const float* scale);
+void _SSE_MNNLineDepthWiseInt8AddBiasScaleUnit(int8_t* dst, const int8_t* src, const int8_t* weight,
+                                               const int32_t* bias_z, size_t width, size_t src_w_step, size_t fw,
+                                               size_t fh, size_t dilateX_step, size_t dilateY_step,
+                                               const float* scale_z, size_t mode);
+
+// ========= MathFunctions.cpp ===========
+
+void _SSE_MNNExp(float* dst, const float* src, size_t size);
+void _SSE_MNNTanh(float* dst, const float* src, size_t size);
+void _SSE_MNNMathExp(float* dst, const float* src, size_t size);
+void _SSE_MNNMathLog(float* dst, const float* src, size_t size);
+void _SSE_MNNMathSigmoid(float* dst, const float* src, size_t size);
+void _SSE_MNNMathErf(float* dst, const float* src, size_t size);
+void _SSE_MNNMathSwish(float* dst, const float* src, size_t size);
+void _SSE_MNNMathHardSwish(float* dst, const float* src, size_t size);
+void _SSE_MNNMathGelu(float* dst, const float* src, size_t size);
+void _SSE_MNNMathSqrt(float* dst, const float* src, size_t size);
+void _SSE_MNNMathRsqrt(float* dst, const float* src, size_t size);
+void _SSE_MNNMathSin(float* dst, const float* src, size_t size);
+void _SSE_MNNMathCos(float* dst, const float* src, size_t size);
+
+// ========= ImageProcessFunctions.cpp ===========
+
+void _SSE_MNNSamplerC4Bilinear(const unsigned char* source, unsigned char* dest, float* points, size_t count,
+                               size_t xMax, size_t yMax, size_t yStride);
+void _SSE_MNNSamplerC1Bilinear(const unsigned char* source, unsigned char* dest, float* points, size_t count,
+                               size_t xMax, size_t yMax, size_t yStride);
+void _SSE_MNNSamplerC4Nearest(const unsigned char* source, unsigned char* dest, float* points, size_t count,
+                              size_t xMax, size_t yMax, size_t yStride);
+void _SSE_MNNSamplerC1Nearest(const unsigned char* source, unsigned char* dest, float* points, size_t count,
+                              size_t xMax, size_t yMax, size_t yStride);
+void _SSE_MNNNV21ToRGBUnit(const unsigned char* source, unsigned char* dest, size_t countDiv16,
+                           const unsigned char* uv);
+void _SSE_MNNNV21ToBGRUnit(const unsigned char* source, unsigned char* dest, size_t countDiv16,
+                           const unsigned char* uv);
+void _SSE_MNNNV21ToRGBAUnit(const unsigned char* source, unsigned char* dest, size_t countDiv16,
+                            const unsigned char* uv);
+void _SSE_MNNBlitC1ToFloatC1(const unsigned char* source, float* dest, const float* mean, const float* normal,
+                             size_t count);
+void _SSE_MNNBlitC3ToFloatC3(const unsigned char* source, float* dest, const float* mean, const float* normal,
+                             size_t count);
+void _SSE_MNNBlitC4ToFloatC4(const unsigned char* source, float* dest, const float* mean, const float* normal,
+                             size_t count);
+void _SSE_MNNBlitC1ToFloatRGBA(const unsigned char* source, float* dest, const float* mean, const float* normal,
+                               size_t count);
+void _SSE_MNNBlitC3ToFloatRGBA(const unsigned char* source, float* dest, const float* mean, const float* normal,
+                               size_t count);
@@ -0,0 +1,103 @@
+//
+//  GemmInt8.cpp
+//  MNN
+//
+//  Created by MNN on 2020/05/03.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <emmintrin.h>
+#include <stdint.h>
+#include "backend/cpu/compute/Int8FunctionsOpt.h"
+
+// Sign extend the low 8 int8 of x to int16
+static inline __m128i _extendInt16(__m128i x) {
+    return _mm_srai_epi16(_mm_unpacklo_epi8(x, x), 8);
+}
+
+// (sum + bias) * scale, clamped to [-127, 127] and rounded half away from zero as roundf
+static inline __m128i _postInt8(__m128i sum, const int32_t* bias, const float* scale) {
+    auto value = _mm_mul_ps(_mm_cvtepi32_ps(_mm_add_epi32(sum, _mm_loadu_si128((const __m128i*)bias))),
+                            _mm_loadu_ps(scale));
+    value      = _mm_min_ps(_mm_max_ps(value, _mm_set1_ps(-127.0f)), _mm_set1_ps(127.0f));
+    auto half  = _mm_or_ps(_mm_and_ps(value, _mm_set1_ps(-0.0f)), _mm_set1_ps(0.5f));
+    auto result = _mm_cvttps_epi32(_mm_add_ps(value, half));
+    result      = _mm_packs_epi32(result, result);
+    return _mm_packs_epi16(result, result);
+}
+
+void _SSE_MNNGemmInt8AddBiasScale_16x4_Unit(int8_t* dst, const int8_t* src, const int8_t* weight, const int32_t* bias,
+                                            const float* scale, size_t src_depth_quad, size_t dst_step,
+                                            size_t dst_depth_quad) {
+    const auto dst_step_tmp = dst_step / sizeof(int8_t);
+    for (int dz = 0; dz < dst_depth_quad; ++dz) {
+        const auto weight_dz = weight + dz * src_depth_quad * (GEMM_INT8_UNIT * GEMM_INT8_SRC_UNIT);
+        auto dst_z           = dst + dz * dst_step_tmp;
+        // d[w][j] keeps 4 partial sums of src row w and weight column j
+        __m128i d[GEMM_INT8_DST_XUNIT][GEMM_INT8_UNIT];
+        for (int w = 0; w < GEMM_INT8_DST_XUNIT; ++w) {
+            for (int j = 0; j < GEMM_INT8_UNIT; ++j) {
+                d[w][j] = _mm_setzero_si128();
+            }
+        }
+        for (int sz = 0; sz < src_depth_quad; ++sz) {
+            const auto weight_sz = weight_dz + (GEMM_INT8_UNIT * GEMM_INT8_SRC_UNIT) * sz;
+            const auto src_z     = src + sz * GEMM_INT8_DST_XUNIT * GEMM_INT8_SRC_UNIT;
+            __m128i s[GEMM_INT8_DST_XUNIT][2];
+            for (int w = 0; w < GEMM_INT8_DST_XUNIT; ++w) {
+                auto x  = _mm_loadu_si128((const __m128i*)(src_z + w * GEMM_INT8_SRC_UNIT));
+                s[w][0] = _extendInt16(x);
+                s[w][1] = _extendInt16(_mm_unpackhi_epi64(x, x));
+            }
+            for (int j = 0; j < GEMM_INT8_UNIT; ++j) {
+                auto x  = _mm_loadu_si128((const __m128i*)(weight_sz + j * GEMM_INT8_SRC_UNIT));
+                auto w0 = _extendInt16(x);
+                auto w1 = _extendInt16(_mm_unpackhi_epi64(x, x));
+                for (int w = 0; w < GEMM_INT8_DST_XUNIT; ++w) {
+                    d[w][j] = _mm_add_epi32(d[w][j], _mm_madd_epi16(s[w][0], w0));
+                    d[w][j] = _mm_add_epi32(d[w][j], _mm_madd_epi16(s[w][1], w1));
+                }
+            }
+        }
+        for (int w = 0; w < GEMM_INT8_DST_XUNIT; ++w) {
+            // Transpose and add, so that lane j is the sum of column j
+            auto t0  = _mm_unpacklo_epi32(d[w][0], d[w][1]);
+            auto t1  = _mm_unpackhi_epi32(d[w][0], d[w][1]);
+            auto t2  = _mm_unpacklo_epi32(d[w][2], d[w][3]);
+            auto t3  = _mm_unpackhi_epi32(d[w][2], d[w][3]);
+            auto sum = _mm_add_epi32(_mm_add_epi32(_mm_unpacklo_epi64(t0, t2), _mm_unpackhi_epi64(t0, t2)),
+                                     _mm_add_epi32(_mm_unpacklo_epi64(t1, t3), _mm_unpackhi_epi64(t1, t3)));
+            auto result = _postInt8(sum, bias + dz * GEMM_INT8_UNIT, scale + dz * GEMM_INT8_UNIT);
+            *((int32_t*)(dst_z + w * GEMM_INT8_UNIT)) = _mm_cvtsi128_si32(result);
+        }
+    }
+}
+
+void _SSE_MNNDepthWiseInt8AddBiasScaleUnit(int8_t* dst, const int8_t* src, const int8_t* weight, const int32_t* bias,
+                                           size_t fw, size_t fh, size_t weight_y_step, size_t dilateX_step,
+                                           size_t dilateY_step, const float* scale) {
+    const auto zero = _mm_setzero_si128();
+    auto sum        = _mm_setzero_si128();
+    for (int fy = 0; fy < fh; ++fy) {
+        const auto src_y    = src + fy * dilateY_step;
+        const auto weight_y = weight + fy * weight_y_step;
+        for (int fx = 0; fx < fw; ++fx) {
+            // The high half of every int32 lane of weight is zero, so madd gives the product of each channel
+            auto s = _extendInt16(_mm_cvtsi32_si128(*(const int32_t*)(src_y + fx * dilateX_step)));
+            auto w = _extendInt16(_mm_cvtsi32_si128(*(const int32_t*)(weight_y + 4 * fx)));
+            sum    = _mm_add_epi32(sum, _mm_madd_epi16(_mm_unpacklo_epi16(s, zero), _mm_unpacklo_epi16(w, zero)));
+        }
+    }
+    *((int32_t*)dst) = _mm_cvtsi128_si32(_postInt8(sum, bias, scale));
+}
+
+void _SSE_MNNLineDepthWiseInt8AddBiasScaleUnit(int8_t* dst, const int8_t* src, const int8_t* weight,
+                                               const int32_t* bias_z, size_t width, size_t src_w_step, size_t fw,
+                                               size_t fh, size_t dilateX_step, size_t dilateY_step,
+                                               const float* scale_z, size_t mode) {
+    (void)mode;
+    for (int dx = 0; dx < width; ++dx) {
+        _SSE_MNNDepthWiseInt8AddBiasScaleUnit(dst + dx * 4, src + src_w_step * dx, weight, bias_z, fw, fh, fw * 4,
+                                              dilateX_step, dilateY_step, scale_z);
+    }
+}
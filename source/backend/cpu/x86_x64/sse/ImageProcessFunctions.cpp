@@ -0,0 +1,327 @@
+//
+//  ImageProcessFunctions.cpp
+//  MNN
+//
+//  Created by MNN on 2020/05/11.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include "FunctionSummary.hpp"
+
+// Samplers read points[0] as the first position and points[1] as the step, xMax = iw - 1, yMax = ih - 1
+static inline int32_t _load32(const unsigned char* p) {
+    int32_t v;
+    ::memcpy(&v, p, sizeof(int32_t));
+    return v;
+}
+
+struct SamplerPosition {
+    __m128i x0, x1, y0, y1;
+    __m128 xF, yF;
+};
+
+static inline SamplerPosition _bilinearPosition(const float* points, size_t i, size_t xMax, size_t yMax) {
+    auto index = _mm_add_ps(_mm_set1_ps((float)i), _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f));
+    auto x     = _mm_add_ps(_mm_set1_ps(points[0]), _mm_mul_ps(index, _mm_set1_ps(points[2])));
+    auto y     = _mm_add_ps(_mm_set1_ps(points[1]), _mm_mul_ps(index, _mm_set1_ps(points[3])));
+    x          = _mm_min_ps(_mm_max_ps(x, _mm_setzero_ps()), _mm_set1_ps((float)xMax));
+    y          = _mm_min_ps(_mm_max_ps(y, _mm_setzero_ps()), _mm_set1_ps((float)yMax));
+    SamplerPosition p;
+    p.x0 = _mm_cvttps_epi32(x);
+    p.y0 = _mm_cvttps_epi32(y);
+    p.x1 = _mm_min_epi32(_mm_add_epi32(p.x0, _mm_set1_epi32(1)), _mm_set1_epi32((int)xMax));
+    p.y1 = _mm_min_epi32(_mm_add_epi32(p.y0, _mm_set1_epi32(1)), _mm_set1_epi32((int)yMax));
+    p.xF = _mm_sub_ps(x, _mm_cvtepi32_ps(p.x0));
+    p.yF = _mm_sub_ps(y, _mm_cvtepi32_ps(p.y0));
+    return p;
+}
+
+static inline __m128 _lerp2D(__m128 c00, __m128 c01, __m128 c10, __m128 c11, __m128 xF, __m128 yF) {
+    auto top    = _mm_add_ps(c00, _mm_mul_ps(_mm_sub_ps(c01, c00), xF));
+    auto bottom = _mm_add_ps(c10, _mm_mul_ps(_mm_sub_ps(c11, c10), xF));
+    return _mm_add_ps(top, _mm_mul_ps(_mm_sub_ps(bottom, top), yF));
+}
+
+static inline __m128 _channel(__m128i pixels, int c) {
+    return _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(pixels, 8 * c), _mm_set1_epi32(0xff)));
+}
+
+static inline __m128i _toByte(__m128 v) {
+    return _mm_min_epi32(_mm_max_epi32(_mm_cvttps_epi32(v), _mm_setzero_si128()), _mm_set1_epi32(255));
+}
+
+// 4 pixels of 4 bytes, each lane of offset is a pixel
+static inline __m128i _gatherC4(const unsigned char* source, __m128i offset) {
+    int32_t o[4];
+    _mm_storeu_si128((__m128i*)o, offset);
+    return _mm_setr_epi32(_load32(source + o[0]), _load32(source + o[1]), _load32(source + o[2]),
+                          _load32(source + o[3]));
+}
+
+static inline __m128i _gatherC1(const unsigned char* source, __m128i offset) {
+    int32_t o[4];
+    _mm_storeu_si128((__m128i*)o, offset);
+    return _mm_setr_epi32(source[o[0]], source[o[1]], source[o[2]], source[o[3]]);
+}
+
+static inline __m128i _offset(__m128i y, __m128i x, size_t yStride, int bpp) {
+    return _mm_add_epi32(_mm_mullo_epi32(y, _mm_set1_epi32((int)yStride)), _mm_mullo_epi32(x, _mm_set1_epi32(bpp)));
+}
+
+// Save the low byte of 4 lanes
+static inline void _storeC1(unsigned char* dest, __m128i v, size_t count) {
+    auto packed = _mm_packus_epi16(_mm_packus_epi32(v, v), v);
+    int32_t result = _mm_cvtsi128_si32(packed);
+    ::memcpy(dest, &result, count);
+}
+
+void _SSE_MNNSamplerC4Bilinear(const unsigned char* source, unsigned char* dest, float* points, size_t count,
+                               size_t xMax, size_t yMax, size_t yStride) {
+    for (size_t i = 0; i < count; i += 4) {
+        auto p    = _bilinearPosition(points, i, xMax, yMax);
+        auto p00  = _gatherC4(source, _offset(p.y0, p.x0, yStride, 4));
+        auto p01  = _gatherC4(source, _offset(p.y0, p.x1, yStride, 4));
+        auto p10  = _gatherC4(source, _offset(p.y1, p.x0, yStride, 4));
+        auto p11  = _gatherC4(source, _offset(p.y1, p.x1, yStride, 4));
+        auto result = _mm_setzero_si128();
+        for (int c = 0; c < 4; ++c) {
+            auto v = _lerp2D(_channel(p00, c), _channel(p01, c), _channel(p10, c), _channel(p11, c), p.xF, p.yF);
+            result = _mm_or_si128(result, _mm_slli_epi32(_toByte(v), 8 * c));
+        }
+        if (i + 4 <= count) {
+            _mm_storeu_si128((__m128i*)(dest + 4 * i), result);
+        } else {
+            int32_t temp[4];
+            _mm_storeu_si128((__m128i*)temp, result);
+            ::memcpy(dest + 4 * i, temp, 4 * (count - i));
+        }
+    }
+}
+
+void _SSE_MNNSamplerC1Bilinear(const unsigned char* source, unsigned char* dest, float* points, size_t count,
+                               size_t xMax, size_t yMax, size_t yStride) {
+    for (size_t i = 0; i < count; i += 4) {
+        auto p   = _bilinearPosition(points, i, xMax, yMax);
+        auto c00 = _mm_cvtepi32_ps(_gatherC1(source, _offset(p.y0, p.x0, yStride, 1)));
+        auto c01 = _mm_cvtepi32_ps(_gatherC1(source, _offset(p.y0, p.x1, yStride, 1)));
+        auto c10 = _mm_cvtepi32_ps(_gatherC1(source, _offset(p.y1, p.x0, yStride, 1)));
+        auto c11 = _mm_cvtepi32_ps(_gatherC1(source, _offset(p.y1, p.x1, yStride, 1)));
+        _storeC1(dest + i, _toByte(_lerp2D(c00, c01, c10, c11, p.xF, p.yF)), std::min((size_t)4, count - i));
+    }
+}
+
+static inline __m128i _nearestOffset(const float* points, size_t i, size_t xMax, size_t yMax, size_t yStride,
+                                     int bpp) {
+    auto index = _mm_add_ps(_mm_set1_ps((float)i), _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f));
+    auto x     = _mm_add_ps(_mm_set1_ps(points[0]), _mm_mul_ps(index, _mm_set1_ps(points[2])));
+    auto y     = _mm_add_ps(_mm_set1_ps(points[1]), _mm_mul_ps(index, _mm_set1_ps(points[3])));
+    x          = _mm_min_ps(_mm_max_ps(x, _mm_setzero_ps()), _mm_set1_ps((float)xMax));
+    y          = _mm_min_ps(_mm_max_ps(y, _mm_setzero_ps()), _mm_set1_ps((float)yMax));
+    // Round half away from zero as roundf for the positive position
+    auto half  = _mm_set1_ps(0.5f);
+    return _offset(_mm_cvttps_epi32(_mm_add_ps(y, half)), _mm_cvttps_epi32(_mm_add_ps(x, half)), yStride, bpp);
+}
+
+void _SSE_MNNSamplerC4Nearest(const unsigned char* source, unsigned char* dest, float* points, size_t count,
+                              size_t xMax, size_t yMax, size_t yStride) {
+    for (size_t i = 0; i < count; i += 4) {
+        auto result = _gatherC4(source, _nearestOffset(points, i, xMax, yMax, yStride, 4));
+        if (i + 4 <= count) {
+            _mm_storeu_si128((__m128i*)(dest + 4 * i), result);
+        } else {
+            int32_t temp[4];
+            _mm_storeu_si128((__m128i*)temp, result);
+            ::memcpy(dest + 4 * i, temp, 4 * (count - i));
+        }
+    }
+}
+
+void _SSE_MNNSamplerC1Nearest(const unsigned char* source, unsigned char* dest, float* points, size_t count,
+                              size_t xMax, size_t yMax, size_t yStride) {
+    for (size_t i = 0; i < count; i += 4) {
+        auto result = _gatherC1(source, _nearestOffset(points, i, xMax, yMax, yStride, 1));
+        _storeC1(dest + i, result, std::min((size_t)4, count - i));
+    }
+}
+
+// YUV to RGB in int16: R = (64Y + 73V) >> 6, G = (64Y - 25U - 37V) >> 6, B = (64Y + 130U) >> 6, saturated
+#define MNN_SSE_YUV_INIT                                                                                   \
+    const auto c_6             = _mm_set1_epi16((1 << 6));                                                 \
+    const auto c_10            = _mm_set1_epi16((1 << 10));                                                \
+    const auto c_73            = _mm_set1_epi16(73);                                                       \
+    const auto c_25            = _mm_set1_epi16(25);                                                       \
+    const auto c_37            = _mm_set1_epi16(37);                                                       \
+    const auto c_130           = _mm_set1_epi16(130);                                                      \
+    const auto c_128           = _mm_set1_epi16(128);                                                      \
+    const auto zero            = _mm_set1_epi8(0);                                                         \
+    const auto alpha           = _mm_set1_epi8(-1);                                                        \
+    const auto crossMask       = _mm_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15);      \
+    const auto revertCrossMask = _mm_setr_epi8(0, 8, 1, 9, 2, 10, 3, 11, 4, 12, 5, 13, 6, 14, 7, 15);
+
+#define MNN_SSE_YUV_CONVERT                                                                                        \
+    auto Y_ = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(y + z * 16)), crossMask);                          \
+    auto UV = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(uv + z * 16)), crossMask);                         \
+    auto y0 = _mm_mullo_epi16(_mm_unpacklo_epi8(Y_, zero), c_6);                                                   \
+    auto y1 = _mm_mullo_epi16(_mm_unpackhi_epi8(Y_, zero), c_6);                                                   \
+    auto U_ = _mm_sub_epi16(_mm_unpackhi_epi8(UV, zero), c_128);                                                   \
+    auto V_ = _mm_sub_epi16(_mm_unpacklo_epi8(UV, zero), c_128);                                                   \
+    auto r0 = _mm_adds_epi16(y0, _mm_mullo_epi16(V_, c_73));                                                       \
+    auto r1 = _mm_adds_epi16(y1, _mm_mullo_epi16(V_, c_73));                                                       \
+    auto g0 = _mm_sub_epi16(_mm_sub_epi16(y0, _mm_mullo_epi16(U_, c_25)), _mm_mullo_epi16(V_, c_37));             \
+    auto g1 = _mm_sub_epi16(_mm_sub_epi16(y1, _mm_mullo_epi16(U_, c_25)), _mm_mullo_epi16(V_, c_37));             \
+    auto b0 = _mm_adds_epi16(y0, _mm_mullo_epi16(U_, c_130));                                                      \
+    auto b1 = _mm_adds_epi16(y1, _mm_mullo_epi16(U_, c_130));                                                      \
+    r0      = _mm_mulhi_epi16(r0, c_10);                                                                           \
+    r1      = _mm_mulhi_epi16(r1, c_10);                                                                           \
+    g0      = _mm_mulhi_epi16(g0, c_10);                                                                           \
+    g1      = _mm_mulhi_epi16(g1, c_10);                                                                           \
+    b0      = _mm_mulhi_epi16(b0, c_10);                                                                           \
+    b1      = _mm_mulhi_epi16(b1, c_10);                                                                           \
+    auto dR = _mm_shuffle_epi8(_mm_packus_epi16(r0, r1), revertCrossMask);                                         \
+    auto dG = _mm_shuffle_epi8(_mm_packus_epi16(g0, g1), revertCrossMask);                                         \
+    auto dB = _mm_shuffle_epi8(_mm_packus_epi16(b0, b1), revertCrossMask);                                         \
+    auto RG0   = _mm_unpacklo_epi8(dR, dG);                                                                        \
+    auto RG1   = _mm_unpackhi_epi8(dR, dG);                                                                        \
+    auto BA0   = _mm_unpacklo_epi8(dB, alpha);                                                                     \
+    auto BA1   = _mm_unpackhi_epi8(dB, alpha);                                                                     \
+    auto RGBA0 = _mm_unpacklo_epi16(RG0, BA0);                                                                     \
+    auto RGBA1 = _mm_unpackhi_epi16(RG0, BA0);                                                                     \
+    auto RGBA2 = _mm_unpacklo_epi16(RG1, BA1);                                                                     \
+    auto RGBA3 = _mm_unpackhi_epi16(RG1, BA1);
+
+// Pack 16 pixels of 3 bytes, selected from RGBA by select, into 48 bytes
+static inline void _storeC3(unsigned char* dst, __m128i p0, __m128i p1, __m128i p2, __m128i p3, __m128i select) {
+    p0 = _mm_shuffle_epi8(p0, select);
+    p1 = _mm_shuffle_epi8(p1, select);
+    p2 = _mm_shuffle_epi8(p2, select);
+    p3 = _mm_shuffle_epi8(p3, select);
+    _mm_storeu_si128((__m128i*)(dst + 16 * 0), _mm_or_si128(p0, _mm_slli_si128(p1, 12)));
+    _mm_storeu_si128((__m128i*)(dst + 16 * 1), _mm_or_si128(_mm_srli_si128(p1, 4), _mm_slli_si128(p2, 8)));
+    _mm_storeu_si128((__m128i*)(dst + 16 * 2), _mm_or_si128(_mm_srli_si128(p2, 8), _mm_slli_si128(p3, 4)));
+}
+
+void _SSE_MNNNV21ToRGBAUnit(const unsigned char* source, unsigned char* dest, size_t countDiv16,
+                            const unsigned char* uv) {
+    auto y = source;
+    MNN_SSE_YUV_INIT;
+    for (size_t z = 0; z < countDiv16; ++z) {
+        MNN_SSE_YUV_CONVERT;
+        _mm_storeu_si128((__m128i*)(dest + 64 * z + 16 * 0), RGBA0);
+        _mm_storeu_si128((__m128i*)(dest + 64 * z + 16 * 1), RGBA1);
+        _mm_storeu_si128((__m128i*)(dest + 64 * z + 16 * 2), RGBA2);
+        _mm_storeu_si128((__m128i*)(dest + 64 * z + 16 * 3), RGBA3);
+    }
+}
+
+void _SSE_MNNNV21ToRGBUnit(const unsigned char* source, unsigned char* dest, size_t countDiv16,
+                           const unsigned char* uv) {
+    auto y = source;
+    MNN_SSE_YUV_INIT;
+    const auto rgbSelect = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+    for (size_t z = 0; z < countDiv16; ++z) {
+        MNN_SSE_YUV_CONVERT;
+        _storeC3(dest + 48 * z, RGBA0, RGBA1, RGBA2, RGBA3, rgbSelect);
+    }
+}
+
+void _SSE_MNNNV21ToBGRUnit(const unsigned char* source, unsigned char* dest, size_t countDiv16,
+                           const unsigned char* uv) {
+    auto y = source;
+    MNN_SSE_YUV_INIT;
+    const auto bgrSelect = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+    for (size_t z = 0; z < countDiv16; ++z) {
+        MNN_SSE_YUV_CONVERT;
+        _storeC3(dest + 48 * z, RGBA0, RGBA1, RGBA2, RGBA3, bgrSelect);
+    }
+}
+
+// 4 bytes from source to 4 float, (x - mean) * normal
+static inline __m128 _normalize(__m128i bytes, __m128 mean, __m128 normal) {
+    return _mm_mul_ps(_mm_sub_ps(_mm_cvtepi32_ps(_mm_cvtepu8_epi32(bytes)), mean), normal);
+}
+
+static inline __m128i _loadBytes4(const unsigned char* source) {
+    return _mm_cvtsi32_si128(_load32(source));
+}
+
+void _SSE_MNNBlitC1ToFloatC1(const unsigned char* source, float* dest, const float* mean, const float* normal,
+                             size_t count) {
+    const auto meanC4   = _mm_set1_ps(mean[0]);
+    const auto normalC4 = _mm_set1_ps(normal[0]);
+    size_t i            = 0;
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_ps(dest + i, _normalize(_loadBytes4(source + i), meanC4, normalC4));
+    }
+    for (; i < count; ++i) {
+        dest[i] = normal[0] * (source[i] - mean[0]);
+    }
+}
+
+void _SSE_MNNBlitC3ToFloatC3(const unsigned char* source, float* dest, const float* mean, const float* normal,
+                             size_t count) {
+    // RGBRGBRGBRGB -> RGBR , GBRG, BRGB
+    const auto normal0 = _mm_setr_ps(normal[0], normal[1], normal[2], normal[0]);
+    const auto normal1 = _mm_setr_ps(normal[1], normal[2], normal[0], normal[1]);
+    const auto normal2 = _mm_setr_ps(normal[2], normal[0], normal[1], normal[2]);
+    const auto mean0   = _mm_setr_ps(mean[0], mean[1], mean[2], mean[0]);
+    const auto mean1   = _mm_setr_ps(mean[1], mean[2], mean[0], mean[1]);
+    const auto mean2   = _mm_setr_ps(mean[2], mean[0], mean[1], mean[2]);
+    size_t i           = 0;
+    for (; i + 4 <= count; i += 4) {
+        auto src = source + 3 * i;
+        auto dst = dest + 3 * i;
+        _mm_storeu_ps(dst + 4 * 0, _normalize(_loadBytes4(src + 4 * 0), mean0, normal0));
+        _mm_storeu_ps(dst + 4 * 1, _normalize(_loadBytes4(src + 4 * 1), mean1, normal1));
+        _mm_storeu_ps(dst + 4 * 2, _normalize(_loadBytes4(src + 4 * 2), mean2, normal2));
+    }
+    for (; i < count; ++i) {
+        dest[3 * i + 0] = normal[0] * (source[3 * i + 0] - mean[0]);
+        dest[3 * i + 1] = normal[1] * (source[3 * i + 1] - mean[1]);
+        dest[3 * i + 2] = normal[2] * (source[3 * i + 2] - mean[2]);
+    }
+}
+
+void _SSE_MNNBlitC4ToFloatC4(const unsigned char* source, float* dest, const float* mean, const float* normal,
+                             size_t count) {
+    const auto meanC4   = _mm_loadu_ps(mean);
+    const auto normalC4 = _mm_loadu_ps(normal);
+    for (size_t i = 0; i < count; ++i) {
+        _mm_storeu_ps(dest + 4 * i, _normalize(_loadBytes4(source + 4 * i), meanC4, normalC4));
+    }
+}
+
+void _SSE_MNNBlitC1ToFloatRGBA(const unsigned char* source, float* dest, const float* mean, const float* normal,
+                               size_t count) {
+    // Gray to (v, 0, 0, 0), the mean and normal of other channels are zero
+    const auto meanC4   = _mm_setr_ps(mean[0], 0.0f, 0.0f, 0.0f);
+    const auto normalC4 = _mm_setr_ps(normal[0], 0.0f, 0.0f, 0.0f);
+    for (size_t i = 0; i < count; ++i) {
+        _mm_storeu_ps(dest + 4 * i, _normalize(_mm_cvtsi32_si128(source[i]), meanC4, normalC4));
+    }
+}
+
+void _SSE_MNNBlitC3ToFloatRGBA(const unsigned char* source, float* dest, const float* mean, const float* normal,
+                               size_t count) {
+    // RGB to (r, g, b, 0)
+    const auto meanC4   = _mm_setr_ps(mean[0], mean[1], mean[2], 0.0f);
+    const auto normalC4 = _mm_setr_ps(normal[0], normal[1], normal[2], 0.0f);
+    size_t i            = 0;
+    // The load of 4 bytes reads one byte of the next pixel
+    for (; i + 1 < count; ++i) {
+        _mm_storeu_ps(dest + 4 * i, _normalize(_loadBytes4(source + 3 * i), meanC4, normalC4));
+    }
+    for (; i < count; ++i) {
+        dest[4 * i + 0] = normal[0] * (source[3 * i + 0] - mean[0]);
+        dest[4 * i + 1] = normal[1] * (source[3 * i + 1] - mean[1]);
+        dest[4 * i + 2] = normal[2] * (source[3 * i + 2] - mean[2]);
+        dest[4 * i + 3] = 0.0f;
+    }
+}
@@ -0,0 +1,120 @@
+//
+//  MathFunctions.cpp
+//  MNN
+//
+//  Created by MNN on 2020/05/05.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <emmintrin.h>
+#include <stdint.h>
+#include "FunctionSummary.hpp"
+#include "backend/cpu/compute/MathFunctions.hpp"
+
+struct VecSSE {
+    typedef __m128 F;
+    typedef __m128i I;
+    typedef __m128 M;
+    static const int lanes = 4;
+    static inline F load(const float* addr) {
+        return _mm_loadu_ps(addr);
+    }
+    static inline void save(float* addr, F v) {
+        _mm_storeu_ps(addr, v);
+    }
+    static inline F set1(float v) {
+        return _mm_set1_ps(v);
+    }
+    static inline I seti(int32_t v) {
+        return _mm_set1_epi32(v);
+    }
+    static inline F add(F a, F b) {
+        return _mm_add_ps(a, b);
+    }
+    static inline F sub(F a, F b) {
+        return _mm_sub_ps(a, b);
+    }
+    static inline F mul(F a, F b) {
+        return _mm_mul_ps(a, b);
+    }
+    static inline F div(F a, F b) {
+        return _mm_div_ps(a, b);
+    }
+    static inline F fma(F a, F b, F c) {
+        return _mm_add_ps(_mm_mul_ps(a, b), c);
+    }
+    static inline F sqrt(F a) {
+        return _mm_sqrt_ps(a);
+    }
+    static inline F max(F a, F b) {
+        return _mm_max_ps(a, b);
+    }
+    static inline F min(F a, F b) {
+        return _mm_min_ps(a, b);
+    }
+    static inline I roundToInt(F a) {
+        return _mm_cvtps_epi32(a);
+    }
+    static inline I truncToInt(F a) {
+        return _mm_cvttps_epi32(a);
+    }
+    static inline F toFloat(I a) {
+        return _mm_cvtepi32_ps(a);
+    }
+    static inline I addi(I a, I b) {
+        return _mm_add_epi32(a, b);
+    }
+    static inline I subi(I a, I b) {
+        return _mm_sub_epi32(a, b);
+    }
+    static inline I andi(I a, I b) {
+        return _mm_and_si128(a, b);
+    }
+    static inline I ori(I a, I b) {
+        return _mm_or_si128(a, b);
+    }
+    static inline M equali(I a, I b) {
+        return _mm_castsi128_ps(_mm_cmpeq_epi32(a, b));
+    }
+    static inline I srai1(I a) {
+        return _mm_srai_epi32(a, 1);
+    }
+    static inline I shl23(I a) {
+        return _mm_slli_epi32(a, 23);
+    }
+    static inline I shr23(I a) {
+        return _mm_srli_epi32(a, 23);
+    }
+    static inline I castToInt(F a) {
+        return _mm_castps_si128(a);
+    }
+    static inline F castToFloat(I a) {
+        return _mm_castsi128_ps(a);
+    }
+    static inline F andf(F a, F b) {
+        return _mm_and_ps(a, b);
+    }
+    static inline F orf(F a, F b) {
+        return _mm_or_ps(a, b);
+    }
+    static inline F xorf(F a, F b) {
+        return _mm_xor_ps(a, b);
+    }
+    static inline M less(F a, F b) {
+        return _mm_cmplt_ps(a, b);
+    }
+    static inline M greater(F a, F b) {
+        return _mm_cmpgt_ps(a, b);
+    }
+    static inline M equal(F a, F b) {
+        return _mm_cmpeq_ps(a, b);
+    }
+    static inline F select(M m, F a, F b) {
+        return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b));
+    }
+    static inline bool any(M m) {
+        return _mm_movemask_ps(m) != 0;
+    }
+};
+
+MNN_DEFINE_MATH_FUNCTIONS(_SSE_, VecSSE)
@@ -107,6 +107,32 @@ public:
     virtual Execution* onCreate(const std::vector<Tensor*>& inputs, const std::vector<Tensor*>& outputs,
                                 const MNN::Op* op) = 0;
 
+    /** prepared unit of pipeline, passed to backend to fuse */
+    struct FuseUnit {
+        const Op* op = nullptr;
+        std::vector<Tensor*> inputs;
+        std::vector<Tensor*> outputs;
+        std::shared_ptr<Execution> execution;
+        /** constant unit, computed in resize and not run */
+        bool isConst = false;
+        /** outputs are only read by units of the list, so they needn't be written if consumers are fused */
+        bool internal = false;
+    };
+    /** execution replacing some units, it runs in place of the last one */
+    struct Fusion {
+        std::shared_ptr<Execution> execution;
+        /** ascending indexes of replaced units */
+        std::vector<int> units;
+    };
+    /**
+     * @brief create executions computing several prepared units at once, called after resize.
+     * @param units     all units of pipeline in running order, including the ones of other backends.
+     * @return fusions of units whose executions are created by this backend, none by default.
+     */
+    virtual std::vector<Fusion> onFuse(const std::vector<FuseUnit>& units) {
+        return {};
+    }
+
     /**
      * @brief callback before resize ops.
      */
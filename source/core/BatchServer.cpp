@@ -0,0 +1,219 @@
+//
+//  BatchServer.cpp
+//  MNN
+//
+//  Created by MNN on 2020/04/30.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <MNN/BatchServer.hpp>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include "core/Macro.h"
+
+namespace MNN {
+struct BatchServer::Request {
+    Tensors inputs;
+    std::promise<Result> promise;
+    std::chrono::steady_clock::time_point time;
+};
+
+struct BatchServer::Queue {
+    std::mutex lock;
+    std::condition_variable condition;
+    std::deque<std::unique_ptr<Request>> requests;
+    bool stop = false;
+    std::atomic<int64_t> batches = {0};
+    std::atomic<int64_t> samples = {0};
+};
+
+struct BatchServer::Worker {
+    struct Prepared {
+        Session* session = nullptr;
+        std::map<std::string, std::shared_ptr<Tensor>> inputs;
+        std::map<std::string, std::shared_ptr<Tensor>> outputs;
+    };
+    // Prepared session for batch size index + 1
+    std::vector<Prepared> prepared;
+    std::thread thread;
+
+    void run(Interpreter* net, const std::vector<std::unique_ptr<Request>>& batch);
+};
+
+void BatchServer::Worker::run(Interpreter* net, const std::vector<std::unique_ptr<Request>>& batch) {
+    auto batchSize = (int)batch.size();
+    auto& current  = prepared[batchSize - 1];
+    std::vector<Result> results(batchSize);
+    for (auto& iter : current.inputs) {
+        auto host       = iter.second.get();
+        auto sampleSize = host->elementSize() / batchSize;
+        for (int i = 0; i < batchSize; ++i) {
+            auto dst   = host->host<float>() + i * sampleSize;
+            auto input = batch[i]->inputs.find(iter.first);
+            if (input == batch[i]->inputs.end() || (int)input->second.size() != sampleSize) {
+                results[i].code = INPUT_DATA_ERROR;
+                ::memset(dst, 0, sampleSize * sizeof(float));
+                continue;
+            }
+            ::memcpy(dst, input->second.data(), sampleSize * sizeof(float));
+        }
+        net->getSessionInput(current.session, iter.first.c_str())->copyFromHostTensor(host);
+    }
+    auto code = net->runSession(current.session);
+    for (auto& iter : current.outputs) {
+        auto host = iter.second.get();
+        net->getSessionOutput(current.session, iter.first.c_str())->copyToHostTensor(host);
+        auto sampleSize = host->elementSize() / batchSize;
+        for (int i = 0; i < batchSize; ++i) {
+            auto src = host->host<float>() + i * sampleSize;
+            results[i].outputs[iter.first].assign(src, src + sampleSize);
+        }
+    }
+    for (int i = 0; i < batchSize; ++i) {
+        if (NO_ERROR != code) {
+            results[i].code = code;
+        }
+        if (NO_ERROR != results[i].code) {
+            results[i].outputs.clear();
+        }
+        batch[i]->promise.set_value(std::move(results[i]));
+    }
+}
+
+BatchServer* BatchServer::create(std::shared_ptr<Interpreter> net, const Config& config) {
+    if (nullptr == net || config.maxBatch <= 0 || config.numWorker <= 0 || config.maxWaitUs < 0) {
+        MNN_ERROR("Invalid config for batch server\n");
+        return nullptr;
+    }
+    std::unique_ptr<BatchServer> server(new BatchServer(net, config));
+    // Prepare all sessions before serving, the first session of worker is cloned by others to share weights
+    for (auto& worker : server->mWorkers) {
+        worker->prepared.resize(config.maxBatch);
+        Session* base = nullptr;
+        for (int b = 1; b <= config.maxBatch; ++b) {
+            auto& current = worker->prepared[b - 1];
+            if (nullptr != base) {
+                current.session = net->createSessionContext(base);
+            }
+            if (nullptr == current.session) {
+                current.session = net->createSession(config.schedule);
+            }
+            if (nullptr == current.session) {
+                return nullptr;
+            }
+            for (auto& iter : net->getSessionInputAll(current.session)) {
+                auto input = iter.second;
+                if (input->getType() != halide_type_of<float>() || input->dimensions() < 1) {
+                    MNN_ERROR("Batch server only supports float input with batch, %s is not\n", iter.first.c_str());
+                    return nullptr;
+                }
+                auto shape = input->shape();
+                shape[0]   = b;
+                net->resizeTensor(input, shape);
+            }
+            net->resizeSession(current.session);
+            for (auto& iter : net->getSessionInputAll(current.session)) {
+                current.inputs[iter.first].reset(Tensor::createHostTensorFromDevice(iter.second, false));
+            }
+            for (auto& iter : net->getSessionOutputAll(current.session)) {
+                auto output = iter.second;
+                if (output->getType() != halide_type_of<float>() || output->dimensions() < 1 ||
+                    output->length(0) != b) {
+                    MNN_ERROR("Batch server only supports float output with batch, %s is not\n", iter.first.c_str());
+                    return nullptr;
+                }
+                current.outputs[iter.first].reset(Tensor::createHostTensorFromDevice(output, false));
+            }
+            if (nullptr == base) {
+                base = current.session;
+            }
+        }
+    }
+
+    auto queue = server->mQueue;
+    for (auto& worker : server->mWorkers) {
+        auto workerPtr = worker.get();
+        worker->thread = std::thread([queue, workerPtr, net, config]() {
+            while (true) {
+                std::vector<std::unique_ptr<Request>> batch;
+                {
+                    std::unique_lock<std::mutex> _l(queue->lock);
+                    queue->condition.wait(_l, [queue]() { return queue->stop || !queue->requests.empty(); });
+                    if (queue->requests.empty()) {
+                        // Stopped
+                        break;
+                    }
+                    auto deadline = queue->requests.front()->time + std::chrono::microseconds(config.maxWaitUs);
+                    while (!queue->stop && (int)queue->requests.size() < config.maxBatch) {
+                        if (std::cv_status::timeout == queue->condition.wait_until(_l, deadline)) {
+                            break;
+                        }
+                    }
+                    if (queue->requests.empty()) {
+                        // Taken by other worker
+                        continue;
+                    }
+                    auto batchSize = std::min((int)queue->requests.size(), config.maxBatch);
+                    for (int i = 0; i < batchSize; ++i) {
+                        batch.emplace_back(std::move(queue->requests.front()));
+                        queue->requests.pop_front();
+                    }
+                }
+                // Count before running so stats cover all requests whose future is ready
+                queue->batches++;
+                queue->samples += batch.size();
+                workerPtr->run(net.get(), batch);
+            }
+        });
+    }
+    return server.release();
+}
+
+BatchServer::BatchServer(std::shared_ptr<Interpreter> net, const Config& config) : mNet(net), mConfig(config) {
+    mQueue.reset(new Queue);
+    for (int i = 0; i < config.numWorker; ++i) {
+        mWorkers.emplace_back(new Worker);
+    }
+}
+
+BatchServer::~BatchServer() {
+    {
+        std::unique_lock<std::mutex> _l(mQueue->lock);
+        mQueue->stop = true;
+    }
+    mQueue->condition.notify_all();
+    for (auto& worker : mWorkers) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+        for (auto& prepared : worker->prepared) {
+            if (nullptr != prepared.session) {
+                mNet->releaseSession(prepared.session);
+            }
+        }
+    }
+}
+
+std::future<BatchServer::Result> BatchServer::submit(Tensors&& inputs) {
+    std::unique_ptr<Request> request(new Request);
+    request->inputs = std::move(inputs);
+    request->time   = std::chrono::steady_clock::now();
+    auto future     = request->promise.get_future();
+    {
+        std::unique_lock<std::mutex> _l(mQueue->lock);
+        mQueue->requests.emplace_back(std::move(request));
+    }
+    mQueue->condition.notify_all();
+    return future;
+}
+
+std::pair<int64_t, int64_t> BatchServer::getStats() const {
+    return std::make_pair(mQueue->batches.load(), mQueue->samples.load());
+}
+} // namespace MNN
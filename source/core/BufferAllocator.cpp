@@ -7,6 +7,8 @@
 //
 
 #include "core/BufferAllocator.hpp"
+#include <limits.h>
+#include <algorithm>
 #include "core/Macro.h"
 
 //#define DUMP_USAGE
@@ -18,6 +20,60 @@ BufferAllocator::Node::~Node() {
     }
 }
 void* BufferAllocator::alloc(size_t size, bool seperate) {
+    if (PLAN_NONE == mPlanState) {
+        return allocFromFreeList(size, seperate);
+    }
+    if (PLAN_REPLAY == mPlanState) {
+        auto pointer = allocFromPlan(size);
+        if (nullptr != pointer) {
+            return pointer;
+        }
+        return allocFromFreeList(size, seperate);
+    }
+    auto pointer = allocFromFreeList(size, seperate);
+    if (nullptr != pointer) {
+        MemoryPlanner::Block block;
+        block.size = UP_DIV(size, mAlign) * mAlign;
+        // Seperate memory (such as input) may be filled before running, it must not share with any memory before
+        block.begin         = seperate ? -1 : mClock;
+        block.end           = INT_MAX;
+        mRecording[pointer] = (int)mBlocks.size();
+        mBlocks.emplace_back(block);
+        mBlockClocks.emplace_back(mClock++);
+    }
+    return pointer;
+}
+
+void* BufferAllocator::allocFromPlan(size_t size) {
+    if (!mReplayValid) {
+        return nullptr;
+    }
+    auto sizeAlign = UP_DIV(size, mAlign) * mAlign;
+    if (mReplayIndex >= mBlocks.size() || mBlocks[mReplayIndex].size != sizeAlign ||
+        mBlockClocks[mReplayIndex] != mClock) {
+        // The alloc sequence differs from the recorded one, stop using plan
+        mReplayValid = false;
+        return nullptr;
+    }
+    if (nullptr == mArena) {
+        auto arena = MNNMemoryAllocAlign(mPlannedSize, mAlign);
+        if (nullptr == arena) {
+            mReplayValid = false;
+            return nullptr;
+        }
+        mArena.reset(new Node);
+        mArena->pointer = arena;
+        mArena->size    = mPlannedSize;
+        mTotalSize += mPlannedSize;
+    }
+    auto pointer        = (uint8_t*)mArena->pointer + mBlocks[mReplayIndex].offset;
+    mRecording[pointer] = mReplayIndex;
+    mReplayIndex++;
+    mClock++;
+    return pointer;
+}
+
+void* BufferAllocator::allocFromFreeList(size_t size, bool seperate) {
 #ifdef DUMP_USAGE
     auto memoryUsed = size / 1024.0f / 1024.0f;
     MNN_PRINT("Alloc: %f\n", memoryUsed);
@@ -31,6 +87,15 @@ void* BufferAllocator::alloc(size_t size, bool seperate) {
         if (nullptr != pointer) {
             return pointer;
         }
+        // The freelist of outer groups can be used by inner groups
+        for (auto iter = mBarriers.rbegin(); iter != mBarriers.rend() && nullptr == pointer; iter++) {
+            if (nullptr != iter->origin) {
+                pointer = getFromFreeList(iter->origin, size, false);
+            }
+        }
+        if (nullptr != pointer) {
+            return pointer;
+        }
         pointer = getFromFreeList(&mFreeList, size);
         if (nullptr != pointer) {
             return pointer;
@@ -89,6 +154,30 @@ void BufferAllocator::returnMemory(FREELIST* listP, std::shared_ptr<Node> node,
 }
 
 bool BufferAllocator::free(void* pointer, bool needRelease) {
+    if (PLAN_NONE != mPlanState) {
+        auto iter = mRecording.find(pointer);
+        if (iter != mRecording.end()) {
+            auto index = iter->second;
+            mRecording.erase(iter);
+            if (PLAN_RECORD == mPlanState) {
+                if (!mBarriers.empty()) {
+                    // Other groups may still use the memory until the outermost barrier end
+                    mBarrierFrees.emplace_back(index);
+                } else {
+                    mBlocks[index].end = mClock;
+                }
+            } else if (mClock > mBlocks[index].end) {
+                MNN_ASSERT(false);
+                mReplayValid = false;
+            }
+            mClock++;
+        }
+    }
+    if (nullptr != mArena && pointer >= mArena->pointer && pointer < (uint8_t*)mArena->pointer + mArena->size) {
+        // Memory of arena is never reused by free list
+        return true;
+    }
+
     // get node
     auto x = mUsedList.find(pointer);
     if (x == mUsedList.end()) {
@@ -121,6 +210,8 @@ void BufferAllocator::release(bool allRelease) {
     if (allRelease) {
         mUsedList.clear();
         mFreeList.clear();
+        mRecording.clear();
+        mArena     = nullptr;
         mTotalSize = 0;
         return;
     }
@@ -130,28 +221,98 @@ void BufferAllocator::release(bool allRelease) {
     mFreeList.clear();
 }
 
+void BufferAllocator::swap(BufferAllocator& other) {
+    MNN_ASSERT(mAlign == other.mAlign);
+    MNN_ASSERT(mBarriers.empty() && other.mBarriers.empty());
+    MNN_ASSERT(PLAN_NONE == mPlanState && PLAN_NONE == other.mPlanState);
+    mUsedList.swap(other.mUsedList);
+    mFreeList.swap(other.mFreeList);
+    std::swap(mTotalSize, other.mTotalSize);
+    mBlocks.swap(other.mBlocks);
+    mBlockClocks.swap(other.mBlockClocks);
+    std::swap(mPlannedSize, other.mPlannedSize);
+    mArena.swap(other.mArena);
+}
+
 void BufferAllocator::barrierBegin() {
-    MNN_ASSERT(mGroups.empty());
+    Barrier barrier;
+    barrier.origin = mCurrenetFreeList;
+    mBarriers.emplace_back(std::move(barrier));
 }
 
 void BufferAllocator::barrierEnd() {
-    for (auto& freeGroup : mGroups) {
+    MNN_ASSERT(!mBarriers.empty());
+    auto barrier = std::move(mBarriers.back());
+    mBarriers.pop_back();
+    if (mBarriers.empty()) {
+        for (auto index : mBarrierFrees) {
+            mBlocks[index].end = mClock;
+        }
+        mBarrierFrees.clear();
+    }
+    mClock++;
+    for (auto& freeGroup : barrier.groups) {
         auto freeList = *freeGroup;
         for (auto& iter : freeList) {
-            returnMemory(&mFreeList, iter.second);
+            if (nullptr != barrier.origin) {
+                returnMemory(barrier.origin, iter.second, false);
+            } else {
+                returnMemory(&mFreeList, iter.second);
+            }
         }
     }
-    mGroups.clear();
+    mCurrenetFreeList = barrier.origin;
 }
 
 void BufferAllocator::beginGroup() {
+    MNN_ASSERT(!mBarriers.empty());
     std::shared_ptr<FREELIST> newFreeList(new FREELIST);
     mCurrenetFreeList = newFreeList.get();
-    mGroups.emplace_back(newFreeList);
+    mBarriers.back().groups.emplace_back(newFreeList);
 }
 
 void BufferAllocator::endGroup() {
-    mCurrenetFreeList = nullptr;
+    mCurrenetFreeList = mBarriers.empty() ? nullptr : mBarriers.back().origin;
+}
+
+void BufferAllocator::beginRecord() {
+    MNN_ASSERT(PLAN_NONE == mPlanState);
+    mPlanState   = PLAN_RECORD;
+    mClock       = 0;
+    mPlannedSize = 0;
+    mBlocks.clear();
+    mBlockClocks.clear();
+    mRecording.clear();
+}
+
+size_t BufferAllocator::endRecord() {
+    MNN_ASSERT(PLAN_RECORD == mPlanState);
+    mPlanState = PLAN_NONE;
+    mRecording.clear();
+    mPlannedSize = MemoryPlanner::plan(mBlocks);
+    return mPlannedSize;
+}
+
+void BufferAllocator::beginReplay() {
+    MNN_ASSERT(PLAN_NONE == mPlanState);
+    mPlanState   = PLAN_REPLAY;
+    mClock       = 0;
+    mReplayIndex = 0;
+    mReplayValid = true;
+    mRecording.clear();
+}
+
+bool BufferAllocator::endReplay() {
+    MNN_ASSERT(PLAN_REPLAY == mPlanState);
+    mPlanState = PLAN_NONE;
+    mRecording.clear();
+    auto valid = mReplayValid && mReplayIndex == mBlocks.size();
+    if (!valid) {
+        mPlannedSize = 0;
+        mBlocks.clear();
+        mBlockClocks.clear();
+    }
+    return valid;
 }
 
 void* BufferAllocator::getFromFreeList(FREELIST* list, size_t size, bool permiteSplit) {
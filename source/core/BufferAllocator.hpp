@@ -13,6 +13,7 @@
 #include <memory>
 #include <vector>
 #include "MNNMemoryUtils.h"
+#include "MemoryPlanner.hpp"
 #include "NonCopyable.hpp"
 
 namespace MNN {
@@ -77,12 +78,48 @@ public:
      begin group / end group means the memory allocated belong to one thread
      different group must use different memory,
      but the origin freelist can be used by every group
+     barriers can be nested in a group, memory freed by inner groups returns to the outer group at barrier end
      */
     void barrierBegin();
     void barrierEnd();
     void beginGroup();
     void endGroup();
 
+    /*
+     For memory planning,
+     begin record / end record trace the lifetime of every reusable CHUNK while allocating by free list,
+     then solve the offset of each CHUNK in one arena.
+     begin replay / end replay serve the same alloc sequence from the planned arena, which is allocated at first use.
+     If the alloc sequence differs from the recorded one, the rest of allocs fall back to free list.
+     */
+    void beginRecord();
+    /**
+     * @brief stop recording and plan the arena for recorded CHUNKs.
+     * @return planned arena size.
+     */
+    size_t endRecord();
+    void beginReplay();
+    /**
+     * @brief stop replaying.
+     * @return true if all allocs matched the plan, false otherwise.
+     */
+    bool endReplay();
+
+    /**
+     * @brief query arena size of the plan.
+     * @return planned arena size, 0 if not planned.
+     */
+    size_t plannedSize() const {
+        return mPlannedSize;
+    }
+
+    /**
+     * @brief exchange all memories and the plan with other allocator of the same alignment. allocated pointers stay
+     *        valid and are owned by the other allocator after swap. can't be called inside barrier, record or replay.
+     * @param other given allocator.
+     */
+    void swap(BufferAllocator& other);
+
 private:
     class Node {
     public:
@@ -97,6 +134,8 @@ private:
 
     static void returnMemory(FREELIST* list, std::shared_ptr<Node> node, bool permitMerge = true);
     void* getFromFreeList(FREELIST* list, size_t size, bool permiteSplit = true);
+    void* allocFromFreeList(size_t size, bool seperate);
+    void* allocFromPlan(size_t size);
 
     std::map<void*, std::shared_ptr<Node>> mUsedList;
     FREELIST mFreeList;
@@ -104,7 +143,24 @@ private:
     const size_t mAlign = 0;
 
     FREELIST* mCurrenetFreeList = nullptr;
-    std::vector<std::shared_ptr<FREELIST>> mGroups;
+    struct Barrier {
+        // Freelist of the group that the barrier begins in, nullptr for outermost barrier
+        FREELIST* origin = nullptr;
+        std::vector<std::shared_ptr<FREELIST>> groups;
+    };
+    std::vector<Barrier> mBarriers;
+
+    enum PlanState { PLAN_NONE, PLAN_RECORD, PLAN_REPLAY };
+    PlanState mPlanState = PLAN_NONE;
+    std::vector<MemoryPlanner::Block> mBlocks;
+    std::vector<int> mBlockClocks;
+    std::map<void*, int> mRecording;
+    std::vector<int> mBarrierFrees;
+    int mClock          = 0;
+    int mReplayIndex    = 0;
+    bool mReplayValid   = false;
+    size_t mPlannedSize = 0;
+    std::shared_ptr<Node> mArena;
 };
 } // namespace MNN
 #endif
@@ -6,6 +6,9 @@
 //  Copyright © 2018, Alibaba Group Holding Limited
 //
 
+#ifndef DirectedAcyclicGraph_hpp
+#define DirectedAcyclicGraph_hpp
+
 #include <memory>
 #include <unordered_map>
 #include <unordered_set>
@@ -202,3 +205,4 @@ private:
     unordered_map<shared_ptr<Edge<T> >, int> edges;
 };
 } // namespace MNN
+#endif /* DirectedAcyclicGraph_hpp */
@@ -63,6 +63,18 @@ public:
      */
     virtual ErrorCode onExecute(const std::vector<Tensor *> &inputs, const std::vector<Tensor *> &outputs) = 0;
 
+    /**
+     * @brief clone execution for another backend of the same type, sharing constant resources such as transformed
+     *        weights. the cloned execution must be resized before executing.
+     * @param bn    backend of the cloned execution.
+     * @param op    op of the execution.
+     * @param dst   cloned execution.
+     * @return false if the execution can't be cloned.
+     */
+    virtual bool onClone(Backend *bn, const Op *op, Execution **dst) {
+        return false;
+    }
+
 public:
     /**
      * @brief designed for plugin system. not ready yet.
@@ -13,14 +13,34 @@
 #include "MNN_generated.h"
 #include "core/AutoStorage.h"
 #include <MNN/Interpreter.hpp>
+#include "backend/cpu/CPUTuner.hpp"
 #include "core/Session.hpp"
+#include "core/Tracer.hpp"
 #include "core/FileLoader.hpp"
+#include "core/MappedFile.hpp"
 namespace MNN {
 
 struct Content {
     AutoStorage<uint8_t> buffer;
+    // Read-only mapping of the model file, used instead of buffer by createFromMappedFile
+    std::unique_ptr<MappedFile> mapped;
+    // Mapping given up by releaseModel, kept until the sessions whose executions read their ops from it are released
+    std::unique_ptr<MappedFile> releasedMapping;
     const Net* net = nullptr;
     std::vector<std::unique_ptr<Session>> sessions;
+
+    const uint8_t* data() const {
+        if (nullptr != mapped) {
+            return (const uint8_t*)mapped->data();
+        }
+        return buffer.get();
+    }
+    size_t size() const {
+        if (nullptr != mapped) {
+            return mapped->size();
+        }
+        return buffer.size();
+    }
 };
 
 Interpreter* Interpreter::createFromFile(const char* file) {
@@ -50,6 +70,20 @@ Interpreter* Interpreter::createFromFile(const char* file) {
     loader.reset();
     return createFromBufferInternal(net);
 }
+Interpreter* Interpreter::createFromMappedFile(const char* file) {
+    if (nullptr == file) {
+        MNN_PRINT("NULL file for create interpreter\n");
+        return nullptr;
+    }
+    std::unique_ptr<MappedFile> mapped(new MappedFile(file));
+    if (!mapped->valid()) {
+        MNN_PRINT("Map %s failed, fall back to read it\n", file);
+        return createFromFile(file);
+    }
+    auto net    = new Content;
+    net->mapped = std::move(mapped);
+    return createFromBufferInternal(net);
+}
 Interpreter* Interpreter::createFromBuffer(const void* buffer, size_t size) {
     if (nullptr == buffer || 0 == size) {
         MNN_PRINT("Buffer is null for create interpreter\n");
@@ -71,13 +105,13 @@ Interpreter* Interpreter::createFromBufferInternal(Content* net) {
         MNN_PRINT("Buffer is null for create interpreter\n");
         return nullptr;
     }
-    flatbuffers::Verifier verify((const uint8_t*)(net->buffer.get()), net->buffer.size());
+    flatbuffers::Verifier verify(net->data(), net->size());
     if (false == VerifyNetBuffer(verify)) {
         MNN_PRINT("Invalidate buffer to create interpreter\n");
         delete net;
         return nullptr;
     }
-    net->net = GetNet(net->buffer.get());
+    net->net = GetNet(net->data());
     if (nullptr == net->net->oplists()) {
         MNN_ERROR("Model has no oplist\n");
         delete net;
@@ -105,7 +139,7 @@ Interpreter::~Interpreter() {
 }
 
 Session* Interpreter::createMultiPathSession(const std::vector<ScheduleConfig>& configs) {
-    if (nullptr == mNet->buffer.get()) {
+    if (nullptr == mNet->data()) {
         MNN_ERROR("The model buffer has been released. Can't create session\n");
         return nullptr;
     }
@@ -127,10 +161,37 @@ Session* Interpreter::createSession(const ScheduleConfig& config) {
     return createMultiPathSession({config});
 }
 
+Session* Interpreter::createSessionContext(const Session* session) {
+    MNN_ASSERT(nullptr != session);
+    if (nullptr == mNet->data()) {
+        MNN_ERROR("The model buffer has been released. Can't create session context\n");
+        return nullptr;
+    }
+    if (session->getNeedResize()) {
+        MNN_ERROR("Can't create context for session not resized\n");
+        return nullptr;
+    }
+    auto newSession = std::unique_ptr<Session>(session->clone());
+    if (nullptr == newSession) {
+        MNN_PRINT("Invalide Session!!\n");
+        return nullptr;
+    }
+    auto result = newSession.get();
+    auto code   = result->resize();
+    if (NO_ERROR != code) {
+        return nullptr;
+    }
+    mNet->sessions.emplace_back(std::move(newSession));
+    return result;
+}
+
 bool Interpreter::releaseSession(Session* session) {
     for (auto iter = mNet->sessions.begin(); iter != mNet->sessions.end(); iter++) {
         if ((*iter).get() == session) {
             mNet->sessions.erase(iter);
+            if (mNet->sessions.empty()) {
+                mNet->releasedMapping.reset();
+            }
             return true;
         }
     }
@@ -167,7 +228,7 @@ const std::map<std::string, Tensor*>& Interpreter::getSessionOutputAll(const Ses
 }
 
 void Interpreter::resizeSession(Session* session) {
-    if (mNet->buffer.get() == nullptr) {
+    if (mNet->data() == nullptr) {
         MNN_ERROR("The model buffer has been released. Can't resize session\n");
         return;
     }
@@ -176,6 +237,51 @@ void Interpreter::resizeSession(Session* session) {
     }
 }
 
+void Interpreter::setSessionMemoryPlan(Session* session, bool enable) {
+    session->setMemoryPlan(enable);
+    session->setNeedResize();
+}
+
+void Interpreter::setSessionInterOpParallel(Session* session, bool enable) {
+    session->setInterOpParallel(enable);
+    session->setNeedResize();
+}
+
+std::pair<size_t, size_t> Interpreter::getSessionMemoryUsage(const Session* session) const {
+    return session->getMemoryUsage();
+}
+
+void Interpreter::setSessionResizeCache(Session* session, int capacity) {
+    session->setResizeCache(capacity);
+}
+
+std::pair<int, int> Interpreter::getSessionResizeCacheStats(const Session* session) const {
+    return session->getResizeCacheStats();
+}
+
+ErrorCode Interpreter::setSessionShapeBuckets(Session* session, const std::vector<ShapeBucket>& buckets) {
+    return session->setShapeBuckets(buckets);
+}
+
+void Interpreter::setSessionTrace(Session* session, bool enable) {
+    session->setTrace(enable);
+}
+
+void Interpreter::setSessionTuning(Session* session, bool enable, const std::string& cacheFile) {
+    if (!cacheFile.empty()) {
+        CPUTuner::get()->setCacheFile(cacheFile);
+    }
+    session->setTuning(enable);
+}
+
+std::string Interpreter::getSessionTrace(const Session* session) const {
+    auto tracer = session->getTracer();
+    if (nullptr == tracer) {
+        return "";
+    }
+    return tracer->dump();
+}
+
 ErrorCode Interpreter::runSessionWithCallBack(const Session* session, const TensorCallBack& before,
                                               const TensorCallBack& after, bool sync) const {
     auto beforeWrap = [&before](const std::vector<Tensor*>& tensors, const OperatorInfo* info) {
@@ -201,6 +307,10 @@ void Interpreter::releaseModel() {
     for (auto& iter : mNet->sessions) {
         iter->releaseCache();
     }
+    if (!mNet->sessions.empty()) {
+        mNet->releasedMapping = std::move(mNet->mapped);
+    }
+    mNet->mapped.reset();
 }
 
 void Interpreter::resizeTensor(Tensor* tensor, int batch, int channel, int height, int width) {
@@ -241,6 +351,11 @@ void Interpreter::resizeTensor(Tensor* tensor, const std::vector<int>& dims) {
                 break;
             }
         }
+        for (auto& input : iter->getInputAll()) {
+            if (input.second == tensor) {
+                iter->setNeedBucketResize();
+            }
+        }
     }
 }
 
@@ -250,13 +365,17 @@ const char* Interpreter::bizCode() const {
 }
 
 std::pair<const void*, size_t> Interpreter::getModelBuffer() const {
-    return std::make_pair(mNet->buffer.get(), mNet->buffer.size());
+    return std::make_pair((const void*)mNet->data(), mNet->size());
 }
 ErrorCode Interpreter::updateSessionToModel(Session* session) {
-    if (mNet->buffer.get() == nullptr) {
+    if (mNet->data() == nullptr) {
         MNN_ERROR("Can't updateSessionToModel because you called releaseModel before\n");
         return INPUT_DATA_ERROR;
     }
+    if (nullptr != mNet->mapped) {
+        MNN_ERROR("Can't updateSessionToModel because the model is mapped read-only\n");
+        return INPUT_DATA_ERROR;
+    }
     return session->updateToModel((Net*)mNet->net);
 }
 
@@ -17,6 +17,11 @@
 #define ROUND_UP(x, y) (((x) + (y) - (1)) / (y) * (y))
 #define ALIGN_UP4(x) ROUND_UP((x), 4)
 #define ALIGN_UP8(x) ROUND_UP((x), 8)
+#if defined(__GNUC__) || defined(__clang__)
+#define MNN_PREFETCH(x) __builtin_prefetch(x)
+#else
+#define MNN_PREFETCH(x)
+#endif
 #if (__arm__ || __aarch64__) && (defined(__ARM_NEON__) || defined(__ARM_NEON))
 #define MNN_USE_NEON
 #endif
@@ -0,0 +1,81 @@
+//
+//  MappedFile.cpp
+//  MNN
+//
+//  Created by MNN on 2020/04/20.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include "core/MappedFile.hpp"
+#if defined(_MSC_VER)
+#include "Windows.h"
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+namespace MNN {
+MappedFile::MappedFile(const char* file) {
+#if defined(_MSC_VER)
+    wchar_t wFilename[1024];
+    if (0 == MultiByteToWideChar(65001 /* UTF8 */, 0, file, -1, wFilename, sizeof(wFilename) / sizeof(wFilename[0]))) {
+        return;
+    }
+    HANDLE handle = CreateFileW(wFilename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (INVALID_HANDLE_VALUE == handle) {
+        return;
+    }
+    mFile = handle;
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(handle, &fileSize) || 0 == fileSize.QuadPart) {
+        return;
+    }
+    mMapping = CreateFileMappingW(handle, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (nullptr == mMapping) {
+        return;
+    }
+    mData = MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0);
+    if (nullptr != mData) {
+        mSize = (size_t)fileSize.QuadPart;
+    }
+#else
+    int fd = open(file, O_RDONLY);
+    if (fd < 0) {
+        return;
+    }
+    struct stat st;
+    if (0 != fstat(fd, &st) || st.st_size <= 0) {
+        close(fd);
+        return;
+    }
+    auto addr = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    // The mapping keeps its own reference to the file
+    close(fd);
+    if (MAP_FAILED == addr) {
+        return;
+    }
+    mData = addr;
+    mSize = (size_t)st.st_size;
+#endif
+}
+
+MappedFile::~MappedFile() {
+#if defined(_MSC_VER)
+    if (nullptr != mData) {
+        UnmapViewOfFile(mData);
+    }
+    if (nullptr != mMapping) {
+        CloseHandle((HANDLE)mMapping);
+    }
+    if (nullptr != mFile) {
+        CloseHandle((HANDLE)mFile);
+    }
+#else
+    if (nullptr != mData) {
+        munmap(mData, mSize);
+    }
+#endif
+}
+
+} // namespace MNN
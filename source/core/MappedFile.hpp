@@ -0,0 +1,43 @@
+//
+//  MappedFile.hpp
+//  MNN
+//
+//  Created by MNN on 2020/04/20.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#ifndef MappedFile_hpp
+#define MappedFile_hpp
+
+#include <stddef.h>
+#include "core/Macro.h"
+#include "core/NonCopyable.hpp"
+
+namespace MNN {
+/** read-only memory mapping of a whole file. pages are shared with the system page cache. */
+class MNN_PUBLIC MappedFile : public NonCopyable {
+public:
+    MappedFile(const char* file);
+    ~MappedFile();
+
+    bool valid() const {
+        return mData != nullptr;
+    }
+    inline const void* data() const {
+        return mData;
+    }
+    inline size_t size() const {
+        return mSize;
+    }
+
+private:
+    void* mData  = nullptr;
+    size_t mSize = 0;
+#if defined(_MSC_VER)
+    void* mFile    = nullptr;
+    void* mMapping = nullptr;
+#endif
+};
+} // namespace MNN
+
+#endif /* MappedFile_hpp */
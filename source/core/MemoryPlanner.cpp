@@ -0,0 +1,50 @@
+//
+//  MemoryPlanner.cpp
+//  MNN
+//
+//  Created by MNN on 2020/04/22.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include "core/MemoryPlanner.hpp"
+#include <algorithm>
+
+namespace MNN {
+size_t MemoryPlanner::plan(std::vector<Block>& blocks) {
+    std::vector<int> order(blocks.size());
+    for (int i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    // Large block first, earlier block first for same size
+    std::stable_sort(order.begin(), order.end(),
+                     [&blocks](int a, int b) { return blocks[a].size > blocks[b].size; });
+
+    size_t peak = 0;
+    std::vector<const Block*> placed;
+    std::vector<const Block*> conflicts;
+    for (auto index : order) {
+        auto& block = blocks[index];
+        conflicts.clear();
+        for (auto p : placed) {
+            if (p->begin < block.end && block.begin < p->end) {
+                conflicts.emplace_back(p);
+            }
+        }
+        std::sort(conflicts.begin(), conflicts.end(),
+                  [](const Block* a, const Block* b) { return a->offset < b->offset; });
+
+        // Find the lowest gap that can hold the block
+        size_t offset = 0;
+        for (auto c : conflicts) {
+            if (c->offset >= offset + block.size) {
+                break;
+            }
+            offset = std::max(offset, c->offset + c->size);
+        }
+        block.offset = offset;
+        peak         = std::max(peak, offset + block.size);
+        placed.emplace_back(&block);
+    }
+    return peak;
+}
+} // namespace MNN
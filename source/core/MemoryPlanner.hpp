@@ -0,0 +1,40 @@
+//
+//  MemoryPlanner.hpp
+//  MNN
+//
+//  Created by MNN on 2020/04/22.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#ifndef MemoryPlanner_hpp
+#define MemoryPlanner_hpp
+
+#include <stddef.h>
+#include <vector>
+#include <MNN/MNNDefine.h>
+
+namespace MNN {
+
+/** offline memory planner. assigns offsets in one arena to blocks with known lifetime. */
+class MNN_PUBLIC MemoryPlanner {
+public:
+    /** memory block alive in [begin, end) */
+    struct Block {
+        size_t size   = 0;
+        int begin     = 0;
+        int end       = 0;
+        size_t offset = 0;
+    };
+
+    /**
+     * @brief assign offsets to blocks, blocks whose lifetime overlaps never share memory.
+     *        blocks are placed greedily by size from large to small, each at the lowest offset
+     *        that doesn't conflict with placed blocks alive at the same time.
+     * @param blocks    blocks to plan, offset of each block is written back.
+     * @return arena size needed by the plan, that is the peak memory.
+     */
+    static size_t plan(std::vector<Block>& blocks);
+};
+} // namespace MNN
+
+#endif /* MemoryPlanner_hpp */
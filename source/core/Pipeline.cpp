@@ -7,10 +7,17 @@
 //
 
 #include "core/Pipeline.hpp"
+#include <algorithm>
+#include <set>
+#include "backend/cpu/ThreadPool.hpp"
 #include "core/Backend.hpp"
+#include "core/BufferAllocator.hpp"
+#include "core/DirectedAcyclicGraph.hpp"
+#include "core/MNNMemoryUtils.h"
 #include "core/Macro.h"
 #include "core/SizeComputer.hpp"
 #include "core/TensorUtils.hpp"
+#include "core/Tracer.hpp"
 #include "core/WrapExecution.hpp"
 //#define MNN_OPEN_TIME_TRACE
 #include <MNN/AutoTime.hpp>
@@ -60,6 +67,125 @@ static Backend::StorageType _getTensorReleaseStorageType(const Tensor* tensor) {
     return Backend::DYNAMIC;
 }
 
+// Byte offsets of parts, which split whole along axis into contiguous blocks, false if they are not
+static bool _splitOffsets(const Tensor* whole, const std::vector<Tensor*>& parts, int axis, std::vector<int>& offsets) {
+    auto format    = TensorUtils::getDescribe(whole)->dimensionFormat;
+    const int dims = whole->dimensions();
+    if (axis < 0 || axis >= dims || (MNN_DATA_FORMAT_NC4HW4 == format && axis > 1)) {
+        return false;
+    }
+    for (int i = 0; i < axis; ++i) {
+        if (1 != whole->length(i)) {
+            return false;
+        }
+    }
+    offsets.clear();
+    int offset = 0;
+    int extent = 0;
+    for (int p = 0; p < parts.size(); ++p) {
+        auto part = parts[p];
+        if (part->dimensions() != dims || part->getType() != whole->getType() ||
+            TensorUtils::getDescribe(part)->dimensionFormat != format) {
+            return false;
+        }
+        for (int i = 0; i < dims; ++i) {
+            if (i != axis && part->length(i) != whole->length(i)) {
+                return false;
+            }
+        }
+        // Channels are packed by 4, only the last part can have remain
+        if (MNN_DATA_FORMAT_NC4HW4 == format && 1 == axis && p + 1 < parts.size() && part->length(1) % 4 != 0) {
+            return false;
+        }
+        if (offset % MNN_MEMORY_ALIGN_DEFAULT != 0) {
+            return false;
+        }
+        offsets.emplace_back(offset);
+        offset += part->size();
+        extent += part->length(axis);
+    }
+    return extent == whole->length(axis) && offset == whole->size();
+}
+
+// Byte offset of the output of SliceTf in input if it is a contiguous block, -1 if not
+static int _sliceTfOffset(const Tensor* input, const Tensor* begin, const Tensor* output) {
+    const int dims = input->dimensions();
+    if (MNN_DATA_FORMAT_NC4HW4 == TensorUtils::getDescribe(input)->dimensionFormat || output->dimensions() != dims ||
+        output->getType() != input->getType() || nullptr == begin->host<int32_t>() || begin->elementSize() < dims) {
+        return -1;
+    }
+    // The axes before the last cut one must be 1
+    int cut = dims - 1;
+    while (cut >= 0 && output->length(cut) == input->length(cut)) {
+        cut--;
+    }
+    for (int i = 0; i < cut; ++i) {
+        if (1 != output->length(i)) {
+            return -1;
+        }
+    }
+    int offset = 0;
+    for (int i = 0; i < dims; ++i) {
+        offset += begin->host<int32_t>()[i] * input->stride(i);
+    }
+    offset *= input->getType().bytes();
+    if (offset < 0 || offset % MNN_MEMORY_ALIGN_DEFAULT != 0) {
+        return -1;
+    }
+    return offset;
+}
+
+// Share the memory of parent from offset, which is kept until the view is released
+static void _setView(Tensor* t, const Tensor* parent, int offset) {
+    TensorUtils::setLinearLayout(t);
+    TensorUtils::setView(t, parent, offset);
+    TensorUtils::getDescribe(TensorUtils::getDescribe(t)->viewParent)->useCount += 1;
+}
+
+// Alloc tensor in the slot of its parent planned by last prepare, the parent is allocated first if need
+static bool _allocPlannedView(Backend* bn, Tensor* t, const Pipeline::ViewMap& views) {
+    auto iter = views.find(t);
+    if (iter == views.end()) {
+        return false;
+    }
+    auto& view     = iter->second;
+    auto parent    = view.parent;
+    auto parentDes = TensorUtils::getDescribe(parent);
+    if (t->size() != view.size || parent->size() != view.parentSize) {
+        return false;
+    }
+    if (nullptr == parentDes->backend) {
+        // The parent may be planned in the slot of another one too
+        if (!_allocPlannedView(bn, parent, views)) {
+            TensorUtils::setLinearLayout(parent);
+            if (!bn->onAcquireBuffer(parent, _getTensorStorageType(parent))) {
+                return false;
+            }
+            parentDes->backend = bn;
+        }
+    }
+    if (parentDes->backend != bn) {
+        return false;
+    }
+    _setView(t, parent, view.offset);
+    return true;
+}
+
+static void _releaseTensor(Tensor* t) {
+    auto des = TensorUtils::getDescribe(t);
+    if (nullptr == des->viewParent) {
+        des->backend->onReleaseBuffer(t, _getTensorReleaseStorageType(t));
+        return;
+    }
+    // The memory is released after the owner and all of its views
+    auto owner    = des->viewParent;
+    auto ownerDes = TensorUtils::getDescribe(owner);
+    ownerDes->useCount -= 1;
+    if (0 == ownerDes->useCount) {
+        ownerDes->backend->onReleaseBuffer(owner, _getTensorReleaseStorageType(owner));
+    }
+}
+
 bool Pipeline::Unit::_allocTensors(Backend* bn, const std::vector<Tensor*>& tensors) {
     for (auto t : tensors) {
         auto des = TensorUtils::getDescribe(t);
@@ -76,6 +202,51 @@ bool Pipeline::Unit::_allocTensors(Backend* bn, const std::vector<Tensor*>& tens
     return true;
 }
 
+void Pipeline::Unit::_allocSliceViews(Backend* bn) {
+    if (OpType_Slice != mType && OpType_SliceTf != mType) {
+        return;
+    }
+    auto input    = mInputs[0];
+    auto inputDes = TensorUtils::getDescribe(input);
+    if (inputDes->backend != bn || TensorUsage::NORMAL != inputDes->usage || Tensor::HANDLE_NONE != inputDes->handleType ||
+        nullptr == input->host<void>()) {
+        return;
+    }
+    for (auto t : mOutputs) {
+        auto des = TensorUtils::getDescribe(t);
+        if (nullptr != des->backend || TensorUsage::NORMAL != des->usage || Tensor::HANDLE_NONE != des->handleType) {
+            return;
+        }
+    }
+    std::vector<int> offsets;
+    if (OpType_Slice == mType) {
+        auto slice = mOriginOp->main_as_Slice();
+        if (nullptr == slice) {
+            return;
+        }
+        auto axis = slice->axis();
+        if (axis < 0) {
+            axis += input->dimensions();
+        }
+        if (!_splitOffsets(input, mOutputs, axis, offsets)) {
+            return;
+        }
+    } else {
+        // The begin must not change after resize
+        if (mInputs.size() < 2 || TensorUsage::CONST != TensorUtils::getDescribe(mInputs[1])->usage) {
+            return;
+        }
+        auto offset = _sliceTfOffset(input, mInputs[1], mOutputs[0]);
+        if (offset < 0) {
+            return;
+        }
+        offsets = {offset};
+    }
+    for (int i = 0; i < mOutputs.size(); ++i) {
+        _setView(mOutputs[i], input, offsets[i]);
+    }
+}
+
 Pipeline::Unit::Unit(const Op* op, const std::vector<Tensor*>& inputs, const std::vector<Tensor*>& outputs) {
     MNN_ASSERT(nullptr != op);
     mOriginOp = op;
@@ -94,6 +265,7 @@ Pipeline::Unit::Unit(const Op* op, const std::vector<Tensor*>& inputs, const std
 
 
 bool Pipeline::Unit::_createExecution(Backend* bn, Backend* cpuBn) {
+    Tracer::Scope _s("create", mContent->name);
     mExecution.reset(bn->onCreate(mInputs, mOutputs, mOriginOp));
     if (nullptr == mExecution) {
         mExecution.reset(cpuBn->onCreate(mInputs, mOutputs, mOriginOp));
@@ -119,6 +291,15 @@ bool Pipeline::Unit::_createExecution(Backend* bn, Backend* cpuBn) {
     return mExecution->valid();
 }
 
+ErrorCode Pipeline::Unit::_onExecute() {
+    Tracer::Scope _s("execute", mContent->name);
+    if (nullptr != _s.event()) {
+        _s.event()->strings = {{"type", mContent->type}};
+        _s.event()->numbers = {{"flops", mContent->flops}};
+    }
+    return mExecution->onExecute(mInputs, mOutputs);
+}
+
 ErrorCode Pipeline::Unit::execute() {
     if (nullptr == mExecution) {
         return NO_EXECUTION;
@@ -127,7 +308,7 @@ ErrorCode Pipeline::Unit::execute() {
         return NO_ERROR;
     }
     // MNN_PRINT("\t==> execute op: %s, [%s]\n", mContent->name.c_str(), mContent->type.c_str());
-    auto code = mExecution->onExecute(mInputs, mOutputs);
+    auto code = _onExecute();
     
     for (int i = 0; i < mInputs.size(); i++) {
         MNN_PRINT("  input%d ", i);
@@ -158,7 +339,7 @@ ErrorCode Pipeline::Unit::executeCallBack(const TensorCallBackWithInfo& before,
     }
     auto run = before(mInputs, this);
     if (run) {
-        auto code = mExecution->onExecute(mInputs, mOutputs);
+        auto code = _onExecute();
         if (NO_ERROR != code) {
             MNN_ERROR("Execute Error for [%s], %s, code=%d\n", MNN::EnumNameOpType(mOriginOp->type()), mContent->name.c_str(), code);
             return code;
@@ -171,7 +352,12 @@ ErrorCode Pipeline::Unit::executeCallBack(const TensorCallBackWithInfo& before,
     return NO_ERROR;
 }
 
-ErrorCode Pipeline::Unit::prepare(Backend* bn, Backend* cpuBn) {
+ErrorCode Pipeline::Unit::_onResize() {
+    Tracer::Scope _s("resize", mContent->name);
+    return mExecution->onResize(mInputs, mOutputs);
+}
+
+ErrorCode Pipeline::Unit::prepare(Backend* bn, Backend* cpuBn, const ViewMap* views) {
 #ifdef MNN_DEBUG_TENSOR_SIZE
     MNN_PRINT("\n===> prepare op: %s, [%s]\n", mOriginOp->name()->c_str(), MNN::EnumNameOpType(mOriginOp->type()));
 #endif
@@ -266,20 +452,40 @@ ErrorCode Pipeline::Unit::prepare(Backend* bn, Backend* cpuBn) {
             return OUT_OF_MEMORY;
         }
     }
+    if (nullptr != views && !mConst && MNN_FORWARD_CPU == bn->type()) {
+        for (auto t : mOutputs) {
+            auto des = TensorUtils::getDescribe(t);
+            if (nullptr != des->backend) {
+                // Allocated by the producers of its views, the plan is out of date if size changed
+                for (auto& iter : *views) {
+                    if (iter.second.parent == t && iter.second.parentSize != t->size()) {
+                        return COMPUTE_SIZE_ERROR;
+                    }
+                }
+                continue;
+            }
+            if (TensorUsage::NORMAL == des->usage && Tensor::HANDLE_NONE == des->handleType) {
+                _allocPlannedView(bn, t, *views);
+            }
+        }
+        // Outputs of slice along the outer axis alias their input
+        _allocSliceViews(bn);
+    }
     {
         auto success = _allocTensors(bn, mOutputs);
         if (!success) {
             return OUT_OF_MEMORY;
         }
     }
-    auto code = mExecution->onResize(mInputs, mOutputs);
+    auto code = _onResize();
     if (TENSOR_NOT_SUPPORT == code || TENSOR_NEED_DIVIDE == code) {
         // TODO
         mExecution.reset();
         for (auto t : mOutputs) {
             auto des = TensorUtils::getDescribe(t);
-            des->backend->onReleaseBuffer(t, _getTensorReleaseStorageType(t));
-            des->backend = nullptr;
+            _releaseTensor(t);
+            des->backend    = nullptr;
+            des->viewParent = nullptr;
         }
         auto sucess = _createExecution(cpuBn, cpuBn);
         MNN_ASSERT(NO_ERROR == sucess);
@@ -287,7 +493,7 @@ ErrorCode Pipeline::Unit::prepare(Backend* bn, Backend* cpuBn) {
         if (!success) {
             return OUT_OF_MEMORY;
         }
-        code = mExecution->onResize(mInputs, mOutputs);
+        code = _onResize();
     }
     if (NO_ERROR != code) {
         mExecution.reset();
@@ -301,7 +507,7 @@ ErrorCode Pipeline::Unit::prepare(Backend* bn, Backend* cpuBn) {
         auto des = TensorUtils::getDescribe(t);
         des->useCount -= 1;
         if (0 == des->useCount) {
-            des->backend->onReleaseBuffer(t, _getTensorReleaseStorageType(t));
+            _releaseTensor(t);
         }
     }
 #ifdef MNN_DEBUG_TENSOR_SIZE
@@ -323,18 +529,227 @@ Pipeline::Pipeline(const std::vector<Schedule::PipelineInfo>& infos, Backend* ba
     }
 }
 
+ErrorCode Pipeline::_prepareUnit(Unit* u) {
+    auto code = u->prepare(mBackend, mBackupBackend, &mViews);
+    auto tracer = Tracer::current();
+    if (nullptr != tracer) {
+        // Dynamic memory grows while units are prepared, the peak is the high-water mark of resize
+        double dynamicSize = 0.0;
+        for (auto bn : {mBackend, mBackupBackend}) {
+            auto allocator = static_cast<BufferAllocator*>(bn->getAllocator(Backend::DYNAMIC));
+            if (nullptr != allocator && (bn == mBackend || mBackend->getAllocator(Backend::DYNAMIC) != allocator)) {
+                dynamicSize += allocator->totalSize() / 1024.0 / 1024.0;
+            }
+        }
+        tracer->counter("dynamic memory", {{"MB", dynamicSize}});
+    }
+    if (NO_ERROR != code) {
+        if (nullptr != u->mOriginOp->name()) {
+            MNN_PRINT("-----------------------------------------------------------------------------------------------------------------------------\n");
+            MNN_PRINT("due to the internal logic of MNN, if your MNN model doesn't have input shape, you may ignore this 'Resize error' information:\n");
+            MNN_ERROR("** Resize error for [%s], %s, code=%d **\n", MNN::EnumNameOpType(u->mOriginOp->type()),u->mOriginOp->name()->c_str(), code);
+            MNN_PRINT("it will work after you set the input tensor shape in MNN, and then resize the Session\n");
+            MNN_PRINT("-----------------------------------------------------------------------------------------------------------------------------\n");
+        }
+    }
+    return code;
+}
+
+class UnitNodeDef : public NodeDef<int> {
+public:
+    UnitNodeDef(int index) : mIndex(index) {
+    }
+    virtual shared_ptr<Node<int>> makeNode() override {
+        auto node = make_shared<Node<int>>();
+        node->setData(mIndex);
+        return node;
+    }
+
+private:
+    int mIndex;
+};
+
+bool Pipeline::_buildStages() {
+    mStages.clear();
+    if (nullptr == mBackend->getAllocator(Backend::DYNAMIC) || nullptr == mBackupBackend->getAllocator(Backend::DYNAMIC)) {
+        return false;
+    }
+    DirectedAcyclicGraph<int> graph;
+    std::vector<std::shared_ptr<Node<int>>> nodes;
+    std::map<const Tensor*, int> producers;
+    for (int i = 0; i < mUnits.size(); ++i) {
+        UnitNodeDef def(i);
+        nodes.emplace_back(graph.AddNode(def));
+        for (auto t : mUnits[i]->mOutputs) {
+            producers[t] = i;
+        }
+    }
+    for (int i = 0; i < mUnits.size(); ++i) {
+        for (auto t : mUnits[i]->mInputs) {
+            auto iter = producers.find(t);
+            if (iter != producers.end() && iter->second != i) {
+                graph.AddEdge(nodes[iter->second], nodes[i]);
+            }
+        }
+    }
+    std::vector<std::shared_ptr<Node<int>>> order;
+    if (!graph.GetPostOrder(order)) {
+        MNN_ERROR("Units of pipeline have cycle, can't run in parallel\n");
+        return false;
+    }
+
+    // Stage of unit is the longest path from source units
+    std::vector<int> depth(mUnits.size(), 0);
+    int maxDepth = 0;
+    for (auto& n : order) {
+        auto index = n->getData();
+        for (auto& edge : n->getInEdges()) {
+            auto src     = edge->getSrc().lock();
+            depth[index] = std::max(depth[index], depth[src->getData()] + 1);
+        }
+        maxDepth = std::max(maxDepth, depth[index]);
+    }
+    if (maxDepth + 1 == mUnits.size()) {
+        // No independent units
+        return false;
+    }
+    mStages.resize(maxDepth + 1);
+    for (int i = 0; i < mUnits.size(); ++i) {
+        mStages[depth[i]].emplace_back(i);
+    }
+    return true;
+}
+
+void Pipeline::_buildFusions(const std::map<const Tensor*, int>& useCounts) {
+    std::map<const Tensor*, int> consumers;
+    for (auto& u : mUnits) {
+        for (auto t : u->mInputs) {
+            consumers[t] += 1;
+        }
+    }
+    std::vector<Backend::FuseUnit> units(mUnits.size());
+    for (int i = 0; i < mUnits.size(); ++i) {
+        auto& u        = mUnits[i];
+        auto& unit     = units[i];
+        unit.op        = u->mOriginOp;
+        unit.inputs    = u->mInputs;
+        unit.outputs   = u->mOutputs;
+        unit.execution = u->mExecution;
+        unit.isConst   = u->mConst;
+        unit.internal  = true;
+        for (auto t : u->mOutputs) {
+            // Uses of the output by other pipelines, views and user handles need it to be written
+            auto des  = TensorUtils::getDescribe(t);
+            auto use  = useCounts.find(t);
+            auto iter = consumers.find(t);
+            if (TensorUsage::NORMAL != des->usage || Tensor::HANDLE_NONE != des->handleType ||
+                nullptr != des->viewParent || mViews.find(t) != mViews.end() || use == useCounts.end() ||
+                iter == consumers.end() || use->second != iter->second) {
+                unit.internal = false;
+            }
+        }
+    }
+    std::vector<bool> fused(mUnits.size(), false);
+    std::vector<Backend*> backends = {mBackend};
+    if (mBackupBackend != mBackend) {
+        backends.emplace_back(mBackupBackend);
+    }
+    for (auto backend : backends) {
+        for (auto& fusion : backend->onFuse(units)) {
+            bool valid = nullptr != fusion.execution && !fusion.units.empty();
+            for (auto index : fusion.units) {
+                valid = valid && index >= 0 && index < fused.size() && !fused[index];
+            }
+            if (!valid) {
+                continue;
+            }
+            for (auto index : fusion.units) {
+                fused[index] = true;
+            }
+            mFusions.emplace_back(std::move(fusion));
+        }
+    }
+    _indexFusions();
+}
+
+void Pipeline::_indexFusions() {
+    mFusionOfUnit.clear();
+    if (mFusions.empty()) {
+        return;
+    }
+    mFusionOfUnit.resize(mUnits.size(), -1);
+    for (int i = 0; i < mFusions.size(); ++i) {
+        for (auto index : mFusions[i].units) {
+            mFusionOfUnit[index] = i;
+        }
+    }
+}
+
 ErrorCode Pipeline::prepare() {
     mBackend->onResizeBegin();
-    for (auto& u : mUnits) {
-        auto code = u->prepare(mBackend, mBackupBackend);
-        if (NO_ERROR != code) {
-            if (nullptr != u->mOriginOp->name()) {
-                MNN_PRINT("-----------------------------------------------------------------------------------------------------------------------------\n");
-                MNN_PRINT("due to the internal logic of MNN, if your MNN model doesn't have input shape, you may ignore this 'Resize error' information:\n");
-                MNN_ERROR("** Resize error for [%s], %s, code=%d **\n", MNN::EnumNameOpType(u->mOriginOp->type()),u->mOriginOp->name()->c_str(), code);
-                MNN_PRINT("it will work after you set the input tensor shape in MNN, and then resize the Session\n");
-                MNN_PRINT("-----------------------------------------------------------------------------------------------------------------------------\n");
+    mStages.clear();
+    mFusions.clear();
+    mFusionOfUnit.clear();
+    if (mInterOpParallel && mUnits.size() > 1) {
+        _buildStages();
+    }
+    if (mStages.empty()) {
+        // Consumers of all pipelines, before the units release their inputs
+        std::map<const Tensor*, int> useCounts;
+        for (auto& u : mUnits) {
+            for (auto t : u->mOutputs) {
+                useCounts[t] = TensorUtils::getDescribe(t)->useCount;
+            }
+        }
+        for (auto& u : mUnits) {
+            auto code = _prepareUnit(u.get());
+            if (NO_ERROR != code) {
+                return code;
+            }
+        }
+        _buildFusions(useCounts);
+        mBackend->onResizeEnd();
+        return NO_ERROR;
+    }
+
+    // Units of one stage alloc memory in different groups, so they can run at the same time
+    std::vector<BufferAllocator*> allocators;
+    for (auto bn : {mBackend, mBackupBackend}) {
+        auto allocator = static_cast<BufferAllocator*>(bn->getAllocator(Backend::DYNAMIC));
+        if (std::find(allocators.begin(), allocators.end(), allocator) == allocators.end()) {
+            allocators.emplace_back(allocator);
+        }
+    }
+    for (auto& stage : mStages) {
+        bool parallel = stage.size() > 1;
+        if (parallel) {
+            for (auto allocator : allocators) {
+                allocator->barrierBegin();
+            }
+        }
+        auto code = NO_ERROR;
+        for (auto index : stage) {
+            if (parallel) {
+                for (auto allocator : allocators) {
+                    allocator->beginGroup();
+                }
+            }
+            code = _prepareUnit(mUnits[index].get());
+            if (parallel) {
+                for (auto allocator : allocators) {
+                    allocator->endGroup();
+                }
             }
+            if (NO_ERROR != code) {
+                break;
+            }
+        }
+        if (parallel) {
+            for (auto allocator : allocators) {
+                allocator->barrierEnd();
+            }
+        }
+        if (NO_ERROR != code) {
             return code;
         }
     }
@@ -342,11 +757,142 @@ ErrorCode Pipeline::prepare() {
     return NO_ERROR;
 }
 
+bool Pipeline::planViews() {
+    ViewMap views;
+    std::set<const Tensor*> produced;
+    for (auto& u : mUnits) {
+        produced.insert(u->mOutputs.begin(), u->mOutputs.end());
+    }
+    for (auto& u : mUnits) {
+        if (OpType_Concat != u->mType || u->mConst || nullptr == u->mExecution) {
+            continue;
+        }
+        auto bn        = u->mExecution->backend();
+        auto output    = u->mOutputs[0];
+        auto outputDes = TensorUtils::getDescribe(output);
+        if (MNN_FORWARD_CPU != bn->type() || outputDes->backend != bn || Tensor::HANDLE_NONE != outputDes->handleType ||
+            (TensorUsage::NORMAL != outputDes->usage && TensorUsage::OUTPUT != outputDes->usage)) {
+            continue;
+        }
+        int axis   = 0;
+        auto param = u->mOriginOp->main_as_Axis();
+        if (nullptr != param) {
+            axis = param->axis();
+            if (axis < 0) {
+                axis += output->dimensions();
+            }
+        }
+        std::vector<int> offsets;
+        if (!_splitOffsets(output, u->mInputs, axis, offsets)) {
+            continue;
+        }
+        bool valid = true;
+        for (auto t : u->mInputs) {
+            auto des = TensorUtils::getDescribe(t);
+            // Only the outputs of units which are not aliased by slice can be moved into the slots
+            bool aliased = nullptr != des->viewParent && mViews.find(t) == mViews.end();
+            if (des->backend != bn || TensorUsage::NORMAL != des->usage || Tensor::HANDLE_NONE != des->handleType ||
+                produced.find(t) == produced.end() || views.find(t) != views.end() || aliased ||
+                std::count(u->mInputs.begin(), u->mInputs.end(), t) > 1) {
+                valid = false;
+                break;
+            }
+        }
+        if (!valid) {
+            continue;
+        }
+        for (int i = 0; i < u->mInputs.size(); ++i) {
+            auto& view      = views[u->mInputs[i]];
+            view.parent     = output;
+            view.offset     = offsets[i];
+            view.size       = u->mInputs[i]->size();
+            view.parentSize = output->size();
+        }
+    }
+    bool changed = views.size() != mViews.size();
+    for (auto iter = views.begin(), last = mViews.begin(); !changed && iter != views.end(); ++iter, ++last) {
+        changed = iter->first != last->first || iter->second.parent != last->second.parent ||
+                  iter->second.offset != last->second.offset || iter->second.size != last->second.size ||
+                  iter->second.parentSize != last->second.parentSize;
+    }
+    mViews.swap(views);
+    return changed;
+}
+
+bool Pipeline::clearViews() {
+    bool hasViews = !mViews.empty();
+    mViews.clear();
+    return hasViews;
+}
+
+ErrorCode Pipeline::_executeStage(const std::vector<int>& stage) {
+    if (stage.size() == 1) {
+        return mUnits[stage[0]]->execute();
+    }
+    std::vector<ErrorCode> codes(stage.size(), NO_ERROR);
+#ifdef MNN_USE_THREAD_POOL
+    auto workIndex = ThreadPool::acquireWorkIndex();
+    std::pair<std::function<void(int)>, int> task;
+    task.first  = [&](int i) { codes[i] = mUnits[stage[i]]->execute(); };
+    task.second = (int)stage.size();
+    ThreadPool::enqueue(std::move(task), workIndex);
+    ThreadPool::releaseWorkIndex(workIndex);
+#else
+    for (int i = 0; i < stage.size(); ++i) {
+        codes[i] = mUnits[stage[i]]->execute();
+    }
+#endif
+    for (auto code : codes) {
+        if (NO_ERROR != code) {
+            return code;
+        }
+    }
+    return NO_ERROR;
+}
+
+ErrorCode Pipeline::_executeFusion(const Backend::Fusion& fusion) {
+    auto& last = mUnits[fusion.units.back()];
+    Tracer::Scope _s("execute", last->name());
+    if (nullptr != _s.event()) {
+        float flops = 0.0f;
+        for (auto index : fusion.units) {
+            flops += mUnits[index]->flops();
+        }
+        _s.event()->strings = {{"type", "Fused"}};
+        _s.event()->numbers = {{"flops", flops}, {"units", (double)fusion.units.size()}};
+    }
+    auto code = fusion.execution->onExecute(last->mInputs, last->mOutputs);
+    if (NO_ERROR != code) {
+        MNN_ERROR("Execute Error for fused units ending with %s, code=%d\n", last->name().c_str(), code);
+    }
+    return code;
+}
+
 ErrorCode Pipeline::execute() {
     mBackend->onExecuteBegin();
+    if (!mStages.empty()) {
+        for (auto& stage : mStages) {
+            auto code = _executeStage(stage);
+            if (code != NO_ERROR) {
+                mBackend->onExecuteEnd();
+                return code;
+            }
+        }
+        mBackend->onExecuteEnd();
+        return NO_ERROR;
+    }
     for (int i=0; i<mUnits.size(); ++i) {
         auto& u = mUnits[i];
-        auto code = u->execute();
+        auto code = NO_ERROR;
+        if (!mFusionOfUnit.empty() && mFusionOfUnit[i] >= 0) {
+            // The fusion runs at its last unit
+            auto& fusion = mFusions[mFusionOfUnit[i]];
+            if (fusion.units.back() == i) {
+                code = _executeFusion(fusion);
+            }
+        } else {
+            code = u->execute();
+        }
         if (code != NO_ERROR) {
             mBackend->onExecuteEnd();
             return code;
@@ -359,6 +905,18 @@ ErrorCode Pipeline::execute() {
 ErrorCode Pipeline::executeCallBack(const TensorCallBackWithInfo& before, const TensorCallBackWithInfo& after) {
     mBackend->onExecuteBegin();
     std::shared_ptr<char> __defer(nullptr, [this](void*) { mBackend->onExecuteEnd(); });
+    if (!mStages.empty()) {
+        // Callbacks are not thread-safe, run units one by one in stage order, which memory is planned for
+        for (auto& stage : mStages) {
+            for (auto index : stage) {
+                auto code = mUnits[index]->executeCallBack(before, after);
+                if (code != NO_ERROR) {
+                    return code;
+                }
+            }
+        }
+        return NO_ERROR;
+    }
     for (auto& u : mUnits) {
         auto code = u->executeCallBack(before, after);
         if (code != NO_ERROR) {
@@ -368,6 +926,57 @@ ErrorCode Pipeline::executeCallBack(const TensorCallBackWithInfo& before, const
     return NO_ERROR;
 }
 
+void Pipeline::cloneExecutions(const Pipeline* source) {
+    MNN_ASSERT(source->mUnits.size() == mUnits.size());
+    for (int i = 0; i < mUnits.size(); ++i) {
+        auto sourceExecution = source->mUnits[i]->mExecution;
+        if (nullptr == sourceExecution) {
+            continue;
+        }
+        auto bn = mBackupBackend;
+        if (sourceExecution->backend() == source->mBackend) {
+            bn = mBackend;
+        }
+        Execution* dst = nullptr;
+        if (sourceExecution->onClone(bn, mUnits[i]->mOriginOp, &dst)) {
+            mUnits[i]->mExecution.reset(dst);
+        }
+    }
+}
+
+void Pipeline::swapState(State& state) {
+    if (state.executions.size() != mUnits.size()) {
+        state.executions.resize(mUnits.size());
+        state.consts.resize(mUnits.size(), false);
+        state.flops.resize(mUnits.size(), 0.0f);
+    }
+    for (int i = 0; i < mUnits.size(); ++i) {
+        auto& unit = mUnits[i];
+        unit->mExecution.swap(state.executions[i]);
+        bool isConst    = unit->mConst;
+        unit->mConst    = state.consts[i];
+        state.consts[i] = isConst;
+        std::swap(unit->mContent->flops, state.flops[i]);
+    }
+    mStages.swap(state.stages);
+    mFusions.swap(state.fusions);
+    _indexFusions();
+}
+
+void Pipeline::cloneExecutions(const State& state) {
+    MNN_ASSERT(state.executions.size() == mUnits.size());
+    for (int i = 0; i < mUnits.size(); ++i) {
+        auto& sourceExecution = state.executions[i];
+        if (nullptr == sourceExecution) {
+            continue;
+        }
+        Execution* dst = nullptr;
+        if (sourceExecution->onClone(sourceExecution->backend(), mUnits[i]->mOriginOp, &dst)) {
+            mUnits[i]->mExecution.reset(dst);
+        }
+    }
+}
+
 ErrorCode Pipeline::releaseCache() {
     for (auto& u : mUnits) {
         if (nullptr != u->mExecution) {
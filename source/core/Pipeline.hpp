@@ -54,6 +54,63 @@ public:
      * @return errorcode
      */
     ErrorCode releaseCache();
+    /**
+     * @brief create executions by cloning the ones of given pipeline, sharing their constant resources.
+     *        units whose execution can't be cloned will create it in prepare.
+     * @param source    prepared pipeline with the same ops.
+     */
+    void cloneExecutions(const Pipeline* source);
+
+    /** prepared executions and stages of units, kept to switch between prepare results of different input shapes */
+    struct State {
+        std::vector<std::shared_ptr<Execution>> executions;
+        std::vector<bool> consts;
+        std::vector<float> flops;
+        std::vector<std::vector<int>> stages;
+        std::vector<Backend::Fusion> fusions;
+    };
+    /**
+     * @brief exchange prepared state of units with given state. an empty state leaves units without execution.
+     * @param state     given state.
+     */
+    void swapState(State& state);
+    /**
+     * @brief create executions by cloning the ones in given state, sharing their constant resources.
+     *        units whose execution can't be cloned will create it in prepare.
+     * @param state     prepared state of this pipeline.
+     */
+    void cloneExecutions(const State& state);
+    /**
+     * @brief run independent units concurrently. units are grouped into stages by their depth in the dependency
+     *        graph of tensors, units of one stage run at the same time on CPU thread pool and never share memory.
+     *        take effect on next prepare, only CPU pipeline is supported.
+     * @param enable    enable or not.
+     */
+    void setInterOpParallel(bool enable) {
+        mInterOpParallel = enable;
+    }
+
+    /** slot of tensor in the memory of its parent, whose producer writes into it directly */
+    struct View {
+        Tensor* parent;
+        /** offset in bytes from the memory of parent */
+        int offset;
+        /** bytes of tensor and parent when planned, the view is dropped if they changed */
+        int size;
+        int parentSize;
+    };
+    typedef std::map<const Tensor*, View> ViewMap;
+    /**
+     * @brief plan the inputs of concat on CPU as views in the slots of its output by prepared units, the plan takes
+     *        effect on next prepare.
+     * @return whether the plan changed.
+     */
+    bool planViews();
+    /**
+     * @brief drop planned views.
+     * @return whether there were views.
+     */
+    bool clearViews();
 
     /** op unit in pipeline */
     class Unit : public NonCopyable, public OperatorInfo {
@@ -68,9 +125,10 @@ public:
 
         /**
          * @brief prepare unit.
+         * @param views     planned views, outputs in them share the memory of their parents.
          * @return result code.
          */
-        ErrorCode prepare(Backend* major, Backend* backup);
+        ErrorCode prepare(Backend* major, Backend* backup, const ViewMap* views = nullptr);
         /**
          * @brief execute unit.
          * @return result code.
@@ -99,8 +157,12 @@ public:
     private:
         bool _createExecution(Backend* bn, Backend* cpuBn);
         bool _allocTensors(Backend* bn, const std::vector<Tensor*>& tensors);
+        void _allocSliceViews(Backend* bn);
+        ErrorCode _onResize();
+        ErrorCode _onExecute();
 
     private:
+        friend class Pipeline;
         bool mConst                   = false;
     };
 
@@ -110,10 +172,26 @@ protected:
         return this->mUnits;
     }
 
+private:
+    ErrorCode _prepareUnit(Unit* unit);
+    bool _buildStages();
+    ErrorCode _executeStage(const std::vector<int>& stage);
+    void _buildFusions(const std::map<const Tensor*, int>& useCounts);
+    void _indexFusions();
+    ErrorCode _executeFusion(const Backend::Fusion& fusion);
+
 private:
     Backend* mBackend;
     Backend* mBackupBackend;
     std::vector<std::shared_ptr<Unit>> mUnits;
+    // Index of units for each stage, empty if units run one by one
+    std::vector<std::vector<int>> mStages;
+    bool mInterOpParallel = false;
+    ViewMap mViews;
+    // Units computed at once by executions of backends, their intermediates are not written
+    std::vector<Backend::Fusion> mFusions;
+    // Index of fusion for each unit, -1 if the unit runs itself
+    std::vector<int> mFusionOfUnit;
 };
 } // namespace MNN
 
@@ -9,6 +9,7 @@
 #include "core/Schedule.hpp"
 #include <algorithm>
 #include <iterator>
+#include <map>
 #include <set>
 #include <unordered_map>
 #include "core/DirectedAcyclicGraph.hpp"
@@ -318,6 +319,43 @@ static vector<Schedule::PipelineInfo> _scheduleUnit(const Net* net, const Schedu
     return oplists;
 }
 
+// Half tables only read as params of Gather / GatherV2 stay in half, the rows are widened to float when gathered
+static void _keepHalfTables(const Net* net, std::vector<std::pair<int, std::shared_ptr<Tensor>>>& allTensors) {
+    // Index of table and whether all its readers are gather
+    std::map<int, bool> tables;
+    for (int i = 0; i < net->oplists()->size(); ++i) {
+        auto op = net->oplists()->GetAs<Op>(i);
+        if (OpType_Const == op->type() && nullptr != op->main_as_Blob() && nullptr != op->outputIndexes() &&
+            1 == op->outputIndexes()->size() && DataType_DT_HALF == op->main_as_Blob()->dataType()) {
+            tables[op->outputIndexes()->data()[0]] = true;
+        }
+    }
+    if (tables.empty()) {
+        return;
+    }
+    for (int i = 0; i < net->oplists()->size(); ++i) {
+        auto op = net->oplists()->GetAs<Op>(i);
+        if (nullptr == op->inputIndexes()) {
+            continue;
+        }
+        auto data = op->inputIndexes()->data();
+        for (int j = 0; j < op->inputIndexes()->size(); ++j) {
+            auto iter = tables.find(data[j]);
+            if (iter == tables.end()) {
+                continue;
+            }
+            bool gathered = (OpType_Gather == op->type() || OpType_GatherV2 == op->type()) && 0 == j;
+            iter->second  = iter->second && gathered;
+        }
+    }
+    for (auto& iter : tables) {
+        auto des = TensorUtils::getDescribe(allTensors[iter.first].second.get());
+        if (iter.second && TensorUsage::OUTPUT != des->usage) {
+            des->keepHalf = true;
+        }
+    }
+}
+
 Schedule::ScheduleInfo Schedule::schedule(const Net* net, const std::vector<ScheduleConfig>& configs) {
     std::vector<std::shared_ptr<Tensor>> allTensors;
 
@@ -429,6 +467,14 @@ Schedule::ScheduleInfo Schedule::schedule(const Net* net, const std::vector<Sche
         TensorUtils::getDescribe(schedule.allTensors[outputIndex].second.get())->usage = TensorUsage::OUTPUT;
         schedule.allTensors[outputIndex].first += 1;
     }
+    // Only the gather of CPU reads half tables
+    bool cpuOnly = true;
+    for (auto& pipeline : schedule.pipelineInfo) {
+        cpuOnly = cpuOnly && MNN_FORWARD_CPU == pipeline.first.type;
+    }
+    if (cpuOnly) {
+        _keepHalfTables(net, schedule.allTensors);
+    }
     return schedule;
 }
 } // namespace MNN
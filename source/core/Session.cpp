@@ -8,19 +8,150 @@
 
 #include "core/Session.hpp"
 #include <string.h>
+#include <algorithm>
 #include <MNN/AutoTime.hpp>
 #include <map>
 #include <set>
 #include "MNN_generated.h"
+#include "backend/cpu/CPUBackend.hpp"
 #include "core/AutoStorage.h"
 #include "core/BackendFactory.hpp"
+#include "core/BufferAllocator.hpp"
 #include "core/TensorUtils.hpp"
+#include "core/Tracer.hpp"
 #include "core/WrapExecution.hpp"
 
 using namespace std;
 
 namespace MNN {
 
+struct Session::ResizeCache {
+    struct TensorState {
+        halide_buffer_t buffer;
+        std::vector<halide_dimension_t> dims;
+        MNN_DATA_FORMAT format;
+        Backend* backend;
+        int useCount;
+        TensorUsage usage;
+    };
+    // Options and shapes of inputs
+    std::vector<int> key;
+    std::vector<TensorState> tensors;
+    // Prepared state and memory not in use, empty for current one
+    std::vector<Pipeline::State> pipelines;
+    std::vector<std::shared_ptr<BufferAllocator>> allocators;
+    size_t freeListMemory = 0;
+    size_t plannedMemory  = 0;
+
+    void save(const std::vector<std::pair<int, std::shared_ptr<Tensor>>>& allTensors) {
+        tensors.resize(allTensors.size());
+        for (int i = 0; i < allTensors.size(); ++i) {
+            auto t       = allTensors[i].second.get();
+            auto des     = TensorUtils::getDescribe(t);
+            auto& state  = tensors[i];
+            state.buffer = t->buffer();
+            state.dims.assign(t->buffer().dim, t->buffer().dim + t->buffer().dimensions);
+            state.format   = des->dimensionFormat;
+            state.backend  = des->backend;
+            state.useCount = des->useCount;
+            state.usage    = des->usage;
+        }
+    }
+    void load(const std::vector<std::pair<int, std::shared_ptr<Tensor>>>& allTensors) const {
+        MNN_ASSERT(tensors.size() == allTensors.size());
+        for (int i = 0; i < allTensors.size(); ++i) {
+            auto t            = allTensors[i].second.get();
+            auto des          = TensorUtils::getDescribe(t);
+            auto& state       = tensors[i];
+            auto dim          = t->buffer().dim;
+            t->buffer()       = state.buffer;
+            t->buffer().dim   = dim;
+            ::memcpy(dim, state.dims.data(), state.dims.size() * sizeof(halide_dimension_t));
+            des->dimensionFormat = state.format;
+            des->backend         = state.backend;
+            des->useCount        = state.useCount;
+            des->usage           = state.usage;
+        }
+    }
+};
+
+struct Session::BucketTensor {
+    // Tensor in session
+    Tensor* origin = nullptr;
+    // Tensor of real size
+    std::shared_ptr<Tensor> tensor;
+    AutoStorage<uint8_t> storage;
+    // For input: dimension to pad and bucket sizes
+    int axis = 0;
+    std::vector<int> sizes;
+    // For output: dimension to crop and index of input bucket
+    std::vector<std::pair<int, int>> crops;
+};
+
+// Extents of tensor in memory order
+static std::vector<int> _getMemoryShape(const Tensor* tensor) {
+    std::vector<int> shape(tensor->buffer().dimensions);
+    for (int i = 0; i < shape.size(); ++i) {
+        shape[i] = tensor->length(i);
+    }
+    if (TensorUtils::getDescribe(tensor)->dimensionFormat == MNN_DATA_FORMAT_NC4HW4 && shape.size() > 1) {
+        shape[1] = UP_DIV(shape[1], 4);
+        shape.emplace_back(4);
+    }
+    return shape;
+}
+
+// Copy the common region of two tensors with the same dimensions, the rest of dst is set to zero
+static void _copyRegion(const Tensor* src, Tensor* dst) {
+    auto srcShape = _getMemoryShape(src);
+    auto dstShape = _getMemoryShape(dst);
+    MNN_ASSERT(srcShape.size() == dstShape.size());
+    auto bytes = src->getType().bytes();
+    if (srcShape == dstShape) {
+        ::memcpy(dst->host<void>(), src->host<void>(), src->size());
+        return;
+    }
+    // Dimensions after the last different one are copied by block
+    int last = (int)srcShape.size() - 1;
+    while (srcShape[last] == dstShape[last]) {
+        bytes *= srcShape[last];
+        last--;
+    }
+    std::vector<int> countShape(last + 1);
+    size_t srcStride = bytes, dstStride = bytes;
+    std::vector<size_t> srcStrides(last + 1), dstStrides(last + 1);
+    bool pad = false;
+    for (int i = last; i >= 0; --i) {
+        srcStrides[i] = srcStride;
+        dstStrides[i] = dstStride;
+        srcStride *= srcShape[i];
+        dstStride *= dstShape[i];
+        countShape[i] = std::min(srcShape[i], dstShape[i]);
+        pad           = pad || dstShape[i] > srcShape[i];
+    }
+    if (pad) {
+        ::memset(dst->host<void>(), 0, dstStride);
+    }
+    auto blockBytes = countShape[last] * bytes;
+    int outside     = 1;
+    for (int i = 0; i < last; ++i) {
+        outside *= countShape[i];
+    }
+    auto srcPtr = src->host<uint8_t>();
+    auto dstPtr = dst->host<uint8_t>();
+    for (int o = 0; o < outside; ++o) {
+        size_t srcOffset = 0, dstOffset = 0;
+        int index        = o;
+        for (int i = last - 1; i >= 0; --i) {
+            auto pos = index % countShape[i];
+            index /= countShape[i];
+            srcOffset += pos * srcStrides[i];
+            dstOffset += pos * dstStrides[i];
+        }
+        ::memcpy(dstPtr + dstOffset, srcPtr + srcOffset, blockBytes);
+    }
+}
+
 Backend* Session::_getDefaultBackend() {
     auto defaultType = MNN_FORWARD_CPU;
     if (mBackends.find(defaultType) == mBackends.end()) {
@@ -39,7 +170,16 @@ Session::Session(const Schedule::ScheduleInfo& info) {
         return;
     }
 
-    mTensors = info.allTensors;
+    mTensors      = info.allTensors;
+    mPipelineInfo = info.pipelineInfo;
+    for (auto& iter : mPipelineInfo) {
+        // Keep backend config for clone
+        if (nullptr != iter.first.user) {
+            std::shared_ptr<BackendConfig> config(new BackendConfig(*iter.first.user));
+            iter.first.user = config.get();
+            mBackendConfigs.emplace_back(config);
+        }
+    }
     for (auto& iter : info.pipelineInfo) {
         if (mBackends.find(iter.first.type) == mBackends.end()) {
             auto newBn = BackendFactory::create(iter.first);
@@ -92,40 +232,153 @@ Session::Session(const Schedule::ScheduleInfo& info) {
 }
 
 Session::~Session() {
+    // Cached executions release their constant memory to backends
+    mResizeCaches.clear();
     for (auto& t : mTensors) {
         TensorUtils::clearHandleData(t.second.get());
     }
     mPipelines.clear();
     mBackends.clear();
+    mSharedBackends.clear();
     mTensors.clear();
 }
 
+Session* Session::clone() const {
+    std::map<const Tensor*, Tensor*> tensorMap;
+    Schedule::ScheduleInfo info;
+    info.validForResize = true;
+    for (auto& iter : mTensors) {
+        auto src = iter.second.get();
+        std::shared_ptr<Tensor> dst(new Tensor(src->dimensions()));
+        TensorUtils::copyShape(src, dst.get(), true);
+        dst->buffer().type = src->buffer().type;
+        dst->setName(src->getName());
+        auto srcDes   = TensorUtils::getDescribe(src);
+        auto dstDes   = TensorUtils::getDescribe(dst.get());
+        dstDes->usage = srcDes->usage;
+        dstDes->name  = srcDes->name;
+        tensorMap[src] = dst.get();
+        info.allTensors.emplace_back(std::make_pair(iter.first, dst));
+    }
+    for (auto& iter : mInputs) {
+        info.inputTensors.insert(std::make_pair(iter.first, tensorMap[iter.second]));
+    }
+    for (auto& iter : mOutputs) {
+        info.outputTensor.insert(std::make_pair(iter.first, tensorMap[iter.second]));
+    }
+    for (auto& iter : mPipelineInfo) {
+        std::vector<Schedule::PipelineInfo> units;
+        for (auto& unit : iter.second) {
+            Schedule::PipelineInfo newUnit;
+            newUnit.op = unit.op;
+            for (auto t : unit.inputs) {
+                newUnit.inputs.emplace_back(tensorMap[t]);
+            }
+            for (auto t : unit.outputs) {
+                newUnit.outputs.emplace_back(tensorMap[t]);
+            }
+            units.emplace_back(std::move(newUnit));
+        }
+        info.pipelineInfo.emplace_back(std::make_pair(iter.first, std::move(units)));
+    }
+    std::unique_ptr<Session> newSession(new Session(info));
+    if (!newSession->valid() || newSession->mPipelines.size() != mPipelines.size()) {
+        return nullptr;
+    }
+    newSession->mMemoryPlan          = mMemoryPlan;
+    newSession->mResizeCacheCapacity = mResizeCacheCapacity;
+    newSession->setInterOpParallel(mInterOpParallel);
+    newSession->setTrace(nullptr != mTracer);
+    if (!mShapeBuckets.empty() && NO_ERROR != newSession->setShapeBuckets(mShapeBuckets)) {
+        return nullptr;
+    }
+    for (int i = 0; i < mPipelines.size(); ++i) {
+        newSession->mPipelines[i]->cloneExecutions(mPipelines[i].get());
+    }
+    newSession->mSharedBackends = mSharedBackends;
+    for (auto& iter : mBackends) {
+        newSession->mSharedBackends.emplace_back(iter.second);
+    }
+    return newSession.release();
+}
+
+void Session::setInterOpParallel(bool flag) {
+    mInterOpParallel = flag;
+    for (auto& iter : mPipelines) {
+        iter->setInterOpParallel(flag);
+    }
+}
+
+void Session::setTrace(bool enable) {
+    if (!enable) {
+        mTracer.reset();
+        return;
+    }
+    if (nullptr != mTracer) {
+        return;
+    }
+    mTracer.reset(new Tracer);
+    // Prepare again to record creating of executions
+    _releaseExecutions();
+}
+
+void Session::setTuning(bool enable) {
+    for (auto& iter : mBackends) {
+        if (nullptr != iter.second && MNN_FORWARD_CPU == iter.second->type()) {
+            static_cast<CPUBackend*>(iter.second.get())->setTuning(enable);
+        }
+    }
+    if (enable) {
+        // Executions are tuned when created
+        _releaseExecutions();
+    }
+}
+
+void Session::_releaseExecutions() {
+    // Cached shapes are dropped since they skip preparing
+    mResizeCaches.clear();
+    mResizeCacheCurrent = false;
+    for (auto& p : mPipelines) {
+        Pipeline::State dropped;
+        p->swapState(dropped);
+    }
+    mNeedResize = true;
+}
+
 ErrorCode Session::run() const {
-    if (mNeedResize) {
+    if (getNeedResize()) {
         MNN_ERROR("Can't run session because not resized\n");
         return COMPUTE_SIZE_ERROR;
     }
+    Tracer::Bind _b(mTracer.get());
+    Tracer::Scope _s("session", "run");
+    _padBucketInputs();
     for (auto& iter : mPipelines) {
         auto error = iter->execute();
         if (NO_ERROR != error) {
             return error;
         }
     }
+    _cropBucketOutputs();
     return NO_ERROR;
 }
 
 ErrorCode Session::runWithCallBack(const TensorCallBackWithInfo& before, const TensorCallBackWithInfo& end,
                                    bool sync) const {
-    if (mNeedResize) {
+    if (getNeedResize()) {
         MNN_ERROR("Can't run session because not resized\n");
         return COMPUTE_SIZE_ERROR;
     }
+    Tracer::Bind _b(mTracer.get());
+    Tracer::Scope _s("session", "run");
+    _padBucketInputs();
     for (auto& iter : mPipelines) {
         auto error = iter->executeCallBack(before, end);
         if (NO_ERROR != error) {
             return error;
         }
     }
+    _cropBucketOutputs();
     if (sync) {
         for (auto& bn : mBackends) {
             if(bn.second){
@@ -136,16 +389,424 @@ ErrorCode Session::runWithCallBack(const TensorCallBackWithInfo& before, const T
     return NO_ERROR;
 }
 
+ErrorCode Session::setShapeBuckets(const std::vector<ShapeBucket>& buckets) {
+    std::vector<std::shared_ptr<BucketTensor>> inputs;
+    std::map<Tensor*, std::shared_ptr<BucketTensor>> outputs;
+    std::map<std::string, Tensor*> userInputs  = mInputs;
+    std::map<std::string, Tensor*> userOutputs = mOutputs;
+    auto cpuBackend                            = _getDefaultBackend();
+    auto createUserTensor = [cpuBackend](BucketTensor* bucket) {
+        auto origin = bucket->origin;
+        bucket->tensor.reset(new Tensor(origin->dimensions()));
+        TensorUtils::copyShape(origin, bucket->tensor.get(), true);
+        bucket->tensor->buffer().type = origin->buffer().type;
+        TensorUtils::getDescribe(bucket->tensor.get())->backend = cpuBackend;
+    };
+    for (auto& config : buckets) {
+        Tensor* input = nullptr;
+        if (config.input.empty()) {
+            input = mInputs.empty() ? nullptr : mInputs.begin()->second;
+        } else if (mInputs.find(config.input) != mInputs.end()) {
+            input = mInputs.find(config.input)->second;
+        }
+        if (nullptr == input || config.axis < 0 || config.axis >= input->dimensions() || config.sizes.empty()) {
+            MNN_ERROR("Invalid shape bucket for input %s\n", config.input.c_str());
+            return INVALID_VALUE;
+        }
+        std::shared_ptr<BucketTensor> bucket(new BucketTensor);
+        bucket->origin = input;
+        bucket->axis   = config.axis;
+        bucket->sizes  = config.sizes;
+        createUserTensor(bucket.get());
+        for (auto& iter : mInputs) {
+            if (iter.second == input) {
+                userInputs[iter.first] = bucket->tensor.get();
+            }
+        }
+        for (auto& outputConfig : config.outputs) {
+            auto outputIter = mOutputs.find(outputConfig.first);
+            if (outputIter == mOutputs.end() || outputConfig.second < 0) {
+                MNN_ERROR("Invalid output %s for shape bucket\n", outputConfig.first.c_str());
+                return INVALID_VALUE;
+            }
+            auto& output = outputs[outputIter->second];
+            if (nullptr == output) {
+                output.reset(new BucketTensor);
+                output->origin = outputIter->second;
+                createUserTensor(output.get());
+                userOutputs[outputIter->first] = output->tensor.get();
+            }
+            output->crops.emplace_back(std::make_pair(outputConfig.second, (int)inputs.size()));
+        }
+        inputs.emplace_back(bucket);
+    }
+    mShapeBuckets = buckets;
+    mBucketInputs = std::move(inputs);
+    mBucketOutputs.clear();
+    for (auto& iter : outputs) {
+        mBucketOutputs.emplace_back(iter.second);
+    }
+    mUserInputs       = std::move(userInputs);
+    mUserOutputs      = std::move(userOutputs);
+    mNeedBucketResize = true;
+    return NO_ERROR;
+}
+
+bool Session::_applyShapeBuckets() {
+    bool changed = false;
+    for (auto& bucket : mBucketInputs) {
+        auto user   = bucket->tensor.get();
+        auto origin = bucket->origin;
+        std::vector<int> shape(user->dimensions());
+        for (int i = 0; i < shape.size(); ++i) {
+            shape[i] = user->length(i);
+        }
+        auto& size = shape[bucket->axis];
+        for (auto s : bucket->sizes) {
+            if (s >= size) {
+                size = s;
+                break;
+            }
+        }
+        if (origin->shape() != shape) {
+            origin->buffer().dimensions = (int)shape.size();
+            for (int i = 0; i < shape.size(); ++i) {
+                origin->setLength(i, shape[i]);
+            }
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+ErrorCode Session::_allocBucketTensors() {
+    auto alloc = [](BucketTensor* bucket) {
+        auto tensor = bucket->tensor.get();
+        TensorUtils::setLinearLayout(tensor);
+        auto bytes = tensor->size();
+        if (bucket->storage.size() < bytes) {
+            bucket->storage.reset(bytes);
+        }
+        tensor->buffer().host = bucket->storage.get();
+    };
+    for (auto& bucket : mBucketInputs) {
+        if (nullptr == bucket->origin->host<void>()) {
+            MNN_ERROR("Shape bucket only supports input in CPU memory\n");
+            return NOT_SUPPORT;
+        }
+        alloc(bucket.get());
+    }
+    for (auto& bucket : mBucketOutputs) {
+        auto origin = bucket->origin;
+        auto tensor = bucket->tensor.get();
+        if (nullptr == origin->host<void>()) {
+            MNN_ERROR("Shape bucket only supports output in CPU memory\n");
+            return NOT_SUPPORT;
+        }
+        tensor->buffer().dimensions = origin->dimensions();
+        TensorUtils::copyShape(origin, tensor, true);
+        for (auto& crop : bucket->crops) {
+            if (crop.first >= tensor->dimensions()) {
+                continue;
+            }
+            auto input  = mBucketInputs[crop.second];
+            auto real   = input->tensor->length(input->axis);
+            auto padded = input->origin->length(input->axis);
+            tensor->setLength(crop.first, UP_DIV(tensor->length(crop.first) * real, padded));
+        }
+        alloc(bucket.get());
+    }
+    return NO_ERROR;
+}
+
+void Session::_padBucketInputs() const {
+    for (auto& bucket : mBucketInputs) {
+        _copyRegion(bucket->tensor.get(), bucket->origin);
+    }
+}
+
+void Session::_cropBucketOutputs() const {
+    for (auto& bucket : mBucketOutputs) {
+        _copyRegion(bucket->origin, bucket->tensor.get());
+    }
+}
+
 void Session::_clearCache() {
     for (auto& t : mTensors) {
         auto describe = TensorUtils::getDescribe(t.second.get());
         TensorUtils::clearHandleData(t.second.get());
-        describe->useCount = t.first;
-        describe->backend  = nullptr;
+        describe->useCount   = t.first;
+        describe->backend    = nullptr;
+        describe->viewParent = nullptr;
+        describe->viewOffset = 0;
+    }
+}
+
+std::vector<BufferAllocator*> Session::_getDynamicAllocators() const {
+    std::vector<BufferAllocator*> allocators;
+    for (auto& b : mBackends) {
+        if (nullptr == b.second) {
+            continue;
+        }
+        auto allocator = static_cast<BufferAllocator*>(b.second->getAllocator(Backend::DYNAMIC));
+        if (nullptr != allocator && std::find(allocators.begin(), allocators.end(), allocator) == allocators.end()) {
+            allocators.emplace_back(allocator);
+        }
     }
+    return allocators;
+}
+
+void Session::_traceMemory() const {
+    double dynamicSize = 0.0, staticSize = 0.0;
+    std::vector<void*> allocators;
+    for (auto& b : mBackends) {
+        if (nullptr == b.second) {
+            continue;
+        }
+        for (auto type : {Backend::DYNAMIC, Backend::STATIC}) {
+            auto allocator = b.second->getAllocator(type);
+            if (nullptr == allocator || std::find(allocators.begin(), allocators.end(), allocator) != allocators.end()) {
+                continue;
+            }
+            allocators.emplace_back(allocator);
+            auto size = static_cast<BufferAllocator*>(allocator)->totalSize() / 1024.0 / 1024.0;
+            if (Backend::DYNAMIC == type) {
+                dynamicSize += size;
+            } else {
+                staticSize += size;
+            }
+        }
+    }
+    mTracer->counter("dynamic memory", {{"MB", dynamicSize}});
+    mTracer->counter("static memory", {{"MB", staticSize}});
 }
 
 ErrorCode Session::resize() {
+    Tracer::Bind _b(mTracer.get());
+    auto code = NO_ERROR;
+    {
+        Tracer::Scope _s("session", "resize");
+        code = _resizeAll();
+    }
+    if (nullptr != mTracer) {
+        _traceMemory();
+    }
+    return code;
+}
+
+ErrorCode Session::_resizeAll() {
+    if (!mBucketInputs.empty()) {
+        auto changed = _applyShapeBuckets();
+        if (!changed && !mNeedResize) {
+            // Inputs are resized within their buckets
+            mNeedBucketResize = false;
+            return _allocBucketTensors();
+        }
+    }
+    mNeedBucketResize = false;
+    auto allocators   = _getDynamicAllocators();
+    ErrorCode code    = NO_ERROR;
+    if (mResizeCacheCapacity > 0 && _supportResizeCache(allocators)) {
+        code = _resizeWithCache(allocators);
+    } else {
+        code = _resizeAndAllocate(allocators);
+    }
+    if (NO_ERROR != code) {
+        return code;
+    }
+    return _allocBucketTensors();
+}
+
+void Session::setResizeCache(int capacity) {
+    mResizeCacheCapacity = capacity;
+    if (capacity <= 0) {
+        // Current state stays in backends and pipelines
+        mResizeCaches.clear();
+        mResizeCacheCurrent = false;
+        return;
+    }
+    while (mResizeCaches.size() > capacity) {
+        mResizeCaches.pop_back();
+    }
+}
+
+bool Session::_supportResizeCache(const std::vector<BufferAllocator*>& allocators) const {
+    // Memory of all backends must be swappable
+    for (auto& b : mBackends) {
+        if (nullptr != b.second && nullptr == b.second->getAllocator(Backend::DYNAMIC)) {
+            return false;
+        }
+    }
+    for (auto& t : mTensors) {
+        if (TensorUtils::getDescribe(t.second.get())->handleType != Tensor::HANDLE_NONE) {
+            return false;
+        }
+    }
+    return !allocators.empty();
+}
+
+void Session::_swapResizeCache(ResizeCache* cache, const std::vector<BufferAllocator*>& allocators) {
+    while (cache->allocators.size() < allocators.size()) {
+        cache->allocators.emplace_back(new BufferAllocator);
+    }
+    for (int i = 0; i < allocators.size(); ++i) {
+        allocators[i]->swap(*cache->allocators[i]);
+    }
+    cache->pipelines.resize(mPipelines.size());
+    for (int i = 0; i < mPipelines.size(); ++i) {
+        mPipelines[i]->swapState(cache->pipelines[i]);
+    }
+}
+
+ErrorCode Session::_resizeWithCache(const std::vector<BufferAllocator*>& allocators) {
+    std::vector<int> key = {mMemoryPlan, mInterOpParallel};
+    auto shapeKey        = _inputShapeKey();
+    key.insert(key.end(), shapeKey.begin(), shapeKey.end());
+    auto iter = mResizeCaches.begin();
+    for (; iter != mResizeCaches.end(); ++iter) {
+        if ((*iter)->key == key) {
+            break;
+        }
+    }
+    if (iter != mResizeCaches.end()) {
+        auto cache = *iter;
+        if (!mResizeCacheCurrent || iter != mResizeCaches.begin()) {
+            if (mResizeCacheCurrent) {
+                _swapResizeCache(mResizeCaches.front().get(), allocators);
+            } else {
+                // Drop the state of failed resize
+                ResizeCache dropped;
+                _swapResizeCache(&dropped, allocators);
+            }
+            _swapResizeCache(cache.get(), allocators);
+            mResizeCaches.erase(iter);
+            mResizeCaches.push_front(cache);
+        }
+        cache->load(mTensors);
+        mFreeListMemory     = cache->freeListMemory;
+        mPlannedMemory      = cache->plannedMemory;
+        mResizeCacheCurrent = true;
+        mNeedResize         = false;
+        mResizeCacheHit++;
+        return NO_ERROR;
+    }
+
+    mResizeCacheMiss++;
+    if (mResizeCacheCurrent) {
+        // Keep the current state, prepare new executions sharing its constant resources
+        auto source = mResizeCaches.front();
+        _swapResizeCache(source.get(), allocators);
+        for (int i = 0; i < mPipelines.size(); ++i) {
+            mPipelines[i]->cloneExecutions(source->pipelines[i]);
+        }
+        mResizeCacheCurrent = false;
+    }
+    auto code = _resizeAndAllocate(allocators);
+    if (NO_ERROR != code) {
+        return code;
+    }
+    std::shared_ptr<ResizeCache> cache(new ResizeCache);
+    cache->key = std::move(key);
+    cache->save(mTensors);
+    cache->freeListMemory = mFreeListMemory;
+    cache->plannedMemory  = mPlannedMemory;
+    mResizeCaches.push_front(cache);
+    mResizeCacheCurrent = true;
+    while (mResizeCaches.size() > mResizeCacheCapacity) {
+        mResizeCaches.pop_back();
+    }
+    return NO_ERROR;
+}
+
+std::vector<int> Session::_inputShapeKey() const {
+    std::vector<int> key;
+    for (auto& iter : mInputs) {
+        auto t = iter.second;
+        key.emplace_back(t->getType().code);
+        key.emplace_back(t->getType().bits);
+        key.emplace_back(t->dimensions());
+        for (int i = 0; i < t->dimensions(); ++i) {
+            key.emplace_back(t->length(i));
+        }
+    }
+    return key;
+}
+
+bool Session::_planViews(ErrorCode code) {
+    bool changed = false;
+    for (auto& p : mPipelines) {
+        // The views may cause the failure, prepare again without them
+        changed = (NO_ERROR == code ? p->planViews() : p->clearViews()) || changed;
+    }
+    return changed;
+}
+
+ErrorCode Session::_resizeAndAllocate(const std::vector<BufferAllocator*>& allocators) {
+    mFreeListMemory = 0;
+    mPlannedMemory  = 0;
+    // Views planned for other input shapes don't match the sizes of tensors
+    auto key = _inputShapeKey();
+    if (key != mViewKey) {
+        for (auto& p : mPipelines) {
+            p->clearViews();
+        }
+        mViewKey = std::move(key);
+    }
+    if (!mMemoryPlan || allocators.empty()) {
+        auto code = _resize();
+        if (_planViews(code)) {
+            code = _resize();
+        }
+        for (auto allocator : allocators) {
+            mFreeListMemory += allocator->totalSize();
+        }
+        return code;
+    }
+
+    // Record lifetime of memory while resizing by free list
+    for (auto allocator : allocators) {
+        allocator->beginRecord();
+    }
+    auto code = _resize();
+    if (_planViews(code)) {
+        // Record again with the views, which change lifetime of memory
+        for (auto allocator : allocators) {
+            allocator->endRecord();
+            allocator->beginRecord();
+        }
+        code = _resize();
+    }
+    for (auto allocator : allocators) {
+        mFreeListMemory += allocator->totalSize();
+        allocator->endRecord();
+    }
+    if (NO_ERROR != code) {
+        return code;
+    }
+
+    // Resize again and alloc from the plan
+    for (auto allocator : allocators) {
+        allocator->beginReplay();
+    }
+    code       = _resize();
+    bool valid = true;
+    for (auto allocator : allocators) {
+        valid = allocator->endReplay() && valid;
+        mPlannedMemory += allocator->totalSize();
+    }
+    if (NO_ERROR == code && !valid) {
+        MNN_PRINT("Memory plan mismatch, resize by free list\n");
+        mPlannedMemory = 0;
+        code           = _resize();
+    }
+#ifdef MNN_DUMP_MEMORY_USAGE
+    MNN_PRINT("Dynamic memory: free list %f MB, planned %f MB\n", mFreeListMemory / 1024.0f / 1024.0f,
+              mPlannedMemory / 1024.0f / 1024.0f);
+#endif
+    return code;
+}
+
+ErrorCode Session::_resize() {
     _clearCache();
     for (auto& b : mBackends) {
         // avoid library not loaded
@@ -175,12 +836,13 @@ const Backend* Session::getBackEnd(const Tensor* tensor) const {
 }
 
 Tensor* Session::getInput(const char* name) const {
-    MNN_ASSERT(!mInputs.empty());
+    auto& inputs = getInputAll();
+    MNN_ASSERT(!inputs.empty());
     if (nullptr == name) {
-        return mInputs.begin()->second;
+        return inputs.begin()->second;
     }
-    auto iter = mInputs.find(name);
-    if (iter == mInputs.end()) {
+    auto iter = inputs.find(name);
+    if (iter == inputs.end()) {
         MNN_PRINT("Error: can't find input: %s\n", name);
         return nullptr;
     }
@@ -188,13 +850,14 @@ Tensor* Session::getInput(const char* name) const {
 }
 
 Tensor* Session::getOutput(const char* name) const {
-    MNN_ASSERT(!mOutputs.empty());
+    auto& outputs = getOutputAll();
+    MNN_ASSERT(!outputs.empty());
     if (nullptr == name) {
-        return mOutputs.begin()->second;
+        return outputs.begin()->second;
     }
 
-    auto iter = mOutputs.find(name);
-    if (iter == mOutputs.end()) {
+    auto iter = outputs.find(name);
+    if (iter == outputs.end()) {
         MNN_PRINT("Error: can't find output: %s\n", name);
         return nullptr;
     }
@@ -202,10 +865,16 @@ Tensor* Session::getOutput(const char* name) const {
 }
 
 const std::map<std::string, Tensor*>& Session::getInputAll() const {
+    if (!mShapeBuckets.empty()) {
+        return mUserInputs;
+    }
     return mInputs;
 }
 
 const std::map<std::string, Tensor*>& Session::getOutputAll() const {
+    if (!mShapeBuckets.empty()) {
+        return mUserOutputs;
+    }
     return mOutputs;
 }
 
@@ -214,6 +883,10 @@ const std::vector<std::pair<int, std::shared_ptr<Tensor>>>& Session::getTensors(
 }
 
 ErrorCode Session::releaseCache() {
+    // Only the current resize result is needed
+    while (mResizeCaches.size() > (mResizeCacheCurrent ? 1 : 0)) {
+        mResizeCaches.pop_back();
+    }
     for (auto& p : mPipelines) {
         auto code = p->releaseCache();
         if (NO_ERROR != code) {
@@ -9,6 +9,7 @@
 #ifndef Session_hpp
 #define Session_hpp
 
+#include <list>
 #include <map>
 #include <memory>
 #include <vector>
@@ -21,6 +22,8 @@
 
 namespace MNN {
 struct Net;
+class BufferAllocator;
+class Tracer;
 /** infer unit. multiple sessions could share one net. */
 class MNN_PUBLIC Session {
 public:
@@ -64,7 +67,7 @@ public:
      * @return needs resize or not.
      */
     bool getNeedResize() const {
-        return mNeedResize;
+        return mNeedResize || mNeedBucketResize;
     }
     /**
      * @brief set if needs resize.
@@ -73,6 +76,70 @@ public:
     void setNeedResize(bool flag = true) {
         mNeedResize = flag;
     }
+    /**
+     * @brief set if input of shape bucket is resized.
+     */
+    void setNeedBucketResize() {
+        mNeedBucketResize = true;
+    }
+    /**
+     * @brief set if plan dynamic memory by tensor lifetime when resize.
+     * @param flag  plan memory or not.
+     */
+    void setMemoryPlan(bool flag) {
+        mMemoryPlan = flag;
+    }
+    /**
+     * @brief set if run independent ops concurrently, take effect on next resize.
+     * @param flag  run in parallel or not.
+     */
+    void setInterOpParallel(bool flag);
+    /**
+     * @brief get dynamic memory size of last resize.
+     * @return first: size allocated by free list reuse, second: size allocated by plan, 0 if not planned.
+     */
+    std::pair<size_t, size_t> getMemoryUsage() const {
+        return std::make_pair(mFreeListMemory, mPlannedMemory);
+    }
+    /**
+     * @brief keep resize results of recent input shapes. when inputs are resized to a kept shape, resize only swaps
+     *        prepared executions, tensor shapes and memory of the shape in instead of preparing again.
+     * @param capacity  max number of input shapes kept, including current one. 0 disables the cache.
+     */
+    void setResizeCache(int capacity);
+    /**
+     * @brief get statistics of resize cache.
+     * @return first: number of resize served by cache, second: number of resize prepared again.
+     */
+    std::pair<int, int> getResizeCacheStats() const {
+        return std::make_pair(mResizeCacheHit, mResizeCacheMiss);
+    }
+    /**
+     * @brief pad inputs up to bucket sizes before running and crop outputs after running. inputs and outputs of
+     *        buckets are replaced by tensors of real sizes. take effect on next resize.
+     * @param buckets   given buckets, empty to disable.
+     * @return result code.
+     */
+    ErrorCode setShapeBuckets(const std::vector<ShapeBucket>& buckets);
+    /**
+     * @brief record timeline of resize and run, including creating and running of every op, work items of thread
+     *        pool and dynamic memory size. enabling releases executions and needs resize to create them again.
+     * @param enable    record or not, disabling drops recorded events.
+     */
+    void setTrace(bool enable);
+    /**
+     * @brief get tracer of session.
+     * @return tracer, NULL if trace is not enabled.
+     */
+    Tracer* getTracer() const {
+        return mTracer.get();
+    }
+    /**
+     * @brief measure candidate algorithms of ops on CPU backend when creating them and choose the fastest.
+     *        enabling releases executions and needs resize to create them again.
+     * @param enable    tune or not.
+     */
+    void setTuning(bool enable);
 
 public:
     /**
@@ -124,24 +191,77 @@ public:
      */
     ErrorCode updateToModel(Net* net) const;
 
+    /**
+     * @brief create an execution context of the session. the context shares executions' constant resources (such as
+     *        transformed weights) with the session, and owns its tensors and memory for activations, so that
+     *        contexts of one session could run concurrently in different threads.
+     * @return created context, need resize before running.
+     */
+    Session* clone() const;
+
 protected:
     const std::vector<std::shared_ptr<Pipeline>>& getPipelines() const {
         return this->mPipelines;
     }
 
 private:
+    struct ResizeCache;
+    struct BucketTensor;
     void _clearCache();
+    void _releaseExecutions();
+    ErrorCode _resizeAll();
+    void _traceMemory() const;
+    ErrorCode _resize();
+    bool _planViews(ErrorCode code);
+    std::vector<int> _inputShapeKey() const;
+    ErrorCode _resizeAndAllocate(const std::vector<BufferAllocator*>& allocators);
+    ErrorCode _resizeWithCache(const std::vector<BufferAllocator*>& allocators);
+    bool _supportResizeCache(const std::vector<BufferAllocator*>& allocators) const;
+    void _swapResizeCache(ResizeCache* cache, const std::vector<BufferAllocator*>& allocators);
+    std::vector<BufferAllocator*> _getDynamicAllocators() const;
+    bool _applyShapeBuckets();
+    ErrorCode _allocBucketTensors();
+    void _padBucketInputs() const;
+    void _cropBucketOutputs() const;
     void _setUpTensorInfo(const Schedule::ScheduleInfo& info);
     Backend* _getDefaultBackend();
 
 private:
     std::map<MNNForwardType, std::shared_ptr<Backend>> mBackends;
+    // Backends of the sessions cloned from, which own the shared constant resources
+    std::vector<std::shared_ptr<Backend>> mSharedBackends;
+    std::vector<std::pair<Backend::Info, std::vector<Schedule::PipelineInfo>>> mPipelineInfo;
+    std::vector<std::shared_ptr<BackendConfig>> mBackendConfigs;
     std::vector<std::shared_ptr<Pipeline>> mPipelines;
     std::vector<std::pair<int, std::shared_ptr<Tensor>>> mTensors;
     std::map<std::string, Tensor*> mInputs;
     std::map<std::string, Tensor*> mOutputs;
     bool mNeedResize       = false;
     bool mValid            = true;
+    bool mMemoryPlan       = false;
+    bool mInterOpParallel  = false;
+    size_t mFreeListMemory = 0;
+    size_t mPlannedMemory  = 0;
+    // Input shapes which views of pipelines are planned for
+    std::vector<int> mViewKey;
+
+    // Resize results of recent input shapes, the most recent first
+    std::list<std::shared_ptr<ResizeCache>> mResizeCaches;
+    // Whether the first resize cache is the state in backends and pipelines
+    bool mResizeCacheCurrent = false;
+    int mResizeCacheCapacity = 0;
+    int mResizeCacheHit      = 0;
+    int mResizeCacheMiss     = 0;
+
+    // Tensors of real sizes for padded inputs and cropped outputs
+    std::vector<ShapeBucket> mShapeBuckets;
+    std::vector<std::shared_ptr<BucketTensor>> mBucketInputs;
+    std::vector<std::shared_ptr<BucketTensor>> mBucketOutputs;
+    std::map<std::string, Tensor*> mUserInputs;
+    std::map<std::string, Tensor*> mUserOutputs;
+    bool mNeedBucketResize = false;
+
+    std::shared_ptr<Tracer> mTracer;
 };
 } // namespace MNN
 
@@ -44,6 +44,21 @@ void TensorUtils::setLinearLayout(Tensor* tensor) {
     }
 }
 
+void TensorUtils::setView(Tensor* view, const Tensor* parent, int offset) {
+    auto des       = view->mDescribe;
+    auto parentDes = parent->mDescribe;
+    view->buffer().host = parent->buffer().host + offset;
+    des->backend        = parentDes->backend;
+    // Views always refer to the tensor owning the memory
+    if (nullptr != parentDes->viewParent) {
+        des->viewParent = parentDes->viewParent;
+        des->viewOffset = parentDes->viewOffset + offset;
+    } else {
+        des->viewParent = (Tensor*)parent;
+        des->viewOffset = offset;
+    }
+}
+
 void TensorUtils::clearHandleData(Tensor* tensor) {
     if (tensor->buffer().type.code != halide_type_handle) {
         return;
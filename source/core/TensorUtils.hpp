@@ -48,6 +48,13 @@ public:
     };
     Usage usage = NORMAL;
     std::string name;
+
+    /** for view tensor only. tensor owning the memory, which contains this tensor from viewOffset bytes. */
+    Tensor* viewParent = nullptr;
+    /** for view tensor only. offset in bytes from the memory of viewParent. */
+    int viewOffset = 0;
+    /** for const tensor of half blob only. keep the data in half because all readers widen it, such as Gather. */
+    bool keepHalf = false;
 };
 typedef Tensor::InsideDescribe::Usage TensorUsage;
 
@@ -75,6 +82,14 @@ public:
      */
     static void setLinearLayout(Tensor* tensor);
 
+    /**
+     * @brief make tensor a view sharing the memory of parent from given offset, its layout must be set before.
+     * @param view      given tensor.
+     * @param parent    allocated tensor, may be a view too.
+     * @param offset    offset in bytes from the memory of parent.
+     */
+    static void setView(Tensor* view, const Tensor* parent, int offset);
+
     /**
      * @brief call handle free function to clear handle of tensor.
      * @param tensor    given tensor.
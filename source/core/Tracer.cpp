@@ -0,0 +1,181 @@
+//
+//  Tracer.cpp
+//  MNN
+//
+//  Created by MNN on 2020/05/01.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include "core/Tracer.hpp"
+#include <stdio.h>
+#include <algorithm>
+#include <atomic>
+
+namespace MNN {
+static thread_local Tracer* gCurrentTracer = nullptr;
+
+static void _appendString(std::string& dst, const std::string& src) {
+    dst.push_back('"');
+    for (auto c : src) {
+        switch (c) {
+            case '"':
+                dst += "\\\"";
+                break;
+            case '\\':
+                dst += "\\\\";
+                break;
+            case '\n':
+                dst += "\\n";
+                break;
+            default:
+                if ((unsigned char)c < 0x20) {
+                    char buffer[8];
+                    snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+                    dst += buffer;
+                } else {
+                    dst.push_back(c);
+                }
+                break;
+        }
+    }
+    dst.push_back('"');
+}
+
+Tracer::Tracer() {
+    mStart = std::chrono::steady_clock::now();
+}
+
+int64_t Tracer::now() const {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - mStart).count();
+}
+
+void Tracer::add(Event&& event) {
+    std::lock_guard<std::mutex> _l(mLock);
+    mEvents.emplace_back(std::move(event));
+}
+
+void Tracer::counter(const char* name, const std::vector<std::pair<std::string, double>>& values) {
+    Event event;
+    event.name     = name;
+    event.category = "memory";
+    event.phase    = 'C';
+    event.begin    = now();
+    event.duration = 0;
+    event.thread   = threadId();
+    event.numbers  = values;
+    std::lock_guard<std::mutex> _l(mLock);
+    for (auto& v : values) {
+        auto& peak = mPeaks[event.name + "." + v.first];
+        peak       = std::max(peak, v.second);
+    }
+    mEvents.emplace_back(std::move(event));
+}
+
+double Tracer::peak(const char* name, const char* key) const {
+    std::lock_guard<std::mutex> _l(mLock);
+    auto iter = mPeaks.find(std::string(name) + "." + key);
+    if (iter == mPeaks.end()) {
+        return 0.0;
+    }
+    return iter->second;
+}
+
+void Tracer::clear() {
+    std::lock_guard<std::mutex> _l(mLock);
+    mEvents.clear();
+    mPeaks.clear();
+}
+
+size_t Tracer::size() const {
+    std::lock_guard<std::mutex> _l(mLock);
+    return mEvents.size();
+}
+
+std::string Tracer::dump() const {
+    std::lock_guard<std::mutex> _l(mLock);
+    std::string result = "{\"traceEvents\":[";
+    char buffer[64];
+    for (int i = 0; i < mEvents.size(); ++i) {
+        auto& e = mEvents[i];
+        if (i > 0) {
+            result += ",";
+        }
+        result += "\n{\"name\":";
+        _appendString(result, e.name);
+        result += ",\"cat\":";
+        _appendString(result, e.category);
+        snprintf(buffer, sizeof(buffer), ",\"ph\":\"%c\",\"ts\":%lld", e.phase, (long long)e.begin);
+        result += buffer;
+        if ('X' == e.phase) {
+            snprintf(buffer, sizeof(buffer), ",\"dur\":%lld", (long long)e.duration);
+            result += buffer;
+        }
+        snprintf(buffer, sizeof(buffer), ",\"pid\":0,\"tid\":%d,\"args\":{", e.thread);
+        result += buffer;
+        bool first = true;
+        for (auto& s : e.strings) {
+            if (!first) {
+                result += ",";
+            }
+            first = false;
+            _appendString(result, s.first);
+            result += ":";
+            _appendString(result, s.second);
+        }
+        for (auto& n : e.numbers) {
+            if (!first) {
+                result += ",";
+            }
+            first = false;
+            _appendString(result, n.first);
+            snprintf(buffer, sizeof(buffer), ":%.6g", n.second);
+            result += buffer;
+        }
+        result += "}}";
+    }
+    result += "\n],\"displayTimeUnit\":\"ms\"}\n";
+    return result;
+}
+
+Tracer* Tracer::current() {
+    return gCurrentTracer;
+}
+
+int Tracer::threadId() {
+    static std::atomic<int> gThreadNumber(0);
+    static thread_local int gThreadId = gThreadNumber++;
+    return gThreadId;
+}
+
+Tracer::Bind::Bind(Tracer* tracer) {
+    mOrigin        = gCurrentTracer;
+    gCurrentTracer = tracer;
+}
+
+Tracer::Bind::~Bind() {
+    gCurrentTracer = mOrigin;
+}
+
+Tracer::Scope::Scope(const char* category, const char* name) {
+    mTracer = gCurrentTracer;
+    if (nullptr == mTracer) {
+        return;
+    }
+    mEvent.name     = name;
+    mEvent.category = category;
+    mEvent.phase    = 'X';
+    mEvent.thread   = threadId();
+    mEvent.begin    = mTracer->now();
+}
+
+Tracer::Scope::Scope(const char* category, const std::string& name) : Scope(category, name.c_str()) {
+}
+
+Tracer::Scope::~Scope() {
+    if (nullptr == mTracer) {
+        return;
+    }
+    mEvent.duration = mTracer->now() - mEvent.begin;
+    mTracer->add(std::move(mEvent));
+}
+} // namespace MNN
@@ -0,0 +1,131 @@
+//
+//  Tracer.hpp
+//  MNN
+//
+//  Created by MNN on 2020/05/01.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#ifndef Tracer_hpp
+#define Tracer_hpp
+
+#include <stdint.h>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+#include "core/NonCopyable.hpp"
+#include <MNN/MNNDefine.h>
+
+namespace MNN {
+/**
+ records timeline of a session in chrome trace event format, viewed in chrome://tracing or perfetto.
+ the tracer of a session is bound to the running thread while the session resizes or runs, code on the path records
+ spans to Tracer::current(), which is null when tracing is off. thread pool binds the tracer of a task to the threads
+ running its work items.
+ */
+class MNN_PUBLIC Tracer : public NonCopyable {
+public:
+    struct Event {
+        std::string name;
+        const char* category;
+        // 'X' for complete event, 'C' for counter
+        char phase;
+        int64_t begin;
+        int64_t duration;
+        int thread;
+        std::vector<std::pair<std::string, std::string>> strings;
+        std::vector<std::pair<std::string, double>> numbers;
+    };
+
+    Tracer();
+    ~Tracer() = default;
+
+    /**
+     * @brief get microseconds since the tracer is created.
+     * @return timestamp.
+     */
+    int64_t now() const;
+    /**
+     * @brief add event, thread-safe.
+     * @param event     given event.
+     */
+    void add(Event&& event);
+    /**
+     * @brief add counter event at current time, peak of every value is kept as well.
+     * @param name      name of counter.
+     * @param values    values of counter.
+     */
+    void counter(const char* name, const std::vector<std::pair<std::string, double>>& values);
+    /**
+     * @brief get peak of counter value recorded.
+     * @param name      name of counter.
+     * @param key       name of value.
+     * @return peak value, 0 if not recorded.
+     */
+    double peak(const char* name, const char* key) const;
+    /**
+     * @brief clear recorded events.
+     */
+    void clear();
+    /**
+     * @brief get recorded events in chrome trace event json.
+     * @return json string.
+     */
+    std::string dump() const;
+    /**
+     * @brief get number of recorded events.
+     * @return number of events.
+     */
+    size_t size() const;
+
+    /**
+     * @brief get tracer bound to current thread.
+     * @return tracer, NULL if not bound.
+     */
+    static Tracer* current();
+    /**
+     * @brief get small id of current thread used in events.
+     * @return thread id.
+     */
+    static int threadId();
+
+    /** binds tracer to current thread in the scope */
+    class MNN_PUBLIC Bind : public NonCopyable {
+    public:
+        Bind(Tracer* tracer);
+        ~Bind();
+
+    private:
+        Tracer* mOrigin;
+    };
+
+    /** records complete event of the scope to current tracer, does nothing if no tracer bound */
+    class MNN_PUBLIC Scope : public NonCopyable {
+    public:
+        Scope(const char* category, const char* name);
+        Scope(const char* category, const std::string& name);
+        ~Scope();
+        /**
+         * @brief get event to add arguments, NULL if no tracer bound.
+         */
+        Event* event() {
+            return nullptr == mTracer ? nullptr : &mEvent;
+        }
+
+    private:
+        Tracer* mTracer;
+        Event mEvent;
+    };
+
+private:
+    std::chrono::steady_clock::time_point mStart;
+    mutable std::mutex mLock;
+    std::vector<Event> mEvents;
+    std::map<std::string, double> mPeaks;
+};
+} // namespace MNN
+
+#endif /* Tracer_hpp */
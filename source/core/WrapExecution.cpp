@@ -16,6 +16,21 @@ WrapExecution::WrapExecution(Backend* CPUBackend, std::shared_ptr<Execution> exe
     mValid = execution->valid();
 }
 
+bool WrapExecution::onClone(Backend* bn, const Op* op, Execution** dst) {
+    // Only CPU execution wrapped for CPU, whose converting tensors can be allocated by the new backend
+    if (mCPUBackend != mExecution->backend()) {
+        return false;
+    }
+    Execution* execution = nullptr;
+    if (!mExecution->onClone(bn, op, nullptr == dst ? nullptr : &execution)) {
+        return false;
+    }
+    if (nullptr != dst) {
+        *dst = new WrapExecution(bn, std::shared_ptr<Execution>(execution));
+    }
+    return true;
+}
+
 ErrorCode WrapExecution::onResize(const std::vector<Tensor*>& inputs, const std::vector<Tensor*>& outputs) {
     mWrapInputTensors.clear();
     mInputMaps.clear();
@@ -16,16 +16,27 @@
 #include "cv/ImageBlitter.hpp"
 #include "cv/ImageFloatBlitter.hpp"
 #include "cv/ImageSampler.hpp"
+#include "backend/cpu/CPUBackend.hpp"
 #include "backend/cpu/CPUTensorConvert.hpp"
 #include <MNN/MNNForwardType.h>
 #include "core/Backend.hpp"
+#include "core/BackendFactory.hpp"
+#include "core/Concurrency.h"
 #define CACHE_SIZE 256
+// Don't split the images among threads if they are small
+#define MULTI_THREAD_PIXELS (64 * 256)
 namespace MNN {
 namespace CV {
 struct ImageProcess::Inside {
     Config config;
+    // Caches of each thread, every one has 4 * CACHE_SIZE bytes
     AutoStorage<uint8_t> cacheBuffer;
     AutoStorage<uint8_t> cacheBufferRGBA;
+    // Threads requested by setThreadNumber
+    int numThread = 1;
+    // Offer the thread pool, only created if more than one thread is requested
+    std::shared_ptr<Backend> backend;
+    int threadNumber = 1;
 };
 
 ImageProcess::~ImageProcess() {
@@ -35,6 +46,8 @@ ImageProcess::~ImageProcess() {
 ImageProcess::ImageProcess(const Config& config) {
     mInside         = new Inside;
     mInside->config = config;
+    // Choose the functions of cpu, such as SSE / AVX2 kernels on x86
+    CPUBackend::initFunctions();
     mInside->cacheBuffer.reset(4 * CACHE_SIZE);
     mInside->cacheBufferRGBA.reset(4 * CACHE_SIZE);
     for (int i = 0; i < 4; ++i) {
@@ -43,6 +56,27 @@ ImageProcess::ImageProcess(const Config& config) {
     }
 }
 
+void ImageProcess::setThreadNumber(int numThread) {
+    numThread = std::max(1, numThread);
+    if (numThread == mInside->numThread) {
+        return;
+    }
+    mInside->numThread    = numThread;
+    mInside->threadNumber = 1;
+    mInside->backend.reset();
+    if (numThread > 1) {
+        Backend::Info info;
+        info.type      = MNN_FORWARD_CPU;
+        info.numThread = numThread;
+        mInside->backend.reset(BackendFactory::create(info));
+        if (nullptr != mInside->backend) {
+            mInside->threadNumber = static_cast<CPUBackend*>(mInside->backend.get())->threadNumber();
+        }
+    }
+    mInside->cacheBuffer.reset(4 * CACHE_SIZE * mInside->threadNumber);
+    mInside->cacheBufferRGBA.reset(4 * CACHE_SIZE * mInside->threadNumber);
+}
+
 ImageProcess* ImageProcess::create(const Config& config, const Tensor* dstTensor) {
     // TODO Get dstTensor' backend
 
@@ -193,95 +227,100 @@ static ImageFormat _correctImageFormat(int outputBpp, halide_type_t type, ImageF
     return format;
 }
 
-ErrorCode ImageProcess::convert(const uint8_t* source, int iw, int ih, int stride, Tensor* destOrigin) {
-    auto dest = destOrigin;
-    if (nullptr == dest || nullptr == source) {
-        MNN_ERROR("null dest or source for image process\n");
-        return INPUT_DATA_ERROR;
-    }
-    std::shared_ptr<Tensor> tempTensor;
-    auto ow              = dest->width();
-    auto oh              = dest->height();
-    auto bpp             = dest->channel();
-    auto dimensionFormat = TensorUtils::getDescribe(dest)->dimensionFormat;
-    auto tensorBn = TensorUtils::getDescribe(dest)->backend;
-    auto bnType = MNN_FORWARD_CPU;
-    if(tensorBn){
-        bnType = tensorBn->type();
-    }
-    if (bnType != MNN_FORWARD_CPU) {
-        tempTensor.reset(Tensor::create({1, bpp, oh, ow}, dest->getType(), nullptr, Tensor::CAFFE_C4),[destOrigin] (void* p) {
-            auto hostTensor = (Tensor*)p;
-            destOrigin->copyFromHostTensor(hostTensor);
-            delete hostTensor;
-        });
-        dest = tempTensor.get();
-    }
-    else if (MNN_DATA_FORMAT_NCHW == dimensionFormat) {
-        tempTensor.reset(Tensor::create(dest->shape(), dest->getType(), nullptr, Tensor::CAFFE_C4), [destOrigin](void* p) {
-            auto hostTensor = (Tensor*)p;
-            CPUTensorConverter::convert(hostTensor, destOrigin);
-            delete hostTensor;
-        });
-        dest = tempTensor.get();
-    }
-    dimensionFormat = TensorUtils::getDescribe(dest)->dimensionFormat;
-    if (dimensionFormat == MNN_DATA_FORMAT_NC4HW4) {
-        bpp = 4;
-    }
-    return convert(source, iw, ih, stride, dest->host<void>(), ow, oh, bpp, ow * bpp, dest->getType());
-}
+// The formats and functions shared by all images of one convert
+struct ConvertContext {
+    ImageBlitter::BLITTER blitter;
+    ImageFloatBlitter::BLIT_FLOAT blitFloat;
+    const ImageProcess::Config* config;
+    int iw;
+    int ih;
+    int stride;
+    int sourceBpp;
+    int ow;
+    int oh;
+    int bpp;
+    int destBytes;
+    bool needBlit;
+    bool isFloat;
+};
 
-ErrorCode ImageProcess::convert(const uint8_t* source, int iw, int ih, int stride, void* dest, int ow, int oh,
-                                int outputBpp, int outputStride, halide_type_t type) {
-    auto sourceBpp = _getBpp(mInside->config.sourceFormat);
+// One image, dest is the start of its slot in output
+struct ImageSlot {
+    const uint8_t* source;
+    uint8_t* dest;
+    Matrix transform;
+    Matrix invert;
+    ImageSampler::PROC sampler;
+};
+
+static ErrorCode _prepareContext(ConvertContext& context, const ImageProcess::Config& config, int iw, int ih,
+                                 int stride, int ow, int oh, int outputBpp, halide_type_t type) {
+    auto sourceBpp = _getBpp(config.sourceFormat);
     if (0 == stride) {
         stride = iw * sourceBpp;
     }
-
-    // AUTOTIME;
-    auto& config      = mInside->config;
-    auto sourceFormat = config.sourceFormat;
-    auto destFormat   = config.destFormat;
-    destFormat        = _correctImageFormat(outputBpp, type, destFormat);
-    auto blitter      = ImageBlitter::choose(sourceFormat, destFormat);
-    if (nullptr == blitter) {
-        return INPUT_DATA_ERROR;
-    }
-    bool identity = mTransform.isIdentity() && iw >= ow && ih >= oh; // TODO, no need for iw, ih limit
-    auto sampler  = ImageSampler::choose(sourceFormat, config.filterType, identity);
-    if (nullptr == sampler) {
+    auto destFormat = _correctImageFormat(outputBpp, type, config.destFormat);
+    context.blitter = ImageBlitter::choose(config.sourceFormat, destFormat);
+    if (nullptr == context.blitter) {
         return INPUT_DATA_ERROR;
     }
     if (0 == outputBpp) {
         outputBpp = _getBpp(destFormat);
     }
+    context.blitFloat = ImageFloatBlitter::choose(destFormat, outputBpp);
+    context.config    = &config;
+    context.iw        = iw;
+    context.ih        = ih;
+    context.stride    = stride;
+    context.sourceBpp = sourceBpp;
+    context.ow        = ow;
+    context.oh        = oh;
+    context.bpp       = outputBpp;
+    context.destBytes = type.bytes();
+    context.needBlit  = config.sourceFormat != destFormat;
+    context.isFloat   = type.code == halide_type_float;
+    return NO_ERROR;
+}
+
+static ErrorCode _prepareSlot(ImageSlot& slot, const ConvertContext& context, const Matrix& transform) {
+    slot.transform = transform;
+    transform.invert(&slot.invert);
+    // TODO, no need for iw, ih limit
+    bool identity = transform.isIdentity() && context.iw >= context.ow && context.ih >= context.oh;
+    slot.sampler  = ImageSampler::choose(context.config->sourceFormat, context.config->filterType, identity);
+    if (nullptr == slot.sampler) {
+        return INPUT_DATA_ERROR;
+    }
+    return NO_ERROR;
+}
 
-    int tileCount = UP_DIV(ow, CACHE_SIZE);
+// Convert the rows in [yStart, yEnd) of one image, each cache has 4 * CACHE_SIZE bytes
+static void _convertRows(const ConvertContext& context, const ImageSlot& slot, int yStart, int yEnd,
+                         uint8_t* sampleBuffer, uint8_t* blitBuffer) {
+    auto& config        = *context.config;
+    auto& transform     = slot.transform;
+    const int iw        = context.iw;
+    const int ih        = context.ih;
+    const int ow        = context.ow;
+    const int bpp       = context.bpp;
+    const int destBytes = context.destBytes;
+    const int sourceBpp = context.sourceBpp;
+    int tileCount       = UP_DIV(ow, CACHE_SIZE);
     Point points[2];
-    auto sampleBuffer = (uint8_t*)mInside->cacheBuffer.get();
-    auto srcData      = source;
-    auto destBytes    = type.bytes();
-    auto bpp          = outputBpp;
-    auto needBlit     = sourceFormat != destFormat;
-    bool isFloat      = type.code == halide_type_float;
-    //            MNN_PRINT("bpp:%d, destBytes:%d, destFormat:%d, %d, %d\n",bpp, destBytes, ow, oh, dimensionFormat);
-
-    auto blitFloat = ImageFloatBlitter::choose(destFormat, bpp);
-    for (int dy = 0; dy < oh; ++dy) {
-        auto dstY = (uint8_t*)dest + dy * destBytes * ow * bpp;
+    for (int dy = yStart; dy < yEnd; ++dy) {
+        auto dstY = slot.dest + dy * destBytes * ow * bpp;
         for (int tIndex = 0; tIndex < tileCount; ++tIndex) {
             int xStart    = tIndex * CACHE_SIZE;
             int count     = std::min(CACHE_SIZE, ow - xStart);
             auto dstStart = dstY + destBytes * bpp * xStart;
 
             auto samplerDest = sampleBuffer;
-            auto blitDest    = mInside->cacheBufferRGBA.get();
+            auto blitDest    = blitBuffer;
 
-            if (!isFloat) {
+            if (!context.isFloat) {
                 blitDest = dstStart;
             }
-            if (!needBlit) {
+            if (!context.needBlit) {
                 samplerDest = blitDest;
             }
 
@@ -294,7 +333,7 @@ ErrorCode ImageProcess::convert(const uint8_t* source, int iw, int ih, int strid
                 points[1].fX = xStart + count;
                 points[1].fY = dy;
 
-                mTransform.mapPoints(points, 2);
+                transform.mapPoints(points, 2);
                 float deltaY = points[1].fY - points[0].fY;
                 float deltaX = points[1].fX - points[0].fX;
 
@@ -304,13 +343,13 @@ ErrorCode ImageProcess::convert(const uint8_t* source, int iw, int ih, int strid
                 // FUNC_PRINT(sta);
                 if (config.wrap == ZERO) {
                     // Clip: Cohen-Sutherland
-                    auto clip    = _computeClip(points, iw, ih, mTransformInvert, xStart, count);
+                    auto clip    = _computeClip(points, iw, ih, slot.invert, xStart, count);
                     sta          = clip.first;
                     end          = clip.second;
                     points[0].fX = sta + xStart;
                     points[0].fY = dy;
 
-                    mTransform.mapPoints(points, 1);
+                    transform.mapPoints(points, 1);
                     if (sta != 0 || end < count) {
                         if (sourceBpp > 0) {
                             if (sta > 0) {
@@ -329,21 +368,144 @@ ErrorCode ImageProcess::convert(const uint8_t* source, int iw, int ih, int strid
                 points[1].fX = (deltaX) / (float)(count);
                 points[1].fY = (deltaY) / (float)(count);
 
-                sampler(srcData, samplerDest, points, sta, end - sta, count, iw, ih, stride);
+                slot.sampler(slot.source, samplerDest, points, sta, end - sta, count, iw, ih, context.stride);
             }
             // Convert format
-            if (needBlit) {
-                blitter(samplerDest, blitDest, count);
+            if (context.needBlit) {
+                context.blitter(samplerDest, blitDest, count);
             }
             // Turn float
-            if (isFloat) {
-                auto normal = mInside->config.normal;
-                auto mean   = mInside->config.mean;
-                blitFloat(blitDest, (float*)dstStart, mean, normal, count);
+            if (context.isFloat) {
+                context.blitFloat(blitDest, (float*)dstStart, config.mean, config.normal, count);
             }
         }
     }
+}
+
+// Images are split among threads, and the rows of them too if there are less images than threads
+static void _convertImages(const ConvertContext& context, const std::vector<ImageSlot>& slots, Backend* cpuBackend,
+                           int threadNumber, uint8_t* sampleCaches, uint8_t* blitCaches) {
+    const int oh        = context.oh;
+    const int imageSize = (int)slots.size();
+    if (threadNumber <= 1 || context.ow * oh * imageSize < MULTI_THREAD_PIXELS) {
+        for (auto& slot : slots) {
+            _convertRows(context, slot, 0, oh, sampleCaches, blitCaches);
+        }
+        return;
+    }
+    const int bands = std::min(UP_DIV(threadNumber, imageSize), oh);
+    const int units = imageSize * bands;
+    threadNumber    = std::min(threadNumber, units);
+    auto backend    = [cpuBackend]() { return cpuBackend; };
+    cpuBackend->onExecuteBegin();
+    MNN_CONCURRENCY_BEGIN(tId, threadNumber) {
+        for (int u = (int)tId; u < units; u += threadNumber) {
+            int band   = u % bands;
+            int yStart = (int)((int64_t)oh * band / bands);
+            int yEnd   = (int)((int64_t)oh * (band + 1) / bands);
+            _convertRows(context, slots[u / bands], yStart, yEnd, sampleCaches + 4 * CACHE_SIZE * tId,
+                         blitCaches + 4 * CACHE_SIZE * tId);
+        }
+    }
+    MNN_CONCURRENCY_END();
+    cpuBackend->onExecuteEnd();
+}
 
+ErrorCode ImageProcess::convert(const uint8_t* source, int iw, int ih, int stride, Tensor* destOrigin) {
+    if (nullptr == source) {
+        MNN_ERROR("null dest or source for image process\n");
+        return INPUT_DATA_ERROR;
+    }
+    return convert(std::vector<const uint8_t*>{source}, iw, ih, stride, std::vector<Matrix>{mTransform}, destOrigin);
+}
+
+ErrorCode ImageProcess::convert(const std::vector<const uint8_t*>& sources, int iw, int ih, int stride,
+                                const std::vector<Matrix>& matrixs, Tensor* destOrigin) {
+    auto dest = destOrigin;
+    if (nullptr == dest || sources.empty()) {
+        MNN_ERROR("null dest or source for image process\n");
+        return INPUT_DATA_ERROR;
+    }
+    if ((!matrixs.empty() && matrixs.size() != sources.size()) || (int)sources.size() > dest->batch()) {
+        MNN_ERROR("Images %d don't match matrixs %d or batch %d of dest\n", (int)sources.size(), (int)matrixs.size(),
+                  dest->batch());
+        return INPUT_DATA_ERROR;
+    }
+    std::shared_ptr<Tensor> tempTensor;
+    auto batch           = dest->batch();
+    auto ow              = dest->width();
+    auto oh              = dest->height();
+    auto bpp             = dest->channel();
+    auto dimensionFormat = TensorUtils::getDescribe(dest)->dimensionFormat;
+    auto tensorBn = TensorUtils::getDescribe(dest)->backend;
+    auto bnType = MNN_FORWARD_CPU;
+    if(tensorBn){
+        bnType = tensorBn->type();
+    }
+    if (bnType != MNN_FORWARD_CPU) {
+        tempTensor.reset(Tensor::create({batch, bpp, oh, ow}, dest->getType(), nullptr, Tensor::CAFFE_C4),[destOrigin] (void* p) {
+            auto hostTensor = (Tensor*)p;
+            destOrigin->copyFromHostTensor(hostTensor);
+            delete hostTensor;
+        });
+        dest = tempTensor.get();
+    }
+    else if (MNN_DATA_FORMAT_NCHW == dimensionFormat) {
+        tempTensor.reset(Tensor::create(dest->shape(), dest->getType(), nullptr, Tensor::CAFFE_C4), [destOrigin](void* p) {
+            auto hostTensor = (Tensor*)p;
+            CPUTensorConverter::convert(hostTensor, destOrigin);
+            delete hostTensor;
+        });
+        dest = tempTensor.get();
+    }
+    dimensionFormat = TensorUtils::getDescribe(dest)->dimensionFormat;
+    // The images are written into the slots of batch, the first 4 channels for NC4HW4
+    int imageSize = ow * oh * bpp;
+    if (dimensionFormat == MNN_DATA_FORMAT_NC4HW4) {
+        imageSize = ow * oh * ALIGN_UP4(bpp);
+        bpp       = 4;
+    }
+    auto type = dest->getType();
+    ConvertContext context;
+    auto code = _prepareContext(context, mInside->config, iw, ih, stride, ow, oh, bpp, type);
+    if (NO_ERROR != code) {
+        return code;
+    }
+    std::vector<ImageSlot> slots(sources.size());
+    for (int i = 0; i < slots.size(); ++i) {
+        if (nullptr == sources[i]) {
+            MNN_ERROR("null source of image %d for image process\n", i);
+            return INPUT_DATA_ERROR;
+        }
+        slots[i].source = sources[i];
+        slots[i].dest   = dest->host<uint8_t>() + (size_t)i * imageSize * type.bytes();
+        code            = _prepareSlot(slots[i], context, matrixs.empty() ? mTransform : matrixs[i]);
+        if (NO_ERROR != code) {
+            return code;
+        }
+    }
+    _convertImages(context, slots, mInside->backend.get(), mInside->threadNumber, mInside->cacheBuffer.get(),
+                   mInside->cacheBufferRGBA.get());
+    return NO_ERROR;
+}
+
+ErrorCode ImageProcess::convert(const uint8_t* source, int iw, int ih, int stride, void* dest, int ow, int oh,
+                                int outputBpp, int outputStride, halide_type_t type) {
+    // AUTOTIME;
+    ConvertContext context;
+    auto code = _prepareContext(context, mInside->config, iw, ih, stride, ow, oh, outputBpp, type);
+    if (NO_ERROR != code) {
+        return code;
+    }
+    std::vector<ImageSlot> slots(1);
+    slots[0].source = source;
+    slots[0].dest   = (uint8_t*)dest;
+    code            = _prepareSlot(slots[0], context, mTransform);
+    if (NO_ERROR != code) {
+        return code;
+    }
+    _convertImages(context, slots, mInside->backend.get(), mInside->threadNumber, mInside->cacheBuffer.get(),
+                   mInside->cacheBufferRGBA.get());
     return NO_ERROR;
 }
 
@@ -12,6 +12,13 @@
 #ifdef MNN_USE_NEON
 #include <arm_neon.h>
 #endif
+#ifdef MNN_USE_SSE
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
 extern "C" {
 void MNNSamplerC4BilinearOpt(const unsigned char* source, unsigned char* dest, float* points, size_t count, size_t xMax,
                              size_t yMax, size_t yStride);
@@ -69,7 +76,7 @@ static void _sampleBilinearCommon(const unsigned char* source, unsigned char* de
 
 static void MNNSamplerC4Bilinear(const unsigned char* source, unsigned char* dest, Point* points, size_t sta,
                                  size_t count, size_t capacity, size_t iw, size_t ih, size_t yStride) {
-#ifdef MNN_USE_NEON
+#if defined(MNN_USE_NEON) || defined(MNN_USE_SSE)
     MNNSamplerC4BilinearOpt(source, dest + 4 * sta, reinterpret_cast<float*>(points), count, iw - 1, ih - 1, yStride);
 #else
     _sampleBilinearCommon(source, dest + 4 * sta, points, count, iw, ih, yStride, 4);
@@ -81,7 +88,7 @@ static void MNNSamplerC3Bilinear(const unsigned char* source, unsigned char* des
 }
 static void MNNSamplerC1Bilinear(const unsigned char* source, unsigned char* dest, Point* points, size_t sta,
                                  size_t count, size_t capacity, size_t iw, size_t ih, size_t yStride) {
-#ifdef MNN_USE_NEON
+#if defined(MNN_USE_NEON) || defined(MNN_USE_SSE)
     MNNSamplerC1BilinearOpt(source, dest + sta, reinterpret_cast<float*>(points), count, iw - 1, ih - 1, yStride);
 #else
     _sampleBilinearCommon(source, dest + sta, points, count, iw, ih, yStride, 1);
@@ -112,7 +119,7 @@ static void MNNSamplerNearest(const unsigned char* source, unsigned char* dest,
 
 static void MNNSamplerC4Nearest(const unsigned char* source, unsigned char* dest, Point* points, size_t sta,
                                 size_t count, size_t capacity, size_t iw, size_t ih, size_t yStride) {
-#ifdef MNN_USE_NEON
+#if defined(MNN_USE_NEON) || defined(MNN_USE_SSE)
     MNNSamplerC4NearestOpt(source, dest + 4 * sta, (float*)points, count, iw - 1, ih - 1, yStride);
 #else
     MNNSamplerNearest(source, dest, points, sta, count, iw, ih, yStride, 4);
@@ -121,7 +128,7 @@ static void MNNSamplerC4Nearest(const unsigned char* source, unsigned char* dest
 
 static void MNNSamplerC1Nearest(const unsigned char* source, unsigned char* dest, Point* points, size_t sta,
                                 size_t count, size_t capacity, size_t iw, size_t ih, size_t yStride) {
-#ifdef MNN_USE_NEON
+#if defined(MNN_USE_NEON) || defined(MNN_USE_SSE)
     MNNSamplerC1NearestOpt(source, dest + sta, (float*)points, count, iw - 1, ih - 1, yStride);
 #else
     MNNSamplerNearest(source, dest, points, sta, count, iw, ih, yStride, 1);
@@ -276,6 +283,13 @@ static void _swapUV(const unsigned char* source, unsigned char* dest, size_t cou
         src.val[1] = temp;
         vst2q_u8(dest + i * 32, src);
     }
+#elif defined(MNN_USE_SSE)
+    int countC2C8 = (int)countC2 / 8;
+    sta = countC2C8 * 8;
+    for (int i=0; i<countC2C8; ++i) {
+        auto src = _mm_loadu_si128((const __m128i*)(source + i * 16));
+        _mm_storeu_si128((__m128i*)(dest + i * 16), _mm_or_si128(_mm_slli_epi16(src, 8), _mm_srli_epi16(src, 8)));
+    }
 #endif
     for (int i=sta; i < countC2; ++i) {
         auto temp = source[2*i];
@@ -50,6 +50,14 @@ struct Vec4 {
         dst.value = vminq_f32(v1.value, v2.value);
         return dst;
     }
+    static void transpose4(Vec4& v0, Vec4& v1, Vec4& v2, Vec4& v3) {
+        auto t0  = vtrnq_f32(v0.value, v1.value);
+        auto t1  = vtrnq_f32(v2.value, v3.value);
+        v0.value = vcombine_f32(vget_low_f32(t0.val[0]), vget_low_f32(t1.val[0]));
+        v1.value = vcombine_f32(vget_low_f32(t0.val[1]), vget_low_f32(t1.val[1]));
+        v2.value = vcombine_f32(vget_high_f32(t0.val[0]), vget_high_f32(t1.val[0]));
+        v3.value = vcombine_f32(vget_high_f32(t0.val[1]), vget_high_f32(t1.val[1]));
+    }
     Vec4 operator+(const Vec4& lr) {
         Vec4 dst;
         dst.value = value + lr.value;
@@ -70,6 +78,22 @@ struct Vec4 {
         dst.value = value * lr.value;
         return dst;
     }
+    Vec4 operator/(const Vec4& lr) {
+        Vec4 dst;
+#ifdef __aarch64__
+        dst.value = vdivq_f32(value, lr.value);
+#else
+        // No exact division on armv7, the reciprocal estimate would change the result
+        float a[4], b[4];
+        vst1q_f32(a, value);
+        vst1q_f32(b, lr.value);
+        for (int i = 0; i < 4; ++i) {
+            a[i] = a[i] / b[i];
+        }
+        dst.value = vld1q_f32(a);
+#endif
+        return dst;
+    }
     Vec4& operator=(const Vec4& lr) {
         value = lr.value;
         return *this;
@@ -103,6 +127,11 @@ struct Vec4 {
         dst.value = _mm_mul_ps(value, lr.value);
         return dst;
     }
+    Vec4 operator/(const Vec4& lr) {
+        Vec4 dst;
+        dst.value = _mm_div_ps(value, lr.value);
+        return dst;
+    }
     Vec4 operator*(float lr) {
         Vec4 dst;
         dst.value = _mm_mul_ps(value, _mm_set1_ps(lr));
@@ -158,6 +187,9 @@ struct Vec4 {
         dst.value = _mm_min_ps(v1.value, v2.value);
         return dst;
     }
+    static void transpose4(Vec4& v0, Vec4& v1, Vec4& v2, Vec4& v3) {
+        _MM_TRANSPOSE4_PS(v0.value, v1.value, v2.value, v3.value);
+    }
 };
 #else
 struct Vec4 {
@@ -183,6 +215,13 @@ struct Vec4 {
         }
         return dst;
     }
+    Vec4 operator/(const Vec4& lr) {
+        Vec4 dst;
+        for (int i = 0; i < 4; ++i) {
+            dst.value[i] = value[i] / lr.value[i];
+        }
+        return dst;
+    }
     Vec4 operator*(float lr) {
         Vec4 dst;
         for (int i = 0; i < 4; ++i) {
@@ -246,6 +285,14 @@ struct Vec4 {
         }
         return dst;
     }
+    static void transpose4(Vec4& v0, Vec4& v1, Vec4& v2, Vec4& v3) {
+        std::swap(v0.value[1], v1.value[0]);
+        std::swap(v0.value[2], v2.value[0]);
+        std::swap(v0.value[3], v3.value[0]);
+        std::swap(v1.value[2], v2.value[1]);
+        std::swap(v1.value[3], v3.value[1]);
+        std::swap(v2.value[3], v3.value[2]);
+    }
 };
 #endif
 } // namespace Math
@@ -6,6 +6,7 @@
 //  Copyright © 2018, Alibaba Group Holding Limited
 //
 
+#include <algorithm>
 #include "core/Macro.h"
 #include "core/SizeComputer.hpp"
 #include "core/TensorUtils.hpp"
@@ -19,34 +20,46 @@ public:
         MNN_ASSERT(2 == inputs.size());
         MNN_ASSERT(1 == outputs.size());
 
-        auto param = op->main_as_BatchMatMulParam();
+        auto param  = op->main_as_BatchMatMulParam();
         auto input0 = inputs[0];
         auto input1 = inputs[1];
-        MNN_ASSERT(input0->dimensions() == input1->dimensions());
+        auto i0Dim  = input0->dimensions();
+        auto i1Dim  = input1->dimensions();
+        if (i0Dim < 2 || i1Dim < 2) {
+            return false;
+        }
 
-        const int dimensions = input0->dimensions();
-        MNN_ASSERT(dimensions >= 2);
+        // Batch dimensions broadcast like numpy, aligned from the last one
+        const int dimensions = std::max(i0Dim, i1Dim);
+        auto output          = outputs[0];
+        output->buffer().type       = input0->buffer().type;
+        output->buffer().dimensions = dimensions;
         for (int i = 0; i < dimensions - 2; ++i) {
-            MNN_ASSERT(input0->length(i) == input1->length(i));
+            auto a  = i - (dimensions - i0Dim);
+            auto b  = i - (dimensions - i1Dim);
+            auto l0 = a >= 0 ? input0->length(a) : 1;
+            auto l1 = b >= 0 ? input1->length(b) : 1;
+            if (l0 != l1 && l0 != 1 && l1 != 1) {
+                MNN_PRINT("Don't support broadcast for BatchMatMulOp, i0=%d, i1=%d\n", l0, l1);
+                return false;
+            }
+            output->setLength(i, l0 == 1 ? l1 : l0);
         }
-
-        auto output = outputs[0];
-        output->buffer().type = input0->buffer().type;
-        TensorUtils::copyShape(input0, output, true);
-        auto k0 = input0->length(dimensions - 1);
-        auto k1 = input1->length(dimensions - 2);
+        auto k0 = input0->length(i0Dim - 1);
+        auto k1 = input1->length(i1Dim - 2);
         if (param->adjX()) {
-            k0 = input0->length(dimensions - 2);
-            output->setLength(dimensions - 2, input0->length(dimensions - 1));
+            k0 = input0->length(i0Dim - 2);
+            output->setLength(dimensions - 2, input0->length(i0Dim - 1));
         } else {
-            output->setLength(dimensions - 2, input0->length(dimensions - 2));
+            output->setLength(dimensions - 2, input0->length(i0Dim - 2));
         }
         if (param->adjY()) {
-            k1 = input1->length(dimensions - 1);
-            output->setLength(dimensions - 1, input1->length(dimensions - 2));
+            k1 = input1->length(i1Dim - 1);
+            output->setLength(dimensions - 1, input1->length(i1Dim - 2));
         } else {
-            output->setLength(dimensions - 1, input1->length(dimensions - 1));
+            output->setLength(dimensions - 1, input1->length(i1Dim - 1));
         }
+        TensorUtils::getDescribe(output)->dimensionFormat = TensorUtils::getDescribe(input0)->dimensionFormat;
         if (k0 != k1) {
             return false;
         }
@@ -25,7 +25,9 @@ public:
         for (int i = 0; i < output->buffer().dimensions; i++) {
             output->buffer().dim[i].extent = parameter->dims()->Get(i);
         }
-        if (parameter->dataType() == DataType_DT_HALF) {
+        if (parameter->dataType() == DataType_DT_HALF && TensorUtils::getDescribe(output)->keepHalf) {
+            output->buffer().type = halide_type_t(halide_type_float, 16);
+        } else if (parameter->dataType() == DataType_DT_HALF) {
             output->setType(DataType_DT_FLOAT);
         } else {
             output->setType(parameter->dataType());
@@ -15,7 +15,7 @@ class GatherComputer : public SizeComputer {
 public:
     virtual bool onComputeSize(const MNN::Op* op, const std::vector<Tensor*>& inputs,
                                const std::vector<Tensor*>& outputs) const override {
-        MNN_ASSERT(2 == inputs.size());
+        MNN_ASSERT(2 == inputs.size() || 3 == inputs.size());
         MNN_ASSERT(1 == outputs.size());
 
         auto embedding = inputs[0];
@@ -33,6 +33,10 @@ public:
         }
 
         output->buffer().type = embedding->buffer().type;
+        // float16 embedding and int8 one with scales are dequantized to float
+        if (embedding->getType() == halide_type_t(halide_type_float, 16) || 3 == inputs.size()) {
+            output->buffer().type = halide_type_of<float>();
+        }
         TensorUtils::getDescribe(outputs[0])->dimensionFormat = TensorUtils::getDescribe(inputs[0])->dimensionFormat;
 
         return true;
@@ -18,7 +18,7 @@ class GatherV2Computer : public SizeComputer {
         auto indices = inputs[1];
         MNN_ASSERT(indices->getType().code == halide_type_int);
         int axis = 0;
-        if (inputs.size() == 3) {
+        if (inputs.size() >= 3) {
             auto axis_tensor = inputs[2];
             axis = axis_tensor->host<int32_t>()[0];
         }
@@ -49,6 +49,10 @@ class GatherV2Computer : public SizeComputer {
 
         outputs[0]->buffer().dimensions = (int)result_shape.size();
         outputs[0]->buffer().type       = params->buffer().type;
+        // float16 params and int8 ones with scales are dequantized to float
+        if (params->getType() == halide_type_t(halide_type_float, 16) || inputs.size() == 4) {
+            outputs[0]->buffer().type = halide_type_of<float>();
+        }
         for (int i = 0; i < result_shape.size(); i++) {
             outputs[0]->buffer().dim[i].extent = result_shape.at(i);
         }
@@ -0,0 +1,184 @@
+//
+//  MathFunctionsTest.cpp
+//  MNNTests
+//
+//  Created by MNN on 2020/05/05.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <math.h>
+#include <string.h>
+#include <vector>
+#include "MNNTestSuite.h"
+#include "backend/cpu/compute/CommonOptFunction.h"
+#include "core/Macro.h"
+#ifdef MNN_USE_SSE
+#include "backend/cpu/x86_x64/avx/FunctionSummary.hpp"
+#include "backend/cpu/x86_x64/cpu_id.h"
+#include "backend/cpu/x86_x64/sse/FunctionSummary.hpp"
+#ifdef MNN_AVX512
+#include "backend/cpu/x86_x64/avx512/FunctionSummary.hpp"
+#endif
+#endif
+
+typedef void (*MATH_FUNCTION)(float* dst, const float* src, size_t size);
+
+struct MathFunctionSet {
+    const char* name;
+    MATH_FUNCTION exp;
+    MATH_FUNCTION expNeg;
+    MATH_FUNCTION log;
+    MATH_FUNCTION tanh;
+    MATH_FUNCTION sigmoid;
+    MATH_FUNCTION erf;
+    MATH_FUNCTION sqrt;
+    MATH_FUNCTION rsqrt;
+    MATH_FUNCTION sin;
+    MATH_FUNCTION cos;
+    MATH_FUNCTION swish;
+    MATH_FUNCTION hardSwish;
+    MATH_FUNCTION gelu;
+};
+
+static double _expNeg(double x) {
+    return ::exp(-x);
+}
+static double _sigmoid(double x) {
+    return 1.0 / (1.0 + ::exp(-x));
+}
+static double _rsqrt(double x) {
+    return 1.0 / ::sqrt(x);
+}
+static double _swish(double x) {
+    return x / (1.0 + ::exp(-x));
+}
+static double _hardSwish(double x) {
+    return x * fmin(6.0, fmax(0.0, x + 3.0)) / 6.0;
+}
+static double _gelu(double x) {
+    return x * (1.0 + ::erf(x / ::sqrt(2.0))) * 0.5;
+}
+
+class MathFunctionsTest : public MNNTestCase {
+public:
+    virtual ~MathFunctionsTest() = default;
+    // Max error of func in [low, high] must be less than maxUlp ulp or maxAbs, the input is log uniform if logScale
+    static bool testRange(const char* name, MATH_FUNCTION func, double (*reference)(double), float low, float high,
+                          bool logScale, float maxUlp, float maxAbs) {
+        // Odd size to cover the remain of every vector width
+        const int size = 20011;
+        std::vector<float> src(size), dst(size);
+        for (int i = 0; i < size; ++i) {
+            float t = (float)i / (float)(size - 1);
+            if (logScale) {
+                src[i] = expf(logf(low) + (logf(high) - logf(low)) * t);
+            } else {
+                src[i] = low + (high - low) * t;
+            }
+        }
+        func(dst.data(), src.data(), size);
+        for (int i = 0; i < size; ++i) {
+            double expect = reference((double)src[i]);
+            float expectF = (float)expect;
+            int exponent  = 0;
+            frexpf(expectF, &exponent);
+            // Built with fast math, so the ulp is computed by the exponent instead of nextafter
+            double ulp   = ldexp(1.0, ALIMAX(exponent - 24, -149));
+            double error = fabs((double)dst[i] - expect);
+            if (error > maxAbs && error > maxUlp * ulp) {
+                MNN_ERROR("%s error at %.9g: %.9g - %.9g, %f ulp\n", name, src[i], dst[i], expect, error / ulp);
+                return false;
+            }
+        }
+        return true;
+    }
+    static bool _isNan(float x) {
+        uint32_t bits;
+        ::memcpy(&bits, &x, sizeof(bits));
+        return (bits & 0x7fffffff) > 0x7f800000;
+    }
+    // Special input must give the exact result, nan is compared as nan. Compare the bits as isnan is unreliable with fast math
+    static bool testSpecial(const char* name, MATH_FUNCTION func, const std::vector<float>& src,
+                            const std::vector<float>& expect) {
+        std::vector<float> dst(src.size());
+        func(dst.data(), src.data(), src.size());
+        for (int i = 0; i < src.size(); ++i) {
+            bool same = _isNan(expect[i]) ? _isNan(dst[i]) : 0 == ::memcmp(&expect[i], &dst[i], sizeof(float));
+            if (!same) {
+                MNN_ERROR("%s error at %g: %g - %g\n", name, src[i], dst[i], expect[i]);
+                return false;
+            }
+        }
+        return true;
+    }
+    static bool testSet(const MathFunctionSet& f) {
+        MNN_PRINT("Test math functions of %s\n", f.name);
+        const float inf = INFINITY;
+        const float nan = NAN;
+        bool res        = true;
+        res = res && testRange("exp", f.exp, ::exp, -87.0f, 88.0f, false, 1.0f, 0.0f);
+        res = res && testRange("exp underflow", f.exp, ::exp, -103.0f, -87.5f, false, 1.0f, 1e-45f);
+        res = res && testSpecial("exp", f.exp, {inf, -inf, nan, 89.0f, -110.0f, 0.0f},
+                                 {inf, 0.0f, nan, inf, 0.0f, 1.0f});
+        res = res && testRange("exp(-x)", f.expNeg, _expNeg, -88.0f, 87.0f, false, 1.0f, 0.0f);
+        res = res && testRange("log", f.log, ::log, 1e-44f, 3e38f, true, 1.0f, 0.0f);
+        res = res && testRange("log near 1", f.log, ::log, 0.5f, 2.0f, false, 1.0f, 0.0f);
+        res = res && testSpecial("log", f.log, {0.0f, -0.0f, -1.0f, inf, -inf, nan, 1.0f},
+                                 {-inf, -inf, nan, inf, nan, nan, 0.0f});
+        res = res && testRange("tanh", f.tanh, ::tanh, -10.0f, 10.0f, false, 2.0f, 0.0f);
+        res = res && testRange("tanh small", f.tanh, ::tanh, 1e-30f, 1.0f, true, 2.0f, 0.0f);
+        res = res && testSpecial("tanh", f.tanh, {inf, -inf, nan, 0.0f}, {1.0f, -1.0f, nan, 0.0f});
+        res = res && testRange("sigmoid", f.sigmoid, _sigmoid, -85.0f, 20.0f, false, 2.0f, 0.0f);
+        res = res && testSpecial("sigmoid", f.sigmoid, {inf, -inf, nan, 0.0f}, {1.0f, 0.0f, nan, 0.5f});
+        res = res && testRange("erf", f.erf, ::erf, -5.0f, 5.0f, false, 3.0f, 1e-7f);
+        res = res && testRange("erf small", f.erf, ::erf, 1e-30f, 1.0f, true, 3.0f, 0.0f);
+        res = res && testSpecial("erf", f.erf, {inf, -inf, nan, 0.0f}, {1.0f, -1.0f, nan, 0.0f});
+        res = res && testRange("sqrt", f.sqrt, ::sqrt, 1e-30f, 1e30f, true, 0.5f, 0.0f);
+        res = res && testRange("rsqrt", f.rsqrt, _rsqrt, 1e-30f, 1e30f, true, 2.0f, 0.0f);
+        res = res && testRange("sin", f.sin, ::sin, -8192.0f, 8192.0f, false, 2.0f, 6e-8f);
+        res = res && testRange("sin small", f.sin, ::sin, 1e-30f, 4.0f, true, 2.0f, 0.0f);
+        res = res && testRange("sin large", f.sin, ::sin, 8000.0f, 1e6f, false, 2.0f, 6e-8f);
+        res = res && testSpecial("sin", f.sin, {inf, nan, 0.0f}, {nan, nan, 0.0f});
+        res = res && testRange("cos", f.cos, ::cos, -8192.0f, 8192.0f, false, 2.0f, 6e-8f);
+        res = res && testRange("cos large", f.cos, ::cos, -1e6f, -8000.0f, false, 2.0f, 6e-8f);
+        res = res && testSpecial("cos", f.cos, {inf, nan, 0.0f}, {nan, nan, 1.0f});
+        res = res && testRange("swish", f.swish, _swish, -20.0f, 20.0f, false, 3.0f, 0.0f);
+        res = res && testRange("hardSwish", f.hardSwish, _hardSwish, -6.0f, 6.0f, false, 2.0f, 0.0f);
+        res = res && testRange("gelu", f.gelu, _gelu, -5.0f, 5.0f, false, 4.0f, 1e-7f);
+        return res;
+    }
+    virtual bool run() {
+        MathFunctionSet common = {"MNN",          MNNMathExp,   MNNExp,      MNNMathLog,
+                                  MNNTanh,        MNNMathSigmoid, MNNMathErf, MNNMathSqrt,
+                                  MNNMathRsqrt,   MNNMathSin,   MNNMathCos,
+                                  MNNMathSwish,   MNNMathHardSwish, MNNMathGelu};
+        bool res               = testSet(common);
+#ifdef MNN_USE_SSE
+        MathFunctionSet sse = {"SSE",          _SSE_MNNMathExp,    _SSE_MNNExp,     _SSE_MNNMathLog,
+                               _SSE_MNNTanh,   _SSE_MNNMathSigmoid, _SSE_MNNMathErf, _SSE_MNNMathSqrt,
+                               _SSE_MNNMathRsqrt, _SSE_MNNMathSin, _SSE_MNNMathCos,
+                               _SSE_MNNMathSwish, _SSE_MNNMathHardSwish, _SSE_MNNMathGelu};
+        res                 = res && testSet(sse);
+        auto cpuFlags       = libyuv::InitCpuFlags();
+        if ((cpuFlags & libyuv::kCpuHasAVX2) && (cpuFlags & libyuv::kCpuHasFMA3)) {
+            MathFunctionSet avx = {"AVX2",         _AVX_MNNMathExp,    _AVX_MNNExp,     _AVX_MNNMathLog,
+                                   _AVX_MNNTanh,   _AVX_MNNMathSigmoid, _AVX_MNNMathErf, _AVX_MNNMathSqrt,
+                                   _AVX_MNNMathRsqrt, _AVX_MNNMathSin, _AVX_MNNMathCos,
+                                   _AVX_MNNMathSwish, _AVX_MNNMathHardSwish, _AVX_MNNMathGelu};
+            res                 = res && testSet(avx);
+        }
+#ifdef MNN_AVX512
+        if (cpuFlags & libyuv::kCpuHasAVX512F) {
+            MathFunctionSet avx512 = {"AVX512",          _AVX512_MNNMathExp,    _AVX512_MNNExp,
+                                      _AVX512_MNNMathLog, _AVX512_MNNTanh,      _AVX512_MNNMathSigmoid,
+                                      _AVX512_MNNMathErf, _AVX512_MNNMathSqrt,  _AVX512_MNNMathRsqrt,
+                                      _AVX512_MNNMathSin, _AVX512_MNNMathCos,
+                                      _AVX512_MNNMathSwish, _AVX512_MNNMathHardSwish, _AVX512_MNNMathGelu};
+            res                    = res && testSet(avx512);
+        }
+#endif
+#endif
+        return res;
+    }
+};
+MNNTestSuiteRegister(MathFunctionsTest, "backend/cpu/compute/math_functions");
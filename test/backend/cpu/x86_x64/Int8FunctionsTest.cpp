@@ -0,0 +1,141 @@
+//
+//  Int8FunctionsTest.cpp
+//  MNNTests
+//
+//  Created by MNN on 2020/05/03.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#ifdef MNN_USE_SSE
+#include <math.h>
+#include <algorithm>
+#include <vector>
+#include "MNNTestSuite.h"
+#include "backend/cpu/compute/Int8FunctionsOpt.h"
+#include "backend/cpu/x86_x64/avx/FunctionSummary.hpp"
+#include "backend/cpu/x86_x64/cpu_id.h"
+#include "backend/cpu/x86_x64/sse/FunctionSummary.hpp"
+#ifdef MNN_AVX512_VNNI
+#include "backend/cpu/x86_x64/avx512/FunctionSummary.hpp"
+#endif
+
+typedef void (*INT8LINE_KERNEL)(int8_t* dst, const int8_t* src, const int8_t* weight, const int32_t* bias_z,
+                                size_t width, size_t src_w_step, size_t fw, size_t fh, size_t dilateX_step,
+                                size_t dilateY_step, const float* scale_z, size_t mode);
+
+static int8_t _int32ToInt8(int data, int bias, float scale) {
+    float value = (float)(data + bias) * scale;
+    value       = std::max(value, -127.0f);
+    value       = std::min(value, 127.0f);
+    return static_cast<int8_t>(roundf(value));
+}
+
+// Quantized values are in [-127, 127]
+static void _fill(std::vector<int8_t>& data, int seed) {
+    for (int i = 0; i < data.size(); ++i) {
+        data[i] = (int8_t)((i * 7 + seed * 13 + (i * i) % 31) % 255 - 127);
+    }
+}
+
+class Int8FunctionsTest : public MNNTestCase {
+public:
+    virtual ~Int8FunctionsTest() = default;
+    static bool testGemm(INT8GEMM_KERNEL kernel, const char* name) {
+        for (int srcDepthQuad = 1; srcDepthQuad <= 9; srcDepthQuad += 2) {
+            for (int dstDepthQuad = 1; dstDepthQuad <= 5; dstDepthQuad += 2) {
+                const int unit = GEMM_INT8_UNIT * GEMM_INT8_SRC_UNIT;
+                std::vector<int8_t> src(srcDepthQuad * GEMM_INT8_DST_XUNIT * GEMM_INT8_SRC_UNIT);
+                std::vector<int8_t> weight(dstDepthQuad * srcDepthQuad * unit);
+                std::vector<int32_t> bias(dstDepthQuad * GEMM_INT8_UNIT);
+                std::vector<float> scale(dstDepthQuad * GEMM_INT8_UNIT);
+                _fill(src, srcDepthQuad);
+                _fill(weight, dstDepthQuad);
+                for (int i = 0; i < bias.size(); ++i) {
+                    bias[i]  = (i * 97) % 2001 - 1000;
+                    scale[i] = (float)(i % 7 + 1) / 2048.0f;
+                }
+                const int dstStep = GEMM_INT8_DST_XUNIT * GEMM_INT8_UNIT + 4;
+                std::vector<int8_t> dst(dstDepthQuad * dstStep, 0);
+                kernel(dst.data(), src.data(), weight.data(), bias.data(), scale.data(), srcDepthQuad, dstStep,
+                       dstDepthQuad);
+                for (int dz = 0; dz < dstDepthQuad; ++dz) {
+                    for (int w = 0; w < GEMM_INT8_DST_XUNIT; ++w) {
+                        for (int j = 0; j < GEMM_INT8_UNIT; ++j) {
+                            int sum = 0;
+                            for (int sz = 0; sz < srcDepthQuad; ++sz) {
+                                auto srcZ    = src.data() + (sz * GEMM_INT8_DST_XUNIT + w) * GEMM_INT8_SRC_UNIT;
+                                auto weightZ = weight.data() + (dz * srcDepthQuad + sz) * unit + j * GEMM_INT8_SRC_UNIT;
+                                for (int i = 0; i < GEMM_INT8_SRC_UNIT; ++i) {
+                                    sum += (int)srcZ[i] * (int)weightZ[i];
+                                }
+                            }
+                            auto expect = _int32ToInt8(sum, bias[dz * 4 + j], scale[dz * 4 + j]);
+                            auto result = dst[dz * dstStep + w * GEMM_INT8_UNIT + j];
+                            if (expect != result) {
+                                MNN_ERROR("%s error for %d x %d: %d - %d\n", name, srcDepthQuad, dstDepthQuad, result,
+                                          expect);
+                                return false;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        return true;
+    }
+    static bool testLineDepthwise(INT8LINE_KERNEL kernel, const char* name) {
+        const int kernelSize = 3;
+        for (int stride = 1; stride <= 2; ++stride) {
+            for (int dilate = 1; dilate <= 2; ++dilate) {
+                for (int width = 1; width <= 37; width += 3) {
+                    const int srcWidth = width * stride + kernelSize * dilate;
+                    std::vector<int8_t> src(srcWidth * kernelSize * dilate * 4);
+                    std::vector<int8_t> weight(kernelSize * kernelSize * 4);
+                    std::vector<int32_t> bias = {-300, 0, 17, 1000};
+                    std::vector<float> scale  = {1.0f / 64.0f, 1.0f / 300.0f, 1.0f / 1000.0f, 1.0f / 512.0f};
+                    _fill(src, width);
+                    _fill(weight, stride + dilate);
+                    std::vector<int8_t> dst(width * 4);
+                    kernel(dst.data(), src.data(), weight.data(), bias.data(), width, stride * 4, kernelSize,
+                           kernelSize, dilate * 4, dilate * srcWidth * 4, scale.data(), 0);
+                    for (int x = 0; x < width; ++x) {
+                        for (int c = 0; c < 4; ++c) {
+                            int sum = 0;
+                            for (int fy = 0; fy < kernelSize; ++fy) {
+                                for (int fx = 0; fx < kernelSize; ++fx) {
+                                    sum += (int)src[((fy * dilate) * srcWidth + x * stride + fx * dilate) * 4 + c] *
+                                           (int)weight[(fy * kernelSize + fx) * 4 + c];
+                                }
+                            }
+                            auto expect = _int32ToInt8(sum, bias[c], scale[c]);
+                            if (expect != dst[x * 4 + c]) {
+                                MNN_ERROR("%s error for width %d, stride %d, dilate %d: %d - %d\n", name, width,
+                                          stride, dilate, dst[x * 4 + c], expect);
+                                return false;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        return true;
+    }
+    virtual bool run() {
+        bool res = testGemm(_SSE_MNNGemmInt8AddBiasScale_16x4_Unit, "SSE gemm");
+        res      = res && testLineDepthwise(_SSE_MNNLineDepthWiseInt8AddBiasScaleUnit, "SSE depthwise");
+        auto cpuFlags = libyuv::InitCpuFlags();
+        if (cpuFlags & libyuv::kCpuHasAVX2) {
+            res = res && testGemm(_AVX_MNNGemmInt8AddBiasScale_16x4_Unit, "AVX2 gemm");
+            res = res && testLineDepthwise(_AVX_MNNLineDepthWiseInt8AddBiasScaleUnit, "AVX2 depthwise");
+        }
+#ifdef MNN_AVX512_VNNI
+        if (cpuFlags & libyuv::kCpuHasAVX512VNNI) {
+            res = res && testGemm(_AVX512_MNNGemmInt8AddBiasScale_16x4_Unit, "AVX512 VNNI gemm");
+            res = res && testLineDepthwise(_AVX512_MNNLineDepthWiseInt8AddBiasScaleUnit, "AVX512 VNNI depthwise");
+        }
+#endif
+        return res;
+    }
+};
+MNNTestSuiteRegister(Int8FunctionsTest, "backend/cpu/x86_x64/int8");
+#endif
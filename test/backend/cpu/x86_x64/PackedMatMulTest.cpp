@@ -0,0 +1,134 @@
+//
+//  PackedMatMulTest.cpp
+//  MNNTests
+//
+//  Created by MNN on 2020/05/04.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#ifdef MNN_USE_SSE
+#include <math.h>
+#include <algorithm>
+#include <vector>
+#include "MNNTestSuite.h"
+#include "backend/cpu/x86_x64/avx/FunctionSummary.hpp"
+#include "backend/cpu/x86_x64/cpu_id.h"
+#include "backend/cpu/x86_x64/sse/FunctionSummary.hpp"
+#include "core/Macro.h"
+#ifdef MNN_AVX512
+#include "backend/cpu/x86_x64/avx512/FunctionSummary.hpp"
+#endif
+
+struct PackedMatMulKernel {
+    const char* name;
+    int eP;
+    int hP;
+    void (*packA)(float* dest, const float* source, size_t e, size_t l, size_t eReal);
+    void (*packB)(float* dest, const float* source, size_t h, size_t l, bool transpose);
+    void (*matmul)(float* C, const float* A, const float* B, const size_t* parameter, float* cache,
+                   const float* postParameters, const float* bias);
+    void (*matmulRemain)(float* C, const float* A, const float* B, size_t eSize, const size_t* parameter, float* cache,
+                         const float* postParameters, const float* bias);
+};
+
+class PackedMatMulTest : public MNNTestCase {
+public:
+    virtual ~PackedMatMulTest() = default;
+    // A is C4 packed [l / 4, e, 4], B is [l, h] or [h, l] if transpose, C is C4 packed [h / 4, e, 4]
+    static bool test(const PackedMatMulKernel& kernel, int e, int l, int h, bool transpose, bool post) {
+        auto lC4 = UP_DIV(l, 4);
+        auto hC4 = UP_DIV(h, 4);
+        std::vector<float> A(lC4 * e * 4, 0.0f), B(l * h), bias(hC4 * 4);
+        for (int z = 0; z < l; ++z) {
+            for (int x = 0; x < e; ++x) {
+                A[(z / 4) * e * 4 + x * 4 + z % 4] = (float)((x * 7 + z * 3) % 17 - 8) / 8.0f;
+            }
+        }
+        for (int i = 0; i < B.size(); ++i) {
+            B[i] = (float)((i * 5) % 13 - 6) / 6.0f;
+        }
+        for (int i = 0; i < bias.size(); ++i) {
+            bias[i] = (float)(i % 5 - 2);
+        }
+        std::vector<float> postParameters = {1.0f, 1.0f, -2.0f, 3.0f};
+        std::vector<float> packA(UP_DIV(e, kernel.eP) * kernel.eP * l);
+        std::vector<float> packB(UP_DIV(h, kernel.hP) * kernel.hP * l);
+        // The kernel with unaligned hP need a cache
+        std::vector<float> cache(kernel.eP * kernel.hP * 4 + hC4 * kernel.eP * 4);
+        const int cStride = e * 4 + 4;
+        std::vector<float> C(hC4 * cStride, 0.0f);
+        kernel.packA(packA.data(), A.data(), e, l, e);
+        kernel.packB(packB.data(), B.data(), h, l, transpose);
+        std::vector<size_t> parameters = {e * sizeof(float), (size_t)l, (size_t)h, cStride * sizeof(float), 0, 0};
+        auto postPtr = post ? postParameters.data() : nullptr;
+        auto biasPtr = post ? bias.data() : nullptr;
+        if (e == kernel.eP) {
+            kernel.matmul(C.data(), packA.data(), packB.data(), parameters.data(), cache.data(), postPtr, biasPtr);
+        } else {
+            kernel.matmulRemain(C.data(), packA.data(), packB.data(), e, parameters.data(), cache.data(), postPtr,
+                                biasPtr);
+        }
+        for (int y = 0; y < h; ++y) {
+            for (int x = 0; x < e; ++x) {
+                float expect = 0.0f;
+                for (int z = 0; z < l; ++z) {
+                    auto b = transpose ? B[y * l + z] : B[z * h + y];
+                    expect += A[(z / 4) * e * 4 + x * 4 + z % 4] * b;
+                }
+                if (post) {
+                    expect = std::min(std::max(expect + bias[y], postParameters[2]), postParameters[3]);
+                }
+                auto result = C[(y / 4) * cStride + x * 4 + y % 4];
+                if (fabsf(result - expect) > 1e-4f * (1.0f + fabsf(expect))) {
+                    MNN_ERROR("%s error for e=%d, l=%d, h=%d, transpose=%d, post=%d at (%d, %d): %f - %f\n",
+                              kernel.name, e, l, h, transpose, post, x, y, result, expect);
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+    static bool testKernel(const PackedMatMulKernel& kernel) {
+        std::vector<int> eSizes = {1, 3, 4, 7, 16, 17, 31, 33, 47, kernel.eP};
+        std::vector<int> lSizes = {1, 3, 4, 9, 16, 21};
+        std::vector<int> hSizes = {1, 4, 5, 8, 12, 19, 24};
+        for (auto e : eSizes) {
+            if (e > kernel.eP) {
+                continue;
+            }
+            for (auto l : lSizes) {
+                for (auto h : hSizes) {
+                    for (int i = 0; i < 4; ++i) {
+                        if (!test(kernel, e, l, h, i % 2 == 1, i / 2 == 1)) {
+                            return false;
+                        }
+                    }
+                }
+            }
+        }
+        return true;
+    }
+    virtual bool run() {
+        PackedMatMulKernel sse = {"SSE", 16, 6, _SSE_MNNPackC4ForMatMul_A, _SSE_MNNPackForMatMul_B,
+                                  _SSE_MNNPackedMatMul, _SSE_MNNPackedMatMulRemain};
+        bool res      = testKernel(sse);
+        auto cpuFlags = libyuv::InitCpuFlags();
+        if ((cpuFlags & libyuv::kCpuHasAVX2) && (cpuFlags & libyuv::kCpuHasFMA3)) {
+            PackedMatMulKernel avx = {"AVX2", 16, 6, _SSE_MNNPackC4ForMatMul_A, _SSE_MNNPackForMatMul_B,
+                                      _AVX_MNNPackedMatMulFMA, _AVX_MNNPackedMatMulRemainFMA};
+            res = res && testKernel(avx);
+        }
+#ifdef MNN_AVX512
+        if (cpuFlags & libyuv::kCpuHasAVX512F) {
+            PackedMatMulKernel avx512 = {"AVX512", 0, 0, _AVX512_MNNPackC4ForMatMul_A, _AVX512_MNNPackForMatMul_B,
+                                         _AVX512_MNNPackedMatMul, _AVX512_MNNPackedMatMulRemain};
+            int lP;
+            _AVX512_MNNGetMatMulPackMode(&avx512.eP, &lP, &avx512.hP);
+            res = res && testKernel(avx512);
+        }
+#endif
+        return res;
+    }
+};
+MNNTestSuiteRegister(PackedMatMulTest, "backend/cpu/x86_x64/packed_matmul");
+#endif
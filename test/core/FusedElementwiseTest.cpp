@@ -0,0 +1,111 @@
+//
+//  FusedElementwiseTest.cpp
+//  MNNTests
+//
+//  Created by MNN on 2020/05/12.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <math.h>
+#include <MNN/Interpreter.hpp>
+#include <MNN/expr/ExprCreator.hpp>
+#include "MNNTestSuite.h"
+#include "MNN_generated.h"
+
+using namespace MNN;
+using namespace MNN::Express;
+
+class FusedElementwiseTest : public MNNTestCase {
+public:
+    virtual ~FusedElementwiseTest() = default;
+    static float inputValue(int i) {
+        return (float)(i % 101 - 50) / 8.0f;
+    }
+    // Run the net of y in session, the chain of element-wise ops is fused and the result is compared with expr
+    static bool test(const char* name, VARP x, VARP y) {
+        auto inputPtr = x->writeMap<float>();
+        for (int i = 0; i < x->getInfo()->size; ++i) {
+            inputPtr[i] = inputValue(i);
+        }
+        auto expectPtr = y->readMap<float>();
+        std::vector<float> expect(expectPtr, expectPtr + y->getInfo()->size);
+
+        std::unique_ptr<NetT> net(new NetT);
+        Variable::save({y}, net.get());
+        flatbuffers::FlatBufferBuilder builder(1024);
+        auto len = Net::Pack(builder, net.get());
+        builder.Finish(len);
+        std::shared_ptr<Interpreter> interp(Interpreter::createFromBuffer(builder.GetBufferPointer(), builder.GetSize()));
+        for (int thread : {1, 4}) {
+            ScheduleConfig config;
+            config.numThread = thread;
+            auto session     = interp->createSession(config);
+            interp->setSessionTrace(session, true);
+            interp->resizeSession(session);
+            auto input = interp->getSessionInput(session, nullptr);
+            std::unique_ptr<Tensor> inputHost(Tensor::createHostTensorFromDevice(input, false));
+            for (int i = 0; i < inputHost->elementSize(); ++i) {
+                inputHost->host<float>()[i] = inputValue(i);
+            }
+            input->copyFromHostTensor(inputHost.get());
+            interp->runSession(session);
+            if (interp->getSessionTrace(session).find("\"type\":\"Fused\"") == std::string::npos) {
+                MNN_ERROR("%s isn't fused\n", name);
+                return false;
+            }
+            auto output = interp->getSessionOutput(session, nullptr);
+            std::unique_ptr<Tensor> outputHost(Tensor::createHostTensorFromDevice(output, true));
+            if (outputHost->elementSize() != expect.size()) {
+                MNN_ERROR("%s output size error: %d - %d\n", name, outputHost->elementSize(), (int)expect.size());
+                return false;
+            }
+            for (int i = 0; i < expect.size(); ++i) {
+                auto value = outputHost->host<float>()[i];
+                if (fabsf(value - expect[i]) > 1e-5f + 1e-5f * fabsf(expect[i])) {
+                    MNN_ERROR("%s error at %d with %d threads: %f - %f\n", name, i, thread, value, expect[i]);
+                    return false;
+                }
+            }
+            interp->releaseSession(session);
+        }
+        return true;
+    }
+    virtual bool run() {
+        // Several blocks with remain
+        const std::vector<int> shape = {1, 3, 37, 29};
+        {
+            auto x = _Input(shape, NCHW);
+            if (!test("swish", x, x * _Sigmoid(x))) {
+                return false;
+            }
+        }
+        {
+            auto x = _Input(shape, NCHW);
+            if (!test("hard swish", x, x * _Relu6(x + _Const(3.0f)) / _Const(6.0f))) {
+                return false;
+            }
+        }
+        {
+            auto x = _Input(shape, NCHW);
+            auto y = x * (_Erf(x / _Const(1.41421356f)) + _Const(1.0f)) * _Const(0.5f);
+            if (!test("gelu", x, y)) {
+                return false;
+            }
+        }
+        // Scalar and full operands
+        {
+            auto x = _Input(shape, NCHW);
+            std::vector<float> weight(3 * 37 * 29);
+            for (int i = 0; i < weight.size(); ++i) {
+                weight[i] = (float)(i % 7 - 3) / 4.0f;
+            }
+            auto w = _Const(weight.data(), shape, NCHW);
+            auto y = _Sqrt(_Abs(_Tanh(x * _Const(2.0f) - w)) + _Const(1.0f));
+            if (!test("chain", x, _Maximum(w, y))) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+MNNTestSuiteRegister(FusedElementwiseTest, "core/fused_elementwise");
@@ -0,0 +1,130 @@
+//
+//  MemoryPlannerTest.cpp
+//  MNNTests
+//
+//  Created by MNN on 2020/04/22.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <math.h>
+#include <MNN/Interpreter.hpp>
+#include <MNN/expr/ExprCreator.hpp>
+#include "MNNTestSuite.h"
+#include "MNN_generated.h"
+#include "core/BufferAllocator.hpp"
+#include "core/MemoryPlanner.hpp"
+
+using namespace MNN;
+using namespace MNN::Express;
+
+static MemoryPlanner::Block _block(size_t size, int begin, int end) {
+    MemoryPlanner::Block block;
+    block.size  = size;
+    block.begin = begin;
+    block.end   = end;
+    return block;
+}
+
+class MemoryPlannerTest : public MNNTestCase {
+public:
+    virtual ~MemoryPlannerTest() = default;
+    virtual bool run() {
+        // plan: b0 and b2 don't overlap in time, so they share memory
+        {
+            std::vector<MemoryPlanner::Block> blocks = {_block(100, 0, 2), _block(50, 1, 3), _block(100, 2, 4)};
+            auto peak = MemoryPlanner::plan(blocks);
+            MNNTEST_ASSERT(peak == 150);
+            MNNTEST_ASSERT(blocks[0].offset == blocks[2].offset);
+            MNNTEST_ASSERT(blocks[1].offset >= 100 || blocks[1].offset + 50 <= blocks[0].offset);
+        }
+
+        // record - replay on allocator
+        {
+            auto alignment = 64;
+            BufferAllocator allocator(alignment);
+            auto sequence = [&allocator](std::vector<void*>& pointers) {
+                pointers.clear();
+                auto p0 = allocator.alloc(64);
+                auto p1 = allocator.alloc(128);
+                allocator.free(p0);
+                auto p2 = allocator.alloc(128);
+                allocator.free(p1);
+                auto p3 = allocator.alloc(192);
+                pointers = {p0, p1, p2, p3};
+            };
+            std::vector<void*> pointers;
+            allocator.beginRecord();
+            sequence(pointers);
+            auto planned = allocator.endRecord();
+            MNNTEST_ASSERT(planned == 320);
+            allocator.release();
+            allocator.beginReplay();
+            sequence(pointers);
+            MNNTEST_ASSERT(allocator.endReplay());
+            MNNTEST_ASSERT(allocator.totalSize() == planned);
+            MNNTEST_ASSERT(pointers[1] != pointers[2]);
+            MNNTEST_ASSERT(pointers[2] != pointers[3]);
+            for (auto p : pointers) {
+                MNNTEST_ASSERT((size_t)p % alignment == 0);
+            }
+
+            // a different sequence falls back to free list
+            allocator.release();
+            allocator.beginReplay();
+            auto p0 = allocator.alloc(256);
+            MNNTEST_ASSERT(nullptr != p0);
+            MNNTEST_ASSERT(!allocator.endReplay());
+            MNNTEST_ASSERT(allocator.plannedSize() == 0);
+        }
+
+        // plan memory of session
+        {
+            auto x = _Input({1, 4, 16, 16}, NC4HW4, halide_type_of<float>());
+            auto y = x;
+            for (int i = 0; i < 6; ++i) {
+                auto branch = _Relu(y);
+                y           = _Add(_Sigmoid(y), branch);
+            }
+            y = _Convert(y, NCHW);
+            std::unique_ptr<NetT> net(new NetT);
+            Variable::save({y}, net.get());
+            flatbuffers::FlatBufferBuilder builder(1024);
+            auto len = Net::Pack(builder, net.get());
+            builder.Finish(len);
+            std::shared_ptr<Interpreter> interp(Interpreter::createFromBuffer(builder.GetBufferPointer(), builder.GetSize()));
+            ScheduleConfig config;
+            config.numThread = 1;
+            auto session     = interp->createSession(config);
+            auto compute     = [&]() {
+                auto input = interp->getSessionInput(session, nullptr);
+                std::unique_ptr<Tensor> inputHost(Tensor::createHostTensorFromDevice(input, false));
+                for (int i = 0; i < inputHost->elementSize(); ++i) {
+                    inputHost->host<float>()[i] = (float)(i % 13 - 6) / 6.0f;
+                }
+                input->copyFromHostTensor(inputHost.get());
+                interp->runSession(session);
+                auto output = interp->getSessionOutput(session, nullptr);
+                std::unique_ptr<Tensor> outputHost(Tensor::createHostTensorFromDevice(output, true));
+                return std::vector<float>(outputHost->host<float>(),
+                                          outputHost->host<float>() + outputHost->elementSize());
+            };
+            auto expect = compute();
+            MNNTEST_ASSERT(interp->getSessionMemoryUsage(session).second == 0);
+            interp->setSessionMemoryPlan(session, true);
+            interp->resizeSession(session);
+            auto usage = interp->getSessionMemoryUsage(session);
+            MNNTEST_ASSERT(usage.second > 0);
+            MNNTEST_ASSERT(usage.second <= usage.first);
+            auto result = compute();
+            MNNTEST_ASSERT(result.size() == expect.size());
+            for (int i = 0; i < expect.size(); ++i) {
+                if (fabsf(result[i] - expect[i]) > 1e-5f) {
+                    MNN_ERROR("Planned session error at %d: %f - %f\n", i, result[i], expect[i]);
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+};
+MNNTestSuiteRegister(MemoryPlannerTest, "core/memory_planner");
@@ -0,0 +1,133 @@
+//
+//  TensorViewTest.cpp
+//  MNNTests
+//
+//  Created by MNN on 2020/05/10.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <math.h>
+#include <MNN/Interpreter.hpp>
+#include <MNN/expr/ExprCreator.hpp>
+#include "MNNTestSuite.h"
+#include "MNN_generated.h"
+
+using namespace MNN;
+using namespace MNN::Express;
+
+class TensorViewTest : public MNNTestCase {
+public:
+    virtual ~TensorViewTest() = default;
+    // Run the net of y in session, the result is compared with expr, which doesn't alias tensors
+    static bool test(VARP x, VARP y, int expectAliased) {
+        auto inputPtr = x->writeMap<float>();
+        for (int i = 0; i < x->getInfo()->size; ++i) {
+            inputPtr[i] = (float)(i % 17 - 8) / 8.0f;
+        }
+        auto expectPtr = y->readMap<float>();
+        std::vector<float> expect(expectPtr, expectPtr + y->getInfo()->size);
+
+        std::unique_ptr<NetT> net(new NetT);
+        Variable::save({y}, net.get());
+        flatbuffers::FlatBufferBuilder builder(1024);
+        auto len = Net::Pack(builder, net.get());
+        builder.Finish(len);
+        std::shared_ptr<Interpreter> interp(Interpreter::createFromBuffer(builder.GetBufferPointer(), builder.GetSize()));
+        ScheduleConfig config;
+        config.numThread = 1;
+        auto session     = interp->createSession(config);
+        for (int plan = 0; plan < 2; ++plan) {
+            interp->setSessionMemoryPlan(session, plan > 0);
+            interp->resizeSession(session);
+            auto input = interp->getSessionInput(session, nullptr);
+            std::unique_ptr<Tensor> inputHost(Tensor::createHostTensorFromDevice(input, false));
+            for (int i = 0; i < inputHost->elementSize(); ++i) {
+                inputHost->host<float>()[i] = (float)(i % 17 - 8) / 8.0f;
+            }
+            input->copyFromHostTensor(inputHost.get());
+
+            // Concat or slice is aliased if the memory of inputs are the slots of output
+            int aliased = 0;
+            std::vector<Tensor*> inputs;
+            auto before = [&inputs](const std::vector<Tensor*>& tensors, const OperatorInfo* info) {
+                inputs = tensors;
+                return true;
+            };
+            auto after = [&inputs, &aliased](const std::vector<Tensor*>& tensors, const OperatorInfo* info) {
+                if (info->type() == "Concat" || info->type() == "Slice") {
+                    bool isConcat = info->type() == "Concat";
+                    auto& whole   = isConcat ? tensors[0] : inputs[0];
+                    auto& parts   = isConcat ? inputs : tensors;
+                    auto slot     = whole->host<uint8_t>();
+                    for (auto t : parts) {
+                        if (t->host<uint8_t>() != slot) {
+                            return true;
+                        }
+                        slot += t->size();
+                    }
+                    aliased++;
+                }
+                if (info->type() == "SliceTf" && tensors[0]->host<uint8_t>() >= inputs[0]->host<uint8_t>() &&
+                    tensors[0]->host<uint8_t>() < inputs[0]->host<uint8_t>() + inputs[0]->size()) {
+                    aliased++;
+                }
+                return true;
+            };
+            interp->runSessionWithCallBackInfo(session, before, after);
+            auto output = interp->getSessionOutput(session, nullptr);
+            std::unique_ptr<Tensor> outputHost(Tensor::createHostTensorFromDevice(output, true));
+            if (outputHost->elementSize() != expect.size()) {
+                MNN_ERROR("Output size error: %d - %d\n", outputHost->elementSize(), (int)expect.size());
+                return false;
+            }
+            for (int i = 0; i < expect.size(); ++i) {
+                if (fabsf(outputHost->host<float>()[i] - expect[i]) > 1e-5f) {
+                    MNN_ERROR("Session with views error at %d: %f - %f\n", i, outputHost->host<float>()[i], expect[i]);
+                    return false;
+                }
+            }
+            if (aliased != expectAliased) {
+                MNN_ERROR("Aliased %d ops of %d, memory plan = %d\n", aliased, expectAliased, plan);
+                return false;
+            }
+        }
+        return true;
+    }
+    virtual bool run() {
+        // Nested concat along channel, the first one is split again
+        {
+            auto x     = _Input({1, 8, 8, 8}, NCHW);
+            auto xC4   = _Convert(x, NC4HW4);
+            auto c     = _Concat({_Relu(xC4), _Sigmoid(xC4)}, 1);
+            auto d     = _Concat({c, _Tanh(xC4)}, 1);
+            auto parts = _Split(c, {8, 8}, 1);
+            auto y     = _Concat({_Add(parts[0], parts[1]), d}, 1);
+            if (!test(x, _Convert(y, NCHW), 4)) {
+                return false;
+            }
+        }
+        // Remain of channels in NC4HW4 and batch above 1 can't be aliased
+        {
+            auto x     = _Input({2, 6, 4, 4}, NCHW);
+            auto xC4   = _Convert(x, NC4HW4);
+            auto c     = _Concat({_Relu(xC4), _Sigmoid(xC4)}, 1);
+            auto parts = _Split(c, {6, 6}, 1);
+            if (!test(x, _Convert(_Add(parts[0], parts[1]), NCHW), 0)) {
+                return false;
+            }
+        }
+        // Concat along the outer axis and slice of it
+        {
+            auto x     = _Input({4, 6, 16}, NHWC);
+            auto c     = _Concat({_Relu(x), _Sigmoid(x)}, 0);
+            auto begin = _Const((const void*)std::vector<int>{2, 0, 0}.data(), {3}, NHWC, halide_type_of<int>());
+            auto size  = _Const((const void*)std::vector<int>{4, 6, 16}.data(), {3}, NHWC, halide_type_of<int>());
+            auto y     = _Concat({_Slice(c, begin, size), _Tanh(x)}, 1);
+            if (!test(x, y, 2)) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+MNNTestSuiteRegister(TensorViewTest, "core/tensor_view");
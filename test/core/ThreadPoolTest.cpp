@@ -43,4 +43,50 @@ public:
 };
 
 MNNTestSuiteRegister(ThreadPoolTest, "core/threadpool");
+
+class ThreadPoolNestedTest : public MNNTestCase {
+public:
+    virtual ~ThreadPoolNestedTest() = default;
+    virtual bool run() {
+        const int outerSize = 7, innerSize = 13, threadNumber = 6;
+        std::vector<std::atomic_int> counts(threadNumber * outerSize * innerSize);
+        for (auto& c : counts) {
+            c = 0;
+        }
+        std::vector<std::thread> threads;
+        for (int t = 0; t < threadNumber; ++t) {
+            threads.emplace_back([&, t]() {
+                ThreadPool::init(4);
+                auto workIndex = ThreadPool::acquireWorkIndex();
+                ThreadPool::active();
+                ThreadPool::enqueue(std::make_pair(
+                                        [&, t, workIndex](int i) {
+                                            // Nested parallel region
+                                            ThreadPool::enqueue(std::make_pair(
+                                                                    [&, t, i](int j) {
+                                                                        counts[(t * outerSize + i) * innerSize + j]++;
+                                                                    },
+                                                                    innerSize),
+                                                                workIndex);
+                                        },
+                                        outerSize),
+                                    workIndex);
+                ThreadPool::deactive();
+                ThreadPool::releaseWorkIndex(workIndex);
+            });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        for (int i = 0; i < counts.size(); ++i) {
+            if (1 != counts[i]) {
+                MNN_ERROR("Work %d run %d times\n", i, (int)counts[i]);
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+MNNTestSuiteRegister(ThreadPoolNestedTest, "core/threadpool_nested");
 #endif
@@ -0,0 +1,78 @@
+//
+//  TracerTest.cpp
+//  MNNTests
+//
+//  Created by MNN on 2020/05/01.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <MNN/Interpreter.hpp>
+#include <MNN/expr/ExprCreator.hpp>
+#include "MNNTestSuite.h"
+#include "MNN_generated.h"
+#include "core/Tracer.hpp"
+
+using namespace MNN;
+using namespace MNN::Express;
+
+class TracerTest : public MNNTestCase {
+public:
+    virtual ~TracerTest() = default;
+    virtual bool run() {
+        // tracer records only when bound
+        {
+            Tracer tracer;
+            {
+                Tracer::Scope _s("test", "unbound");
+                MNNTEST_ASSERT(nullptr == _s.event());
+            }
+            MNNTEST_ASSERT(tracer.size() == 0);
+            {
+                Tracer::Bind _b(&tracer);
+                MNNTEST_ASSERT(Tracer::current() == &tracer);
+                Tracer::Scope _s("test", "a \"quoted\" name");
+                _s.event()->numbers = {{"value", 1.0}};
+            }
+            MNNTEST_ASSERT(nullptr == Tracer::current());
+            tracer.counter("memory", {{"MB", 2.0}});
+            tracer.counter("memory", {{"MB", 1.0}});
+            MNNTEST_ASSERT(tracer.size() == 3);
+            MNNTEST_ASSERT(tracer.peak("memory", "MB") == 2.0);
+            auto json = tracer.dump();
+            MNNTEST_ASSERT(json.find("\"a \\\"quoted\\\" name\"") != std::string::npos);
+            MNNTEST_ASSERT(json.find("\"ph\":\"C\"") != std::string::npos);
+        }
+
+        // trace of session
+        auto x = _Input({1, 8, 32, 32}, NC4HW4, halide_type_of<float>());
+        std::vector<float> weight(8 * 8 * 9, 0.01f), bias(8, 0.0f);
+        auto y = _Conv(std::move(weight), std::move(bias), x, {8, 8}, {3, 3}, SAME);
+        y      = _Convert(_Sigmoid(_Relu(y)), NCHW);
+        std::unique_ptr<NetT> net(new NetT);
+        Variable::save({y}, net.get());
+        flatbuffers::FlatBufferBuilder builder(1024);
+        auto len = Net::Pack(builder, net.get());
+        builder.Finish(len);
+        std::shared_ptr<Interpreter> interp(Interpreter::createFromBuffer(builder.GetBufferPointer(), builder.GetSize()));
+        ScheduleConfig config;
+        config.numThread = 4;
+        auto session     = interp->createSession(config);
+        MNNTEST_ASSERT(interp->getSessionTrace(session).empty());
+        interp->setSessionTrace(session, true);
+        interp->resizeSession(session);
+        interp->runSession(session);
+        auto json = interp->getSessionTrace(session);
+        for (auto key : {"\"cat\":\"session\"", "\"name\":\"resize\"", "\"name\":\"run\"", "\"cat\":\"create\"",
+                         "\"cat\":\"resize\"", "\"cat\":\"execute\"", "\"type\":\"Convolution\"", "\"flops\":",
+                         "\"name\":\"dynamic memory\"", "\"name\":\"static memory\""}) {
+            if (json.find(key) == std::string::npos) {
+                MNN_ERROR("Trace of session doesn't contain %s\n", key);
+                return false;
+            }
+        }
+        interp->setSessionTrace(session, false);
+        MNNTEST_ASSERT(interp->getSessionTrace(session).empty());
+        return true;
+    }
+};
+MNNTestSuiteRegister(TracerTest, "core/tracer");
@@ -0,0 +1,110 @@
+//
+//  TuningTest.cpp
+//  MNNTests
+//
+//  Created by MNN on 2020/05/02.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <MNN/Interpreter.hpp>
+#include <MNN/expr/ExprCreator.hpp>
+#include "MNNTestSuite.h"
+#include "MNN_generated.h"
+#include "backend/cpu/CPUTuner.hpp"
+
+using namespace MNN;
+using namespace MNN::Express;
+
+class TuningTest : public MNNTestCase {
+public:
+    virtual ~TuningTest() = default;
+    static std::vector<float> compute(Interpreter* interp, Session* session) {
+        auto input = interp->getSessionInput(session, nullptr);
+        std::unique_ptr<Tensor> inputHost(Tensor::createHostTensorFromDevice(input, false));
+        for (int i = 0; i < inputHost->elementSize(); ++i) {
+            inputHost->host<float>()[i] = (float)(i % 13 - 6) / 6.0f;
+        }
+        input->copyFromHostTensor(inputHost.get());
+        interp->runSession(session);
+        auto output = interp->getSessionOutput(session, nullptr);
+        std::unique_ptr<Tensor> outputHost(Tensor::createHostTensorFromDevice(output, true));
+        return std::vector<float>(outputHost->host<float>(), outputHost->host<float>() + outputHost->elementSize());
+    }
+    static int countLines(const char* path, const char* prefix) {
+        auto file = fopen(path, "r");
+        if (nullptr == file) {
+            return -1;
+        }
+        int number = 0;
+        char line[1024];
+        while (nullptr != fgets(line, sizeof(line), file)) {
+            if (0 == strncmp(line, prefix, strlen(prefix))) {
+                number++;
+            }
+        }
+        fclose(file);
+        return number;
+    }
+    virtual bool run() {
+        const int ic = 8, oc = 16, size = 16;
+        auto x = _Input({1, ic, size, size}, NC4HW4, halide_type_of<float>());
+        std::vector<float> weight(oc * ic * 9), weight1x1(oc * oc), bias(oc);
+        for (int i = 0; i < weight.size(); ++i) {
+            weight[i] = (float)(i % 11 - 5) / 32.0f;
+        }
+        for (int i = 0; i < weight1x1.size(); ++i) {
+            weight1x1[i] = (float)(i % 7 - 3) / 16.0f;
+        }
+        for (int i = 0; i < oc; ++i) {
+            bias[i] = (float)i / oc;
+        }
+        auto y = _Conv(std::move(weight), std::vector<float>(bias), x, {ic, oc}, {3, 3}, SAME);
+        y      = _Conv(std::move(weight1x1), std::move(bias), y, {oc, oc}, {1, 1});
+        y      = _Reshape(_Convert(y, NCHW), {oc, size * size});
+        std::vector<float> matrix(size * size * 8);
+        for (int i = 0; i < matrix.size(); ++i) {
+            matrix[i] = (float)(i % 5 - 2) / 8.0f;
+        }
+        y = _MatMul(y, _Const(matrix.data(), {size * size, 8}, NCHW));
+        std::unique_ptr<NetT> net(new NetT);
+        Variable::save({y}, net.get());
+        flatbuffers::FlatBufferBuilder builder(1024);
+        auto len = Net::Pack(builder, net.get());
+        builder.Finish(len);
+        std::shared_ptr<Interpreter> interp(Interpreter::createFromBuffer(builder.GetBufferPointer(), builder.GetSize()));
+        ScheduleConfig config;
+        config.numThread = 2;
+        auto reference   = interp->createSession(config);
+        auto expect      = compute(interp.get(), reference);
+
+        const char* cacheFile = "mnn_tuning_test.cache";
+        ::remove(cacheFile);
+        auto session = interp->createSession(config);
+        interp->setSessionTuning(session, true, cacheFile);
+        interp->resizeSession(session);
+        auto result = compute(interp.get(), session);
+        MNNTEST_ASSERT(result.size() == expect.size());
+        for (int i = 0; i < expect.size(); ++i) {
+            if (fabsf(result[i] - expect[i]) > 1e-3f * (1.0f + fabsf(expect[i]))) {
+                MNN_ERROR("Tuned session error at %d: %f - %f\n", i, result[i], expect[i]);
+                return false;
+            }
+        }
+        // Winners of both convolutions and the matmul are saved
+        auto convNumber   = countLines(cacheFile, "conv:");
+        auto matmulNumber = countLines(cacheFile, "matmul:");
+        ::remove(cacheFile);
+        if (convNumber != 2 || matmulNumber != 1) {
+            MNN_ERROR("Tuning cache has %d conv and %d matmul\n", convNumber, matmulNumber);
+            return false;
+        }
+        MNNTEST_ASSERT(CPUTuner::get()->size() >= 3);
+        MNNTEST_ASSERT(!CPUTuner::cpuId().empty());
+        CPUTuner::get()->setCacheFile("");
+        return true;
+    }
+};
+MNNTestSuiteRegister(TuningTest, "core/tuning");
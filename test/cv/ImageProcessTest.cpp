@@ -7,7 +7,9 @@
 //
 
 #include <memory>
+#include <algorithm>
 #include <cmath>
+#include <vector>
 #include <MNN/ImageProcess.hpp>
 #include "MNNTestSuite.h"
 
@@ -938,3 +940,216 @@ public:
     }
 };
 MNNTestSuiteRegister(ImageProcessGrayToGrayFloatBlitterTest, "cv/image_process/gray_to_gray_blitter");
+
+// Rows are split among threads for big images, and the samplers / blitters run with SSE or AVX2 on x86
+class ImageProcessMultiThreadTest : public MNNTestCase {
+public:
+    virtual ~ImageProcessMultiThreadTest() = default;
+    static std::vector<uint8_t> makeSource(int size) {
+        std::vector<uint8_t> source(size);
+        for (int i = 0; i < size; ++i) {
+            source[i] = (uint8_t)((i * i + 7 * i) % 251);
+        }
+        return source;
+    }
+    static std::vector<uint8_t> convert(ImageFormat sourceFormat, ImageFormat destFormat, Filter filter,
+                                        const Matrix& tr, const std::vector<uint8_t>& source, int sw, int sh, int dw,
+                                        int dh, int bpp, bool isFloat, int numThread) {
+        ImageProcess::Config config;
+        config.sourceFormat = sourceFormat;
+        config.destFormat   = destFormat;
+        config.filterType   = filter;
+        for (int i = 0; i < 4; ++i) {
+            config.mean[i]   = 10.0f * i + 100.0f;
+            config.normal[i] = 0.01f * (i + 1);
+        }
+        std::shared_ptr<ImageProcess> process(ImageProcess::create(config));
+        process->setThreadNumber(numThread);
+        process->setMatrix(tr);
+        std::vector<uint8_t> dest(dw * dh * bpp * (isFloat ? sizeof(float) : 1));
+        auto type = isFloat ? halide_type_of<float>() : halide_type_of<uint8_t>();
+        process->convert(source.data(), sw, sh, 0, dest.data(), dw, dh, bpp, 0, type);
+        return dest;
+    }
+    // The result of threads must be the same as single thread
+    static bool testThreads() {
+        const int sw = 333, sh = 257, dw = 301, dh = 211;
+        Matrix tr;
+        tr.setScale(1.0 / dw, 1.0 / dh);
+        tr.postRotate(15, 0.5f, 0.5f);
+        tr.postScale(sw, sh);
+        auto source = makeSource(sw * sh * 4);
+        struct Case {
+            ImageFormat sourceFormat;
+            ImageFormat destFormat;
+            Filter filter;
+            int bpp;
+            bool isFloat;
+        };
+        const Case cases[] = {
+            {RGBA, RGBA, BILINEAR, 4, false}, {GRAY, GRAY, BILINEAR, 1, false}, {RGBA, RGBA, NEAREST, 4, false},
+            {GRAY, GRAY, NEAREST, 1, false},  {YUV_NV21, RGB, NEAREST, 3, false}, {YUV_NV21, RGBA, NEAREST, 4, false},
+            {RGB, RGB, BILINEAR, 3, true},    {RGBA, RGBA, BILINEAR, 4, true},  {GRAY, GRAY, NEAREST, 4, true},
+            {RGB, BGR, NEAREST, 4, true},
+        };
+        for (auto& c : cases) {
+            auto single = convert(c.sourceFormat, c.destFormat, c.filter, tr, source, sw, sh, dw, dh, c.bpp, c.isFloat, 1);
+            auto multi  = convert(c.sourceFormat, c.destFormat, c.filter, tr, source, sw, sh, dw, dh, c.bpp, c.isFloat, 4);
+            if (single != multi) {
+                MNN_ERROR("Multi thread error for case %d\n", (int)(&c - cases));
+                return false;
+            }
+        }
+        return true;
+    }
+    // Bilinear of scale against the reference, the width is not aligned to the vector
+    static bool testBilinear(int bpp) {
+        const int sw = 203, sh = 101, dw = 511, dh = 67;
+        auto format = bpp == 4 ? RGBA : GRAY;
+        Matrix tr;
+        tr.setScale((float)sw / dw, (float)sh / dh);
+        auto source = makeSource(sw * sh * bpp);
+        auto dest   = convert(format, format, BILINEAR, tr, source, sw, sh, dw, dh, bpp, false, 4);
+        for (int y = 0; y < dh; ++y) {
+            float sy = std::min(std::max(y * (float)sh / dh, 0.0f), (float)(sh - 1));
+            int y0   = (int)sy;
+            int y1   = std::min(y0 + 1, sh - 1);
+            float fy = sy - y0;
+            for (int x = 0; x < dw; ++x) {
+                float sx = std::min(std::max(x * (float)sw / dw, 0.0f), (float)(sw - 1));
+                int x0   = (int)sx;
+                int x1   = std::min(x0 + 1, sw - 1);
+                float fx = sx - x0;
+                for (int c = 0; c < bpp; ++c) {
+                    auto p = [&](int px, int py) { return (float)source[(py * sw + px) * bpp + c]; };
+                    float v = (p(x0, y0) * (1 - fx) + p(x1, y0) * fx) * (1 - fy) +
+                              (p(x0, y1) * (1 - fx) + p(x1, y1) * fx) * fy;
+                    if (fabsf(dest[(y * dw + x) * bpp + c] - v) > 2) {
+                        MNN_ERROR("Bilinear C%d error at %d, %d: %d - %f\n", bpp, x, y, dest[(y * dw + x) * bpp + c], v);
+                        return false;
+                    }
+                }
+            }
+        }
+        return true;
+    }
+    // NV21 to RGB / BGR / RGBA without transform against the formula
+    static bool testNV21(ImageFormat destFormat) {
+        const int sw = 250, sh = 140;
+        auto source = makeSource(sw * sh + sw * sh / 2);
+        int bpp     = destFormat == RGBA ? 4 : 3;
+        auto dest   = convert(YUV_NV21, destFormat, NEAREST, Matrix(), source, sw, sh, sw, sh, bpp, false, 4);
+        for (int y = 0; y < sh; ++y) {
+            for (int x = 0; x < sw; ++x) {
+                int Y      = source[y * sw + x] << 6;
+                auto uv    = source.data() + sw * sh + (y / 2) * sw + (x / 2) * 2;
+                int U      = (int)uv[1] - 128;
+                int V      = (int)uv[0] - 128;
+                int rgb[3] = {(Y + 73 * V) >> 6, (Y - 25 * U - 37 * V) >> 6, (Y + 130 * U) >> 6};
+                for (int c = 0; c < 3; ++c) {
+                    int expect = std::min(std::max(rgb[destFormat == BGR ? 2 - c : c], 0), 255);
+                    int value  = dest[(y * sw + x) * bpp + c];
+                    if (abs(value - expect) > 2) {
+                        MNN_ERROR("NV21 to %d error at %d, %d: %d - %d\n", destFormat, x, y, value, expect);
+                        return false;
+                    }
+                }
+            }
+        }
+        return true;
+    }
+    // Blit to float without transform, include the GRAY / RGB to 4 channels of NC4HW4
+    static bool testFloat(ImageFormat format, int srcBpp, int bpp) {
+        const int sw = 123, sh = 45;
+        auto source = makeSource(sw * sh * srcBpp);
+        auto dest   = convert(format, format, NEAREST, Matrix(), source, sw, sh, sw, sh, bpp, true, 1);
+        auto result = (const float*)dest.data();
+        for (int i = 0; i < sw * sh; ++i) {
+            for (int c = 0; c < bpp; ++c) {
+                float expect = 0.0f;
+                if (c < srcBpp) {
+                    expect = (source[i * srcBpp + c] - (10.0f * c + 100.0f)) * 0.01f * (c + 1);
+                }
+                if (fabsf(result[i * bpp + c] - expect) > 1e-4f) {
+                    MNN_ERROR("Float of C%d to C%d error at %d: %f - %f\n", srcBpp, bpp, i, result[i * bpp + c], expect);
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+    virtual bool run() {
+        return testThreads() && testBilinear(4) && testBilinear(1) && testNV21(RGB) && testNV21(BGR) &&
+               testNV21(RGBA) && testFloat(GRAY, 1, 1) && testFloat(RGB, 3, 3) && testFloat(RGBA, 4, 4) &&
+               testFloat(GRAY, 1, 4) && testFloat(RGB, 3, 4);
+    }
+};
+MNNTestSuiteRegister(ImageProcessMultiThreadTest, "cv/image_process/multi_thread");
+
+// Batch of images with their own crops are written into one tensor, compare with the convert of each image
+class ImageProcessBatchTest : public MNNTestCase {
+public:
+    virtual ~ImageProcessBatchTest() = default;
+    static bool test(Tensor::DimensionType dimensionType, int numThread) {
+        const int sw = 320, sh = 240, dw = 97, dh = 61, batch = 3;
+        ImageProcess::Config config;
+        config.sourceFormat = RGBA;
+        config.destFormat   = BGR;
+        config.filterType   = BILINEAR;
+        for (int i = 0; i < 4; ++i) {
+            config.mean[i]   = 127.5f;
+            config.normal[i] = 1.0f / 127.5f;
+        }
+        std::shared_ptr<ImageProcess> process(ImageProcess::create(config));
+        process->setThreadNumber(numThread);
+        std::vector<std::vector<uint8_t>> images(batch, std::vector<uint8_t>(sw * sh * 4));
+        std::vector<const uint8_t*> sources;
+        std::vector<Matrix> matrixs(batch);
+        for (int b = 0; b < batch; ++b) {
+            for (int i = 0; i < sw * sh * 4; ++i) {
+                images[b][i] = (uint8_t)((i * (b + 3) + i / 7) % 253);
+            }
+            sources.emplace_back(images[b].data());
+            // Crop of [20b, 10b, 20b + 150, 10b + 100] to dest
+            matrixs[b].setScale(150.0f / dw, 100.0f / dh);
+            matrixs[b].postTranslate(20.0f * b, 10.0f * b);
+        }
+        auto shape = [dimensionType, dh, dw](int n) {
+            return dimensionType == Tensor::TENSORFLOW ? std::vector<int>{n, dh, dw, 3} : std::vector<int>{n, 3, dh, dw};
+        };
+        std::shared_ptr<Tensor> tensor(Tensor::create<float>(shape(batch), nullptr, dimensionType));
+        if (NO_ERROR != process->convert(sources, sw, sh, 0, matrixs, tensor.get())) {
+            MNN_ERROR("Batch convert failed\n");
+            return false;
+        }
+        for (int b = 0; b < batch; ++b) {
+            std::shared_ptr<Tensor> single(Tensor::create<float>(shape(1), nullptr, dimensionType));
+            process->setMatrix(matrixs[b]);
+            process->convert(sources[b], sw, sh, 0, single.get());
+            auto size = single->elementSize();
+            if (dimensionType == Tensor::CAFFE_C4) {
+                size = 4 * dw * dh;
+            }
+            auto result = tensor->host<float>() + b * size;
+            auto expect = single->host<float>();
+            for (int i = 0; i < size; ++i) {
+                if (result[i] != expect[i]) {
+                    MNN_ERROR("Batch error of format %d at %d, %d: %f - %f\n", dimensionType, b, i, result[i],
+                              expect[i]);
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+    virtual bool run() {
+        for (int numThread : {1, 4}) {
+            if (!(test(Tensor::CAFFE_C4, numThread) && test(Tensor::TENSORFLOW, numThread) &&
+                  test(Tensor::CAFFE, numThread))) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+MNNTestSuiteRegister(ImageProcessBatchTest, "cv/image_process/batch");
@@ -0,0 +1,125 @@
+//
+//  BatchServerTest.cpp
+//  MNNTests
+//
+//  Created by MNN on 2020/04/30.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <math.h>
+#include <string.h>
+#include <thread>
+#include <MNN/BatchServer.hpp>
+#include <MNN/expr/ExprCreator.hpp>
+#include "MNNTestSuite.h"
+#include "MNN_generated.h"
+using namespace MNN::Express;
+using namespace MNN;
+
+class BatchServerTest : public MNNTestCase {
+public:
+    static std::vector<float> makeSample(int index, int size) {
+        std::vector<float> sample(size);
+        for (int i = 0; i < size; ++i) {
+            sample[i] = (float)((i + index * 7) % 17 - 8) / 8.0f;
+        }
+        return sample;
+    }
+    virtual bool run() {
+        const int ic = 4, oc = 8, h = 4, w = 4;
+        auto x = _Input({1, ic, h, w}, NCHW, halide_type_of<float>());
+        x->setName("x");
+        std::vector<float> weight(oc * ic * 9), bias(oc);
+        for (int i = 0; i < weight.size(); ++i) {
+            weight[i] = (float)(i % 11 - 5) / 16.0f;
+        }
+        for (int i = 0; i < oc; ++i) {
+            bias[i] = (float)i / oc;
+        }
+        auto y = _Conv(std::move(weight), std::move(bias), _Convert(x, NC4HW4), {ic, oc}, {3, 3}, SAME);
+        y      = _Convert(_Sigmoid(y), NCHW);
+        y->setName("y");
+        std::unique_ptr<NetT> net(new NetT);
+        Variable::save({y}, net.get());
+        flatbuffers::FlatBufferBuilder builder(1024);
+        auto len = Net::Pack(builder, net.get());
+        builder.Finish(len);
+        std::shared_ptr<Interpreter> interp(Interpreter::createFromBuffer(builder.GetBufferPointer(), builder.GetSize()));
+
+        // Reference of every sample computed in single batch
+        const int sampleNumber = 24, inputSize = ic * h * w;
+        std::vector<std::vector<float>> expects(sampleNumber);
+        {
+            ScheduleConfig config;
+            config.numThread = 1;
+            auto session     = interp->createSession(config);
+            auto input       = interp->getSessionInput(session, "x");
+            auto output      = interp->getSessionOutput(session, "y");
+            for (int s = 0; s < sampleNumber; ++s) {
+                auto sample = makeSample(s, inputSize);
+                std::unique_ptr<Tensor> inputHost(Tensor::createHostTensorFromDevice(input, false));
+                ::memcpy(inputHost->host<float>(), sample.data(), inputSize * sizeof(float));
+                input->copyFromHostTensor(inputHost.get());
+                interp->runSession(session);
+                std::unique_ptr<Tensor> outputHost(Tensor::createHostTensorFromDevice(output, true));
+                expects[s].assign(outputHost->host<float>(), outputHost->host<float>() + outputHost->elementSize());
+            }
+            interp->releaseSession(session);
+        }
+
+        BatchServer::Config config;
+        config.maxBatch           = 4;
+        config.maxWaitUs          = 2000;
+        config.numWorker          = 2;
+        config.schedule.numThread = 1;
+        std::unique_ptr<BatchServer> server(BatchServer::create(interp, config));
+        if (nullptr == server) {
+            MNN_ERROR("Create batch server failed\n");
+            return false;
+        }
+        const int clientNumber = 4;
+        std::vector<BatchServer::Result> results(sampleNumber);
+        std::vector<std::thread> clients;
+        for (int c = 0; c < clientNumber; ++c) {
+            clients.emplace_back([&, c]() {
+                for (int s = c; s < sampleNumber; s += clientNumber) {
+                    BatchServer::Tensors inputs;
+                    inputs["x"] = makeSample(s, inputSize);
+                    results[s]  = server->submit(std::move(inputs)).get();
+                }
+            });
+        }
+        for (auto& client : clients) {
+            client.join();
+        }
+        for (int s = 0; s < sampleNumber; ++s) {
+            auto& result = results[s];
+            if (NO_ERROR != result.code || result.outputs["y"].size() != expects[s].size()) {
+                MNN_ERROR("Batch server result error for %d\n", s);
+                return false;
+            }
+            for (int i = 0; i < expects[s].size(); ++i) {
+                if (fabsf(result.outputs["y"][i] - expects[s][i]) > 1e-5f) {
+                    MNN_ERROR("Batch server error for %d at %d: %f - %f\n", s, i, result.outputs["y"][i],
+                              expects[s][i]);
+                    return false;
+                }
+            }
+        }
+        auto stats = server->getStats();
+        if (stats.second != sampleNumber || stats.first > sampleNumber) {
+            MNN_ERROR("Batch server run %d batches for %d samples\n", (int)stats.first, (int)stats.second);
+            return false;
+        }
+
+        // Missing input is reported to the request only
+        BatchServer::Tensors wrong;
+        wrong["z"] = makeSample(0, inputSize);
+        if (NO_ERROR == server->submit(std::move(wrong)).get().code) {
+            MNN_ERROR("Batch server should fail for missing input\n");
+            return false;
+        }
+        return true;
+    }
+};
+MNNTestSuiteRegister(BatchServerTest, "expr/BatchServer");
@@ -0,0 +1,96 @@
+//
+//  ExecutorScopeTest.cpp
+//  MNNTests
+//
+//  Created by MNN on 2020/05/12.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <math.h>
+#include <thread>
+#include <vector>
+#include <MNN/expr/Executor.hpp>
+#include <MNN/expr/ExprCreator.hpp>
+#include "MNNTestSuite.h"
+
+using namespace MNN::Express;
+
+// Independent graphs are created and computed by the executors of their threads
+class ExecutorScopeTest : public MNNTestCase {
+public:
+    virtual ~ExecutorScopeTest() = default;
+    // A chain of matmul and activation, the seed makes graphs of threads different
+    static VARP makeGraph(int seed) {
+        const int size = 32;
+        std::vector<float> x(size * size), w(size * size);
+        for (int i = 0; i < size * size; ++i) {
+            x[i] = (float)((i * (seed + 1)) % 17 - 8) / 16.0f;
+            w[i] = (float)((i * 7 + seed) % 13 - 6) / 32.0f;
+        }
+        auto y      = _Const(x.data(), {size, size}, NHWC);
+        auto weight = _Const(w.data(), {size, size}, NHWC);
+        for (int i = 0; i < 8; ++i) {
+            y = _Tanh(_MatMul(y, weight) + y);
+        }
+        return _ReduceSum(y);
+    }
+    virtual bool run() {
+        const int threadNumber = 4;
+        // Expects of the global executor
+        std::vector<float> expects(threadNumber);
+        for (int i = 0; i < threadNumber; ++i) {
+            expects[i] = makeGraph(i)->readMap<float>()[0];
+        }
+        MNN::BackendConfig config;
+        auto global = Executor::getGlobalExecutor();
+        // Nested scopes
+        {
+            auto first = Executor::newExecutor(MNN_FORWARD_CPU, config, 1);
+            ExecutorScope firstScope(first);
+            {
+                ExecutorScope secondScope(Executor::newExecutor(MNN_FORWARD_CPU, config, 1));
+                if (ExecutorScope::Current() == first || ExecutorScope::Current() == global) {
+                    MNN_ERROR("The executor of inner scope is not current\n");
+                    return false;
+                }
+            }
+            if (ExecutorScope::Current() != first) {
+                MNN_ERROR("The executor of outer scope is not restored\n");
+                return false;
+            }
+        }
+        if (ExecutorScope::Current() != global) {
+            MNN_ERROR("The global executor is not restored\n");
+            return false;
+        }
+        std::vector<float> results(threadNumber, 0.0f);
+        std::vector<VARP> lazyOutputs(threadNumber);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < threadNumber; ++t) {
+            threads.emplace_back([&, t]() {
+                ExecutorScope scope(Executor::newExecutor(MNN_FORWARD_CPU, config, 1));
+                for (int loop = 0; loop < 10; ++loop) {
+                    results[t] = makeGraph(t)->readMap<float>()[0];
+                }
+                // Computed after the thread exits
+                lazyOutputs[t] = makeGraph(t);
+            });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        for (int t = 0; t < threadNumber; ++t) {
+            if (fabsf(results[t] - expects[t]) > 1e-4f) {
+                MNN_ERROR("Thread %d error: %f - %f\n", t, results[t], expects[t]);
+                return false;
+            }
+            auto lazy = lazyOutputs[t]->readMap<float>()[0];
+            if (fabsf(lazy - expects[t]) > 1e-4f) {
+                MNN_ERROR("Output of thread %d error: %f - %f\n", t, lazy, expects[t]);
+                return false;
+            }
+        }
+        return true;
+    }
+};
+MNNTestSuiteRegister(ExecutorScopeTest, "expr/executor_scope");
@@ -0,0 +1,84 @@
+//
+//  InterOpParallelTest.cpp
+//  MNNTests
+//
+//  Created by MNN on 2020/04/26.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <math.h>
+#include <MNN/Interpreter.hpp>
+#include <MNN/expr/ExprCreator.hpp>
+#include "MNNTestSuite.h"
+#include "MNN_generated.h"
+using namespace MNN::Express;
+using namespace MNN;
+
+class InterOpParallelTest : public MNNTestCase {
+public:
+    static std::vector<float> compute(Interpreter* interp, Session* session) {
+        auto input = interp->getSessionInput(session, nullptr);
+        std::unique_ptr<Tensor> inputHost(Tensor::createHostTensorFromDevice(input, false));
+        for (int i = 0; i < inputHost->elementSize(); ++i) {
+            inputHost->host<float>()[i] = (float)(i % 23 - 11) / 11.0f;
+        }
+        input->copyFromHostTensor(inputHost.get());
+        interp->runSession(session);
+        auto output = interp->getSessionOutput(session, nullptr);
+        std::unique_ptr<Tensor> outputHost(Tensor::createHostTensorFromDevice(output, true));
+        return std::vector<float>(outputHost->host<float>(), outputHost->host<float>() + outputHost->elementSize());
+    }
+    virtual bool run() {
+        const int ic = 8, oc = 8, size = 20, branchNumber = 4;
+        auto x = _Input({1, ic, size, size}, NC4HW4, halide_type_of<float>());
+        std::vector<VARP> branches;
+        for (int b = 0; b < branchNumber; ++b) {
+            const int kernel = 2 * (b % 2) + 1;
+            std::vector<float> weight(oc * ic * kernel * kernel), bias(oc);
+            for (int i = 0; i < weight.size(); ++i) {
+                weight[i] = (float)((i + b) % 9 - 4) / 16.0f;
+            }
+            for (int i = 0; i < oc; ++i) {
+                bias[i] = (float)(i - b) / oc;
+            }
+            auto y = _Conv(std::move(weight), std::move(bias), x, {ic, oc}, {kernel, kernel}, SAME);
+            branches.emplace_back(b % 2 ? _Sigmoid(y) : _Relu(y));
+        }
+        auto y = branches[0];
+        for (int b = 1; b < branchNumber; ++b) {
+            y = _Add(y, branches[b]);
+        }
+        y = _Convert(y, NCHW);
+        std::unique_ptr<NetT> net(new NetT);
+        Variable::save({y}, net.get());
+        flatbuffers::FlatBufferBuilder builder(1024);
+        auto len = Net::Pack(builder, net.get());
+        builder.Finish(len);
+        std::shared_ptr<Interpreter> interp(Interpreter::createFromBuffer(builder.GetBufferPointer(), builder.GetSize()));
+        ScheduleConfig config;
+        config.numThread = 4;
+        auto session     = interp->createSession(config);
+        auto expect      = compute(interp.get(), session);
+
+        for (int plan = 0; plan < 2; ++plan) {
+            interp->setSessionInterOpParallel(session, true);
+            interp->setSessionMemoryPlan(session, plan > 0);
+            interp->resizeSession(session);
+            for (int loop = 0; loop < 3; ++loop) {
+                auto result = compute(interp.get(), session);
+                if (result.size() != expect.size()) {
+                    MNN_ERROR("Inter-op parallel output size mismatch\n");
+                    return false;
+                }
+                for (int i = 0; i < expect.size(); ++i) {
+                    if (fabsf(result[i] - expect[i]) > 1e-4f) {
+                        MNN_ERROR("Inter-op parallel error at %d: %f - %f\n", i, result[i], expect[i]);
+                        return false;
+                    }
+                }
+            }
+        }
+        return true;
+    }
+};
+MNNTestSuiteRegister(InterOpParallelTest, "expr/InterOpParallel");
@@ -0,0 +1,89 @@
+//
+//  MappedFileLoadTest.cpp
+//  MNNTests
+//
+//  Created by MNN on 2020/04/20.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <stdio.h>
+#include <MNN/expr/ExprCreator.hpp>
+#include <MNN/Interpreter.hpp>
+#include "MNNTestSuite.h"
+#include "MNN_generated.h"
+using namespace MNN::Express;
+using namespace MNN;
+
+class MappedFileLoadTest : public MNNTestCase {
+public:
+    static bool compute(Interpreter* interp, Session* session, const std::vector<float>& expect, const char* stage) {
+        auto input = interp->getSessionInput(session, nullptr);
+        std::unique_ptr<Tensor> inputHost(Tensor::createHostTensorFromDevice(input, false));
+        for (int i = 0; i < 4; ++i) {
+            inputHost->host<float>()[i] = (float)i;
+        }
+        input->copyFromHostTensor(inputHost.get());
+        interp->runSession(session);
+        auto output = interp->getSessionOutput(session, nullptr);
+        std::unique_ptr<Tensor> outputHost(Tensor::createHostTensorFromDevice(output, true));
+        for (int i = 0; i < 4; ++i) {
+            if (outputHost->host<float>()[i] != expect[i]) {
+                MNN_ERROR("Mapped model compute error %s at %d\n", stage, i);
+                return false;
+            }
+        }
+        return true;
+    }
+    virtual bool run() {
+        // DepthToSpace reads its op in onExecute, so the ops must stay readable after releaseModel
+        auto x    = _Input({1, 1, 1, 4}, NHWC, halide_type_of<float>());
+        auto y    = _DepthToSpace(_Add(x, _Const(1.0f, {1, 1, 1, 4}, NHWC)), 2);
+        auto xPtr = x->writeMap<float>();
+        for (int i = 0; i < 4; ++i) {
+            xPtr[i] = (float)i;
+        }
+        auto yPtr = y->readMap<float>();
+        std::vector<float> expect(yPtr, yPtr + 4);
+        std::unique_ptr<MNN::NetT> net(new NetT);
+        Variable::save({y}, net.get());
+        flatbuffers::FlatBufferBuilder builderOutput(1024);
+        auto len = MNN::Net::Pack(builderOutput, net.get());
+        builderOutput.Finish(len);
+        const char* fileName = "MappedFileLoadTest.mnn";
+        {
+            auto file = fopen(fileName, "wb");
+            if (nullptr == file) {
+                MNN_ERROR("Can't write %s\n", fileName);
+                return false;
+            }
+            fwrite(builderOutput.GetBufferPointer(), 1, builderOutput.GetSize(), file);
+            fclose(file);
+        }
+        bool res = true;
+        {
+            std::shared_ptr<Interpreter> interp(Interpreter::createFromMappedFile(fileName));
+            if (nullptr == interp || interp->getModelBuffer().second != builderOutput.GetSize()) {
+                MNN_ERROR("Create interpreter from mapped file failed\n");
+                remove(fileName);
+                return false;
+            }
+            ScheduleConfig config;
+            auto session = interp->createSession(config);
+            res          = compute(interp.get(), session, expect, "before release");
+            if (NO_ERROR == interp->updateSessionToModel(session)) {
+                MNN_ERROR("Mapped model should not be writable\n");
+                res = false;
+            }
+            interp->releaseModel();
+            res = res && compute(interp.get(), session, expect, "after release");
+            if (nullptr != interp->createSession(config)) {
+                MNN_ERROR("Released model should not create session\n");
+                res = false;
+            }
+            interp->releaseSession(session);
+        }
+        remove(fileName);
+        return res;
+    }
+};
+MNNTestSuiteRegister(MappedFileLoadTest, "expr/MappedFileLoad");
@@ -0,0 +1,95 @@
+//
+//  OptimizerTest.cpp
+//  MNNTests
+//
+//  Created by MNN on 2020/05/12.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <math.h>
+#include <string.h>
+#include <MNN/expr/ExprCreator.hpp>
+#include <MNN/expr/Optimizer.hpp>
+#include "MNNTestSuite.h"
+#include "MNN_generated.h"
+
+using namespace MNN::Express;
+
+// The optimized graph should have less ops and compute the same result
+class OptimizerTest : public MNNTestCase {
+public:
+    virtual ~OptimizerTest() = default;
+    virtual bool run() {
+        const int ic = 4, oc = 8, h = 7, w = 9;
+        auto x = _Input({1, ic, h, w}, NCHW, halide_type_of<float>());
+        std::vector<float> weight(oc * ic * 3 * 3), bias(oc), scales(oc), scaleBias(oc);
+        for (int i = 0; i < weight.size(); ++i) {
+            weight[i] = (float)(i % 11 - 5) / 10.0f;
+        }
+        for (int i = 0; i < oc; ++i) {
+            bias[i]      = (float)(i % 3 - 1) / 4.0f;
+            scales[i]    = (float)(i % 5 + 1) / 3.0f;
+            scaleBias[i] = (float)(i % 4 - 2) / 2.0f;
+        }
+        auto conv  = _Conv(std::move(weight), std::move(bias), _Convert(x, NC4HW4), {ic, oc}, {3, 3}, SAME);
+        auto scale = _Scale(conv, oc, std::move(scales), std::move(scaleBias));
+        auto relu  = _Relu6(scale);
+        auto y     = _Convert(relu, NCHW);
+        // Constant chain and common subexpression
+        auto factor = _Const(2.0f) * _Const(3.0f) + _Const(1.0f);
+        auto z      = _Sigmoid(y) * factor + _Sigmoid(y);
+
+        auto inputPtr = x->writeMap<float>();
+        for (int i = 0; i < ic * h * w; ++i) {
+            inputPtr[i] = (float)(i % 13 - 6) / 6.0f;
+        }
+        auto size = z->getInfo()->size;
+        std::vector<float> expects(size);
+        ::memcpy(expects.data(), z->readMap<float>(), size * sizeof(float));
+
+        Optimizer::Config config;
+        auto optimizer = Optimizer::create(config);
+        if (nullptr == optimizer) {
+            MNN_ERROR("Can't create optimizer for cpu\n");
+            return false;
+        }
+        auto costBefore = optimizer->onMeasure({z});
+        if (costBefore.compute <= 0.0f || costBefore.memory <= 0.0f) {
+            MNN_ERROR("Cost of graph should be positive: %f, %f\n", costBefore.compute, costBefore.memory);
+            return false;
+        }
+        optimizer->onExecute({z}, optimizer->onGetParameters({z}));
+        auto costAfter = optimizer->onMeasure({z});
+        if (costAfter.compute >= costBefore.compute) {
+            MNN_ERROR("Compute isn't decreased: %f -> %f\n", costBefore.compute, costAfter.compute);
+            return false;
+        }
+
+        auto folded = relu->expr().first->get();
+        if (nullptr == folded || MNN::OpType_Convolution != folded->type() ||
+            !folded->main_as_Convolution2D()->common()->relu6()) {
+            MNN_ERROR("Scale and ReLU6 are not merged into convolution\n");
+            return false;
+        }
+        if (nullptr != factor->expr().first->get() || factor->readMap<float>()[0] != 7.0f) {
+            MNN_ERROR("Constant is not folded\n");
+            return false;
+        }
+        auto add = z->expr().first;
+        if (add->inputs()[0]->expr().first->inputs()[0]->expr().first->inside() !=
+            add->inputs()[1]->expr().first->inside()) {
+            MNN_ERROR("Common sigmoid is not shared\n");
+            return false;
+        }
+
+        auto outputPtr = z->readMap<float>();
+        for (int i = 0; i < size; ++i) {
+            if (fabsf(outputPtr[i] - expects[i]) > 1e-4f) {
+                MNN_ERROR("Optimized result error at %d: %f - %f\n", i, outputPtr[i], expects[i]);
+                return false;
+            }
+        }
+        return true;
+    }
+};
+MNNTestSuiteRegister(OptimizerTest, "expr/optimizer");
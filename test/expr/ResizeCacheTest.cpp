@@ -0,0 +1,82 @@
+//
+//  ResizeCacheTest.cpp
+//  MNNTests
+//
+//  Created by MNN on 2020/04/28.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <math.h>
+#include <MNN/Interpreter.hpp>
+#include <MNN/expr/ExprCreator.hpp>
+#include "MNNTestSuite.h"
+#include "MNN_generated.h"
+using namespace MNN::Express;
+using namespace MNN;
+
+class ResizeCacheTest : public MNNTestCase {
+public:
+    static std::vector<float> compute(Interpreter* interp, Session* session, int size) {
+        auto input = interp->getSessionInput(session, nullptr);
+        interp->resizeTensor(input, {1, input->channel(), size, size});
+        interp->resizeSession(session);
+        std::unique_ptr<Tensor> inputHost(Tensor::createHostTensorFromDevice(input, false));
+        for (int i = 0; i < inputHost->elementSize(); ++i) {
+            inputHost->host<float>()[i] = (float)(i % 19 - 9) / 9.0f;
+        }
+        input->copyFromHostTensor(inputHost.get());
+        interp->runSession(session);
+        auto output = interp->getSessionOutput(session, nullptr);
+        std::unique_ptr<Tensor> outputHost(Tensor::createHostTensorFromDevice(output, true));
+        return std::vector<float>(outputHost->host<float>(), outputHost->host<float>() + outputHost->elementSize());
+    }
+    virtual bool run() {
+        const int ic = 4, oc = 8;
+        auto x = _Input({1, ic, 8, 8}, NC4HW4, halide_type_of<float>());
+        std::vector<float> weight(oc * ic * 9), bias(oc);
+        for (int i = 0; i < weight.size(); ++i) {
+            weight[i] = (float)(i % 11 - 5) / 16.0f;
+        }
+        for (int i = 0; i < oc; ++i) {
+            bias[i] = (float)i / oc;
+        }
+        auto y = _Conv(std::move(weight), std::move(bias), x, {ic, oc}, {3, 3}, SAME);
+        y      = _MaxPool(_Relu(y), {2, 2}, {2, 2});
+        y      = _Convert(_Sigmoid(y), NCHW);
+        std::unique_ptr<NetT> net(new NetT);
+        Variable::save({y}, net.get());
+        flatbuffers::FlatBufferBuilder builder(1024);
+        auto len = Net::Pack(builder, net.get());
+        builder.Finish(len);
+        std::shared_ptr<Interpreter> interp(Interpreter::createFromBuffer(builder.GetBufferPointer(), builder.GetSize()));
+        ScheduleConfig config;
+        config.numThread = 1;
+        auto reference   = interp->createSession(config);
+        auto session     = interp->createSession(config);
+        interp->setSessionResizeCache(session, 2);
+
+        // Session is resized to 8 before the cache is enabled, 24 evicts 8 and 8 evicts 16
+        const std::vector<int> sizes = {8, 16, 8, 16, 24, 8, 24};
+        for (auto size : sizes) {
+            auto expect = compute(interp.get(), reference, size);
+            auto result = compute(interp.get(), session, size);
+            if (result.size() != expect.size()) {
+                MNN_ERROR("Resize cache output size mismatch for %d\n", size);
+                return false;
+            }
+            for (int i = 0; i < expect.size(); ++i) {
+                if (fabsf(result[i] - expect[i]) > 1e-5f) {
+                    MNN_ERROR("Resize cache error for %d at %d: %f - %f\n", size, i, result[i], expect[i]);
+                    return false;
+                }
+            }
+        }
+        auto stats = interp->getSessionResizeCacheStats(session);
+        if (stats.first != 2 || stats.second != 4) {
+            MNN_ERROR("Resize cache hit %d, miss %d\n", stats.first, stats.second);
+            return false;
+        }
+        return true;
+    }
+};
+MNNTestSuiteRegister(ResizeCacheTest, "expr/ResizeCache");
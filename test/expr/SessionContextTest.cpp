@@ -0,0 +1,112 @@
+//
+//  SessionContextTest.cpp
+//  MNNTests
+//
+//  Created by MNN on 2020/04/20.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <math.h>
+#include <thread>
+#include <MNN/expr/ExprCreator.hpp>
+#include <MNN/Interpreter.hpp>
+#include "MNNTestSuite.h"
+#include "MNN_generated.h"
+using namespace MNN::Express;
+using namespace MNN;
+
+static void _fillInput(Tensor* input, int seed) {
+    std::unique_ptr<Tensor> inputHost(Tensor::createHostTensorFromDevice(input, false));
+    auto size = inputHost->elementSize();
+    for (int i = 0; i < size; ++i) {
+        inputHost->host<float>()[i] = (float)((i * 7 + seed * 13) % 17) / 17.0f;
+    }
+    input->copyFromHostTensor(inputHost.get());
+}
+
+static std::vector<float> _readOutput(Tensor* output) {
+    std::unique_ptr<Tensor> outputHost(Tensor::createHostTensorFromDevice(output, true));
+    auto size = outputHost->elementSize();
+    return std::vector<float>(outputHost->host<float>(), outputHost->host<float>() + size);
+}
+
+class SessionContextTest : public MNNTestCase {
+public:
+    virtual bool run() {
+        const int ic = 4, oc = 8, size = 12;
+        auto x = _Input({1, ic, size, size}, NC4HW4, halide_type_of<float>());
+        std::vector<float> weight3x3(oc * ic * 9), weight1x1(oc * oc), bias(oc);
+        for (int i = 0; i < weight3x3.size(); ++i) {
+            weight3x3[i] = (float)(i % 11 - 5) / 11.0f;
+        }
+        for (int i = 0; i < weight1x1.size(); ++i) {
+            weight1x1[i] = (float)(i % 7 - 3) / 7.0f;
+        }
+        for (int i = 0; i < oc; ++i) {
+            bias[i] = (float)i / oc;
+        }
+        auto bias1 = bias;
+        auto y     = _Conv(std::move(weight3x3), std::move(bias), x, {ic, oc}, {3, 3}, SAME);
+        y          = _Conv(std::move(weight1x1), std::move(bias1), y, {oc, oc}, {1, 1});
+        y          = _Convert(y, NCHW);
+        std::unique_ptr<MNN::NetT> net(new NetT);
+        Variable::save({y}, net.get());
+        flatbuffers::FlatBufferBuilder builderOutput(1024);
+        auto len = MNN::Net::Pack(builderOutput, net.get());
+        builderOutput.Finish(len);
+
+        std::shared_ptr<Interpreter> interp(
+            Interpreter::createFromBuffer(builderOutput.GetBufferPointer(), builderOutput.GetSize()));
+        ScheduleConfig config;
+        auto session = interp->createSession(config);
+        const int contextNumber = 2;
+        std::vector<Session*> contexts(contextNumber);
+        for (int i = 0; i < contextNumber; ++i) {
+            contexts[i] = interp->createSessionContext(session);
+            if (nullptr == contexts[i]) {
+                MNN_ERROR("Create session context failed\n");
+                return false;
+            }
+        }
+
+        // Reference results computed serially on the source session
+        std::vector<std::vector<float>> expects(contextNumber);
+        for (int i = 0; i < contextNumber; ++i) {
+            _fillInput(interp->getSessionInput(session, nullptr), i);
+            interp->runSession(session);
+            expects[i] = _readOutput(interp->getSessionOutput(session, nullptr));
+        }
+
+        std::vector<std::vector<float>> results(contextNumber);
+        std::vector<std::thread> threads;
+        for (int i = 0; i < contextNumber; ++i) {
+            threads.emplace_back([&, i]() {
+                for (int loop = 0; loop < 10; ++loop) {
+                    _fillInput(interp->getSessionInput(contexts[i], nullptr), i);
+                    interp->runSession(contexts[i]);
+                    results[i] = _readOutput(interp->getSessionOutput(contexts[i], nullptr));
+                }
+            });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        for (int i = 0; i < contextNumber; ++i) {
+            if (results[i].size() != expects[i].size()) {
+                MNN_ERROR("Context %d output size mismatch\n", i);
+                return false;
+            }
+            for (int j = 0; j < expects[i].size(); ++j) {
+                if (fabsf(results[i][j] - expects[i][j]) > 1e-4f) {
+                    MNN_ERROR("Context %d error at %d: %f - %f\n", i, j, results[i][j], expects[i][j]);
+                    return false;
+                }
+            }
+        }
+        for (auto c : contexts) {
+            interp->releaseSession(c);
+        }
+        return true;
+    }
+};
+MNNTestSuiteRegister(SessionContextTest, "expr/SessionContext");
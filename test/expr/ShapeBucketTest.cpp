@@ -0,0 +1,93 @@
+//
+//  ShapeBucketTest.cpp
+//  MNNTests
+//
+//  Created by MNN on 2020/04/29.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <math.h>
+#include <MNN/Interpreter.hpp>
+#include <MNN/expr/ExprCreator.hpp>
+#include "MNNTestSuite.h"
+#include "MNN_generated.h"
+using namespace MNN::Express;
+using namespace MNN;
+
+class ShapeBucketTest : public MNNTestCase {
+public:
+    static std::vector<float> compute(Interpreter* interp, Session* session, int length) {
+        auto input = interp->getSessionInput(session, nullptr);
+        interp->resizeTensor(input, {1, input->channel(), 1, length});
+        interp->resizeSession(session);
+        std::unique_ptr<Tensor> inputHost(Tensor::createHostTensorFromDevice(input, false));
+        for (int i = 0; i < inputHost->elementSize(); ++i) {
+            inputHost->host<float>()[i] = (float)(i % 13 - 6) / 6.0f;
+        }
+        input->copyFromHostTensor(inputHost.get());
+        interp->runSession(session);
+        auto output = interp->getSessionOutput(session, nullptr);
+        std::unique_ptr<Tensor> outputHost(Tensor::createHostTensorFromDevice(output, true));
+        return std::vector<float>(outputHost->host<float>(), outputHost->host<float>() + outputHost->elementSize());
+    }
+    virtual bool run() {
+        const int ic = 4, oc = 8;
+        auto x = _Input({1, ic, 1, 8}, NCHW, halide_type_of<float>());
+        x->setName("x");
+        std::vector<float> weight(oc * ic), bias(oc);
+        for (int i = 0; i < weight.size(); ++i) {
+            weight[i] = (float)(i % 7 - 3) / 4.0f;
+        }
+        for (int i = 0; i < oc; ++i) {
+            bias[i] = (float)i / oc;
+        }
+        auto y = _Conv(std::move(weight), std::move(bias), _Convert(x, NC4HW4), {ic, oc}, {1, 1});
+        y      = _Convert(_Sigmoid(y), NCHW);
+        y->setName("y");
+        std::unique_ptr<NetT> net(new NetT);
+        Variable::save({y}, net.get());
+        flatbuffers::FlatBufferBuilder builder(1024);
+        auto len = Net::Pack(builder, net.get());
+        builder.Finish(len);
+        std::shared_ptr<Interpreter> interp(Interpreter::createFromBuffer(builder.GetBufferPointer(), builder.GetSize()));
+        ScheduleConfig config;
+        config.numThread = 1;
+        auto reference   = interp->createSession(config);
+        auto session     = interp->createSession(config);
+        ShapeBucket bucket;
+        bucket.input   = "x";
+        bucket.axis    = 3;
+        bucket.sizes   = {8, 16, 32};
+        bucket.outputs = {std::make_pair(std::string("y"), 3)};
+        if (NO_ERROR != interp->setSessionShapeBuckets(session, {bucket})) {
+            MNN_ERROR("Set shape bucket failed\n");
+            return false;
+        }
+        interp->setSessionResizeCache(session, 4);
+
+        // 5 is in the bucket of model shape, 12, 7 and 30 prepare new buckets, 40 is larger than all buckets
+        const std::vector<int> lengths = {5, 12, 7, 16, 30, 7, 13, 40};
+        for (auto length : lengths) {
+            auto expect = compute(interp.get(), reference, length);
+            auto result = compute(interp.get(), session, length);
+            auto output = interp->getSessionOutput(session, "y");
+            if (output->length(3) != length || result.size() != expect.size()) {
+                MNN_ERROR("Shape bucket output size mismatch for %d\n", length);
+                return false;
+            }
+            for (int i = 0; i < expect.size(); ++i) {
+                if (fabsf(result[i] - expect[i]) > 1e-5f) {
+                    MNN_ERROR("Shape bucket error for %d at %d: %f - %f\n", length, i, result[i], expect[i]);
+                    return false;
+                }
+            }
+        }
+        auto stats = interp->getSessionResizeCacheStats(session);
+        if (stats.first != 3 || stats.second != 4) {
+            MNN_ERROR("Shape bucket resize hit %d, miss %d\n", stats.first, stats.second);
+            return false;
+        }
+        return true;
+    }
+};
+MNNTestSuiteRegister(ShapeBucketTest, "expr/ShapeBucket");
@@ -6,7 +6,7 @@
 //  Copyright © 2018, Alibaba Group Holding Limited
 //
 
-
+#include <MNN/expr/Executor.hpp>
 #include <MNN/expr/Expr.hpp>
 #include <MNN/expr/ExprCreator.hpp>
 #include "MNNTestSuite.h"
@@ -74,5 +74,67 @@ public:
         return true;
     }
 };
+// Large rows are split among threads and other axes are compared by contiguous keys, the first index wins ties
+class ArgMaxLargeTest : public MNNTestCase {
+public:
+    virtual ~ArgMaxLargeTest() = default;
+    static bool test(const std::vector<int>& shape, int axis, bool isMax) {
+        auto input = _Input(shape, NHWC);
+        auto size  = input->getInfo()->size;
+        auto ptr   = input->writeMap<float>();
+        for (int i = 0; i < size; ++i) {
+            ptr[i] = (float)((i * 7919) % 1009);
+        }
+        auto output = isMax ? _ArgMax(input, axis) : _ArgMin(input, axis);
+        auto result = output->readMap<int>();
+        int outside = 1, inside = 1;
+        for (int i = 0; i < axis; ++i) {
+            outside *= shape[i];
+        }
+        for (int i = axis + 1; i < shape.size(); ++i) {
+            inside *= shape[i];
+        }
+        const int dim = shape[axis];
+        for (int o = 0; o < outside; ++o) {
+            for (int i = 0; i < inside; ++i) {
+                auto src  = ptr + o * dim * inside + i;
+                int index = 0;
+                for (int j = 1; j < dim; ++j) {
+                    if (isMax ? src[j * inside] > src[index * inside] : src[j * inside] < src[index * inside]) {
+                        index = j;
+                    }
+                }
+                if (result[o * inside + i] != index) {
+                    MNN_ERROR("ArgMaxLargeTest failed for axis %d, isMax %d at %d, %d: %d - %d\n", axis, isMax, o, i,
+                              result[o * inside + i], index);
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+    static bool testAll() {
+        bool res = true;
+        for (int isMax = 0; isMax <= 1; ++isMax) {
+            res = res && test({3, 70001}, 1, isMax);
+            res = res && test({1, 100000}, 1, isMax);
+            res = res && test({9, 1000}, 1, isMax);
+            res = res && test({5, 37, 9}, 1, isMax);
+            res = res && test({2, 3, 4099}, 1, isMax);
+            res = res && test({1000, 3}, 0, isMax);
+        }
+        return res;
+    }
+    virtual bool run() {
+        bool res = testAll();
+        MNN::BackendConfig config;
+        auto executor = Executor::getGlobalExecutor();
+        executor->setGlobalExecutorConfig(MNN_FORWARD_CPU, config, 4);
+        res = res && testAll();
+        executor->setGlobalExecutorConfig(MNN_FORWARD_CPU, config, 1);
+        return res;
+    }
+};
 MNNTestSuiteRegister(ArgMaxTest, "op/argmax");
 MNNTestSuiteRegister(ArgMinTest, "op/argmin");
+MNNTestSuiteRegister(ArgMaxLargeTest, "op/argmax_large");
@@ -0,0 +1,127 @@
+//
+//  BatchMatMulTest.cpp
+//  MNNTests
+//
+//  Created by MNN on 2020/05/06.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+#include <math.h>
+#include <algorithm>
+#include <vector>
+#include <MNN/expr/Executor.hpp>
+#include <MNN/expr/ExprCreator.hpp>
+#include "MNNTestSuite.h"
+#include "TestUtils.h"
+
+using namespace MNN::Express;
+using std::vector;
+
+class BatchMatMulTest : public MNNTestCase {
+public:
+    virtual ~BatchMatMulTest() = default;
+    // Index of the broadcasted batch in a tensor of shape, shape has the same rank as the output
+    static int batchIndex(const vector<int>& shape, const vector<int>& outShape, int index) {
+        int result = 0, stride = 1;
+        for (int i = (int)outShape.size() - 3; i >= 0; --i) {
+            auto cord = index % outShape[i];
+            index     = index / outShape[i];
+            result += (shape[i] > 1 ? cord : 0) * stride;
+            stride *= shape[i];
+        }
+        return result;
+    }
+    static bool test(vector<int> aShape, vector<int> bShape, bool adjX, bool adjY, bool matmulOp) {
+        auto a = _Input(aShape, NCHW);
+        auto b = _Input(bShape, NCHW);
+        auto c = matmulOp ? _MatMul(a, b, adjX, adjY) : _BatchMatMul(a, b, adjX, adjY);
+        auto aSize = a->getInfo()->size, bSize = b->getInfo()->size;
+        auto aPtr  = a->writeMap<float>();
+        auto bPtr  = b->writeMap<float>();
+        for (int i = 0; i < aSize; ++i) {
+            aPtr[i] = (float)((i * 7) % 19 - 9) / 9.0f;
+        }
+        for (int i = 0; i < bSize; ++i) {
+            bPtr[i] = (float)((i * 5) % 13 - 6) / 6.0f;
+        }
+        auto cInfo = c->getInfo();
+        if (nullptr == cInfo) {
+            MNN_ERROR("BatchMatMul shape compute failed\n");
+            return false;
+        }
+        auto outShape = cInfo->dim;
+        auto rank     = (int)outShape.size();
+        // Align the batch dimensions of inputs to the output
+        while (aShape.size() < rank) {
+            aShape.insert(aShape.begin(), 1);
+        }
+        while (bShape.size() < rank) {
+            bShape.insert(bShape.begin(), 1);
+        }
+        int e = outShape[rank - 2], h = outShape[rank - 1];
+        int l = adjX ? aShape[rank - 2] : aShape[rank - 1];
+        int batch = cInfo->size / e / h;
+        auto cPtr = c->readMap<float>();
+        for (int n = 0; n < batch; ++n) {
+            auto A = aPtr + batchIndex(aShape, outShape, n) * e * l;
+            auto B = bPtr + batchIndex(bShape, outShape, n) * l * h;
+            auto C = cPtr + n * e * h;
+            for (int y = 0; y < e; ++y) {
+                for (int x = 0; x < h; ++x) {
+                    float expect = 0.0f;
+                    for (int k = 0; k < l; ++k) {
+                        expect += (adjX ? A[k * e + y] : A[y * l + k]) * (adjY ? B[x * l + k] : B[k * h + x]);
+                    }
+                    if (fabsf(C[y * h + x] - expect) > 1e-4f * (1.0f + fabsf(expect))) {
+                        MNN_ERROR("BatchMatMul error at batch %d (%d, %d), adjX=%d, adjY=%d: %f - %f\n", n, y, x, adjX,
+                                  adjY, C[y * h + x], expect);
+                        return false;
+                    }
+                }
+            }
+        }
+        return true;
+    }
+    static bool testAll() {
+        // {A, B}, the last two dimensions are [e, l] x [l, h] before transpose
+        const vector<vector<vector<int>>> shapes = {
+            {{3, 5, 7}, {3, 7, 4}},                 // Same batch
+            {{2, 3, 33, 17}, {2, 3, 17, 9}},        // e cross the pack unit
+            {{4, 1, 19, 8}, {1, 3, 8, 13}},         // Broadcast both
+            {{2, 3, 6, 5}, {5, 11}},                // B has lower rank
+            {{9, 4}, {2, 2, 4, 50}},                // A has lower rank
+            {{1, 100, 3}, {6, 3, 1}},               // Large e with small batch
+            {{12, 64, 32}, {12, 32, 64}},           // Attention like
+        };
+        for (auto& s : shapes) {
+            for (int i = 0; i < 8; ++i) {
+                bool adjX = i % 2 == 1, adjY = (i / 2) % 2 == 1, matmulOp = i / 4 == 1;
+                auto aShape = s[0], bShape = s[1];
+                if (matmulOp && (aShape.size() < 3 && bShape.size() < 3)) {
+                    continue;
+                }
+                if (adjX) {
+                    std::swap(aShape[aShape.size() - 1], aShape[aShape.size() - 2]);
+                }
+                if (adjY) {
+                    std::swap(bShape[bShape.size() - 1], bShape[bShape.size() - 2]);
+                }
+                if (!test(aShape, bShape, adjX, adjY, matmulOp)) {
+                    MNN_ERROR("Shape index %d, matmulOp=%d\n", (int)(&s - shapes.data()), matmulOp);
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+    virtual bool run() {
+        bool res = testAll();
+        // Check the split of batches and rows with multi threads
+        MNN::BackendConfig config;
+        auto executor = Executor::getGlobalExecutor();
+        executor->setGlobalExecutorConfig(MNN_FORWARD_CPU, config, 4);
+        res = res && testAll();
+        executor->setGlobalExecutorConfig(MNN_FORWARD_CPU, config, 1);
+        return res;
+    }
+};
+MNNTestSuiteRegister(BatchMatMulTest, "op/batch_matmul");
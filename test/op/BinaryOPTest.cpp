@@ -5,6 +5,10 @@
 //  Created by MNN on 2019/01/15.
 //  Copyright © 2018, Alibaba Group Holding Limited
 //
+#include <math.h>
+#include <algorithm>
+#include <string>
+#include <MNN/expr/Executor.hpp>
 #include <MNN/expr/Expr.hpp>
 #include <MNN/expr/ExprCreator.hpp>
 #include "MNNTestSuite.h"
@@ -599,6 +603,113 @@ public:
     }
 };
 
+// Check general broadcast patterns against a reference computed by indexes, the pattern is listed as pairs of shapes
+class BinaryBroadcastTest : public MNNTestCase {
+public:
+    virtual ~BinaryBroadcastTest() = default;
+    template <typename T, typename Tout>
+    static bool check(const std::vector<int>& shape0, const std::vector<int>& shape1, VARP (*op)(VARP, VARP),
+                      Tout (*reference)(T, T), const char* name) {
+        auto x = _Input(shape0, NCHW, halide_type_of<T>());
+        auto y = _Input(shape1, NCHW, halide_type_of<T>());
+        auto xPtr = x->template writeMap<T>();
+        auto yPtr = y->template writeMap<T>();
+        for (int i = 0; i < x->getInfo()->size; ++i) {
+            xPtr[i] = (T)((i * 7) % 23 - 11);
+        }
+        for (int i = 0; i < y->getInfo()->size; ++i) {
+            yPtr[i] = (T)((i * 5) % 17 + 1);
+        }
+        auto z        = op(x, y);
+        auto outShape = z->getInfo()->dim;
+        auto zPtr     = z->template readMap<Tout>();
+        const int dimensions = (int)outShape.size();
+        for (int index = 0; index < z->getInfo()->size; ++index) {
+            int i0 = 0, i1 = 0, s0 = 1, s1 = 1;
+            int c  = index;
+            for (int d = dimensions - 1; d >= 0; --d) {
+                auto cord = c % outShape[d];
+                c         = c / outShape[d];
+                auto d0   = d - (dimensions - (int)shape0.size());
+                auto d1   = d - (dimensions - (int)shape1.size());
+                if (d0 >= 0) {
+                    i0 += (shape0[d0] > 1 ? cord : 0) * s0;
+                    s0 *= shape0[d0];
+                }
+                if (d1 >= 0) {
+                    i1 += (shape1[d1] > 1 ? cord : 0) * s1;
+                    s1 *= shape1[d1];
+                }
+            }
+            auto expect = reference(xPtr[i0], yPtr[i1]);
+            if (fabs((double)zPtr[index] - (double)expect) > 1e-5 * (1.0 + fabs((double)expect))) {
+                MNN_ERROR("%s broadcast error at %d: %f - %f\n", name, index, (double)zPtr[index], (double)expect);
+                return false;
+            }
+        }
+        return true;
+    }
+    static bool testShapes(const std::vector<int>& shape0, const std::vector<int>& shape1) {
+        bool res = true;
+        res      = res && check<float, float>(shape0, shape1, _Add, [](float x, float y) { return x + y; }, "Add");
+        res = res && check<float, float>(shape0, shape1, _Subtract, [](float x, float y) { return x - y; }, "Sub");
+        res = res && check<float, float>(shape0, shape1, _Multiply, [](float x, float y) { return x * y; }, "Mul");
+        res = res && check<float, float>(shape0, shape1, _Divide, [](float x, float y) { return x / y; }, "Div");
+        res = res && check<float, float>(shape0, shape1, _Minimum, [](float x, float y) { return std::min(x, y); }, "Min");
+        res = res && check<float, float>(shape0, shape1, _Maximum, [](float x, float y) { return std::max(x, y); }, "Max");
+        res = res && check<float, float>(shape0, shape1, _SquaredDifference,
+                                         [](float x, float y) { return (x - y) * (x - y); }, "SquaredDifference");
+        res = res && check<float, int>(shape0, shape1, _Greater, [](float x, float y) { return x > y ? 1 : 0; },
+                                       "Greater");
+        res = res && check<int, int>(shape0, shape1, _Add, [](int x, int y) { return x + y; }, "Int Add");
+        res = res && check<int, int>(shape0, shape1, _Multiply, [](int x, int y) { return x * y; }, "Int Mul");
+        res = res && check<int, int>(shape0, shape1, _Less, [](int x, int y) { return x < y ? 1 : 0; }, "Int Less");
+        if (!res) {
+            MNN_ERROR("Broadcast test failed for %s - %s\n", _shapeString(shape0).c_str(),
+                      _shapeString(shape1).c_str());
+        }
+        return res;
+    }
+    static std::string _shapeString(const std::vector<int>& shape) {
+        std::string result;
+        for (auto v : shape) {
+            result += std::to_string(v) + ",";
+        }
+        return result;
+    }
+    static bool testAll() {
+        const std::vector<std::vector<std::vector<int>>> shapes = {
+            {{2, 3, 17}, {2, 3, 17}},        // Same shape
+            {{2, 3, 17}, {1}},               // Scalar
+            {{1}, {5, 9}},                   // Scalar first
+            {{4, 13}, {13}},                 // Bias
+            {{4, 13, 1}, {13, 1}},           // Channel
+            {{3, 1, 7}, {1, 5, 1}},          // Both broadcast
+            {{2, 1, 3, 1, 5}, {1, 4, 1, 6, 5}},
+            {{6, 1}, {1, 35}},               // Outer product
+            {{2, 3, 4, 5}, {3, 1, 5}},       // Mixed
+            {{1, 1, 1}, {1, 1}},             // Single element
+            {{0, 3}, {3}},                   // Empty
+        };
+        for (auto& s : shapes) {
+            if (!testShapes(s[0], s[1])) {
+                return false;
+            }
+        }
+        return true;
+    }
+    virtual bool run() {
+        bool res = testAll();
+        // Check the split of output inside a span with multi threads
+        MNN::BackendConfig config;
+        auto executor = Executor::getGlobalExecutor();
+        executor->setGlobalExecutorConfig(MNN_FORWARD_CPU, config, 4);
+        res = res && testAll();
+        executor->setGlobalExecutorConfig(MNN_FORWARD_CPU, config, 1);
+        return res;
+    }
+};
+
 MNNTestSuiteRegister(BinaryBroadcastShapeTest, "op/binary/broadcastShapeTest");
 MNNTestSuiteRegister(AddTest, "op/binary/add");
 MNNTestSuiteRegister(SubtractTest, "op/binary/subtract");
@@ -620,3 +731,4 @@ MNNTestSuiteRegister(Atan2Test, "op/binary/atan2");
 MNNTestSuiteRegister(LogicalOrTest, "op/binary/logicalor");
 MNNTestSuiteRegister(NotEqualTest, "op/binary/notqual");
 MNNTestSuiteRegister(SubtractBroastTest, "op/binary/subtractBroastTest");
+MNNTestSuiteRegister(BinaryBroadcastTest, "op/binary/broadcast");
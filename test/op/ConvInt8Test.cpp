@@ -116,3 +116,83 @@ public:
     }
 };
 MNNTestSuiteRegister(ConvInt8Test, "op/ConvInt8");
+
+class DepthwiseConvInt8Test : public MNNTestCase {
+public:
+    static bool _testKernel(INTS kernel, INTS strides, INTS dilate) {
+        const int channel = 11;
+        INTS pad          = {1, 2};
+        std::vector<int> bias(channel);
+        std::vector<float> scale(channel);
+        std::vector<int8_t> weight(channel * kernel[0] * kernel[1]);
+        VARP x     = _Input({1, channel, 61, 67}, NC4HW4, halide_type_of<int8_t>());
+        auto xInfo = x->getInfo();
+        auto xPtr  = x->writeMap<int8_t>();
+        for (int i = 0; i < xInfo->size; ++i) {
+            xPtr[i] = (i % 254) - 127;
+        }
+        for (int i = 0; i < channel; ++i) {
+            bias[i]  = (1000 + i * i * 10 - i * i * i) % 1258;
+            scale[i] = ((127 - i) * i % 128) / 2000.0f;
+            for (int k = 0; k < kernel[0] * kernel[1]; ++k) {
+                weight[i * kernel[0] * kernel[1] + k] = ((i * i + k * k) % 254) - 127;
+            }
+        }
+        auto originWeight = weight;
+        auto originBias   = bias;
+        auto originScale  = scale;
+        auto y = _Conv(std::move(weight), std::move(bias), std::move(scale), x, {channel, channel}, kernel,
+                       PaddingMode::CAFFE, strides, dilate, channel, pad, false);
+        auto yInfo = y->getInfo();
+        auto yPtr  = y->readMap<int8_t>();
+        auto ow    = yInfo->dim[3];
+        auto oh    = yInfo->dim[2];
+        auto iw    = xInfo->dim[3];
+        auto ih    = xInfo->dim[2];
+        for (int oz = 0; oz < channel; ++oz) {
+            auto srcPtr = xPtr + (oz / 4) * iw * ih * 4 + oz % 4;
+            for (int oy = 0; oy < oh; ++oy) {
+                for (int ox = 0; ox < ow; ++ox) {
+                    int32_t sum = 0;
+                    for (int ky = 0; ky < kernel[1]; ++ky) {
+                        int sy = ky * dilate[1] + oy * strides[1] - pad[1];
+                        if (sy >= ih || sy < 0) {
+                            continue;
+                        }
+                        for (int kx = 0; kx < kernel[0]; ++kx) {
+                            int sx = kx * dilate[0] + ox * strides[0] - pad[0];
+                            if (sx >= iw || sx < 0) {
+                                continue;
+                            }
+                            sum += (int)srcPtr[sx * 4 + sy * iw * 4] *
+                                   (int)originWeight[(oz * kernel[1] + ky) * kernel[0] + kx];
+                        }
+                    }
+                    auto targetValue   = int32ToInt8(sum, originBias[oz], originScale[oz]);
+                    auto computeResult = yPtr[((oz / 4) * oh * ow + ow * oy + ox) * 4 + oz % 4];
+                    if (targetValue != computeResult) {
+                        MNN_PRINT("DepthwiseConvInt8 result Error: %d -> %d\n", targetValue, computeResult);
+                        return false;
+                    }
+                }
+            }
+        }
+        return true;
+    }
+    virtual bool run() {
+        if (!_testKernel({3, 3}, {1, 1}, {1, 1})) {
+            MNN_ERROR("Error for test kernel 3x3 for depthwise convint8\n");
+            return false;
+        }
+        if (!_testKernel({3, 3}, {2, 2}, {1, 1})) {
+            MNN_ERROR("Error for test kernel 3x3, stride 2 for depthwise convint8\n");
+            return false;
+        }
+        if (!_testKernel({5, 3}, {1, 1}, {2, 2})) {
+            MNN_ERROR("Error for test kernel 5x3, dilate 2 for depthwise convint8\n");
+            return false;
+        }
+        return true;
+    }
+};
+MNNTestSuiteRegister(DepthwiseConvInt8Test, "op/DepthwiseConvInt8");
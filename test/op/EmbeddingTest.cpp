@@ -0,0 +1,254 @@
+//
+//  EmbeddingTest.cpp
+//  MNNTests
+//
+//  Created by MNN on 2020/05/11.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <math.h>
+#include <vector>
+#include <MNN/expr/Executor.hpp>
+#include <MNN/expr/ExprCreator.hpp>
+#include <MNN/Interpreter.hpp>
+#include "MNNTestSuite.h"
+#include "MNN_generated.h"
+#include "TestUtils.h"
+#include "half.hpp"
+
+using namespace MNN::Express;
+
+// Lookups of big tables by Gather, GatherV2, GatherND and ScatterNd, which are split among threads by rows
+class EmbeddingTest : public MNNTestCase {
+public:
+    virtual ~EmbeddingTest() = default;
+    static std::vector<int> randomIndices(int size, int limit) {
+        std::vector<int> indices(size);
+        for (int i = 0; i < size; ++i) {
+            indices[i] = (int)(((int64_t)i * 7919 + 13) % limit);
+        }
+        return indices;
+    }
+    static bool check(const float* result, const std::vector<float>& expect, const char* name) {
+        for (int i = 0; i < expect.size(); ++i) {
+            if (fabsf(result[i] - expect[i]) > 1e-5f) {
+                MNN_ERROR("%s error at %d: %f - %f\n", name, i, result[i], expect[i]);
+                return false;
+            }
+        }
+        return true;
+    }
+    // Gather along axis of [outside, rows, width] table for all types of table
+    static bool testGather(int outside, int rows, int width, int axis, int count) {
+        auto indicesValue = randomIndices(count, axis == 0 ? outside : rows);
+        auto indices      = _Const(indicesValue.data(), {count}, NHWC, halide_type_of<int32_t>());
+        const int total   = outside * rows * width;
+        std::vector<float> table(total);
+        for (int i = 0; i < total; ++i) {
+            table[i] = (float)(i % 255 - 127) / 64.0f;
+        }
+        // The expect of axis 0 and 1
+        std::vector<float> expect;
+        if (axis == 0) {
+            for (auto index : indicesValue) {
+                expect.insert(expect.end(), table.begin() + index * rows * width,
+                              table.begin() + (index + 1) * rows * width);
+            }
+        } else {
+            for (int o = 0; o < outside; ++o) {
+                for (auto index : indicesValue) {
+                    auto row = table.begin() + (o * rows + index) * width;
+                    expect.insert(expect.end(), row, row + width);
+                }
+            }
+        }
+        auto axisVar = _Scalar<int32_t>(axis);
+        // float
+        {
+            auto params = _Const(table.data(), {outside, rows, width}, NHWC);
+            auto output = _GatherV2(params, indices, axisVar);
+            if (!check(output->readMap<float>(), expect, "GatherV2 float")) {
+                return false;
+            }
+            if (axis == 0 && !check(_Gather(params, indices)->readMap<float>(), expect, "Gather float")) {
+                return false;
+            }
+        }
+        // float16 table created by express, see testSession for the DT_HALF blobs of models
+        {
+            std::vector<half_float::half> halfTable(table.begin(), table.end());
+            auto params = _Const(halfTable.data(), {outside, rows, width}, NHWC, halide_type_t(halide_type_float, 16));
+            auto output = _GatherV2(params, indices, axisVar);
+            if (output->getInfo()->type != halide_type_of<float>() ||
+                !check(output->readMap<float>(), expect, "GatherV2 float16")) {
+                return false;
+            }
+        }
+        // int8 with scales of each index along axis
+        {
+            const int limit = axis == 0 ? outside : rows;
+            std::vector<int8_t> int8Table(total);
+            std::vector<float> scales(limit);
+            for (int i = 0; i < limit; ++i) {
+                scales[i] = 1.0f / (i % 7 + 1);
+            }
+            std::vector<float> int8Expect;
+            for (int o = 0; o < (axis == 0 ? 1 : outside); ++o) {
+                for (auto index : indicesValue) {
+                    int begin = axis == 0 ? index * rows * width : (o * rows + index) * width;
+                    int size  = axis == 0 ? rows * width : width;
+                    for (int i = begin; i < begin + size; ++i) {
+                        int8Expect.emplace_back((float)(int8_t)(i % 255 - 127) * scales[index]);
+                    }
+                }
+            }
+            for (int i = 0; i < total; ++i) {
+                int8Table[i] = (int8_t)(i % 255 - 127);
+            }
+            auto params = _Const(int8Table.data(), {outside, rows, width}, NHWC, halide_type_of<int8_t>());
+            auto scale  = _Const(scales.data(), {limit}, NHWC);
+            std::unique_ptr<MNN::OpT> op(new MNN::OpT);
+            op->type       = MNN::OpType_GatherV2;
+            op->main.type  = MNN::OpParameter_GatherV2;
+            op->main.value = new MNN::GatherV2T;
+            auto output    = Variable::create(Expr::create(op.get(), {params, indices, axisVar, scale}));
+            if (!check(output->readMap<float>(), int8Expect, "GatherV2 int8")) {
+                return false;
+            }
+            if (axis == 0) {
+                op->type       = MNN::OpType_Gather;
+                op->main.type  = MNN::OpParameter_Gather;
+                op->main.value = new MNN::GatherT;
+                output         = Variable::create(Expr::create(op.get(), {params, indices, scale}));
+                if (!check(output->readMap<float>(), int8Expect, "Gather int8")) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+    // Pick rows of [rows, width] table by GatherND, and add them back by ScatterNd with repeated indices
+    static bool testND(int rows, int width, int count) {
+        auto indicesValue = randomIndices(count, rows);
+        auto indices      = _Const(indicesValue.data(), {count, 1}, NHWC, halide_type_of<int32_t>());
+        std::vector<float> table(rows * width);
+        for (int i = 0; i < rows * width; ++i) {
+            table[i] = (float)(i % 97) / 16.0f;
+        }
+        auto params = _Const(table.data(), {rows, width}, NHWC);
+        auto picked = _GatherND(params, indices);
+        std::vector<float> expect;
+        for (auto index : indicesValue) {
+            expect.insert(expect.end(), table.begin() + index * width, table.begin() + (index + 1) * width);
+        }
+        if (!check(picked->readMap<float>(), expect, "GatherND")) {
+            return false;
+        }
+        const int shapeValue[] = {rows, width};
+        auto scattered = _ScatterNd(indices, picked, _Const(shapeValue, {2}, NHWC, halide_type_of<int32_t>()));
+        std::vector<float> scatterExpect(rows * width, 0.0f);
+        for (int i = 0; i < count; ++i) {
+            for (int k = 0; k < width; ++k) {
+                scatterExpect[indicesValue[i] * width + k] += expect[i * width + k];
+            }
+        }
+        return check(scattered->readMap<float>(), scatterExpect, "ScatterNd");
+    }
+    // Tables of models stay in half or int8 in sessions if they are only read by gather
+    static bool testSession() {
+        const int rows = 300, width = 24, count = 50;
+        auto indicesValue = randomIndices(count, rows);
+        auto indices      = _Input({count}, NHWC, halide_type_of<int32_t>());
+        indices->setName("indices");
+        ::memcpy(indices->writeMap<int32_t>(), indicesValue.data(), count * sizeof(int32_t));
+        std::vector<half_float::half> halfTable(rows * width);
+        std::vector<int8_t> int8Table(rows * width);
+        std::vector<float> scales(rows);
+        for (int i = 0; i < rows * width; ++i) {
+            halfTable[i] = (float)(i % 255 - 127) / 64.0f;
+            int8Table[i] = (int8_t)(i % 255 - 127);
+        }
+        for (int i = 0; i < rows; ++i) {
+            scales[i] = 1.0f / (i % 7 + 1);
+        }
+        auto halfParams = _Const(halfTable.data(), {rows, width}, NHWC, halide_type_t(halide_type_float, 16));
+        auto int8Params = _Const(int8Table.data(), {rows, width}, NHWC, halide_type_of<int8_t>());
+        auto scale      = _Const(scales.data(), {rows}, NHWC);
+        std::unique_ptr<MNN::OpT> op(new MNN::OpT);
+        op->type       = MNN::OpType_GatherV2;
+        op->main.type  = MNN::OpParameter_GatherV2;
+        op->main.value = new MNN::GatherV2T;
+        std::vector<VARP> outputs;
+        outputs.emplace_back(_GatherV2(halfParams, indices, _Scalar<int32_t>(0)));
+        outputs.emplace_back(
+            Variable::create(Expr::create(op.get(), {int8Params, indices, _Scalar<int32_t>(0), scale})));
+        op->type       = MNN::OpType_Gather;
+        op->main.type  = MNN::OpParameter_Gather;
+        op->main.value = new MNN::GatherT;
+        outputs.emplace_back(Variable::create(Expr::create(op.get(), {int8Params, indices, scale})));
+        std::vector<std::vector<float>> expects;
+        for (int i = 0; i < outputs.size(); ++i) {
+            outputs[i]->setName("output" + std::to_string(i));
+            auto ptr = outputs[i]->readMap<float>();
+            expects.emplace_back(ptr, ptr + count * width);
+        }
+        std::unique_ptr<MNN::NetT> net(new MNN::NetT);
+        Variable::save(outputs, net.get());
+        flatbuffers::FlatBufferBuilder builder(1024);
+        builder.Finish(MNN::Net::Pack(builder, net.get()));
+        std::shared_ptr<MNN::Interpreter> interp(
+            MNN::Interpreter::createFromBuffer(builder.GetBufferPointer(), builder.GetSize()));
+        MNN::ScheduleConfig config;
+        auto session = interp->createSession(config);
+        auto input   = interp->getSessionInput(session, "indices");
+        ::memcpy(input->host<int32_t>(), indicesValue.data(), count * sizeof(int32_t));
+        int gathered = 0;
+        bool compact = true;
+        MNN::TensorCallBackWithInfo before = [&](const std::vector<MNN::Tensor*>& inputs,
+                                                 const MNN::OperatorInfo* info) {
+            if (info->type() == "Gather" || info->type() == "GatherV2") {
+                auto type = inputs[0]->getType();
+                compact   = compact &&
+                          (type == halide_type_t(halide_type_float, 16) || type == halide_type_of<int8_t>());
+                gathered++;
+            }
+            return true;
+        };
+        MNN::TensorCallBackWithInfo after = [](const std::vector<MNN::Tensor*>&, const MNN::OperatorInfo*) {
+            return true;
+        };
+        interp->runSessionWithCallBackInfo(session, before, after);
+        if (gathered != outputs.size() || !compact) {
+            MNN_ERROR("Tables of session are not kept compact for gather\n");
+            return false;
+        }
+        for (int i = 0; i < outputs.size(); ++i) {
+            auto output = interp->getSessionOutput(session, ("output" + std::to_string(i)).c_str());
+            if (!check(output->host<float>(), expects[i], "Session gather")) {
+                return false;
+            }
+        }
+        return true;
+    }
+    static bool testAll() {
+        bool res = true;
+        res      = res && testGather(1000, 1, 64, 0, 3000);
+        res      = res && testGather(5000, 2, 33, 0, 777);
+        res      = res && testGather(4, 2000, 16, 1, 1500);
+        res      = res && testGather(3, 7, 5, 1, 4);
+        res      = res && testND(3000, 64, 5000);
+        res      = res && testND(500, 3, 20000);
+        res      = res && testSession();
+        return res;
+    }
+    virtual bool run() {
+        bool res = testAll();
+        MNN::BackendConfig config;
+        auto executor = Executor::getGlobalExecutor();
+        executor->setGlobalExecutorConfig(MNN_FORWARD_CPU, config, 4);
+        res = res && testAll();
+        executor->setGlobalExecutorConfig(MNN_FORWARD_CPU, config, 1);
+        return res;
+    }
+};
+MNNTestSuiteRegister(EmbeddingTest, "op/embedding");
@@ -0,0 +1,112 @@
+//
+//  NonMaxSuppressionTest.cpp
+//  MNNTests
+//
+//  Created by MNN on 2020/05/08.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <math.h>
+#include <algorithm>
+#include <vector>
+#include <MNN/expr/Executor.hpp>
+#include <MNN/expr/ExprCreator.hpp>
+#include "MNNTestSuite.h"
+#include "MNN_generated.h"
+#include "TestUtils.h"
+
+using namespace MNN::Express;
+
+class NonMaxSuppressionTest : public MNNTestCase {
+public:
+    virtual ~NonMaxSuppressionTest() = default;
+    static float iou(const float* a, const float* b) {
+        const float areaA = (std::max(a[0], a[2]) - std::min(a[0], a[2])) * (std::max(a[1], a[3]) - std::min(a[1], a[3]));
+        const float areaB = (std::max(b[0], b[2]) - std::min(b[0], b[2])) * (std::max(b[1], b[3]) - std::min(b[1], b[3]));
+        if (areaA <= 0 || areaB <= 0) {
+            return 0.0f;
+        }
+        const float h = std::max(std::min(std::max(a[0], a[2]), std::max(b[0], b[2])) -
+                                     std::max(std::min(a[0], a[2]), std::min(b[0], b[2])),
+                                 0.0f);
+        const float w = std::max(std::min(std::max(a[1], a[3]), std::max(b[1], b[3])) -
+                                     std::max(std::min(a[1], a[3]), std::min(b[1], b[3])),
+                                 0.0f);
+        return h * w / (areaA + areaB - h * w);
+    }
+    // Greedy reference, the candidates are visited by score descending and index ascending
+    static std::vector<int> reference(const float* boxes, const float* scores, int numBoxes, int maxOut,
+                                      float iouThreshold) {
+        std::vector<int> order(numBoxes);
+        for (int i = 0; i < numBoxes; ++i) {
+            order[i] = i;
+        }
+        std::stable_sort(order.begin(), order.end(), [scores](int a, int b) { return scores[a] > scores[b]; });
+        std::vector<int> selected;
+        for (int i = 0; i < numBoxes && selected.size() < maxOut; ++i) {
+            bool keep = true;
+            for (auto s : selected) {
+                if (iou(boxes + 4 * order[i], boxes + 4 * s) > iouThreshold) {
+                    keep = false;
+                    break;
+                }
+            }
+            if (keep) {
+                selected.push_back(order[i]);
+            }
+        }
+        return selected;
+    }
+    static bool test(int numBoxes, int maxOut, float iouThreshold) {
+        std::unique_ptr<MNN::OpT> op(new MNN::OpT);
+        op->type     = MNN::OpType_NonMaxSuppressionV2;
+        auto boxes   = _Input({numBoxes, 4}, NHWC);
+        auto scores  = _Input({numBoxes}, NHWC);
+        auto output  = Variable::create(
+            Expr::create(op.get(), {boxes, scores, _Scalar<int32_t>(maxOut), _Scalar<float>(iouThreshold)}));
+        auto boxesPtr  = boxes->writeMap<float>();
+        auto scoresPtr = scores->writeMap<float>();
+        for (int i = 0; i < numBoxes; ++i) {
+            // Boxes overlap their neighbours, some of them have reversed corners or zero area
+            float y = (float)((i * 37) % 101), x = (float)((i * 53) % 97);
+            float h = (float)((i * 13) % 17), w = (float)((i * 7) % 19 + 1);
+            boxesPtr[4 * i + 0] = i % 5 == 0 ? y + h : y;
+            boxesPtr[4 * i + 1] = x;
+            boxesPtr[4 * i + 2] = i % 5 == 0 ? y : y + h;
+            boxesPtr[4 * i + 3] = x + w;
+            // Many scores are equal
+            scoresPtr[i] = (float)((i * 7919) % 251) / 251.0f;
+        }
+        auto expect    = reference(boxesPtr, scoresPtr, numBoxes, maxOut, iouThreshold);
+        auto outputPtr = output->readMap<int32_t>();
+        for (int i = 0; i < expect.size(); ++i) {
+            if (outputPtr[i] != expect[i]) {
+                MNN_ERROR("NonMaxSuppression error for %d boxes, max = %d at %d: %d - %d\n", numBoxes, maxOut, i,
+                          outputPtr[i], expect[i]);
+                return false;
+            }
+        }
+        return true;
+    }
+    static bool testAll() {
+        bool res = true;
+        res      = res && test(100, 20, 0.5f);
+        res      = res && test(37, 100, 0.0f);
+        res      = res && test(3000, 3000, 0.3f);
+        res      = res && test(3000, 50, 0.7f);
+        res      = res && test(8000, 8000, 0.5f);
+        res      = res && test(20000, 500, 0.5f);
+        return res;
+    }
+    virtual bool run() {
+        bool res = testAll();
+        // Check the bitmask of iou computed by multi threads
+        MNN::BackendConfig config;
+        auto executor = Executor::getGlobalExecutor();
+        executor->setGlobalExecutorConfig(MNN_FORWARD_CPU, config, 4);
+        res = res && testAll();
+        executor->setGlobalExecutorConfig(MNN_FORWARD_CPU, config, 1);
+        return res;
+    }
+};
+MNNTestSuiteRegister(NonMaxSuppressionTest, "op/nms");
@@ -0,0 +1,79 @@
+//
+//  TopKV2Test.cpp
+//  MNNTests
+//
+//  Created by MNN on 2020/05/07.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <algorithm>
+#include <vector>
+#include <MNN/expr/Executor.hpp>
+#include <MNN/expr/ExprCreator.hpp>
+#include "MNNTestSuite.h"
+#include "MNN_generated.h"
+#include "TestUtils.h"
+
+using namespace MNN::Express;
+
+class TopKV2Test : public MNNTestCase {
+public:
+    virtual ~TopKV2Test() = default;
+    // The values have many ties, the smaller index must be in front for the same value
+    template <typename T>
+    static bool test(int numRows, int rowSize, int k) {
+        std::unique_ptr<MNN::OpT> op(new MNN::OpT);
+        op->type       = MNN::OpType_TopKV2;
+        op->main.type  = MNN::OpParameter_TopKV2;
+        op->main.value = new MNN::TopKV2T;
+        auto input     = _Input({numRows, rowSize}, NHWC, halide_type_of<T>());
+        auto inputPtr  = input->template writeMap<T>();
+        for (int i = 0; i < numRows * rowSize; ++i) {
+            // Increase by row to check the threshold
+            inputPtr[i] = (T)((i * 7919) % 1009 + (i % rowSize) / 97);
+        }
+        auto expr       = Expr::create(op.get(), {input, _Scalar<int32_t>(k)}, 2);
+        auto values     = Variable::create(expr, 0);
+        auto indexes    = Variable::create(expr, 1);
+        auto valuesPtr  = values->template readMap<T>();
+        auto indexesPtr = indexes->template readMap<int32_t>();
+        std::vector<int32_t> order(rowSize);
+        for (int row = 0; row < numRows; ++row) {
+            auto src = inputPtr + row * rowSize;
+            for (int i = 0; i < rowSize; ++i) {
+                order[i] = i;
+            }
+            std::stable_sort(order.begin(), order.end(), [src](int32_t a, int32_t b) { return src[a] > src[b]; });
+            for (int i = 0; i < k; ++i) {
+                if (indexesPtr[row * k + i] != order[i] || valuesPtr[row * k + i] != src[order[i]]) {
+                    MNN_ERROR("TopKV2 error for %d x %d, k = %d at row %d, %d: %d - %d\n", numRows, rowSize, k, row, i,
+                              indexesPtr[row * k + i], order[i]);
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+    static bool testAll() {
+        bool res = true;
+        res      = res && test<float>(4, 1000, 10);
+        res      = res && test<float>(3, 20, 20);
+        res      = res && test<float>(2, 50000, 1);
+        res      = res && test<float>(1, 200000, 500);
+        res      = res && test<float>(1, 100003, 2000);
+        res      = res && test<int32_t>(5, 3001, 7);
+        res      = res && test<int32_t>(1, 70000, 100);
+        return res;
+    }
+    virtual bool run() {
+        bool res = testAll();
+        // Check the split of row with multi threads
+        MNN::BackendConfig config;
+        auto executor = Executor::getGlobalExecutor();
+        executor->setGlobalExecutorConfig(MNN_FORWARD_CPU, config, 4);
+        res = res && testAll();
+        executor->setGlobalExecutorConfig(MNN_FORWARD_CPU, config, 1);
+        return res;
+    }
+};
+MNNTestSuiteRegister(TopKV2Test, "op/topkv2");
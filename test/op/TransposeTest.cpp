@@ -0,0 +1,107 @@
+//
+//  TransposeTest.cpp
+//  MNNTests
+//
+//  Created by MNN on 2020/05/09.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <vector>
+#include <MNN/expr/Executor.hpp>
+#include <MNN/expr/ExprCreator.hpp>
+#include "MNNTestSuite.h"
+#include "TestUtils.h"
+
+using namespace MNN::Express;
+using std::vector;
+
+class TransposeTest : public MNNTestCase {
+public:
+    virtual ~TransposeTest() = default;
+    // Offset in input of every output element in order
+    static vector<int> reference(const vector<int>& shape, const vector<int>& perm) {
+        const int dims = (int)shape.size();
+        vector<int> stride(dims), outShape(dims);
+        int total = 1;
+        for (int i = dims - 1; i >= 0; --i) {
+            stride[i] = total;
+            total *= shape[i];
+        }
+        for (int i = 0; i < dims; ++i) {
+            outShape[i] = shape[perm[i]];
+        }
+        vector<int> offsets(total);
+        for (int i = 0; i < total; ++i) {
+            int index = i, offset = 0;
+            for (int j = dims - 1; j >= 0; --j) {
+                offset += (index % outShape[j]) * stride[perm[j]];
+                index /= outShape[j];
+            }
+            offsets[i] = offset;
+        }
+        return offsets;
+    }
+    template <typename T>
+    static bool test(const vector<int>& shape, const vector<int>& perm, bool permuteOp) {
+        auto input    = _Input(shape, NCHW, halide_type_of<T>());
+        auto size     = input->getInfo()->size;
+        auto inputPtr = input->template writeMap<T>();
+        for (int i = 0; i < size; ++i) {
+            inputPtr[i] = (T)(i % 251);
+        }
+        VARP output;
+        if (permuteOp) {
+            output = _Convert(_Permute(_Convert(input, NC4HW4), perm), NCHW);
+        } else {
+            output = _Transpose(input, perm);
+        }
+        auto outputPtr = output->template readMap<T>();
+        auto offsets   = reference(shape, perm);
+        for (int i = 0; i < size; ++i) {
+            if (outputPtr[i] != inputPtr[offsets[i]]) {
+                MNN_ERROR("%s error for %d bytes at %d\n", permuteOp ? "Permute" : "Transpose", (int)sizeof(T), i);
+                return false;
+            }
+        }
+        return true;
+    }
+    static bool testAll() {
+        // {shape, perm}
+        const vector<vector<vector<int>>> cases = {
+            {{5, 7}, {1, 0}},                          // 2D with remain of 4 x 4
+            {{64, 1024}, {1, 0}},                      // Large 2D, split into blocks
+            {{2, 3, 4}, {0, 1, 2}},                    // Identity
+            {{3, 1, 5, 1}, {1, 0, 3, 2}},              // Only moves the axes of extent 1
+            {{2, 6, 4, 5}, {0, 1, 3, 2}},              // Last two axes
+            {{4, 3, 10, 17}, {0, 2, 1, 3}},            // Attention like, the last axis is kept
+            {{2, 128, 12, 64}, {0, 2, 3, 1}},          // Attention like, the last axis is moved
+            {{3, 4, 5, 6}, {3, 2, 1, 0}},              // Reverse
+            {{2, 3, 4, 5, 6}, {4, 0, 3, 1, 2}},        // 5D
+            {{2, 2, 3, 2, 3, 2}, {5, 3, 1, 0, 2, 4}},  // 6D
+        };
+        for (auto& c : cases) {
+            bool res = test<float>(c[0], c[1], false) && test<int32_t>(c[0], c[1], false) &&
+                       test<int8_t>(c[0], c[1], false) && test<uint8_t>(c[0], c[1], false);
+            // Permute on NC4HW4 supports 2 to 5 dimensions and float
+            if (c[0].size() >= 2 && c[0].size() <= 5) {
+                res = res && test<float>(c[0], c[1], true);
+            }
+            if (!res) {
+                MNN_ERROR("Case index %d\n", (int)(&c - cases.data()));
+                return false;
+            }
+        }
+        return true;
+    }
+    virtual bool run() {
+        bool res = testAll();
+        // Check the split of blocks and rows with multi threads
+        MNN::BackendConfig config;
+        auto executor = Executor::getGlobalExecutor();
+        executor->setGlobalExecutorConfig(MNN_FORWARD_CPU, config, 4);
+        res = res && testAll();
+        executor->setGlobalExecutorConfig(MNN_FORWARD_CPU, config, 1);
+        return res;
+    }
+};
+MNNTestSuiteRegister(TransposeTest, "op/transpose");
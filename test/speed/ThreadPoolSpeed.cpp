@@ -0,0 +1,121 @@
+//
+//  ThreadPoolSpeed.cpp
+//  MNNTests
+//
+//  Created by MNN on 2020/04/24.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <thread>
+#include <MNN/AutoTime.hpp>
+#include <MNN/Interpreter.hpp>
+#include <MNN/expr/ExprCreator.hpp>
+#include "MNNTestSuite.h"
+#include "MNN_generated.h"
+#ifdef MNN_USE_THREAD_POOL
+#include "backend/cpu/ThreadPool.hpp"
+#endif
+
+using namespace MNN;
+using namespace MNN::Express;
+
+#define CHANNEL 16
+#define SIZE 56
+#define LAYERS 4
+#define TIME 20
+class ThreadPoolSpeed : public MNNTestCase {
+public:
+    static std::vector<int8_t> buildModel() {
+        auto x = _Input({1, CHANNEL, SIZE, SIZE}, NC4HW4, halide_type_of<float>());
+        auto y = x;
+        for (int l = 0; l < LAYERS; ++l) {
+            std::vector<float> weight(CHANNEL * CHANNEL * 9), bias(CHANNEL);
+            for (int i = 0; i < weight.size(); ++i) {
+                weight[i] = (float)(i % 17 - 8) / 64.0f;
+            }
+            for (int i = 0; i < bias.size(); ++i) {
+                bias[i] = (float)i / CHANNEL;
+            }
+            y = _Conv(std::move(weight), std::move(bias), y, {CHANNEL, CHANNEL}, {3, 3}, SAME, {1, 1}, {1, 1}, 1,
+                      {0, 0}, true);
+        }
+        std::unique_ptr<NetT> net(new NetT);
+        Variable::save({y}, net.get());
+        flatbuffers::FlatBufferBuilder builder(1024);
+        auto len = Net::Pack(builder, net.get());
+        builder.Finish(len);
+        return std::vector<int8_t>((int8_t*)builder.GetBufferPointer(),
+                                   (int8_t*)builder.GetBufferPointer() + builder.GetSize());
+    }
+    static void sessionTest(const std::vector<int8_t>& model, int sessionNumber) {
+        std::shared_ptr<Interpreter> interp(Interpreter::createFromBuffer(model.data(), model.size()));
+        ScheduleConfig config;
+        config.numThread = 4;
+        std::vector<Session*> sessions;
+        for (int i = 0; i < sessionNumber; ++i) {
+            sessions.emplace_back(interp->createSession(config));
+        }
+        Timer timer;
+        std::vector<std::thread> threads;
+        for (int i = 0; i < sessionNumber; ++i) {
+            threads.emplace_back([&, i]() {
+                for (int t = 0; t < TIME; ++t) {
+                    interp->runSession(sessions[i]);
+                }
+            });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        auto cost = timer.durationInUs() / 1000.0f;
+        MNN_PRINT("%d concurrent sessions: %f ms, %f ms / inference\n", sessionNumber, cost,
+                  cost / (float)(TIME * sessionNumber));
+    }
+#ifdef MNN_USE_THREAD_POOL
+    static void unevenTest(int outerNumber) {
+        // Tiles cost 1x to 8x, like the last tiles of winograd or strassen
+        const int tileNumber = 64;
+        std::vector<std::thread> threads;
+        Timer timer;
+        for (int i = 0; i < outerNumber; ++i) {
+            threads.emplace_back([tileNumber]() {
+                ThreadPool::init(4);
+                auto index = ThreadPool::acquireWorkIndex();
+                ThreadPool::active();
+                for (int t = 0; t < TIME; ++t) {
+                    ThreadPool::enqueue(std::make_pair(
+                                            [](int tId) {
+                                                volatile float sum = 0.0f;
+                                                int loop           = (1 + (tId * 7) % 8) * 20000;
+                                                for (int v = 0; v < loop; ++v) {
+                                                    sum = sum + (float)v;
+                                                }
+                                            },
+                                            tileNumber),
+                                        index);
+                }
+                ThreadPool::deactive();
+                ThreadPool::releaseWorkIndex(index);
+            });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        MNN_PRINT("%d concurrent uneven tasks: %f ms\n", outerNumber, timer.durationInUs() / 1000.0f);
+    }
+#endif
+    virtual bool run() {
+        auto model = buildModel();
+        MNN_PRINT("Test ThreadPool with %d layers conv %d x %d x %d, %d times\n", LAYERS, CHANNEL, SIZE, SIZE, TIME);
+        for (auto number : {1, 4, 16}) {
+            sessionTest(model, number);
+        }
+#ifdef MNN_USE_THREAD_POOL
+        for (auto number : {1, 4, 16}) {
+            unevenTest(number);
+        }
+#endif
+        return true;
+    }
+};
+MNNTestSuiteRegister(ThreadPoolSpeed, "speed/ThreadPool");
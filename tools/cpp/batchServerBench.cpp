@@ -0,0 +1,141 @@
+//
+//  batchServerBench.cpp
+//  MNN
+//
+//  Created by MNN on 2020/04/30.
+//  Copyright © 2018, Alibaba Group Holding Limited
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <MNN/BatchServer.hpp>
+#include <MNN/Interpreter.hpp>
+#include <MNN/expr/ExprCreator.hpp>
+#include "MNN_generated.h"
+
+using namespace MNN;
+using namespace MNN::Express;
+
+// Small convolution network with batch in all outputs, used when model is -
+static Interpreter* _createBuiltinNet() {
+    auto x = _Input({1, 3, 64, 64}, NC4HW4, halide_type_of<float>());
+    auto y = x;
+    int ic = 3;
+    for (int i = 0; i < 4; ++i) {
+        int oc = 16 << (i / 2);
+        std::vector<float> weight(oc * ic * 9), bias(oc, 0.0f);
+        for (int j = 0; j < weight.size(); ++j) {
+            weight[j] = (float)(j % 11 - 5) / 32.0f;
+        }
+        y  = _Relu(_Conv(std::move(weight), std::move(bias), y, {ic, oc}, {3, 3}, SAME, {2 - i % 2, 2 - i % 2}));
+        ic = oc;
+    }
+    y = _Convert(y, NCHW);
+    std::unique_ptr<NetT> net(new NetT);
+    Variable::save({y}, net.get());
+    flatbuffers::FlatBufferBuilder builder(1024);
+    builder.Finish(Net::Pack(builder, net.get()));
+    return Interpreter::createFromBuffer(builder.GetBufferPointer(), builder.GetSize());
+}
+
+int main(int argc, const char* argv[]) {
+    if (argc < 2) {
+        MNN_PRINT("Usage: ./batchServerBench.out model.mnn [clients=16] [requests=1000] [maxBatch=8] [maxWaitUs=1000] "
+                  "[workers=1] [threads=1]\n");
+        MNN_PRINT("Use - as model.mnn to run a builtin convolution network\n");
+        return 0;
+    }
+    int clients   = argc > 2 ? ::atoi(argv[2]) : 16;
+    int requests  = argc > 3 ? ::atoi(argv[3]) : 1000;
+    int maxBatch  = argc > 4 ? ::atoi(argv[4]) : 8;
+    int maxWaitUs = argc > 5 ? ::atoi(argv[5]) : 1000;
+    int workers   = argc > 6 ? ::atoi(argv[6]) : 1;
+    int threads   = argc > 7 ? ::atoi(argv[7]) : 1;
+    MNN_PRINT("clients: %d, requests: %d, maxBatch: %d, maxWaitUs: %d, workers: %d, threads: %d\n", clients, requests,
+              maxBatch, maxWaitUs, workers, threads);
+
+    std::shared_ptr<Interpreter> net;
+    if (std::string("-") == argv[1]) {
+        net.reset(_createBuiltinNet());
+    } else {
+        net.reset(Interpreter::createFromFile(argv[1]));
+    }
+    if (nullptr == net) {
+        return 0;
+    }
+    // Get sample size of inputs from a single batch session
+    BatchServer::Tensors sample;
+    {
+        ScheduleConfig config;
+        auto session = net->createSession(config);
+        for (auto& iter : net->getSessionInputAll(session)) {
+            auto input = iter.second;
+            auto size  = input->elementSize() / std::max(input->length(0), 1);
+            std::vector<float> data(size);
+            for (int i = 0; i < size; ++i) {
+                data[i] = (float)(rand() % 255) / 255.0f;
+            }
+            sample[iter.first] = std::move(data);
+        }
+        net->releaseSession(session);
+    }
+
+    BatchServer::Config config;
+    config.maxBatch           = maxBatch;
+    config.maxWaitUs          = maxWaitUs;
+    config.numWorker          = workers;
+    config.schedule.numThread = threads;
+    std::unique_ptr<BatchServer> server(BatchServer::create(net, config));
+    if (nullptr == server) {
+        MNN_ERROR("Create batch server failed\n");
+        return 0;
+    }
+
+    // Closed loop load: every client submits next request after previous one finished
+    std::vector<std::vector<float>> latencies(clients);
+    std::atomic<int> remain(requests);
+    std::atomic<int> errors(0);
+    std::vector<std::thread> threadPool;
+    auto begin = std::chrono::steady_clock::now();
+    for (int c = 0; c < clients; ++c) {
+        threadPool.emplace_back([&, c]() {
+            while (remain-- > 0) {
+                auto inputs = sample;
+                auto start  = std::chrono::steady_clock::now();
+                auto result = server->submit(std::move(inputs)).get();
+                auto end    = std::chrono::steady_clock::now();
+                if (NO_ERROR != result.code) {
+                    errors++;
+                }
+                latencies[c].emplace_back(std::chrono::duration<float, std::milli>(end - start).count());
+            }
+        });
+    }
+    for (auto& t : threadPool) {
+        t.join();
+    }
+    auto seconds = std::chrono::duration<float>(std::chrono::steady_clock::now() - begin).count();
+
+    std::vector<float> all;
+    for (auto& l : latencies) {
+        all.insert(all.end(), l.begin(), l.end());
+    }
+    if (all.empty()) {
+        return 0;
+    }
+    std::sort(all.begin(), all.end());
+    auto percentile = [&all](float p) { return all[std::min((size_t)(p * all.size()), all.size() - 1)]; };
+    auto stats      = server->getStats();
+    MNN_PRINT("throughput: %.2f req/s, p50: %.3f ms, p99: %.3f ms, max: %.3f ms\n", all.size() / seconds,
+              percentile(0.5f), percentile(0.99f), all.back());
+    MNN_PRINT("batches: %lld, average batch: %.2f, errors: %d\n", (long long)stats.first,
+              stats.first > 0 ? (float)stats.second / stats.first : 0.0f, errors.load());
+    return 0;
+}
@@ -85,6 +85,13 @@ int main(int argc, const char* argv[]) {
     config.numThread      = 4;
     MNN::Session* session = NULL;
     session               = net->createSession(config);
+    const char* tracePath = NULL;
+    if (argc > 5) {
+        // Trace resize and run into chrome trace file
+        tracePath = argv[5];
+        net->setSessionTrace(session, true);
+        net->resizeSession(session);
+    }
     auto inputTensor      = net->getSessionInput(session, NULL);
     if (!inputDims.empty()) {
         net->resizeTensor(inputTensor, inputDims);
@@ -121,5 +128,14 @@ int main(int argc, const char* argv[]) {
     profiler->printTimeByName(runTime);
 #endif
     profiler->printTimeByType(runTime);
+    if (NULL != tracePath) {
+        auto trace = net->getSessionTrace(session);
+        auto file  = fopen(tracePath, "w");
+        if (NULL != file) {
+            fwrite(trace.c_str(), 1, trace.size(), file);
+            fclose(file);
+            MNN_PRINT("Write trace to %s\n", tracePath);
+        }
+    }
     return 0;
 }
@@ -7,6 +7,7 @@
 //
 
 #include "DataLoader.hpp"
+#include <MNN/expr/Executor.hpp>
 #include "LambdaTransform.hpp"
 #include "RandomSampler.hpp"
 #include "Sampler.hpp"
@@ -64,6 +65,9 @@ void DataLoader::prefetch(size_t nJobs) {
 }
 
 void DataLoader::workerThread() {
+    // Each worker compute the transforms by its own executor, so they don't wait for each other
+    MNN::BackendConfig config;
+    Express::ExecutorScope scope(Express::Executor::newExecutor(MNN_FORWARD_CPU, config, 1));
     while (true) {
         auto currentJob = mJobs->pop();
         if (currentJob.quit) {
@@ -7,8 +7,10 @@
 //
 
 #include "PipelineModule.hpp"
+#include <MNN/expr/Optimizer.hpp>
 #include "NN.hpp"
 #include "MNN_generated.h"
+#include <map>
 #include <set>
 #include <vector>
 using namespace MNN::Express;
@@ -75,6 +77,66 @@ private:
     std::vector<int> mInputIndexes;
 };
 
+// Copy the ops between inputs and outputs, so that optimizing the copy doesn't change the exprs of caller.
+// Inputs, constants and trainable parameters are shared
+static std::vector<VARP> _cloneGraph(const std::vector<VARP>& inputs, const std::vector<VARP>& outputs) {
+    std::set<EXPRP> inputExprs;
+    for (auto v : inputs) {
+        inputExprs.insert(v->expr().first);
+    }
+    std::map<EXPRP, EXPRP> cloned;
+    std::vector<EXPRP> visited;
+    auto clonedVar = [&cloned](VARP var) {
+        auto iter = cloned.find(var->expr().first);
+        if (iter == cloned.end()) {
+            return var;
+        }
+        return Variable::create(iter->second, var->expr().second);
+    };
+    for (auto output : outputs) {
+        Expr::visit(output->expr().first,
+        [&inputExprs, &visited](EXPRP expr) {
+            if (expr->visited()) {
+                return false;
+            }
+            if (inputExprs.find(expr) != inputExprs.end() || nullptr == expr->get()) {
+                expr->setVisited(true);
+                visited.emplace_back(expr);
+                return false;
+            }
+            return true;
+        },
+        [&cloned, &visited, &clonedVar](EXPRP expr) {
+            if (expr->visited()) {
+                return true;
+            }
+            expr->setVisited(true);
+            visited.emplace_back(expr);
+            std::vector<VARP> newInputs;
+            for (auto input : expr->inputs()) {
+                newInputs.emplace_back(clonedVar(input));
+            }
+            auto newExpr = Expr::create(expr->extra(), std::move(newInputs), expr->outputSize());
+            newExpr->setName(expr->name());
+            for (int i = 0; i < expr->outputSize(); ++i) {
+                if (!expr->outputName(i).empty()) {
+                    Variable::create(newExpr, i)->setName(expr->outputName(i));
+                }
+            }
+            cloned[expr] = newExpr;
+            return true;
+        });
+    }
+    for (auto expr : visited) {
+        expr->setVisited(false);
+    }
+    std::vector<VARP> newOutputs;
+    for (auto output : outputs) {
+        newOutputs.emplace_back(clonedVar(output));
+    }
+    return newOutputs;
+}
+
 Module* PipelineModule::extract(std::vector<Express::VARP> inputs, std::vector<Express::VARP> outputs, bool fortrain) {
     std::function<std::pair<std::vector<int>, std::shared_ptr<Module>>(EXPRP)> transformFunction;
     if (fortrain) {
@@ -97,6 +159,15 @@ Module* PipelineModule::extract(std::vector<Express::VARP> inputs, std::vector<E
             return std::make_pair(std::vector<int>{0}, module);
         };
     } else {
+        // Fold constant, BN / Scale / ReLU into convolution and share common ops as converter does. The optimizer
+        // replaces exprs in place, so a copy is optimized and the graph of caller, maybe extracted for training too,
+        // is kept unchanged
+        Optimizer::Config config;
+        auto optimizer = Optimizer::create(config);
+        if (nullptr != optimizer) {
+            outputs = _cloneGraph(inputs, outputs);
+            optimizer->onExecute(outputs);
+        }
         transformFunction = [](EXPRP source) {
             if (source->get() == nullptr) {
                 return std::make_pair(std::vector<int>{}, std::shared_ptr<Module>(nullptr));